@@ -26,5 +26,6 @@ AC_DEFUN([OPAL_CONFIG_FILES],[
         opal/tools/wrappers/opalcc-wrapper-data.txt
         opal/tools/wrappers/opalc++-wrapper-data.txt
         opal/tools/wrappers/opal.pc
+        opal/tools/trace/Makefile
     ])
 ])
@@ -178,6 +178,25 @@ AC_DEFINE_UNQUOTED(OPAL_ENABLE_TIMING, $WANT_TIMING,
 AM_CONDITIONAL([OPAL_COMPILE_TIMING], [test "$WANT_TIMING" = "1"])
 AM_CONDITIONAL([OPAL_INSTALL_TIMING_BINARIES], [test "$WANT_TIMING" = "1" && test "$enable_binaries" != "no"])
 
+
+AC_MSG_CHECKING([if want binary event tracing of the communication stack])
+AC_ARG_ENABLE([trace],
+    [AS_HELP_STRING([--enable-trace],
+                   [compile the event trace points of the communication stack, recorded when the opal_trace_enable MCA parameter is set (default: disabled)])])
+if test "$enable_trace" = "yes"; then
+    AC_MSG_RESULT([yes])
+    WANT_TRACE=1
+else
+    AC_MSG_RESULT([no])
+    WANT_TRACE=0
+fi
+
+AC_DEFINE_UNQUOTED(OPAL_ENABLE_TRACE, $WANT_TRACE,
+    [Whether we want the event trace points of the communication stack or not])
+
+AM_CONDITIONAL([OPAL_COMPILE_TRACE], [test "$WANT_TRACE" = "1"])
+AM_CONDITIONAL([OPAL_INSTALL_TRACE_BINARIES], [test "$WANT_TRACE" = "1" && test "$enable_binaries" != "no"])
+
 if test "$WANT_DEBUG" = "0"; then
     CFLAGS="-DNDEBUG $CFLAGS"
     CXXFLAGS="-DNDEBUG $CXXFLAGS"
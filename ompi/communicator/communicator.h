@@ -435,6 +435,19 @@ static inline struct ompi_proc_t* ompi_comm_peer_lookup(ompi_communicator_t* com
     return ompi_group_peer_lookup(comm->c_remote_group,peer_id);
 }
 
+/**
+ * Vpid of a peer of the communicator, or -1 if PEER_ID is not a rank
+ * (e.g. MPI_ANY_SOURCE). Trace points record it as their peer, see
+ * opal/util/trace.h. It does not create the proc of the peer.
+ */
+static inline int ompi_comm_peer_vpid(ompi_communicator_t* comm, int peer_id)
+{
+    if (peer_id < 0) {
+        return -1;
+    }
+    return (int) ompi_group_get_proc_name(comm->c_remote_group, peer_id).vpid;
+}
+
 #if OPAL_ENABLE_FT_MPI
 /*
  * Support for MPI_ANY_SOURCE point-to-point operations
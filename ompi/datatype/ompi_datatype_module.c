@@ -394,6 +394,9 @@ opal_pointer_array_t ompi_datatype_f_to_c_table = {{0}};
         (PDST)->super.nbElems  = (PSRC)->super.nbElems;                              \
         (PDST)->super.desc     = (PSRC)->super.desc;                                 \
         (PDST)->super.opt_desc = (PSRC)->super.opt_desc;                             \
+        (PDST)->super.flat_desc = (PSRC)->super.flat_desc;                           \
+        (PSRC)->super.flat_desc.desc = NULL;                                         \
+        (PSRC)->super.flat_desc.used = 0;                                            \
         (PDST)->packed_description = (PSRC)->packed_description;                     \
         (PSRC)->packed_description = 0;                                              \
         /* transfer the ptypes */                                                    \
@@ -23,6 +23,7 @@
 #include "ompi/request/request.h"
 #include "ompi/mca/coll/base/coll_base_functions.h"
 #include "opal/util/output.h"
+#include "opal/util/trace.h"
 
 /* also need the dynamic rule structures */
 #include "coll_tuned_dynamic_rules.h"
@@ -129,42 +129,58 @@ int ompi_coll_tuned_allgather_intra_do_this(const void *sbuf, int scount,
                                             mca_coll_base_module_t *module,
                                             int algorithm, int faninout, int segsize)
 {
+    int rc;
+
     OPAL_OUTPUT((ompi_coll_tuned_stream,
                  "coll:tuned:allgather_intra_do_this selected algorithm %d topo faninout %d segsize %d",
                  algorithm, faninout, segsize));
 
+    OPAL_TRACE("coll_tuned_allgather_begin", -1, algorithm, comm->c_contextid);
+
     switch (algorithm) {
     case (0):
-        return ompi_coll_tuned_allgather_intra_dec_fixed(sbuf, scount, sdtype,
+        rc = ompi_coll_tuned_allgather_intra_dec_fixed(sbuf, scount, sdtype,
+                                                       rbuf, rcount, rdtype,
+                                                       comm, module);
+        break;
+    case (1):
+        rc = ompi_coll_base_allgather_intra_basic_linear(sbuf, scount, sdtype,
                                                          rbuf, rcount, rdtype,
                                                          comm, module);
-    case (1):
-        return ompi_coll_base_allgather_intra_basic_linear(sbuf, scount, sdtype,
-                                                           rbuf, rcount, rdtype,
-                                                           comm, module);
+        break;
     case (2):
-        return ompi_coll_base_allgather_intra_bruck(sbuf, scount, sdtype,
-                                                    rbuf, rcount, rdtype,
-                                                    comm, module);
+        rc = ompi_coll_base_allgather_intra_bruck(sbuf, scount, sdtype,
+                                                  rbuf, rcount, rdtype,
+                                                  comm, module);
+        break;
     case (3):
-        return ompi_coll_base_allgather_intra_recursivedoubling(sbuf, scount, sdtype,
-                                                                rbuf, rcount, rdtype,
-                                                                comm, module);
+        rc = ompi_coll_base_allgather_intra_recursivedoubling(sbuf, scount, sdtype,
+                                                              rbuf, rcount, rdtype,
+                                                              comm, module);
+        break;
     case (4):
-        return ompi_coll_base_allgather_intra_ring(sbuf, scount, sdtype,
-                                                   rbuf, rcount, rdtype,
-                                                   comm, module);
+        rc = ompi_coll_base_allgather_intra_ring(sbuf, scount, sdtype,
+                                                 rbuf, rcount, rdtype,
+                                                 comm, module);
+        break;
     case (5):
-        return ompi_coll_base_allgather_intra_neighborexchange(sbuf, scount, sdtype,
-                                                               rbuf, rcount, rdtype,
-                                                               comm, module);
+        rc = ompi_coll_base_allgather_intra_neighborexchange(sbuf, scount, sdtype,
+                                                             rbuf, rcount, rdtype,
+                                                             comm, module);
+        break;
     case (6):
-        return ompi_coll_base_allgather_intra_two_procs(sbuf, scount, sdtype,
-                                                        rbuf, rcount, rdtype,
-                                                        comm, module);
+        rc = ompi_coll_base_allgather_intra_two_procs(sbuf, scount, sdtype,
+                                                      rbuf, rcount, rdtype,
+                                                      comm, module);
+        break;
+    default:
+        OPAL_OUTPUT((ompi_coll_tuned_stream,
+                     "coll:tuned:allgather_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
+                     algorithm, ompi_coll_tuned_forced_max_algorithms[ALLGATHER]));
+        rc = MPI_ERR_ARG;
+        break;
     } /* switch */
-    OPAL_OUTPUT((ompi_coll_tuned_stream,
-                 "coll:tuned:allgather_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
-                 algorithm, ompi_coll_tuned_forced_max_algorithms[ALLGATHER]));
-    return (MPI_ERR_ARG);
+    OPAL_TRACE("coll_tuned_allgather_end", -1, algorithm, rc);
+
+    return rc;
 }
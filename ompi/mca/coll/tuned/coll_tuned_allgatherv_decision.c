@@ -130,38 +130,53 @@ int ompi_coll_tuned_allgatherv_intra_do_this(const void *sbuf, int scount,
                                              int algorithm, int faninout,
                                              int segsize)
 {
+    int rc;
+
     OPAL_OUTPUT((ompi_coll_tuned_stream,
                  "coll:tuned:allgatherv_intra_do_this selected algorithm %d topo faninout %d segsize %d",
                  algorithm, faninout, segsize));
 
+    OPAL_TRACE("coll_tuned_allgatherv_begin", -1, algorithm, comm->c_contextid);
+
     switch (algorithm) {
     case (0):
-        return ompi_coll_tuned_allgatherv_intra_dec_fixed(sbuf, scount, sdtype,
-                                                          rbuf, rcounts, rdispls, rdtype,
-                                                          comm, module);
+        rc = ompi_coll_tuned_allgatherv_intra_dec_fixed(sbuf, scount, sdtype,
+                                                        rbuf, rcounts, rdispls, rdtype,
+                                                        comm, module);
+        break;
     case (1):
-        return ompi_coll_base_allgatherv_intra_basic_default(sbuf, scount, sdtype,
-                                                             rbuf, rcounts, rdispls, rdtype,
-                                                             comm, module);
+        rc = ompi_coll_base_allgatherv_intra_basic_default(sbuf, scount, sdtype,
+                                                           rbuf, rcounts, rdispls, rdtype,
+                                                           comm, module);
+        break;
     case (2):
-        return ompi_coll_base_allgatherv_intra_bruck(sbuf, scount, sdtype,
-                                                     rbuf, rcounts, rdispls, rdtype,
-                                                     comm, module);
+        rc = ompi_coll_base_allgatherv_intra_bruck(sbuf, scount, sdtype,
+                                                   rbuf, rcounts, rdispls, rdtype,
+                                                   comm, module);
+        break;
     case (3):
-        return ompi_coll_base_allgatherv_intra_ring(sbuf, scount, sdtype,
-                                                    rbuf, rcounts, rdispls, rdtype,
-                                                    comm, module);
+        rc = ompi_coll_base_allgatherv_intra_ring(sbuf, scount, sdtype,
+                                                  rbuf, rcounts, rdispls, rdtype,
+                                                  comm, module);
+        break;
     case (4):
-        return ompi_coll_base_allgatherv_intra_neighborexchange(sbuf, scount, sdtype,
-                                                                rbuf, rcounts, rdispls, rdtype,
-                                                                comm, module);
+        rc = ompi_coll_base_allgatherv_intra_neighborexchange(sbuf, scount, sdtype,
+                                                              rbuf, rcounts, rdispls, rdtype,
+                                                              comm, module);
+        break;
     case (5):
-        return ompi_coll_base_allgatherv_intra_two_procs(sbuf, scount, sdtype,
-                                                         rbuf, rcounts, rdispls, rdtype,
-                                                         comm, module);
+        rc = ompi_coll_base_allgatherv_intra_two_procs(sbuf, scount, sdtype,
+                                                       rbuf, rcounts, rdispls, rdtype,
+                                                       comm, module);
+        break;
+    default:
+        OPAL_OUTPUT((ompi_coll_tuned_stream,
+                     "coll:tuned:allgatherv_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
+                     algorithm, ompi_coll_tuned_forced_max_algorithms[ALLGATHERV]));
+        rc = MPI_ERR_ARG;
+        break;
     } /* switch */
-    OPAL_OUTPUT((ompi_coll_tuned_stream,
-                 "coll:tuned:allgatherv_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
-                 algorithm, ompi_coll_tuned_forced_max_algorithms[ALLGATHERV]));
-    return (MPI_ERR_ARG);
+    OPAL_TRACE("coll_tuned_allgatherv_end", -1, algorithm, rc);
+
+    return rc;
 }
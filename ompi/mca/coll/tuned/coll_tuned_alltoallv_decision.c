@@ -96,27 +96,39 @@ int ompi_coll_tuned_alltoallv_intra_do_this(const void *sbuf, const int *scounts
                                             mca_coll_base_module_t *module,
                                             int algorithm)
 {
+    int rc;
+
     OPAL_OUTPUT((ompi_coll_tuned_stream,
                  "coll:tuned:alltoallv_intra_do_this selected algorithm %d ",
                  algorithm));
 
+    OPAL_TRACE("coll_tuned_alltoallv_begin", -1, algorithm, comm->c_contextid);
+
     switch (algorithm) {
     case (0):
-        return ompi_coll_tuned_alltoallv_intra_dec_fixed(sbuf, scounts, sdisps, sdtype,
+        rc = ompi_coll_tuned_alltoallv_intra_dec_fixed(sbuf, scounts, sdisps, sdtype,
+                                                       rbuf, rcounts, rdisps, rdtype,
+                                                       comm, module);
+        break;
+    case (1):
+        rc = ompi_coll_base_alltoallv_intra_basic_linear(sbuf, scounts, sdisps, sdtype,
                                                          rbuf, rcounts, rdisps, rdtype,
                                                          comm, module);
-    case (1):
-        return ompi_coll_base_alltoallv_intra_basic_linear(sbuf, scounts, sdisps, sdtype,
-                                                           rbuf, rcounts, rdisps, rdtype,
-                                                           comm, module);
+        break;
     case (2):
-        return ompi_coll_base_alltoallv_intra_pairwise(sbuf, scounts, sdisps, sdtype,
-                                                       rbuf, rcounts, rdisps, rdtype,
-                                                       comm, module);
+        rc = ompi_coll_base_alltoallv_intra_pairwise(sbuf, scounts, sdisps, sdtype,
+                                                     rbuf, rcounts, rdisps, rdtype,
+                                                     comm, module);
+        break;
+    default:
+        OPAL_OUTPUT((ompi_coll_tuned_stream,
+                     "coll:tuned:alltoall_intra_do_this attempt to select "
+                     "algorithm %d when only 0-%d is valid.",
+                     algorithm, ompi_coll_tuned_forced_max_algorithms[ALLTOALLV]));
+        rc = MPI_ERR_ARG;
+        break;
     }  /* switch */
-    OPAL_OUTPUT((ompi_coll_tuned_stream,
-                 "coll:tuned:alltoall_intra_do_this attempt to select "
-                 "algorithm %d when only 0-%d is valid.",
-                 algorithm, ompi_coll_tuned_forced_max_algorithms[ALLTOALLV]));
-    return (MPI_ERR_ARG);
+    OPAL_TRACE("coll_tuned_alltoallv_end", -1, algorithm, rc);
+
+    return rc;
 }
@@ -90,20 +90,36 @@ int ompi_coll_tuned_barrier_intra_do_this (struct ompi_communicator_t *comm,
                                            mca_coll_base_module_t *module,
                                            int algorithm, int faninout, int segsize)
 {
+    int rc;
+
     OPAL_OUTPUT((ompi_coll_tuned_stream,
                  "coll:tuned:barrier_intra_do_this selected algorithm %d topo fanin/out%d",
                  algorithm, faninout));
 
+    OPAL_TRACE("coll_tuned_barrier_begin", -1, algorithm, comm->c_contextid);
+
     switch (algorithm) {
-    case (0):   return ompi_coll_tuned_barrier_intra_dec_fixed(comm, module);
-    case (1):   return ompi_coll_base_barrier_intra_basic_linear(comm, module);
-    case (2):   return ompi_coll_base_barrier_intra_doublering(comm, module);
-    case (3):   return ompi_coll_base_barrier_intra_recursivedoubling(comm, module);
-    case (4):   return ompi_coll_base_barrier_intra_bruck(comm, module);
-    case (5):   return ompi_coll_base_barrier_intra_two_procs(comm, module);
-    case (6):   return ompi_coll_base_barrier_intra_tree(comm, module);
+    case (0):   rc = ompi_coll_tuned_barrier_intra_dec_fixed(comm, module);
+        break;
+    case (1):   rc = ompi_coll_base_barrier_intra_basic_linear(comm, module);
+        break;
+    case (2):   rc = ompi_coll_base_barrier_intra_doublering(comm, module);
+        break;
+    case (3):   rc = ompi_coll_base_barrier_intra_recursivedoubling(comm, module);
+        break;
+    case (4):   rc = ompi_coll_base_barrier_intra_bruck(comm, module);
+        break;
+    case (5):   rc = ompi_coll_base_barrier_intra_two_procs(comm, module);
+        break;
+    case (6):   rc = ompi_coll_base_barrier_intra_tree(comm, module);
+        break;
+    default:
+        OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:barrier_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
+                     algorithm, ompi_coll_tuned_forced_max_algorithms[BARRIER]));
+        rc = MPI_ERR_ARG;
+        break;
     } /* switch */
-    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:barrier_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
-                 algorithm, ompi_coll_tuned_forced_max_algorithms[BARRIER]));
-    return (MPI_ERR_ARG);
+    OPAL_TRACE("coll_tuned_barrier_end", -1, algorithm, rc);
+
+    return rc;
 }
@@ -139,33 +139,53 @@ int ompi_coll_tuned_bcast_intra_do_this(void *buf, int count,
                                         mca_coll_base_module_t *module,
                                         int algorithm, int faninout, int segsize)
 {
+    int rc;
+
     OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:bcast_intra_do_this algorithm %d topo faninout %d segsize %d",
                  algorithm, faninout, segsize));
 
+    OPAL_TRACE("coll_tuned_bcast_begin", ompi_comm_peer_vpid(comm, root), algorithm,
+               comm->c_contextid);
+
     switch (algorithm) {
     case (0):
-        return ompi_coll_tuned_bcast_intra_dec_fixed( buf, count, dtype, root, comm, module );
+        rc = ompi_coll_tuned_bcast_intra_dec_fixed( buf, count, dtype, root, comm, module );
+        break;
     case (1):
-        return ompi_coll_base_bcast_intra_basic_linear( buf, count, dtype, root, comm, module );
+        rc = ompi_coll_base_bcast_intra_basic_linear( buf, count, dtype, root, comm, module );
+        break;
     case (2):
-        return ompi_coll_base_bcast_intra_chain( buf, count, dtype, root, comm, module, segsize, faninout );
+        rc = ompi_coll_base_bcast_intra_chain( buf, count, dtype, root, comm, module, segsize, faninout );
+        break;
     case (3):
-        return ompi_coll_base_bcast_intra_pipeline( buf, count, dtype, root, comm, module, segsize );
+        rc = ompi_coll_base_bcast_intra_pipeline( buf, count, dtype, root, comm, module, segsize );
+        break;
     case (4):
-        return ompi_coll_base_bcast_intra_split_bintree( buf, count, dtype, root, comm, module, segsize );
+        rc = ompi_coll_base_bcast_intra_split_bintree( buf, count, dtype, root, comm, module, segsize );
+        break;
     case (5):
-        return ompi_coll_base_bcast_intra_bintree( buf, count, dtype, root, comm, module, segsize );
+        rc = ompi_coll_base_bcast_intra_bintree( buf, count, dtype, root, comm, module, segsize );
+        break;
     case (6):
-        return ompi_coll_base_bcast_intra_binomial( buf, count, dtype, root, comm, module, segsize );
+        rc = ompi_coll_base_bcast_intra_binomial( buf, count, dtype, root, comm, module, segsize );
+        break;
     case (7):
-        return ompi_coll_base_bcast_intra_knomial(buf, count, dtype, root, comm, module,
-                                                  segsize, coll_tuned_bcast_knomial_radix);
+        rc = ompi_coll_base_bcast_intra_knomial(buf, count, dtype, root, comm, module,
+                                                segsize, coll_tuned_bcast_knomial_radix);
+        break;
     case (8):
-        return ompi_coll_base_bcast_intra_scatter_allgather(buf, count, dtype, root, comm, module, segsize);
+        rc = ompi_coll_base_bcast_intra_scatter_allgather(buf, count, dtype, root, comm, module, segsize);
+        break;
     case (9):
-        return ompi_coll_base_bcast_intra_scatter_allgather_ring(buf, count, dtype, root, comm, module, segsize);
+        rc = ompi_coll_base_bcast_intra_scatter_allgather_ring(buf, count, dtype, root, comm, module, segsize);
+        break;
+    default:
+        OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:bcast_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
+                     algorithm, ompi_coll_tuned_forced_max_algorithms[BCAST]));
+        rc = MPI_ERR_ARG;
+        break;
     } /* switch */
-    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:bcast_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
-                 algorithm, ompi_coll_tuned_forced_max_algorithms[BCAST]));
-    return (MPI_ERR_ARG);
+    OPAL_TRACE("coll_tuned_bcast_end", ompi_comm_peer_vpid(comm, root), algorithm, rc);
+
+    return rc;
 }
@@ -129,31 +129,45 @@ ompi_coll_tuned_gather_intra_do_this(const void *sbuf, int scount,
                                      mca_coll_base_module_t *module,
                                      int algorithm, int faninout, int segsize)
 {
+    int rc;
+
     OPAL_OUTPUT((ompi_coll_tuned_stream,
                  "coll:tuned:gather_intra_do_this selected algorithm %d topo faninout %d segsize %d",
                  algorithm, faninout, segsize));
 
+    OPAL_TRACE("coll_tuned_gather_begin", ompi_comm_peer_vpid(comm, root), algorithm,
+               comm->c_contextid);
+
     switch (algorithm) {
     case (0):
-        return ompi_coll_tuned_gather_intra_dec_fixed(sbuf, scount, sdtype,
+        rc = ompi_coll_tuned_gather_intra_dec_fixed(sbuf, scount, sdtype,
+                                                    rbuf, rcount, rdtype,
+                                                    root, comm, module);
+        break;
+    case (1):
+        rc = ompi_coll_base_gather_intra_basic_linear(sbuf, scount, sdtype,
                                                       rbuf, rcount, rdtype,
                                                       root, comm, module);
-    case (1):
-        return ompi_coll_base_gather_intra_basic_linear(sbuf, scount, sdtype,
-                                                        rbuf, rcount, rdtype,
-                                                        root, comm, module);
+        break;
     case (2):
-        return ompi_coll_base_gather_intra_binomial(sbuf, scount, sdtype,
-                                                    rbuf, rcount, rdtype,
-                                                    root, comm, module);
+        rc = ompi_coll_base_gather_intra_binomial(sbuf, scount, sdtype,
+                                                  rbuf, rcount, rdtype,
+                                                  root, comm, module);
+        break;
     case (3):
-        return ompi_coll_base_gather_intra_linear_sync(sbuf, scount, sdtype,
-                                                       rbuf, rcount, rdtype,
-                                                       root, comm, module,
-                                                       segsize);
+        rc = ompi_coll_base_gather_intra_linear_sync(sbuf, scount, sdtype,
+                                                     rbuf, rcount, rdtype,
+                                                     root, comm, module,
+                                                     segsize);
+        break;
+    default:
+        OPAL_OUTPUT((ompi_coll_tuned_stream,
+                     "coll:tuned:gather_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
+                     algorithm, ompi_coll_tuned_forced_max_algorithms[GATHER]));
+        rc = MPI_ERR_ARG;
+        break;
     } /* switch */
-    OPAL_OUTPUT((ompi_coll_tuned_stream,
-                 "coll:tuned:gather_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
-                 algorithm, ompi_coll_tuned_forced_max_algorithms[GATHER]));
-    return (MPI_ERR_ARG);
+    OPAL_TRACE("coll_tuned_gather_end", ompi_comm_peer_vpid(comm, root), algorithm, rc);
+
+    return rc;
 }
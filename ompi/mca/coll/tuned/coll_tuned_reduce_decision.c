@@ -152,33 +152,51 @@ int ompi_coll_tuned_reduce_intra_do_this(const void *sbuf, void* rbuf, int count
                                          int algorithm, int faninout,
                                          int segsize, int max_requests )
 {
+    int rc;
+
     OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:reduce_intra_do_this selected algorithm %d topo faninout %d segsize %d",
                  algorithm, faninout, segsize));
 
+    OPAL_TRACE("coll_tuned_reduce_begin", ompi_comm_peer_vpid(comm, root), algorithm,
+               comm->c_contextid);
+
     switch (algorithm) {
-    case (0):  return ompi_coll_tuned_reduce_intra_dec_fixed(sbuf, rbuf, count, dtype,
+    case (0):  rc = ompi_coll_tuned_reduce_intra_dec_fixed(sbuf, rbuf, count, dtype,
+                                                           op, root, comm, module);
+        break;
+    case (1):  rc = ompi_coll_base_reduce_intra_basic_linear(sbuf, rbuf, count, dtype,
                                                              op, root, comm, module);
-    case (1):  return ompi_coll_base_reduce_intra_basic_linear(sbuf, rbuf, count, dtype,
-                                                               op, root, comm, module);
-    case (2):  return ompi_coll_base_reduce_intra_chain(sbuf, rbuf, count, dtype,
-                                                        op, root, comm, module,
-                                                        segsize, faninout, max_requests);
-    case (3):  return ompi_coll_base_reduce_intra_pipeline(sbuf, rbuf, count, dtype,
-                                                           op, root, comm, module,
-                                                           segsize, max_requests);
-    case (4):  return ompi_coll_base_reduce_intra_binary(sbuf, rbuf, count, dtype,
+        break;
+    case (2):  rc = ompi_coll_base_reduce_intra_chain(sbuf, rbuf, count, dtype,
+                                                      op, root, comm, module,
+                                                      segsize, faninout, max_requests);
+        break;
+    case (3):  rc = ompi_coll_base_reduce_intra_pipeline(sbuf, rbuf, count, dtype,
                                                          op, root, comm, module,
                                                          segsize, max_requests);
-    case (5):  return ompi_coll_base_reduce_intra_binomial(sbuf, rbuf, count, dtype,
-                                                           op, root, comm, module,
-                                                           segsize, max_requests);
-    case (6):  return ompi_coll_base_reduce_intra_in_order_binary(sbuf, rbuf, count, dtype,
-                                                                  op, root, comm, module,
-                                                                  segsize, max_requests);
-    case (7):  return ompi_coll_base_reduce_intra_redscat_gather(sbuf, rbuf, count, dtype,
-                                                                  op, root, comm, module);
+        break;
+    case (4):  rc = ompi_coll_base_reduce_intra_binary(sbuf, rbuf, count, dtype,
+                                                       op, root, comm, module,
+                                                       segsize, max_requests);
+        break;
+    case (5):  rc = ompi_coll_base_reduce_intra_binomial(sbuf, rbuf, count, dtype,
+                                                         op, root, comm, module,
+                                                         segsize, max_requests);
+        break;
+    case (6):  rc = ompi_coll_base_reduce_intra_in_order_binary(sbuf, rbuf, count, dtype,
+                                                                op, root, comm, module,
+                                                                segsize, max_requests);
+        break;
+    case (7):  rc = ompi_coll_base_reduce_intra_redscat_gather(sbuf, rbuf, count, dtype,
+                                                                op, root, comm, module);
+        break;
+    default:
+        OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:reduce_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
+                     algorithm, ompi_coll_tuned_forced_max_algorithms[REDUCE]));
+        rc = MPI_ERR_ARG;
+        break;
     } /* switch */
-    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:reduce_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
-                 algorithm, ompi_coll_tuned_forced_max_algorithms[REDUCE]));
-    return (MPI_ERR_ARG);
+    OPAL_TRACE("coll_tuned_reduce_end", ompi_comm_peer_vpid(comm, root), algorithm, rc);
+
+    return rc;
 }
@@ -122,22 +122,36 @@ int ompi_coll_tuned_reduce_scatter_block_intra_do_this(const void *sbuf, void *r
                                                        mca_coll_base_module_t *module,
                                                        int algorithm, int faninout, int segsize)
 {
+    int rc;
+
     OPAL_OUTPUT((ompi_coll_tuned_stream, "coll:tuned:reduce_scatter_block_intra_do_this selected algorithm %d topo faninout %d segsize %d",
                  algorithm, faninout, segsize));
 
+    OPAL_TRACE("coll_tuned_reduce_scatter_block_begin", -1, algorithm, comm->c_contextid);
+
     switch (algorithm) {
-    case (0): return ompi_coll_tuned_reduce_scatter_block_intra_dec_fixed(sbuf, rbuf, rcount,
-                                                                          dtype, op, comm, module);
-    case (1): return ompi_coll_base_reduce_scatter_block_basic_linear(sbuf, rbuf, rcount,
-                                                                      dtype, op, comm, module);
-    case (2): return ompi_coll_base_reduce_scatter_block_intra_recursivedoubling(sbuf, rbuf, rcount,
-                                                                                 dtype, op, comm, module);
-    case (3): return ompi_coll_base_reduce_scatter_block_intra_recursivehalving(sbuf, rbuf, rcount,
-                                                                                dtype, op, comm, module);
-    case (4): return ompi_coll_base_reduce_scatter_block_intra_butterfly(sbuf, rbuf, rcount, dtype, op, comm,
-                                                                         module);
+    case (0): rc = ompi_coll_tuned_reduce_scatter_block_intra_dec_fixed(sbuf, rbuf, rcount,
+                                                                        dtype, op, comm, module);
+        break;
+    case (1): rc = ompi_coll_base_reduce_scatter_block_basic_linear(sbuf, rbuf, rcount,
+                                                                    dtype, op, comm, module);
+        break;
+    case (2): rc = ompi_coll_base_reduce_scatter_block_intra_recursivedoubling(sbuf, rbuf, rcount,
+                                                                               dtype, op, comm, module);
+        break;
+    case (3): rc = ompi_coll_base_reduce_scatter_block_intra_recursivehalving(sbuf, rbuf, rcount,
+                                                                              dtype, op, comm, module);
+        break;
+    case (4): rc = ompi_coll_base_reduce_scatter_block_intra_butterfly(sbuf, rbuf, rcount, dtype, op, comm,
+                                                                       module);
+        break;
+    default:
+        OPAL_OUTPUT((ompi_coll_tuned_stream, "coll:tuned:reduce_scatter_block_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
+                     algorithm, ompi_coll_tuned_forced_max_algorithms[REDUCESCATTERBLOCK]));
+        rc = MPI_ERR_ARG;
+        break;
     } /* switch */
-    OPAL_OUTPUT((ompi_coll_tuned_stream, "coll:tuned:reduce_scatter_block_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
-                 algorithm, ompi_coll_tuned_forced_max_algorithms[REDUCESCATTERBLOCK]));
-    return (MPI_ERR_ARG);
+    OPAL_TRACE("coll_tuned_reduce_scatter_block_end", -1, algorithm, rc);
+
+    return rc;
 }
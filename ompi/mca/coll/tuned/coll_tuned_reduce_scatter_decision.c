@@ -129,22 +129,36 @@ int ompi_coll_tuned_reduce_scatter_intra_do_this(const void *sbuf, void* rbuf,
                                                  mca_coll_base_module_t *module,
                                                  int algorithm, int faninout, int segsize)
 {
+    int rc;
+
     OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:reduce_scatter_intra_do_this selected algorithm %d topo faninout %d segsize %d",
                  algorithm, faninout, segsize));
 
+    OPAL_TRACE("coll_tuned_reduce_scatter_begin", -1, algorithm, comm->c_contextid);
+
     switch (algorithm) {
-    case (0): return ompi_coll_tuned_reduce_scatter_intra_dec_fixed(sbuf, rbuf, rcounts,
-                                                                    dtype, op, comm, module);
-    case (1): return ompi_coll_base_reduce_scatter_intra_nonoverlapping(sbuf, rbuf, rcounts,
-                                                                        dtype, op, comm, module);
-    case (2): return ompi_coll_base_reduce_scatter_intra_basic_recursivehalving(sbuf, rbuf, rcounts,
-                                                                                dtype, op, comm, module);
-    case (3): return ompi_coll_base_reduce_scatter_intra_ring(sbuf, rbuf, rcounts,
-                                                              dtype, op, comm, module);
-    case (4): return ompi_coll_base_reduce_scatter_intra_butterfly(sbuf, rbuf, rcounts,
-                                                                   dtype, op, comm, module);
+    case (0): rc = ompi_coll_tuned_reduce_scatter_intra_dec_fixed(sbuf, rbuf, rcounts,
+                                                                  dtype, op, comm, module);
+        break;
+    case (1): rc = ompi_coll_base_reduce_scatter_intra_nonoverlapping(sbuf, rbuf, rcounts,
+                                                                      dtype, op, comm, module);
+        break;
+    case (2): rc = ompi_coll_base_reduce_scatter_intra_basic_recursivehalving(sbuf, rbuf, rcounts,
+                                                                              dtype, op, comm, module);
+        break;
+    case (3): rc = ompi_coll_base_reduce_scatter_intra_ring(sbuf, rbuf, rcounts,
+                                                            dtype, op, comm, module);
+        break;
+    case (4): rc = ompi_coll_base_reduce_scatter_intra_butterfly(sbuf, rbuf, rcounts,
+                                                                 dtype, op, comm, module);
+        break;
+    default:
+        OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:reduce_scatter_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
+                     algorithm, ompi_coll_tuned_forced_max_algorithms[REDUCESCATTER]));
+        rc = MPI_ERR_ARG;
+        break;
     } /* switch */
-    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:reduce_scatter_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
-                 algorithm, ompi_coll_tuned_forced_max_algorithms[REDUCESCATTER]));
-    return (MPI_ERR_ARG);
+    OPAL_TRACE("coll_tuned_reduce_scatter_end", -1, algorithm, rc);
+
+    return rc;
 }
@@ -92,17 +92,28 @@ int ompi_coll_tuned_scan_intra_do_this(const void *sbuf, void* rbuf, int count,
                                          mca_coll_base_module_t *module,
                                          int algorithm)
 {
+    int rc;
+
     OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:scan_intra_do_this selected algorithm %d",
                  algorithm));
 
+    OPAL_TRACE("coll_tuned_scan_begin", -1, algorithm, comm->c_contextid);
+
     switch (algorithm) {
     case (0):
-    case (1):  return ompi_coll_base_scan_intra_linear(sbuf, rbuf, count, dtype,
-                                                       op, comm, module);
-    case (2):  return ompi_coll_base_scan_intra_recursivedoubling(sbuf, rbuf, count, dtype,
-                                                                  op, comm, module);
+    case (1):  rc = ompi_coll_base_scan_intra_linear(sbuf, rbuf, count, dtype,
+                                                     op, comm, module);
+        break;
+    case (2):  rc = ompi_coll_base_scan_intra_recursivedoubling(sbuf, rbuf, count, dtype,
+                                                                op, comm, module);
+        break;
+    default:
+        OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:scan_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
+                     algorithm, ompi_coll_tuned_forced_max_algorithms[SCAN]));
+        rc = MPI_ERR_ARG;
+        break;
     } /* switch */
-    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:scan_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
-                 algorithm, ompi_coll_tuned_forced_max_algorithms[SCAN]));
-    return (MPI_ERR_ARG);
+    OPAL_TRACE("coll_tuned_scan_end", -1, algorithm, rc);
+
+    return rc;
 }
@@ -25,10 +25,11 @@
 #include "ompi/communicator/communicator.h"
 #include "opal/mca/base/mca_base_component_repository.h"
 #include "opal/class/opal_hash_table.h"
+#include "opal/mca/threads/mutex.h"
 #include "opal/util/output.h"
 #include "opal/util/printf.h"
 #include "opal/runtime/opal.h"
-#include <math.h>
+#include <stddef.h>
 
 #if SIZEOF_LONG_LONG == SIZEOF_SIZE_T
 #define MCA_MONITORING_VAR_TYPE MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG
@@ -64,27 +65,211 @@ static int mca_common_monitoring_output_enabled = 0;
 static char* mca_common_monitoring_initial_filename = "";
 static char* mca_common_monitoring_current_filename = NULL;
 
-/* array for stroring monitoring data*/
-static opal_atomic_size_t* pml_data = NULL;
-static opal_atomic_size_t* pml_count = NULL;
-static opal_atomic_size_t* filtered_pml_data = NULL;
-static opal_atomic_size_t* filtered_pml_count = NULL;
-static opal_atomic_size_t* osc_data_s = NULL;
-static opal_atomic_size_t* osc_count_s = NULL;
-static opal_atomic_size_t* osc_data_r = NULL;
-static opal_atomic_size_t* osc_count_r = NULL;
-static opal_atomic_size_t* coll_data = NULL;
-static opal_atomic_size_t* coll_count = NULL;
-
-static opal_atomic_size_t* size_histogram = NULL;
-static const int max_size_histogram = 66;
-static double log10_2 = 0.;
+/* Size of the data_size distribution: one bucket for empty messages,
+ * then one per power of two, the last one catching everything above */
+#define MCA_MONITORING_MAX_SIZE_HISTOGRAM 66
+static const int max_size_histogram = MCA_MONITORING_MAX_SIZE_HISTOGRAM;
+
+/* Traffic with one peer. Records are only created for the peers we
+ * actually talk to, so the memory used follows the number of peers and
+ * not the size of MPI_COMM_WORLD. */
+typedef struct mca_monitoring_peer_t {
+    int rank;  /* in MPI_COMM_WORLD */
+    opal_atomic_size_t pml_data;
+    opal_atomic_size_t pml_count;
+    opal_atomic_size_t filtered_pml_data;
+    opal_atomic_size_t filtered_pml_count;
+    opal_atomic_size_t osc_data_s;
+    opal_atomic_size_t osc_count_s;
+    opal_atomic_size_t osc_data_r;
+    opal_atomic_size_t osc_count_r;
+    opal_atomic_size_t coll_data;
+    opal_atomic_size_t coll_count;
+    opal_atomic_size_t size_histogram[MCA_MONITORING_MAX_SIZE_HISTOGRAM];
+} mca_monitoring_peer_t;
+
+/* Open addressing table of the peer records, indexed by world rank.
+ * Lookups do not lock: records never move, and a table that is
+ * replaced by a bigger one stays around (through previous) until
+ * finalize, so a reader still walking it finds valid records. Inserts
+ * and growth are serialized by peer_table_lock. */
+typedef struct mca_monitoring_peer_table_t {
+    struct mca_monitoring_peer_table_t *previous;
+    uint32_t mask;
+    uint32_t count;
+    mca_monitoring_peer_t * volatile slots[];
+} mca_monitoring_peer_table_t;
+
+static mca_monitoring_peer_table_t * volatile peer_table = NULL;
+static opal_mutex_t peer_table_lock;
+static const uint32_t initial_peer_table_size = 64;
 
 static int rank_world = -1;
 static int nprocs_world = 0;
 
 opal_hash_table_t *common_monitoring_translation_ht = NULL;
 
+static mca_monitoring_peer_table_t *mca_common_monitoring_peer_table_new(uint32_t size)
+{
+    mca_monitoring_peer_table_t *table;
+
+    table = (mca_monitoring_peer_table_t*)calloc(1, sizeof(*table) +
+                                                 size * sizeof(mca_monitoring_peer_t*));
+    if( NULL != table ) table->mask = size - 1;
+    return table;
+}
+
+static inline uint32_t mca_common_monitoring_peer_hash(int world_rank, uint32_t mask)
+{
+    /* Fibonacci hashing: spreads the ranks of a block over the table */
+    return ((uint32_t)world_rank * 2654435761U) & mask;
+}
+
+/* Find the record of a peer, NULL if we never talked to it */
+static inline mca_monitoring_peer_t *
+mca_common_monitoring_peer_find(mca_monitoring_peer_table_t *table, int world_rank)
+{
+    mca_monitoring_peer_t *peer;
+    uint32_t i;
+
+    for( i = mca_common_monitoring_peer_hash(world_rank, table->mask);
+         NULL != (peer = table->slots[i]); i = (i + 1) & table->mask ) {
+        if( peer->rank == world_rank ) return peer;
+    }
+    return NULL;
+}
+
+static mca_monitoring_peer_t *mca_common_monitoring_peer_insert(int world_rank)
+{
+    mca_monitoring_peer_table_t *table, *bigger;
+    mca_monitoring_peer_t *peer;
+    uint32_t i;
+
+    OPAL_THREAD_LOCK(&peer_table_lock);
+    table = peer_table;
+    /* somebody else might have been faster */
+    if( NULL != (peer = mca_common_monitoring_peer_find(table, world_rank)) ) goto out;
+
+    if( NULL == (peer = (mca_monitoring_peer_t*)calloc(1, sizeof(*peer))) ) goto out;
+    peer->rank = world_rank;
+
+    /* Keep the load under one half, so the probe sequences stay short */
+    if( 2 * (table->count + 1) > table->mask + 1 ) {
+        bigger = mca_common_monitoring_peer_table_new(2 * (table->mask + 1));
+        if( NULL == bigger ) {
+            free(peer);
+            peer = NULL;
+            goto out;
+        }
+        for( i = 0; i <= table->mask; i++ ) {
+            mca_monitoring_peer_t *p = table->slots[i];
+            uint32_t j;
+            if( NULL == p ) continue;
+            for( j = mca_common_monitoring_peer_hash(p->rank, bigger->mask);
+                 NULL != bigger->slots[j]; j = (j + 1) & bigger->mask );
+            bigger->slots[j] = p;
+        }
+        bigger->count = table->count;
+        bigger->previous = table;
+        opal_atomic_wmb();
+        peer_table = table = bigger;
+    }
+
+    for( i = mca_common_monitoring_peer_hash(world_rank, table->mask);
+         NULL != table->slots[i]; i = (i + 1) & table->mask );
+    opal_atomic_wmb();  /* the record is complete before it can be found */
+    table->slots[i] = peer;
+    table->count++;
+ out:
+    OPAL_THREAD_UNLOCK(&peer_table_lock);
+    if( OPAL_UNLIKELY(NULL == peer) ) {
+        OPAL_MONITORING_PRINT_ERR("Cannot allocate the monitoring record of peer %d", world_rank);
+    }
+    return peer;
+}
+
+/* Record of a peer, created the first time we talk to it */
+static inline mca_monitoring_peer_t *mca_common_monitoring_peer(int world_rank)
+{
+    mca_monitoring_peer_t *peer = mca_common_monitoring_peer_find(peer_table, world_rank);
+
+    if( OPAL_UNLIKELY(NULL == peer) ) {
+        peer = mca_common_monitoring_peer_insert(world_rank);
+    }
+    return peer;
+}
+
+static int mca_common_monitoring_peer_compare(const void *a, const void *b)
+{
+    const mca_monitoring_peer_t *pa = *(mca_monitoring_peer_t * const *)a;
+    const mca_monitoring_peer_t *pb = *(mca_monitoring_peer_t * const *)b;
+
+    return (pa->rank > pb->rank) - (pa->rank < pb->rank);
+}
+
+/* The records of all our peers, sorted by rank. The caller frees the array. */
+static mca_monitoring_peer_t **mca_common_monitoring_peers(uint32_t *npeers)
+{
+    mca_monitoring_peer_table_t *table;
+    mca_monitoring_peer_t **peers;
+    uint32_t i, n = 0;
+
+    *npeers = 0;
+    if( NULL == peer_table ) return NULL;
+    OPAL_THREAD_LOCK(&peer_table_lock);
+    table = peer_table;
+    peers = (mca_monitoring_peer_t**)malloc((table->count + 1) * sizeof(*peers));
+    if( NULL != peers ) {
+        for( i = 0; i <= table->mask; i++ ) {
+            if( NULL != table->slots[i] ) peers[n++] = table->slots[i];
+        }
+    }
+    OPAL_THREAD_UNLOCK(&peer_table_lock);
+    if( NULL == peers ) return NULL;
+
+    qsort(peers, n, sizeof(*peers), mca_common_monitoring_peer_compare);
+    *npeers = n;
+    return peers;
+}
+
+/* Expand one counter of the records into a vector indexed by world rank */
+static int mca_common_monitoring_get_values(void *obj_handle, size_t *values, size_t offset)
+{
+    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
+    mca_monitoring_peer_table_t *table = peer_table;
+    mca_monitoring_peer_t *peer;
+    uint32_t i;
+
+    if(comm != &ompi_mpi_comm_world.comm || NULL == table)
+        return OMPI_ERROR;
+
+    memset(values, 0, ompi_comm_size(comm) * sizeof(size_t));
+    for( i = 0; i <= table->mask; i++ ) {
+        if( NULL != (peer = table->slots[i]) ) {
+            values[peer->rank] = *(size_t*)((char*)peer + offset);
+        }
+    }
+
+    return OMPI_SUCCESS;
+}
+
+/* Bucket of a message size in the size histogram: 0 for empty messages,
+ * floor(log2(data_size)) + 1 otherwise */
+static inline int mca_common_monitoring_size_bucket(size_t data_size)
+{
+    int log2_size;
+
+    if( 0 == data_size ) return 0;
+#if OPAL_C_HAVE_BUILTIN_CLZ
+    log2_size = (8 * sizeof(unsigned long long) - 1) - __builtin_clzll((unsigned long long)data_size);
+#else
+    for( log2_size = 0; data_size >>= 1; log2_size++ );
+#endif
+    if(log2_size > max_size_histogram - 2) /* Avoid out-of-bound write */
+        log2_size = max_size_histogram - 2;
+    return log2_size + 1;
+}
+
 /* Reset all the monitoring arrays */
 static void mca_common_monitoring_reset ( void );
 
@@ -216,8 +401,7 @@ int mca_common_monitoring_init( void )
     if( 1 < opal_atomic_add_fetch_32(&mca_common_monitoring_hold, 1) ) return OMPI_SUCCESS; /* Already initialized */
 
     const char *hostname;
-    /* Initialize constant */
-    log10_2 = log10(2.);
+    OBJ_CONSTRUCT(&peer_table_lock, opal_mutex_t);
     /* Open the opal_output stream */
     hostname = opal_gethostname();
     opal_asprintf(&mca_common_monitoring_output_stream_obj.lds_prefix,
@@ -245,7 +429,18 @@ void mca_common_monitoring_finalize( void )
     opal_output_close(mca_common_monitoring_output_stream_id);
     free(mca_common_monitoring_output_stream_obj.lds_prefix);
     /* Free internal data structure */
-    free((void *) pml_data);  /* a single allocation */
+    if( NULL != peer_table ) {
+        mca_monitoring_peer_table_t *table = peer_table, *previous;
+        for( uint32_t i = 0; i <= table->mask; i++ ) {
+            free(table->slots[i]);
+        }
+        for( ; NULL != table; table = previous ) {
+            previous = table->previous;
+            free(table);
+        }
+        peer_table = NULL;
+    }
+    OBJ_DESTRUCT(&peer_table_lock);
     opal_hash_table_remove_all( common_monitoring_translation_ht );
     OBJ_RELEASE(common_monitoring_translation_ht);
     mca_common_monitoring_coll_finalize();
@@ -448,20 +643,9 @@ int mca_common_monitoring_add_procs(struct ompi_proc_t **procs,
     if( !nprocs_world )
         nprocs_world = ompi_comm_size((ompi_communicator_t*)&ompi_mpi_comm_world);
 
-    if( NULL == pml_data ) {
-        int array_size = (10 + max_size_histogram) * nprocs_world;
-        pml_data           = (opal_atomic_size_t*)calloc(array_size, sizeof(size_t));
-        pml_count          = pml_data + nprocs_world;
-        filtered_pml_data  = pml_count + nprocs_world;
-        filtered_pml_count = filtered_pml_data + nprocs_world;
-        osc_data_s         = filtered_pml_count + nprocs_world;
-        osc_count_s        = osc_data_s + nprocs_world;
-        osc_data_r         = osc_count_s + nprocs_world;
-        osc_count_r        = osc_data_r + nprocs_world;
-        coll_data          = osc_count_r + nprocs_world;
-        coll_count         = coll_data + nprocs_world;
-
-        size_histogram     = coll_count + nprocs_world;
+    if( NULL == peer_table ) {
+        peer_table = mca_common_monitoring_peer_table_new(initial_peer_table_size);
+        if( NULL == peer_table ) return OMPI_ERR_OUT_OF_RESOURCE;
     }
 
     /* For all procs in the same MPI_COMM_WORLD we need to add them to the hash table */
@@ -496,32 +680,38 @@ int mca_common_monitoring_add_procs(struct ompi_proc_t **procs,
 
 static void mca_common_monitoring_reset( void )
 {
-    int array_size = (10 + max_size_histogram) * nprocs_world;
-    memset((void *) pml_data, 0, array_size * sizeof(size_t));
+    mca_monitoring_peer_table_t *table = peer_table;
+    mca_monitoring_peer_t *peer;
+
+    /* The records are kept: the peers are likely to be talked to again */
+    if( NULL != table ) {
+        for( uint32_t i = 0; i <= table->mask; i++ ) {
+            if( NULL != (peer = table->slots[i]) ) {
+                memset((char*)peer + offsetof(mca_monitoring_peer_t, pml_data), 0,
+                       sizeof(*peer) - offsetof(mca_monitoring_peer_t, pml_data));
+            }
+        }
+    }
     mca_common_monitoring_coll_reset();
 }
 
 void mca_common_monitoring_record_pml(int world_rank, size_t data_size, int tag)
 {
+    mca_monitoring_peer_t *peer;
+
     if( 0 == mca_common_monitoring_current_state ) return;  /* right now the monitoring is not started */
+    if( OPAL_UNLIKELY(NULL == (peer = mca_common_monitoring_peer(world_rank))) ) return;
 
     /* Keep tracks of the data_size distribution */
-    if( 0 == data_size ) {
-        opal_atomic_add_fetch_size_t(&size_histogram[world_rank * max_size_histogram], 1);
-    } else {
-        int log2_size = log10(data_size)/log10_2;
-        if(log2_size > max_size_histogram - 2) /* Avoid out-of-bound write */
-            log2_size = max_size_histogram - 2;
-        opal_atomic_add_fetch_size_t(&size_histogram[world_rank * max_size_histogram + log2_size + 1], 1);
-    }
+    opal_atomic_add_fetch_size_t(&peer->size_histogram[mca_common_monitoring_size_bucket(data_size)], 1);
 
     /* distinguishses positive and negative tags if requested */
     if( (tag < 0) && (mca_common_monitoring_filter()) ) {
-        opal_atomic_add_fetch_size_t(&filtered_pml_data[world_rank], data_size);
-        opal_atomic_add_fetch_size_t(&filtered_pml_count[world_rank], 1);
+        opal_atomic_add_fetch_size_t(&peer->filtered_pml_data, data_size);
+        opal_atomic_add_fetch_size_t(&peer->filtered_pml_count, 1);
     } else { /* if filtered monitoring is not activated data is aggregated indifferently */
-        opal_atomic_add_fetch_size_t(&pml_data[world_rank], data_size);
-        opal_atomic_add_fetch_size_t(&pml_count[world_rank], 1);
+        opal_atomic_add_fetch_size_t(&peer->pml_data, data_size);
+        opal_atomic_add_fetch_size_t(&peer->pml_count, 1);
     }
 }
 
@@ -529,50 +719,32 @@ static int mca_common_monitoring_get_pml_count(const struct mca_base_pvar_t *pva
                                                void *value,
                                                void *obj_handle)
 {
-    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
-    int i, comm_size = ompi_comm_size (comm);
-    size_t *values = (size_t*) value;
-
-    if(comm != &ompi_mpi_comm_world.comm || NULL == pml_count)
-        return OMPI_ERROR;
-
-    for (i = 0 ; i < comm_size ; ++i) {
-        values[i] = pml_count[i];
-    }
-
-    return OMPI_SUCCESS;
+    return mca_common_monitoring_get_values(obj_handle, (size_t*) value,
+                                            offsetof(mca_monitoring_peer_t, pml_count));
 }
 
 static int mca_common_monitoring_get_pml_size(const struct mca_base_pvar_t *pvar,
                                               void *value,
                                               void *obj_handle)
 {
-    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
-    int comm_size = ompi_comm_size (comm);
-    size_t *values = (size_t*) value;
-    int i;
-
-    if(comm != &ompi_mpi_comm_world.comm || NULL == pml_data)
-        return OMPI_ERROR;
-
-    for (i = 0 ; i < comm_size ; ++i) {
-        values[i] = pml_data[i];
-    }
-
-    return OMPI_SUCCESS;
+    return mca_common_monitoring_get_values(obj_handle, (size_t*) value,
+                                            offsetof(mca_monitoring_peer_t, pml_data));
 }
 
 void mca_common_monitoring_record_osc(int world_rank, size_t data_size,
                                       enum mca_monitoring_osc_direction dir)
 {
+    mca_monitoring_peer_t *peer;
+
     if( 0 == mca_common_monitoring_current_state ) return;  /* right now the monitoring is not started */
+    if( OPAL_UNLIKELY(NULL == (peer = mca_common_monitoring_peer(world_rank))) ) return;
 
     if( SEND == dir ) {
-        opal_atomic_add_fetch_size_t(&osc_data_s[world_rank], data_size);
-        opal_atomic_add_fetch_size_t(&osc_count_s[world_rank], 1);
+        opal_atomic_add_fetch_size_t(&peer->osc_data_s, data_size);
+        opal_atomic_add_fetch_size_t(&peer->osc_count_s, 1);
     } else {
-        opal_atomic_add_fetch_size_t(&osc_data_r[world_rank], data_size);
-        opal_atomic_add_fetch_size_t(&osc_count_r[world_rank], 1);
+        opal_atomic_add_fetch_size_t(&peer->osc_data_r, data_size);
+        opal_atomic_add_fetch_size_t(&peer->osc_count_r, 1);
     }
 }
 
@@ -580,152 +752,103 @@ static int mca_common_monitoring_get_osc_sent_count(const struct mca_base_pvar_t
                                                     void *value,
                                                     void *obj_handle)
 {
-    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
-    int i, comm_size = ompi_comm_size (comm);
-    size_t *values = (size_t*) value;
-
-    if(comm != &ompi_mpi_comm_world.comm || NULL == pml_count)
-        return OMPI_ERROR;
-
-    for (i = 0 ; i < comm_size ; ++i) {
-        values[i] = osc_count_s[i];
-    }
-
-    return OMPI_SUCCESS;
+    return mca_common_monitoring_get_values(obj_handle, (size_t*) value,
+                                            offsetof(mca_monitoring_peer_t, osc_count_s));
 }
 
 static int mca_common_monitoring_get_osc_sent_size(const struct mca_base_pvar_t *pvar,
                                                    void *value,
                                                    void *obj_handle)
 {
-    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
-    int comm_size = ompi_comm_size (comm);
-    size_t *values = (size_t*) value;
-    int i;
-
-    if(comm != &ompi_mpi_comm_world.comm || NULL == pml_data)
-        return OMPI_ERROR;
-
-    for (i = 0 ; i < comm_size ; ++i) {
-        values[i] = osc_data_s[i];
-    }
-
-    return OMPI_SUCCESS;
+    return mca_common_monitoring_get_values(obj_handle, (size_t*) value,
+                                            offsetof(mca_monitoring_peer_t, osc_data_s));
 }
 
 static int mca_common_monitoring_get_osc_recv_count(const struct mca_base_pvar_t *pvar,
                                                     void *value,
                                                     void *obj_handle)
 {
-    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
-    int i, comm_size = ompi_comm_size (comm);
-    size_t *values = (size_t*) value;
-
-    if(comm != &ompi_mpi_comm_world.comm || NULL == pml_count)
-        return OMPI_ERROR;
-
-    for (i = 0 ; i < comm_size ; ++i) {
-        values[i] = osc_count_r[i];
-    }
-
-    return OMPI_SUCCESS;
+    return mca_common_monitoring_get_values(obj_handle, (size_t*) value,
+                                            offsetof(mca_monitoring_peer_t, osc_count_r));
 }
 
 static int mca_common_monitoring_get_osc_recv_size(const struct mca_base_pvar_t *pvar,
                                                    void *value,
                                                    void *obj_handle)
 {
-    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
-    int comm_size = ompi_comm_size (comm);
-    size_t *values = (size_t*) value;
-    int i;
-
-    if(comm != &ompi_mpi_comm_world.comm || NULL == pml_data)
-        return OMPI_ERROR;
-
-    for (i = 0 ; i < comm_size ; ++i) {
-        values[i] = osc_data_r[i];
-    }
-
-    return OMPI_SUCCESS;
+    return mca_common_monitoring_get_values(obj_handle, (size_t*) value,
+                                            offsetof(mca_monitoring_peer_t, osc_data_r));
 }
 
 void mca_common_monitoring_record_coll(int world_rank, size_t data_size)
 {
+    mca_monitoring_peer_t *peer;
+
     if( 0 == mca_common_monitoring_current_state ) return;  /* right now the monitoring is not started */
+    if( OPAL_UNLIKELY(NULL == (peer = mca_common_monitoring_peer(world_rank))) ) return;
 
-    opal_atomic_add_fetch_size_t(&coll_data[world_rank], data_size);
-    opal_atomic_add_fetch_size_t(&coll_count[world_rank], 1);
+    opal_atomic_add_fetch_size_t(&peer->coll_data, data_size);
+    opal_atomic_add_fetch_size_t(&peer->coll_count, 1);
 }
 
 static int mca_common_monitoring_get_coll_count(const struct mca_base_pvar_t *pvar,
                                                 void *value,
                                                 void *obj_handle)
 {
-    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
-    int i, comm_size = ompi_comm_size (comm);
-    size_t *values = (size_t*) value;
-
-    if(comm != &ompi_mpi_comm_world.comm || NULL == pml_count)
-        return OMPI_ERROR;
-
-    for (i = 0 ; i < comm_size ; ++i) {
-        values[i] = coll_count[i];
-    }
-
-    return OMPI_SUCCESS;
+    return mca_common_monitoring_get_values(obj_handle, (size_t*) value,
+                                            offsetof(mca_monitoring_peer_t, coll_count));
 }
 
 static int mca_common_monitoring_get_coll_size(const struct mca_base_pvar_t *pvar,
                                                void *value,
                                                void *obj_handle)
 {
-    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
-    int comm_size = ompi_comm_size (comm);
-    size_t *values = (size_t*) value;
-    int i;
-
-    if(comm != &ompi_mpi_comm_world.comm || NULL == pml_data)
-        return OMPI_ERROR;
-
-    for (i = 0 ; i < comm_size ; ++i) {
-        values[i] = coll_data[i];
-    }
+    return mca_common_monitoring_get_values(obj_handle, (size_t*) value,
+                                            offsetof(mca_monitoring_peer_t, coll_data));
+}
 
-    return OMPI_SUCCESS;
+static void mca_common_monitoring_output_histogram( FILE *pf, mca_monitoring_peer_t *peer )
+{
+    for(int j = 0 ; j < max_size_histogram ; ++j)
+        fprintf(pf, "%zu%s", peer->size_histogram[j],
+                j < max_size_histogram - 1 ? "," : "\n");
 }
 
-static void mca_common_monitoring_output( FILE *pf, int my_rank, int nbprocs )
+static void mca_common_monitoring_output( FILE *pf, int my_rank )
 {
+    mca_monitoring_peer_t **peers, *peer;
+    uint32_t i, npeers;
+
+    /* Only the peers we talked to, in rank order */
+    peers = mca_common_monitoring_peers(&npeers);
+
     /* Dump outgoing messages */
     fprintf(pf, "# POINT TO POINT\n");
-    for (int i = 0 ; i < nbprocs ; i++) {
-        if(pml_count[i] > 0) {
+    for (i = 0 ; i < npeers ; i++) {
+        peer = peers[i];
+        if(peer->pml_count > 0) {
             fprintf(pf, "E\t%" PRId32 "\t%" PRId32 "\t%zu bytes\t%zu msgs sent\t",
-                    my_rank, i, pml_data[i], pml_count[i]);
-            for(int j = 0 ; j < max_size_histogram ; ++j)
-                fprintf(pf, "%zu%s", size_histogram[i * max_size_histogram + j],
-                        j < max_size_histogram - 1 ? "," : "\n");
+                    my_rank, peer->rank, peer->pml_data, peer->pml_count);
+            mca_common_monitoring_output_histogram(pf, peer);
         }
     }
 
     /* Dump outgoing synchronization/collective messages */
     if( mca_common_monitoring_filter() ) {
-        for (int i = 0 ; i < nbprocs ; i++) {
-            if(filtered_pml_count[i] > 0) {
+        for (i = 0 ; i < npeers ; i++) {
+            peer = peers[i];
+            if(peer->filtered_pml_count > 0) {
                 fprintf(pf, "I\t%" PRId32 "\t%" PRId32 "\t%zu bytes\t%zu msgs sent%s",
-                        my_rank, i, filtered_pml_data[i], filtered_pml_count[i],
-                        0 == pml_count[i] ? "\t" : "\n");
+                        my_rank, peer->rank, peer->filtered_pml_data, peer->filtered_pml_count,
+                        0 == peer->pml_count ? "\t" : "\n");
                 /* 
                  * In the case there was no external messages
                  * exchanged between the two processes, the histogram
                  * has not yet been dumpped. Then we need to add it at
                  * the end of the internal category.
                  */
-                if(0 == pml_count[i]) {
-                    for(int j = 0 ; j < max_size_histogram ; ++j)
-                        fprintf(pf, "%zu%s", size_histogram[i * max_size_histogram + j],
-                                j < max_size_histogram - 1 ? "," : "\n");
+                if(0 == peer->pml_count) {
+                    mca_common_monitoring_output_histogram(pf, peer);
                 }
             }
         }
@@ -733,25 +856,28 @@ static void mca_common_monitoring_output( FILE *pf, int my_rank, int nbprocs )
 
     /* Dump incoming messages */
     fprintf(pf, "# OSC\n");
-    for (int i = 0 ; i < nbprocs ; i++) {
-        if(osc_count_s[i] > 0) {
+    for (i = 0 ; i < npeers ; i++) {
+        peer = peers[i];
+        if(peer->osc_count_s > 0) {
             fprintf(pf, "S\t%" PRId32 "\t%" PRId32 "\t%zu bytes\t%zu msgs sent\n",
-                    my_rank, i, osc_data_s[i], osc_count_s[i]);
+                    my_rank, peer->rank, peer->osc_data_s, peer->osc_count_s);
         }
-        if(osc_count_r[i] > 0) {
+        if(peer->osc_count_r > 0) {
             fprintf(pf, "R\t%" PRId32 "\t%" PRId32 "\t%zu bytes\t%zu msgs sent\n",
-                    my_rank, i, osc_data_r[i], osc_count_r[i]);
+                    my_rank, peer->rank, peer->osc_data_r, peer->osc_count_r);
         }
     }
 
     /* Dump collectives */
     fprintf(pf, "# COLLECTIVES\n");
-    for (int i = 0 ; i < nbprocs ; i++) {
-        if(coll_count[i] > 0) {
+    for (i = 0 ; i < npeers ; i++) {
+        peer = peers[i];
+        if(peer->coll_count > 0) {
             fprintf(pf, "C\t%" PRId32 "\t%" PRId32 "\t%zu bytes\t%zu msgs sent\n",
-                    my_rank, i, coll_data[i], coll_count[i]);
+                    my_rank, peer->rank, peer->coll_data, peer->coll_count);
         }
     }
+    free(peers);
     mca_common_monitoring_coll_flush_all(pf);
 }
 
@@ -767,10 +893,10 @@ static int mca_common_monitoring_flush(int fd, char* filename)
 
     if( 1 == fd ) {
         OPAL_MONITORING_PRINT_INFO("Proc %" PRId32 " flushing monitoring to stdout", rank_world);
-        mca_common_monitoring_output( stdout, rank_world, nprocs_world );
+        mca_common_monitoring_output( stdout, rank_world );
     } else if( 2 == fd ) {
         OPAL_MONITORING_PRINT_INFO("Proc %" PRId32 " flushing monitoring to stderr", rank_world);
-        mca_common_monitoring_output( stderr, rank_world, nprocs_world );
+        mca_common_monitoring_output( stderr, rank_world );
     } else {
         FILE *pf = NULL;
         char* tmpfn = NULL;
@@ -793,7 +919,7 @@ static int mca_common_monitoring_flush(int fd, char* filename)
         OPAL_MONITORING_PRINT_INFO("Proc %d flushing monitoring to: %s.%" PRId32 ".prof",
                                    rank_world, filename, rank_world);
 
-        mca_common_monitoring_output( pf, rank_world, nprocs_world );
+        mca_common_monitoring_output( pf, rank_world );
 
         fclose(pf);
     }
@@ -93,7 +93,13 @@ static monitoring_result osc_rsizes;
 static monitoring_result coll_counts;
 static monitoring_result coll_sizes;
 
+/* Column of this process in a matrix, see symmetrize */
+static size_t * column;
+
 static int  write_mat(char *, size_t *, unsigned int);
+static void symmetrize(size_t *, size_t *);
+static void aggregate(size_t *, size_t *, size_t *, size_t *);
+static void average(size_t *, size_t *, size_t *);
 static void init_monitoring_result(const char *, monitoring_result *);
 static void start_monitoring_result(monitoring_result *);
 static void stop_monitoring_result(monitoring_result *);
@@ -146,13 +152,12 @@ int MPI_Init(int* argc, char*** argv)
 int MPI_Finalize(void)
 {
     int result, MPIT_result;
-    size_t * exchange_count_matrix_1   = NULL;
-    size_t * exchange_size_matrix_1    = NULL;
-    size_t * exchange_count_matrix_2   = NULL;
-    size_t * exchange_size_matrix_2    = NULL;
-    size_t * exchange_all_size_matrix  = NULL;
-    size_t * exchange_all_count_matrix = NULL;
-    size_t * exchange_all_avg_matrix   = NULL;
+    size_t * msg_row       = NULL;
+    size_t * size_row      = NULL;
+    size_t * all_msg_row   = NULL;
+    size_t * all_size_row  = NULL;
+    size_t * avg_row       = NULL;
+    int i;
 
     stop_monitoring_result(&pml_counts);
     stop_monitoring_result(&pml_sizes);
@@ -172,108 +177,84 @@ int MPI_Finalize(void)
     get_monitoring_result(&coll_counts);
     get_monitoring_result(&coll_sizes);
 
-    if (0 == comm_world_rank) {
-        exchange_count_matrix_1   = (size_t *) calloc(comm_world_size * comm_world_size, sizeof(size_t));
-        exchange_size_matrix_1    = (size_t *) calloc(comm_world_size * comm_world_size, sizeof(size_t));
-        exchange_count_matrix_2   = (size_t *) calloc(comm_world_size * comm_world_size, sizeof(size_t));
-        exchange_size_matrix_2    = (size_t *) calloc(comm_world_size * comm_world_size, sizeof(size_t));
-        exchange_all_size_matrix  = (size_t *) calloc(comm_world_size * comm_world_size, sizeof(size_t));
-        exchange_all_count_matrix = (size_t *) calloc(comm_world_size * comm_world_size, sizeof(size_t));
-        exchange_all_avg_matrix   = (size_t *) calloc(comm_world_size * comm_world_size, sizeof(size_t));
+    /*
+     * Every process only handles its own row of the matrices: the
+     * symmetric entries come from an all-to-all and the rows are
+     * streamed to the first process as it writes the matrix files, so no
+     * process ever holds more than a few vectors of comm_world_size
+     * entries.
+     */
+    msg_row      = (size_t *) calloc(comm_world_size, sizeof(size_t));
+    size_row     = (size_t *) calloc(comm_world_size, sizeof(size_t));
+    all_msg_row  = (size_t *) calloc(comm_world_size, sizeof(size_t));
+    all_size_row = (size_t *) calloc(comm_world_size, sizeof(size_t));
+    avg_row      = (size_t *) calloc(comm_world_size, sizeof(size_t));
+    column       = (size_t *) malloc(comm_world_size * sizeof(size_t));
+    if (!msg_row || !size_row || !all_msg_row || !all_size_row || !avg_row || !column) {
+        fprintf(stderr, "ERROR : failed to allocate the rows of the monitoring matrices\n");
+        PMPI_Abort(MPI_COMM_WORLD, MPI_ERR_NO_MEM);
     }
 
-    /* Gather PML and COLL results */
-    PMPI_Gather(pml_counts.vector,  comm_world_size, MPI_UNSIGNED_LONG, exchange_count_matrix_1, comm_world_size, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
-    PMPI_Gather(pml_sizes.vector,   comm_world_size, MPI_UNSIGNED_LONG, exchange_size_matrix_1,  comm_world_size, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
-    PMPI_Gather(coll_counts.vector, comm_world_size, MPI_UNSIGNED_LONG, exchange_count_matrix_2, comm_world_size, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
-    PMPI_Gather(coll_sizes.vector,  comm_world_size, MPI_UNSIGNED_LONG, exchange_size_matrix_2,  comm_world_size, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
-
-    if (0 == comm_world_rank) {
-        int i, j;
-
-        for (i = 0; i < comm_world_size; ++i) {
-            for (j = i + 1; j < comm_world_size; ++j) {
-                /* Reduce PML results */
-                exchange_count_matrix_1[i * comm_world_size + j] = exchange_count_matrix_1[j * comm_world_size + i] = (exchange_count_matrix_1[i * comm_world_size + j] + exchange_count_matrix_1[j * comm_world_size + i]) / 2;
-                exchange_size_matrix_1[i * comm_world_size + j]  = exchange_size_matrix_1[j * comm_world_size + i]  = (exchange_size_matrix_1[i * comm_world_size + j]  + exchange_size_matrix_1[j * comm_world_size + i]) / 2;
-                if (exchange_count_matrix_1[i * comm_world_size + j] != 0)
-                    exchange_all_size_matrix[i * comm_world_size + j] = exchange_all_size_matrix[j * comm_world_size + i] = exchange_size_matrix_1[i * comm_world_size + j] / exchange_count_matrix_1[i * comm_world_size + j];
-
-                /* Reduce COLL results */
-                exchange_count_matrix_2[i * comm_world_size + j] = exchange_count_matrix_2[j * comm_world_size + i] = (exchange_count_matrix_2[i * comm_world_size + j] + exchange_count_matrix_2[j * comm_world_size + i]) / 2;
-                exchange_size_matrix_2[i * comm_world_size + j]  = exchange_size_matrix_2[j * comm_world_size + i]  = (exchange_size_matrix_2[i * comm_world_size + j]  + exchange_size_matrix_2[j * comm_world_size + i]) / 2;
-                if (exchange_count_matrix_2[i * comm_world_size + j] != 0)
-                    exchange_all_count_matrix[i * comm_world_size + j] = exchange_all_count_matrix[j * comm_world_size + i] = exchange_size_matrix_2[i * comm_world_size + j] / exchange_count_matrix_2[i * comm_world_size + j];
-            }
-        }
+    /* Reduce PML results */
+    symmetrize(pml_counts.vector, msg_row);
+    symmetrize(pml_sizes.vector, size_row);
+    average(size_row, msg_row, avg_row);
 
-        /* Write PML matrices */
-        write_mat("monitoring_pml_msg.mat",  exchange_count_matrix_1, comm_world_size);
-        write_mat("monitoring_pml_size.mat", exchange_size_matrix_1, comm_world_size);
-        write_mat("monitoring_pml_avg.mat",  exchange_all_size_matrix, comm_world_size);
-
-        /* Write COLL matrices */
-        write_mat("monitoring_coll_msg.mat",  exchange_count_matrix_2, comm_world_size);
-        write_mat("monitoring_coll_size.mat", exchange_size_matrix_2, comm_world_size);
-        write_mat("monitoring_coll_avg.mat",  exchange_all_count_matrix, comm_world_size);
-
-        /* Aggregate PML and COLL in ALL matrices */
-        for (i = 0; i < comm_world_size; ++i) {
-            for (j = i + 1; j < comm_world_size; ++j) {
-                exchange_all_size_matrix[i * comm_world_size + j]  = exchange_all_size_matrix[j * comm_world_size + i]  = exchange_size_matrix_1[i * comm_world_size + j]  + exchange_size_matrix_2[i * comm_world_size + j];
-                exchange_all_count_matrix[i * comm_world_size + j] = exchange_all_count_matrix[j * comm_world_size + i] = exchange_count_matrix_1[i * comm_world_size + j] + exchange_count_matrix_2[i * comm_world_size + j];
-            }
-        }
-    }
+    /* Write PML matrices */
+    write_mat("monitoring_pml_msg.mat",  msg_row, comm_world_size);
+    write_mat("monitoring_pml_size.mat", size_row, comm_world_size);
+    write_mat("monitoring_pml_avg.mat",  avg_row, comm_world_size);
 
-    /* Gather OSC results */
-    PMPI_Gather(osc_scounts.vector, comm_world_size, MPI_UNSIGNED_LONG, exchange_count_matrix_1, comm_world_size, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
-    PMPI_Gather(osc_ssizes.vector,  comm_world_size, MPI_UNSIGNED_LONG, exchange_size_matrix_1,  comm_world_size, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
-    PMPI_Gather(osc_rcounts.vector, comm_world_size, MPI_UNSIGNED_LONG, exchange_count_matrix_2, comm_world_size, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
-    PMPI_Gather(osc_rsizes.vector,  comm_world_size, MPI_UNSIGNED_LONG, exchange_size_matrix_2,  comm_world_size, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
-
-    if (0 == comm_world_rank) {
-        int i, j;
-
-        for (i = 0; i < comm_world_size; ++i) {
-            for (j = i + 1; j < comm_world_size; ++j) {
-                /* Reduce OSC results */
-                exchange_count_matrix_1[i * comm_world_size + j] = exchange_count_matrix_1[j * comm_world_size + i] = (exchange_count_matrix_1[i * comm_world_size + j] + exchange_count_matrix_1[j * comm_world_size + i] + exchange_count_matrix_2[i * comm_world_size + j] + exchange_count_matrix_2[j * comm_world_size + i]) / 2;
-                exchange_size_matrix_1[i * comm_world_size + j]  = exchange_size_matrix_1[j * comm_world_size + i]  = (exchange_size_matrix_1[i * comm_world_size + j]  + exchange_size_matrix_1[j * comm_world_size + i]  + exchange_size_matrix_2[i * comm_world_size + j]  + exchange_size_matrix_2[j * comm_world_size + i]) / 2;
-                if (exchange_count_matrix_1[i * comm_world_size + j] != 0)
-                    exchange_all_avg_matrix[i * comm_world_size + j] = exchange_all_avg_matrix[j * comm_world_size + i] = exchange_size_matrix_1[i * comm_world_size + j] / exchange_count_matrix_1[i * comm_world_size + j];
-            }
-        }
+    /* Aggregate PML in ALL matrices */
+    aggregate(msg_row, size_row, all_msg_row, all_size_row);
 
-        /* Write OSC matrices */
-        write_mat("monitoring_osc_msg.mat",  exchange_count_matrix_1, comm_world_size);
-        write_mat("monitoring_osc_size.mat", exchange_size_matrix_1, comm_world_size);
-        write_mat("monitoring_osc_avg.mat",  exchange_all_avg_matrix, comm_world_size);
-
-        /* Aggregate OSC in ALL matrices and compute AVG */
-        for (i = 0; i < comm_world_size; ++i) {
-            for (j = i + 1; j < comm_world_size; ++j) {
-                exchange_all_size_matrix[i * comm_world_size + j]  = exchange_all_size_matrix[j * comm_world_size + i]  += exchange_size_matrix_1[i * comm_world_size + j];
-                exchange_all_count_matrix[i * comm_world_size + j] = exchange_all_count_matrix[j * comm_world_size + i] += exchange_count_matrix_1[i * comm_world_size + j];
-                if (exchange_all_count_matrix[i * comm_world_size + j] != 0)
-                    exchange_all_avg_matrix[i * comm_world_size + j] = exchange_all_avg_matrix[j * comm_world_size + i] = exchange_all_size_matrix[i * comm_world_size + j] / exchange_all_count_matrix[i * comm_world_size + j];
-            }
-        }
+    /* Reduce COLL results */
+    symmetrize(coll_counts.vector, msg_row);
+    symmetrize(coll_sizes.vector, size_row);
+    average(size_row, msg_row, avg_row);
+
+    /* Write COLL matrices */
+    write_mat("monitoring_coll_msg.mat",  msg_row, comm_world_size);
+    write_mat("monitoring_coll_size.mat", size_row, comm_world_size);
+    write_mat("monitoring_coll_avg.mat",  avg_row, comm_world_size);
+
+    /* Aggregate COLL in ALL matrices */
+    aggregate(msg_row, size_row, all_msg_row, all_size_row);
 
-        /* Write ALL matrices */
-        write_mat("monitoring_all_msg.mat",  exchange_all_count_matrix, comm_world_size);
-        write_mat("monitoring_all_size.mat", exchange_all_size_matrix, comm_world_size);
-        write_mat("monitoring_all_avg.mat",  exchange_all_avg_matrix, comm_world_size);
-
-        /* Free matrices */
-        free(exchange_count_matrix_1);
-        free(exchange_size_matrix_1);
-        free(exchange_count_matrix_2);
-        free(exchange_size_matrix_2);
-        free(exchange_all_count_matrix);
-        free(exchange_all_size_matrix);
-        free(exchange_all_avg_matrix);
+    /* Reduce OSC results: sent and received data both count */
+    for (i = 0; i < comm_world_size; ++i) {
+        osc_scounts.vector[i] += osc_rcounts.vector[i];
+        osc_ssizes.vector[i]  += osc_rsizes.vector[i];
     }
+    symmetrize(osc_scounts.vector, msg_row);
+    symmetrize(osc_ssizes.vector, size_row);
+    /* the diagonal only holds what was sent */
+    msg_row[comm_world_rank]  -= osc_rcounts.vector[comm_world_rank];
+    size_row[comm_world_rank] -= osc_rsizes.vector[comm_world_rank];
+    average(size_row, msg_row, avg_row);
+
+    /* Write OSC matrices */
+    write_mat("monitoring_osc_msg.mat",  msg_row, comm_world_size);
+    write_mat("monitoring_osc_size.mat", size_row, comm_world_size);
+    write_mat("monitoring_osc_avg.mat",  avg_row, comm_world_size);
+
+    /* Aggregate OSC in ALL matrices and compute AVG */
+    aggregate(msg_row, size_row, all_msg_row, all_size_row);
+    average(all_size_row, all_msg_row, avg_row);
+
+    /* Write ALL matrices */
+    write_mat("monitoring_all_msg.mat",  all_msg_row, comm_world_size);
+    write_mat("monitoring_all_size.mat", all_size_row, comm_world_size);
+    write_mat("monitoring_all_avg.mat",  avg_row, comm_world_size);
+
+    /* Free rows */
+    free(msg_row);
+    free(size_row);
+    free(all_msg_row);
+    free(all_size_row);
+    free(avg_row);
+    free(column);
+    column = NULL;
 
     destroy_monitoring_result(&pml_counts);
     destroy_monitoring_result(&pml_sizes);
@@ -299,6 +280,42 @@ int MPI_Finalize(void)
     return result;
 }
 
+/* Row of this process in (m + m^T) / 2, where m is the matrix whose
+ * row is given. The diagonal is left as is. */
+void symmetrize(size_t * row, size_t * result)
+{
+    int i;
+
+    /* column[i] is what process i recorded for us */
+    PMPI_Alltoall(row, 1, MPI_UNSIGNED_LONG, column, 1, MPI_UNSIGNED_LONG, MPI_COMM_WORLD);
+    for (i = 0; i < comm_world_size; ++i) {
+        result[i] = (i == comm_world_rank) ? row[i] : (row[i] + column[i]) / 2;
+    }
+}
+
+/* Add a row to the row of the ALL matrices, but the diagonal */
+void aggregate(size_t * msgs, size_t * sizes, size_t * all_msgs, size_t * all_sizes)
+{
+    int i;
+
+    for (i = 0; i < comm_world_size; ++i) {
+        if (i != comm_world_rank) {
+            all_msgs[i]  += msgs[i];
+            all_sizes[i] += sizes[i];
+        }
+    }
+}
+
+/* Average size of the messages exchanged with each peer */
+void average(size_t * sizes, size_t * counts, size_t * result)
+{
+    int i;
+
+    for (i = 0; i < comm_world_size; ++i) {
+        result[i] = (i != comm_world_rank && counts[i] != 0) ? sizes[i] / counts[i] : 0;
+    }
+}
+
 void init_monitoring_result(const char * pvar_name, monitoring_result * res)
 {
     int count;
@@ -313,7 +330,7 @@ void init_monitoring_result(const char * pvar_name, monitoring_result * res)
         PMPI_Abort(MPI_COMM_WORLD, MPIT_result);
     }
 
-    MPIT_result = MPI_T_pvar_handle_alloc(session, res->pvar_idx, comm_world, &(res->pvar_handle), &count);
+    MPIT_result = MPI_T_pvar_handle_alloc(session, res->pvar_idx, &comm_world, &(res->pvar_handle), &count);
     if (MPIT_result != MPI_SUCCESS) {
         fprintf(stderr, "ERROR : failed to allocate handle on \"%s\" pvar, check that you have monitoring pml\n", pvar_name);
         PMPI_Abort(MPI_COMM_WORLD, MPIT_result);
@@ -374,27 +391,55 @@ void destroy_monitoring_result(monitoring_result * res)
     free(res->vector);
 }
 
-int write_mat(char * filename, size_t * mat, unsigned int dim)
+/*
+ * Collective: the first process writes the file, pulling the rows from
+ * the others one at a time, so it never holds more than two of them.
+ */
+int write_mat(char * filename, size_t * row, unsigned int dim)
 {
-    FILE *matrix_file;
-    int i, j;
+    FILE *matrix_file = NULL;
+    size_t *peer_row;
+    int i, j, failed = 0;
+
+    if (0 != comm_world_rank) {
+        /* wait to be asked, so the rows do not pile up at the first process */
+        PMPI_Recv(&failed, 1, MPI_INT, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        if (!failed) {
+            PMPI_Send(row, comm_world_size, MPI_UNSIGNED_LONG, 0, 0, MPI_COMM_WORLD);
+        }
+        return failed ? -1 : 0;
+    }
 
     matrix_file = fopen(filename, "w");
-    if (!matrix_file) {
+    peer_row = (size_t *) malloc(comm_world_size * sizeof(size_t));
+    if (!matrix_file || !peer_row) {
         fprintf(stderr, "ERROR : failed to open \"%s\" file in write mode, check your permissions\n", filename);
-        return -1;
+        failed = 1;
+    } else {
+        printf("writing %ux%u matrix to %s\n", dim, dim, filename);
     }
 
-    printf("writing %ux%u matrix to %s\n", dim, dim, filename);
-
     for (i = 0; i < comm_world_size; ++i) {
+        if (0 != i) {
+            PMPI_Send(&failed, 1, MPI_INT, i, 0, MPI_COMM_WORLD);
+        }
+        if (failed) {
+            continue;
+        }
+        if (0 != i) {
+            PMPI_Recv(peer_row, comm_world_size, MPI_UNSIGNED_LONG, i, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        }
         for (j = 0; j < comm_world_size; ++j) {
-            fprintf(matrix_file, "%zu ", mat[i * comm_world_size + j]);
+            fprintf(matrix_file, "%zu ", (0 == i) ? row[j] : peer_row[j]);
         }
         fprintf(matrix_file, "\n");
     }
-    fflush(matrix_file);
-    fclose(matrix_file);
 
-    return 0;
+    free(peer_row);
+    if (matrix_file) {
+        fflush(matrix_file);
+        fclose(matrix_file);
+    }
+
+    return failed ? -1 : 0;
 }
@@ -68,6 +68,7 @@
 #define OMPIO_LOCK_NOT_THIS_OP       0x00000200
 #define OMPIO_DATAREP_NATIVE         0x00000400
 #define OMPIO_COLLECTIVE_OP          0x00000800
+#define OMPIO_FILE_NODE_LOCAL        0x00001000
 
 #define OMPIO_ROOT                    0
 
@@ -83,6 +84,7 @@
 #define SIMPLE                          5
 #define NO_REFINEMENT                   6
 #define SIMPLE_PLUS                     7
+#define TOPOLOGY_AWARE                  8
 
 #define OMPIO_LOCK_ENTIRE_REGION  10
 #define OMPIO_LOCK_SELECTIVE      11
@@ -142,6 +144,8 @@ typedef int (*mca_common_ompio_get_mca_parameter_value_fn_t) ( char *mca_paramet
 
 
 struct mca_common_ompio_print_queue;
+struct mca_common_ompio_wbcache_t;
+typedef struct mca_common_ompio_wbcache_t mca_common_ompio_wbcache_t;
 
 /**
  * Back-end structure for MPI_File
@@ -164,6 +168,7 @@ struct ompio_file_t {
     opal_info_t           *f_info;
     int32_t                f_flags;
     void                  *f_fs_ptr;
+    void                  *f_fbtl_ptr;
     int                    f_fs_block_size;
     int                    f_atomicity;
     size_t                 f_stripe_size;
@@ -198,6 +203,9 @@ struct ompio_file_t {
     mca_common_ompio_io_array_t *f_io_array;
     int                      f_num_of_io_entries;
 
+    /* write-behind cache for small independent writes, NULL if disabled */
+    mca_common_ompio_wbcache_t *f_wbcache;
+
     /* Hooks for modules to hang things */
     mca_base_component_t *f_fs_component;
     mca_base_component_t *f_fcoll_component;
@@ -278,6 +286,12 @@ OMPI_DECLSPEC int mca_common_ompio_build_io_array ( ompio_file_t *fh, int index,
                                                     int *num_io_entries );
 
 
+int mca_common_ompio_wbcache_init (ompio_file_t *fh);
+void mca_common_ompio_wbcache_fini (ompio_file_t *fh);
+OMPI_DECLSPEC int mca_common_ompio_wbcache_flush (ompio_file_t *fh);
+ssize_t mca_common_ompio_wbcache_pwritev (ompio_file_t *fh);
+ssize_t mca_common_ompio_wbcache_preadv (ompio_file_t *fh);
+
 OMPI_DECLSPEC int mca_common_ompio_file_read (ompio_file_t *fh,  void *buf,  int count,
                                               struct ompi_datatype_t *datatype, ompi_status_public_t *status);
 
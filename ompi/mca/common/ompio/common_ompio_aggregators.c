@@ -51,6 +51,8 @@
 ** 2. fview_based_grouping: analysis the fileview to detect regular patterns
 ** 3. cart_based_grouping: uses a cartesian communicator to derive certain (probable) properties
 **    of the access pattern
+** 4. topology_aware_grouping: spreads the aggregators evenly across the nodes and matches
+**    their number to the striping of the file
 */
 
 static double cost_calc (int P, int P_agg, size_t Data_proc, size_t coll_buffer, int dim );
@@ -225,6 +227,146 @@ int  mca_common_ompio_forced_grouping ( ompio_file_t *fh,
     return OMPI_SUCCESS;
 }
 
+int mca_common_ompio_topology_aware_grouping(ompio_file_t *fh,
+                                             int *num_groups_out,
+                                             mca_common_ompio_contg *contg_groups)
+{
+    int ret = OMPI_SUCCESS;
+    int num_groups = 1;
+    int max_on_node = 0;
+    int i, k, n, r, p;
+    int *node_of = NULL;          /* lowest rank on the node of each process */
+    int *node_count = NULL;       /* no. of processes on each node */
+    int *node_start = NULL;       /* offset of each node in node_procs */
+    int *node_procs = NULL;       /* processes sorted by node, in rank order */
+    int *node_aggrs = NULL;       /* no. of aggregators placed on each node */
+    int *node_next = NULL;
+    int *group_of = NULL;
+    int my_node = fh->f_rank;
+    ompi_proc_t *proc;
+
+    /* Determine the no. of aggregators. For a striped file (e.g. Lustre), use
+    ** one aggregator per stripe, i.e. per OST. If there are fewer processes
+    ** than stripes, use the largest divisor of the stripe count, such that
+    ** every OST is still accessed by a single aggregator. For other file
+    ** systems fall back to the cost model of the simple grouping.
+    */
+    if ( fh->f_stripe_count > 1 && fh->f_stripe_size > 0 ) {
+        num_groups = fh->f_stripe_count;
+        if ( num_groups > fh->f_size ) {
+            for ( num_groups = fh->f_size; fh->f_stripe_count % num_groups; num_groups-- );
+        }
+    }
+    else {
+        ret = mca_common_ompio_simple_grouping (fh, &num_groups, contg_groups);
+        if ( OMPI_SUCCESS != ret ) {
+            return ret;
+        }
+    }
+
+    /* Identify every node by the lowest rank running on it. */
+    for ( i = 0; i < fh->f_rank; i++ ) {
+        proc = ompi_group_peer_lookup (fh->f_comm->c_local_group, i);
+        if ( OPAL_PROC_ON_LOCAL_NODE(proc->super.proc_flags) ) {
+            my_node = i;
+            break;
+        }
+    }
+
+    node_of    = (int *) malloc ( 5 * fh->f_size * sizeof(int));
+    group_of   = (int *) malloc ( fh->f_size * sizeof(int));
+    if ( NULL == node_of || NULL == group_of ) {
+        opal_output (1, "OUT OF MEMORY\n");
+        ret = OMPI_ERR_OUT_OF_RESOURCE;
+        goto exit;
+    }
+    node_count      = node_of + fh->f_size;
+    node_start      = node_count + fh->f_size;
+    node_procs      = node_start + fh->f_size;
+    node_aggrs      = node_procs + fh->f_size;
+
+    ret = fh->f_comm->c_coll->coll_allgather (&my_node, 1, MPI_INT,
+                                              node_of, 1, MPI_INT,
+                                              fh->f_comm,
+                                              fh->f_comm->c_coll->coll_allgather_module);
+    if ( OMPI_SUCCESS != ret ) {
+        goto exit;
+    }
+
+    /* Sort the processes by node, nodes are numbered by their lowest rank,
+    ** which is the first process seen on them.
+    */
+    memset ( node_count, 0, fh->f_size * sizeof(int));
+    for ( i = 0; i < fh->f_size; i++ ) {
+        node_count[node_of[i]]++;
+    }
+    for ( k = 0, i = 0; i < fh->f_size; i++ ) {
+        node_start[i] = k;
+        k += node_count[i];
+        if ( node_count[i] > max_on_node ) {
+            max_on_node = node_count[i];
+        }
+    }
+    node_next = node_aggrs;
+    memcpy ( node_next, node_start, fh->f_size * sizeof(int));
+    for ( i = 0; i < fh->f_size; i++ ) {
+        node_procs[node_next[node_of[i]]++] = i;
+    }
+
+    /* Place the aggregators round-robin across the nodes: the first process of
+    ** every node, then the second process of every node etc.
+    */
+    memset ( node_aggrs, 0, fh->f_size * sizeof(int));
+    for ( i = 0; i < fh->f_size; i++ ) {
+        group_of[i] = -1;
+    }
+    for ( k = 0, r = 0; r < max_on_node && k < num_groups; r++ ) {
+        for ( n = 0; n < fh->f_size && k < num_groups; n++ ) {
+            if ( node_of[n] != n || r >= node_count[n] ) {
+                continue;
+            }
+            p = node_procs[node_start[n] + r];
+            node_aggrs[n]++;
+            group_of[p] = k;
+            contg_groups[k].procs_in_contg_group[0] = p;
+            contg_groups[k].procs_per_contg_group   = 1;
+            k++;
+        }
+    }
+
+    /* The remaining processes join an aggregator on their own node. Processes
+    ** on nodes without an aggregator are distributed over all groups.
+    */
+    for ( k = 0, n = 0; n < fh->f_size; n++ ) {
+        if ( node_of[n] != n ) {
+            continue;
+        }
+        for ( i = node_aggrs[n]; i < node_count[n]; i++ ) {
+            p = node_procs[node_start[n] + i];
+            if ( node_aggrs[n] > 0 ) {
+                group_of[p] = group_of[node_procs[node_start[n] + (i % node_aggrs[n])]];
+            }
+            else {
+                group_of[p] = k;
+                k = (k + 1) % num_groups;
+            }
+            r = group_of[p];
+            contg_groups[r].procs_in_contg_group[contg_groups[r].procs_per_contg_group++] = p;
+        }
+    }
+
+    *num_groups_out = num_groups;
+
+exit:
+    if ( NULL != node_of ) {
+        free ( node_of );
+    }
+    if ( NULL != group_of ) {
+        free ( group_of );
+    }
+    return ret;
+}
+
 int mca_common_ompio_fview_based_grouping(ompio_file_t *fh,
                      		          int *num_groups,
 				          mca_common_ompio_contg *contg_groups)
@@ -512,9 +654,10 @@ int mca_common_ompio_set_aggregator_props (struct ompio_file_t *fh,
     fh->f_flags |= OMPIO_AGGREGATOR_IS_SET;
 
     if ( (-1 == num_aggregators) && 
-         ((SIMPLE        != OMPIO_MCA_GET(fh, grouping_option) &&
-           NO_REFINEMENT != OMPIO_MCA_GET(fh, grouping_option) &&
-           SIMPLE_PLUS   != OMPIO_MCA_GET(fh, grouping_option) ))) {
+         ((SIMPLE         != OMPIO_MCA_GET(fh, grouping_option) &&
+           NO_REFINEMENT  != OMPIO_MCA_GET(fh, grouping_option) &&
+           SIMPLE_PLUS    != OMPIO_MCA_GET(fh, grouping_option) &&
+           TOPOLOGY_AWARE != OMPIO_MCA_GET(fh, grouping_option) ))) {
         ret = mca_common_ompio_create_groups(fh,bytes_per_proc);
     }
     else {
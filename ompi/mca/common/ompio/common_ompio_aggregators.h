@@ -65,6 +65,9 @@ int mca_common_ompio_fview_based_grouping(ompio_file_t *fh, int *num_groups,
 int mca_common_ompio_simple_grouping(ompio_file_t *fh, int *num_groups,
                                      mca_common_ompio_contg *contg_groups);
 
+int mca_common_ompio_topology_aware_grouping(ompio_file_t *fh, int *num_groups,
+                                             mca_common_ompio_contg *contg_groups);
+
 int mca_common_ompio_finalize_initial_grouping(ompio_file_t *fh,  int num_groups,
                                                mca_common_ompio_contg *contg_groups);
 
@@ -165,6 +165,11 @@ int mca_common_ompio_file_open (ompi_communicator_t *comm,
         goto fn_fail;
     }
 
+    ret = mca_common_ompio_wbcache_init (ompio_fh);
+    if ( OMPI_SUCCESS != ret ) {
+        goto fn_fail;
+    }
+
     if ( true == use_sharedfp ) {
 	/* open the file once more for the shared file pointer if required.           
         ** Can be disabled by the user if no shared file pointer operations
@@ -234,6 +239,11 @@ int mca_common_ompio_file_close (ompio_file_t *ompio_fh)
     int ret = OMPI_SUCCESS;
     int delete_flag = 0;
     char name[256];
+    int wb_ret;
+
+    /* write out what is left in the write-behind cache */
+    wb_ret = mca_common_ompio_wbcache_flush (ompio_fh);
+    mca_common_ompio_wbcache_fini (ompio_fh);
 
     ret = ompio_fh->f_comm->c_coll->coll_barrier ( ompio_fh->f_comm, ompio_fh->f_comm->c_coll->coll_barrier_module);
     if ( OMPI_SUCCESS != ret ) {
@@ -372,6 +382,9 @@ int mca_common_ompio_file_close (ompio_file_t *ompio_fh)
         ompi_comm_free (&ompio_fh->f_comm);
     }
 
+    if ( OMPI_SUCCESS == ret ) {
+        ret = wb_ret;
+    }
     return ret;
 }
 
@@ -380,6 +393,10 @@ int mca_common_ompio_file_get_size (ompio_file_t *ompio_fh,
 {
     int ret = OMPI_SUCCESS;
 
+    ret = mca_common_ompio_wbcache_flush (ompio_fh);
+    if ( OMPI_SUCCESS != ret ) {
+        return ret;
+    }
     ret = ompio_fh->f_fs->fs_file_get_size (ompio_fh, size);
 
     return ret;
@@ -422,6 +439,8 @@ int mca_common_ompio_set_file_defaults (ompio_file_t *fh)
        int i, flag;
        
        fh->f_io_array = NULL;
+       fh->f_wbcache = NULL;
+       fh->f_fbtl_ptr = NULL;
        fh->f_perm = OMPIO_PERM_NULL;
        fh->f_flags = 0;
        
@@ -168,7 +168,7 @@ int mca_common_ompio_file_read (ompio_file_t *fh,
                                           &fh->f_num_of_io_entries);
 
         if (fh->f_num_of_io_entries) {
-            ret_code = fh->f_fbtl->fbtl_preadv (fh);
+            ret_code = mca_common_ompio_wbcache_preadv (fh);
             if ( 0<= ret_code ) {
                 real_bytes_read+=(size_t)ret_code;
             }
@@ -245,6 +245,11 @@ int mca_common_ompio_file_iread (ompio_file_t *fh,
       return ret;
     }
 
+    ret = mca_common_ompio_wbcache_flush (fh);
+    if ( OMPI_SUCCESS != ret ) {
+        return ret;
+    }
+
     mca_common_ompio_request_alloc ( &ompio_req, MCA_OMPIO_REQUEST_READ);
 
     if ( 0 == count ) {
@@ -411,6 +416,10 @@ int mca_common_ompio_file_read_all (ompio_file_t *fh,
 {
     int ret = OMPI_SUCCESS;
 
+    ret = mca_common_ompio_wbcache_flush (fh);
+    if ( OMPI_SUCCESS != ret ) {
+        return ret;
+    }
 
     if ( !( fh->f_flags & OMPIO_DATAREP_NATIVE ) &&
          !(datatype == &ompi_mpi_byte.dt  ||
@@ -489,6 +498,11 @@ int mca_common_ompio_file_iread_all (ompio_file_t *fp,
 {
     int ret = OMPI_SUCCESS;
 
+    ret = mca_common_ompio_wbcache_flush (fp);
+    if ( OMPI_SUCCESS != ret ) {
+        return ret;
+    }
+
     if ( NULL != fp->f_fcoll->fcoll_file_iread_all ) {
 	ret = fp->f_fcoll->fcoll_file_iread_all (fp,
 						 buf,
@@ -251,6 +251,15 @@ int mca_common_ompio_set_view (ompio_file_t *fh,
         }
         mca_common_ompio_forced_grouping ( fh, num_groups, contg_groups);
     }
+    else if ( TOPOLOGY_AWARE == OMPIO_MCA_GET(fh, grouping_option) ) {
+        ret = mca_common_ompio_topology_aware_grouping(fh,
+                                                       &num_groups,
+                                                       contg_groups);
+        if ( OMPI_SUCCESS != ret ) {
+            opal_output(1, "mca_common_ompio_set_view: mca_common_ompio_topology_aware_grouping failed\n");
+            goto exit;
+        }
+    }
     else {
         if ( SIMPLE != OMPIO_MCA_GET(fh, grouping_option) && 
              SIMPLE_PLUS != OMPIO_MCA_GET(fh, grouping_option) ) {
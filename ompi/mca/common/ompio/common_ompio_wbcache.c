@@ -0,0 +1,218 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "ompi/mca/fbtl/fbtl.h"
+#include "ompi/mca/fbtl/base/base.h"
+
+#include "common_ompio.h"
+#include <string.h>
+
+/*
+** Write-behind cache for small independent writes.
+**
+** The cache holds a single dirty extent of the file, [offset, offset+len).
+** Blocking independent writes that start inside or right at the end of
+** the extent are copied into the cache instead of being handed to the
+** fbtl. The extent is written out in one operation once the cache is
+** full, the data is read back, and before any operation that does not go
+** through the cache (non-blocking and collective operations, sync, close,
+** changing the size of the file).
+**
+** Errors of the deferred write are reported by the next operation
+** flushing the cache.
+*/
+
+struct mca_common_ompio_wbcache_t {
+    char                 *buf;
+    size_t                size;    /* capacity of buf */
+    OMPI_MPI_OFFSET_TYPE  offset;  /* file offset of buf[0] */
+    size_t                len;     /* no. of dirty bytes in buf */
+};
+
+int mca_common_ompio_wbcache_init (ompio_file_t *fh)
+{
+    mca_common_ompio_wbcache_t *wb;
+    int size = OMPIO_MCA_GET(fh, write_behind_size);
+
+    fh->f_wbcache = NULL;
+    if ( 0 >= size || (fh->f_amode & MPI_MODE_RDONLY) ) {
+        return OMPI_SUCCESS;
+    }
+
+    wb = (mca_common_ompio_wbcache_t *) malloc ( sizeof(mca_common_ompio_wbcache_t));
+    if ( NULL == wb ) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    wb->buf = (char *) malloc ( size );
+    if ( NULL == wb->buf ) {
+        free ( wb );
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    wb->size   = (size_t) size;
+    wb->offset = 0;
+    wb->len    = 0;
+
+    fh->f_wbcache = wb;
+    return OMPI_SUCCESS;
+}
+
+void mca_common_ompio_wbcache_fini (ompio_file_t *fh)
+{
+    if ( NULL != fh->f_wbcache ) {
+        free ( fh->f_wbcache->buf );
+        free ( fh->f_wbcache );
+        fh->f_wbcache = NULL;
+    }
+}
+
+/* Write the first nbytes of the dirty extent and keep the rest. */
+static int wbcache_write_out (ompio_file_t *fh, size_t nbytes)
+{
+    mca_common_ompio_wbcache_t *wb = fh->f_wbcache;
+    mca_common_ompio_io_array_t entry, *io_array;
+    int num_io_entries;
+    ssize_t ret_code;
+
+    if ( 0 == nbytes ) {
+        return OMPI_SUCCESS;
+    }
+
+    /* the caller might be in the middle of an operation */
+    io_array       = fh->f_io_array;
+    num_io_entries = fh->f_num_of_io_entries;
+
+    entry.memory_address = wb->buf;
+    entry.offset         = (void *)(intptr_t) wb->offset;
+    entry.length         = nbytes;
+    fh->f_io_array          = &entry;
+    fh->f_num_of_io_entries = 1;
+
+    ret_code = fh->f_fbtl->fbtl_pwritev (fh);
+
+    fh->f_io_array          = io_array;
+    fh->f_num_of_io_entries = num_io_entries;
+
+    if ( ret_code < (ssize_t) nbytes ) {
+        /* drop the data, it would fail again on the next flush */
+        wb->len = 0;
+        return OMPI_ERROR;
+    }
+
+    if ( nbytes < wb->len ) {
+        memmove ( wb->buf, wb->buf + nbytes, wb->len - nbytes );
+    }
+    wb->offset += nbytes;
+    wb->len    -= nbytes;
+
+    return OMPI_SUCCESS;
+}
+
+int mca_common_ompio_wbcache_flush (ompio_file_t *fh)
+{
+    if ( NULL == fh->f_wbcache ) {
+        return OMPI_SUCCESS;
+    }
+    return wbcache_write_out ( fh, fh->f_wbcache->len );
+}
+
+ssize_t mca_common_ompio_wbcache_pwritev (ompio_file_t *fh)
+{
+    mca_common_ompio_wbcache_t *wb = fh->f_wbcache;
+    OMPI_MPI_OFFSET_TYPE off, end, cut;
+    size_t len, total_bytes = 0;
+    int i, ret;
+
+    if ( NULL == wb ) {
+        return fh->f_fbtl->fbtl_pwritev (fh);
+    }
+
+    for ( i = 0; i < fh->f_num_of_io_entries; i++ ) {
+        total_bytes += fh->f_io_array[i].length;
+    }
+    if ( fh->f_atomicity || total_bytes > wb->size ) {
+        /* large writes gain nothing from the cache */
+        ret = mca_common_ompio_wbcache_flush (fh);
+        if ( OMPI_SUCCESS != ret ) {
+            return ret;
+        }
+        return fh->f_fbtl->fbtl_pwritev (fh);
+    }
+
+    for ( i = 0; i < fh->f_num_of_io_entries; i++ ) {
+        off = (OMPI_MPI_OFFSET_TYPE)(intptr_t) fh->f_io_array[i].offset;
+        len = fh->f_io_array[i].length;
+        end = off + (OMPI_MPI_OFFSET_TYPE) len;
+
+        if ( wb->len > 0 &&
+             ( off < wb->offset || off > wb->offset + (OMPI_MPI_OFFSET_TYPE) wb->len )) {
+            /* not adjacent to the dirty extent */
+            ret = mca_common_ompio_wbcache_flush (fh);
+            if ( OMPI_SUCCESS != ret ) {
+                return ret;
+            }
+        }
+        if ( 0 == wb->len ) {
+            wb->offset = off;
+        }
+
+        if ( end > wb->offset + (OMPI_MPI_OFFSET_TYPE) wb->size ) {
+            /* Cache is full. Write out everything up to the last file system
+            ** block boundary, so that the writes issued are aligned and the
+            ** partial block stays in the cache for the next writes.
+            */
+            cut = wb->offset + (OMPI_MPI_OFFSET_TYPE) wb->len;
+            if ( fh->f_fs_block_size > 0 ) {
+                cut = (cut / fh->f_fs_block_size) * fh->f_fs_block_size;
+            }
+            if ( cut <= wb->offset || cut > off ||
+                 end > cut + (OMPI_MPI_OFFSET_TYPE) wb->size ) {
+                cut = wb->offset + (OMPI_MPI_OFFSET_TYPE) wb->len;
+            }
+            ret = wbcache_write_out ( fh, (size_t) (cut - wb->offset) );
+            if ( OMPI_SUCCESS != ret ) {
+                return ret;
+            }
+            if ( 0 == wb->len ) {
+                wb->offset = off;
+            }
+        }
+
+        memcpy ( wb->buf + (off - wb->offset), fh->f_io_array[i].memory_address, len );
+        if ( end > wb->offset + (OMPI_MPI_OFFSET_TYPE) wb->len ) {
+            wb->len = (size_t) (end - wb->offset);
+        }
+    }
+
+    return (ssize_t) total_bytes;
+}
+
+ssize_t mca_common_ompio_wbcache_preadv (ompio_file_t *fh)
+{
+    mca_common_ompio_wbcache_t *wb = fh->f_wbcache;
+    OMPI_MPI_OFFSET_TYPE off;
+    int i, ret;
+
+    if ( NULL != wb && 0 < wb->len ) {
+        for ( i = 0; i < fh->f_num_of_io_entries; i++ ) {
+            off = (OMPI_MPI_OFFSET_TYPE)(intptr_t) fh->f_io_array[i].offset;
+            if ( off < wb->offset + (OMPI_MPI_OFFSET_TYPE) wb->len &&
+                 off + (OMPI_MPI_OFFSET_TYPE) fh->f_io_array[i].length > wb->offset ) {
+                ret = mca_common_ompio_wbcache_flush (fh);
+                if ( OMPI_SUCCESS != ret ) {
+                    return ret;
+                }
+                break;
+            }
+        }
+    }
+
+    return fh->f_fbtl->fbtl_preadv (fh);
+}
@@ -0,0 +1,25 @@
+# -*- shell-script -*-
+#
+# $COPYRIGHT$
+#
+# Additional copyrights may follow
+#
+# $HEADER$
+#
+
+# MCA_fbtl_iouring_CONFIG(action-if-can-compile,
+#                        [action-if-cant-compile])
+# ------------------------------------------------
+AC_DEFUN([MCA_ompi_fbtl_iouring_CONFIG],[
+    AC_CONFIG_FILES([ompi/mca/fbtl/iouring/Makefile])
+
+    fbtl_iouring_happy=no
+    AC_CHECK_HEADERS([linux/io_uring.h],
+                     [AC_CHECK_DECL([__NR_io_uring_setup],
+                                    [fbtl_iouring_happy=yes], [],
+                                    [#include <sys/syscall.h>])])
+
+    AS_IF([test "$fbtl_iouring_happy" = "yes"],
+          [$1],
+          [$2])
+])dnl
@@ -0,0 +1,568 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "mpi.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "opal/sys/atomic.h"
+#include "opal/mca/threads/mutex.h"
+#include "ompi/mca/fbtl/fbtl.h"
+#include "ompi/mca/fbtl/base/base.h"
+#include "ompi/mca/fbtl/iouring/fbtl_iouring.h"
+
+/*
+ * *******************************************************************
+ * ************************ actions structure ************************
+ * *******************************************************************
+ */
+static mca_fbtl_base_module_1_0_0_t iouring =  {
+    mca_fbtl_iouring_module_init,     /* initalise after being selected */
+    mca_fbtl_iouring_module_finalize, /* close a module on a communicator */
+    mca_fbtl_iouring_preadv,          /* blocking read */
+    mca_fbtl_iouring_ipreadv,         /* non-blocking read*/
+    mca_fbtl_iouring_pwritev,         /* blocking write */
+    mca_fbtl_iouring_ipwritev,        /* non-blocking write */
+    mca_fbtl_iouring_progress,        /* module specific progress */
+    mca_fbtl_iouring_request_free,    /* free module specific data items on the request */
+    mca_fbtl_base_check_atomicity     /* check whether atomicity is supported on this fs */
+};
+/*
+ * *******************************************************************
+ * ************************* structure ends **************************
+ * *******************************************************************
+ */
+
+/*
+ * A single ring is shared by all the files opened by this process, since
+ * each submission carries its own file descriptor. It is created by the
+ * first file query and torn down when the component is closed. The lock
+ * lives as long as the component is open: it protects the creation of the
+ * ring as well as its use.
+ */
+struct mca_fbtl_iouring_ring_t {
+    int                  fd;
+    unsigned             sq_entries;
+    unsigned             cq_entries;
+    unsigned             inflight;   /* submissions not completed yet */
+    unsigned             pending;    /* entries queued but not submitted yet */
+    volatile unsigned   *sq_head;
+    volatile unsigned   *sq_tail;
+    unsigned            *sq_mask;
+    unsigned            *sq_array;
+    struct io_uring_sqe *sqes;
+    volatile unsigned   *cq_head;
+    volatile unsigned   *cq_tail;
+    unsigned            *cq_mask;
+    struct io_uring_cqe *cqes;
+    void                *sq_ptr;
+    void                *cq_ptr;
+    size_t               sq_len;
+    size_t               cq_len;
+    size_t               sqes_len;
+};
+typedef struct mca_fbtl_iouring_ring_t mca_fbtl_iouring_ring_t;
+
+static mca_fbtl_iouring_ring_t mca_fbtl_iouring_ring = { .fd = -1 };
+static opal_mutex_t mca_fbtl_iouring_lock;
+static bool mca_fbtl_iouring_ring_failed = false;
+
+static int mca_fbtl_iouring_enter (unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+    return (int) syscall (__NR_io_uring_enter, mca_fbtl_iouring_ring.fd, to_submit,
+                          min_complete, flags, NULL, 0);
+}
+
+void mca_fbtl_iouring_ring_open (void)
+{
+    OBJ_CONSTRUCT(&mca_fbtl_iouring_lock, opal_mutex_t);
+}
+
+/* create the ring, the lock is held */
+static int mca_fbtl_iouring_ring_create (void)
+{
+    mca_fbtl_iouring_ring_t *ring = &mca_fbtl_iouring_ring;
+    struct io_uring_params p;
+
+    if ( -1 != ring->fd ) {
+        return OMPI_SUCCESS;
+    }
+    if ( mca_fbtl_iouring_ring_failed ) {
+        return OMPI_ERR_NOT_SUPPORTED;
+    }
+
+    memset (&p, 0, sizeof(p));
+    ring->fd = (int) syscall (__NR_io_uring_setup, mca_fbtl_iouring_entries, &p);
+    if ( 0 > ring->fd ) {
+        opal_output_verbose(10, ompi_fbtl_base_framework.framework_output,
+                            "fbtl:iouring: io_uring_setup failed: %s", strerror(errno));
+        ring->fd = -1;
+        mca_fbtl_iouring_ring_failed = true;
+        return OMPI_ERR_NOT_SUPPORTED;
+    }
+
+    ring->sq_entries = p.sq_entries;
+    ring->cq_entries = p.cq_entries;
+    ring->sq_len   = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    ring->cq_len   = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqes_len = p.sq_entries * sizeof(struct io_uring_sqe);
+    if ( p.features & IORING_FEAT_SINGLE_MMAP ) {
+        if ( ring->cq_len > ring->sq_len ) {
+            ring->sq_len = ring->cq_len;
+        }
+        ring->cq_len = ring->sq_len;
+    }
+
+    ring->sq_ptr = mmap (NULL, ring->sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         ring->fd, IORING_OFF_SQ_RING);
+    if ( MAP_FAILED == ring->sq_ptr ) {
+        goto error;
+    }
+    if ( p.features & IORING_FEAT_SINGLE_MMAP ) {
+        ring->cq_ptr = ring->sq_ptr;
+    }
+    else {
+        ring->cq_ptr = mmap (NULL, ring->cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             ring->fd, IORING_OFF_CQ_RING);
+        if ( MAP_FAILED == ring->cq_ptr ) {
+            munmap (ring->sq_ptr, ring->sq_len);
+            goto error;
+        }
+    }
+    ring->sqes = (struct io_uring_sqe *) mmap (NULL, ring->sqes_len, PROT_READ | PROT_WRITE,
+                                               MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if ( MAP_FAILED == ring->sqes ) {
+        if ( ring->cq_ptr != ring->sq_ptr ) {
+            munmap (ring->cq_ptr, ring->cq_len);
+        }
+        munmap (ring->sq_ptr, ring->sq_len);
+        goto error;
+    }
+
+    ring->sq_head  = (unsigned *) ((char *) ring->sq_ptr + p.sq_off.head);
+    ring->sq_tail  = (unsigned *) ((char *) ring->sq_ptr + p.sq_off.tail);
+    ring->sq_mask  = (unsigned *) ((char *) ring->sq_ptr + p.sq_off.ring_mask);
+    ring->sq_array = (unsigned *) ((char *) ring->sq_ptr + p.sq_off.array);
+    ring->cq_head  = (unsigned *) ((char *) ring->cq_ptr + p.cq_off.head);
+    ring->cq_tail  = (unsigned *) ((char *) ring->cq_ptr + p.cq_off.tail);
+    ring->cq_mask  = (unsigned *) ((char *) ring->cq_ptr + p.cq_off.ring_mask);
+    ring->cqes     = (struct io_uring_cqe *) ((char *) ring->cq_ptr + p.cq_off.cqes);
+    ring->inflight = 0;
+    ring->pending  = 0;
+
+    return OMPI_SUCCESS;
+
+ error:
+    opal_output_verbose(10, ompi_fbtl_base_framework.framework_output,
+                        "fbtl:iouring: could not map the rings: %s", strerror(errno));
+    close (ring->fd);
+    ring->fd = -1;
+    mca_fbtl_iouring_ring_failed = true;
+    return OMPI_ERR_NOT_SUPPORTED;
+}
+
+int mca_fbtl_iouring_ring_init (void)
+{
+    int ret;
+
+    /* files may be opened by several threads at once */
+    OPAL_THREAD_LOCK(&mca_fbtl_iouring_lock);
+    ret = mca_fbtl_iouring_ring_create ();
+    OPAL_THREAD_UNLOCK(&mca_fbtl_iouring_lock);
+
+    return ret;
+}
+
+void mca_fbtl_iouring_ring_fini (void)
+{
+    mca_fbtl_iouring_ring_t *ring = &mca_fbtl_iouring_ring;
+
+    if ( -1 == ring->fd ) {
+        OBJ_DESTRUCT(&mca_fbtl_iouring_lock);
+        return;
+    }
+    munmap (ring->sqes, ring->sqes_len);
+    if ( ring->cq_ptr != ring->sq_ptr ) {
+        munmap (ring->cq_ptr, ring->cq_len);
+    }
+    munmap (ring->sq_ptr, ring->sq_len);
+    close (ring->fd);
+    ring->fd = -1;
+    OBJ_DESTRUCT(&mca_fbtl_iouring_lock);
+}
+
+int mca_fbtl_iouring_component_init_query(bool enable_progress_threads,
+                                          bool enable_mpi_threads)
+{
+    /* Nothing to do */
+   return OMPI_SUCCESS;
+}
+
+struct mca_fbtl_base_module_1_0_0_t *
+mca_fbtl_iouring_component_file_query (ompio_file_t *fh, int *priority)
+{
+   *priority = mca_fbtl_iouring_priority;
+
+   /* io_uring may be disabled in the kernel or forbidden by a seccomp
+      filter, only offer the module if the ring can be created */
+   if ( OMPI_SUCCESS != mca_fbtl_iouring_ring_init () ) {
+       return NULL;
+   }
+
+   return &iouring;
+}
+
+int mca_fbtl_iouring_component_file_unquery (ompio_file_t *file)
+{
+   /* This function might be needed for some purposes later. for now it
+    * does not have anything to do since there are no steps which need
+    * to be undone if this module is not selected */
+
+   return OMPI_SUCCESS;
+}
+
+int mca_fbtl_iouring_module_init (ompio_file_t *file)
+{
+    return OMPI_SUCCESS;
+}
+
+
+int mca_fbtl_iouring_module_finalize (ompio_file_t *file)
+{
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Same policy as the posix fbtl: always lock for atomic mode, never lock
+ * if the file system or the fcoll component tells us so. Otherwise the
+ * whole range of the operation is locked.
+ */
+static int mca_fbtl_iouring_file_lock (mca_fbtl_iouring_request_data_t *data,
+                                       off_t start, off_t len)
+{
+    ompio_file_t *fh = data->aio_fh;
+    int ret;
+
+    if ( !fh->f_atomicity &&
+         (fh->f_flags & (OMPIO_LOCK_NEVER | OMPIO_LOCK_NOT_THIS_OP)) ) {
+        return OMPI_SUCCESS;
+    }
+
+    data->aio_lock.l_type   = (FBTL_IOURING_WRITE == data->aio_req_type) ? F_WRLCK : F_RDLCK;
+    data->aio_lock.l_whence = SEEK_SET;
+    data->aio_lock.l_start  = start;
+    data->aio_lock.l_len    = len;
+    data->aio_lock.l_pid    = 0;
+    if ( fh->f_flags & OMPIO_LOCK_ENTIRE_FILE ) {
+        data->aio_lock.l_start = 0;
+        data->aio_lock.l_len   = 0;
+    }
+
+    do {
+        ret = fcntl (fh->fd, F_SETLKW, &data->aio_lock);
+    } while ( ret && EINTR == errno );
+    if ( ret ) {
+        opal_output(1, "mca_fbtl_iouring: error in fcntl(F_SETLKW): %s", strerror(errno));
+        return OMPI_ERROR;
+    }
+    data->aio_locked = true;
+    return OMPI_SUCCESS;
+}
+
+mca_fbtl_iouring_request_data_t *mca_fbtl_iouring_request_create (ompio_file_t *fh, int io_op)
+{
+    mca_fbtl_iouring_request_data_t *data;
+    off_t start, end;
+    int i, req_index = 0;
+
+    if ( NULL == fh->f_io_array || 0 == fh->f_num_of_io_entries ) {
+        return NULL;
+    }
+
+    data = (mca_fbtl_iouring_request_data_t *) malloc (sizeof(mca_fbtl_iouring_request_data_t));
+    if ( NULL == data ) {
+        opal_output (1, "OUT OF MEMORY\n");
+        return NULL;
+    }
+    /* The io_array of the file handle may be released as soon as the
+       operation is started, so everything is copied. */
+    data->allocated_data = malloc (fh->f_num_of_io_entries *
+                                   (sizeof(struct iovec) +
+                                    sizeof(mca_fbtl_iouring_sub_t) +
+                                    sizeof(mca_fbtl_iouring_sub_t *)));
+    if ( NULL == data->allocated_data ) {
+        opal_output (1, "OUT OF MEMORY\n");
+        free (data);
+        return NULL;
+    }
+    data->aio_iovecs = (struct iovec *) data->allocated_data;
+    data->aio_reqs   = (mca_fbtl_iouring_sub_t *) (data->aio_iovecs + fh->f_num_of_io_entries);
+    data->aio_retry  = (mca_fbtl_iouring_sub_t **) (data->aio_reqs + fh->f_num_of_io_entries);
+
+    data->aio_req_type       = io_op;
+    data->aio_req_fail_count = 0;
+    data->aio_retry_count    = 0;
+    data->aio_next_req       = 0;
+    data->aio_total_len      = 0;
+    data->aio_locked         = false;
+    data->aio_fh             = fh;
+
+    start = (off_t)(intptr_t) fh->f_io_array[0].offset;
+    end   = start;
+    data->aio_reqs[0].iovcnt = 0;
+    for ( i = 0; i < fh->f_num_of_io_entries; i++ ) {
+        off_t offset = (off_t)(intptr_t) fh->f_io_array[i].offset;
+
+        data->aio_iovecs[i].iov_base = fh->f_io_array[i].memory_address;
+        data->aio_iovecs[i].iov_len  = fh->f_io_array[i].length;
+        if ( offset < start ) {
+            start = offset;
+        }
+        if ( offset + (off_t) fh->f_io_array[i].length > end ) {
+            end = offset + (off_t) fh->f_io_array[i].length;
+        }
+
+        if ( 0 == data->aio_reqs[req_index].iovcnt ) {
+            data->aio_reqs[req_index].iov    = &data->aio_iovecs[i];
+            data->aio_reqs[req_index].iovcnt = 1;
+            data->aio_reqs[req_index].offset = offset;
+            data->aio_reqs[req_index].data   = data;
+        }
+
+        /* Append the next block to this submission if it follows it in the file */
+        if ( i+1 != fh->f_num_of_io_entries &&
+             (offset + (off_t) fh->f_io_array[i].length) ==
+             (off_t)(intptr_t) fh->f_io_array[i+1].offset &&
+             data->aio_reqs[req_index].iovcnt < mca_fbtl_iouring_iov_max ) {
+            data->aio_reqs[req_index].iovcnt++;
+        }
+        else if ( i+1 != fh->f_num_of_io_entries ) {
+            req_index++;
+            data->aio_reqs[req_index].iovcnt = 0;
+        }
+    }
+    data->aio_req_count = req_index + 1;
+    data->aio_open_reqs = req_index + 1;
+
+    if ( OMPI_SUCCESS != mca_fbtl_iouring_file_lock (data, start, end - start) ) {
+        free (data->allocated_data);
+        free (data);
+        return NULL;
+    }
+    return data;
+}
+
+void mca_fbtl_iouring_request_unlock (mca_fbtl_iouring_request_data_t *data)
+{
+    if ( data->aio_locked ) {
+        data->aio_lock.l_type = F_UNLCK;
+        fcntl (data->aio_fh->fd, F_SETLK, &data->aio_lock);
+        data->aio_locked = false;
+    }
+}
+
+void mca_fbtl_iouring_request_release (mca_fbtl_iouring_request_data_t *data)
+{
+    mca_fbtl_iouring_request_unlock (data);
+    free (data->allocated_data);
+    free (data);
+}
+
+/* queue one submission, the ring lock is held and there is room for it */
+static void mca_fbtl_iouring_queue (mca_fbtl_iouring_sub_t *sub)
+{
+    mca_fbtl_iouring_ring_t *ring = &mca_fbtl_iouring_ring;
+    unsigned tail = *ring->sq_tail;
+    unsigned index = tail & *ring->sq_mask;
+    struct io_uring_sqe *sqe = &ring->sqes[index];
+
+    memset (sqe, 0, sizeof(*sqe));
+    sqe->opcode    = (FBTL_IOURING_READ == sub->data->aio_req_type) ? IORING_OP_READV : IORING_OP_WRITEV;
+    sqe->fd        = sub->data->aio_fh->fd;
+    sqe->off       = (uint64_t) sub->offset;
+    sqe->addr      = (uint64_t)(uintptr_t) sub->iov;
+    sqe->len       = (uint32_t) sub->iovcnt;
+    sqe->user_data = (uint64_t)(uintptr_t) sub;
+    ring->sq_array[index] = index;
+
+    /* the entry has to be visible before the kernel sees the new tail */
+    opal_atomic_wmb ();
+    *ring->sq_tail = tail + 1;
+    ring->pending++;
+    ring->inflight++;
+}
+
+/*
+ * Post as many submissions of this request as the ring can take, then
+ * hand all the queued entries to the kernel with a single system call.
+ */
+int mca_fbtl_iouring_submit (mca_fbtl_iouring_request_data_t *data)
+{
+    mca_fbtl_iouring_ring_t *ring = &mca_fbtl_iouring_ring;
+    int ret = OMPI_SUCCESS;
+
+    OPAL_THREAD_LOCK(&mca_fbtl_iouring_lock);
+    while ( ring->inflight < ring->cq_entries &&
+            (*ring->sq_tail - *ring->sq_head) < ring->sq_entries ) {
+        if ( 0 < data->aio_retry_count ) {
+            mca_fbtl_iouring_queue (data->aio_retry[--data->aio_retry_count]);
+        }
+        else if ( data->aio_next_req < data->aio_req_count ) {
+            mca_fbtl_iouring_queue (&data->aio_reqs[data->aio_next_req++]);
+        }
+        else {
+            break;
+        }
+    }
+
+    while ( 0 < ring->pending ) {
+        int n = mca_fbtl_iouring_enter (ring->pending, 0, 0);
+        if ( 0 > n ) {
+            if ( EINTR == errno ) {
+                continue;
+            }
+            if ( EAGAIN == errno || EBUSY == errno ) {
+                /* the kernel is short of resources, the entries stay
+                   queued and are submitted again on the next call */
+                break;
+            }
+            opal_output(1, "mca_fbtl_iouring_submit: error in io_uring_enter(): %s", strerror(errno));
+            ret = OMPI_ERROR;
+            break;
+        }
+        ring->pending -= n;
+    }
+
+    if ( OMPI_SUCCESS != ret ) {
+        /* the submissions never posted will not complete */
+        data->aio_open_reqs -= (data->aio_req_count - data->aio_next_req) + data->aio_retry_count;
+        data->aio_req_fail_count++;
+        data->aio_next_req = data->aio_req_count;
+        data->aio_retry_count = 0;
+    }
+    OPAL_THREAD_UNLOCK(&mca_fbtl_iouring_lock);
+
+    return ret;
+}
+
+static void mca_fbtl_iouring_complete (mca_fbtl_iouring_sub_t *sub, int res)
+{
+    mca_fbtl_iouring_request_data_t *data = sub->data;
+    size_t done;
+
+    if ( 0 > res ) {
+        if ( -EINTR == res || -EAGAIN == res ) {
+            data->aio_retry[data->aio_retry_count++] = sub;
+            return;
+        }
+        data->aio_req_fail_count++;
+        data->aio_open_reqs--;
+        return;
+    }
+
+    data->aio_total_len += res;
+    done = (size_t) res;
+    sub->offset += res;
+    while ( 0 < done && 0 < sub->iovcnt ) {
+        if ( done >= sub->iov->iov_len ) {
+            done -= sub->iov->iov_len;
+            sub->iov++;
+            sub->iovcnt--;
+        }
+        else {
+            sub->iov->iov_base = (char *) sub->iov->iov_base + done;
+            sub->iov->iov_len -= done;
+            done = 0;
+        }
+    }
+
+    if ( 0 == sub->iovcnt || 0 == res ) {
+        /* done, or end of file reached */
+        data->aio_open_reqs--;
+    }
+    else {
+        /* partial transfer, post the rest again */
+        data->aio_retry[data->aio_retry_count++] = sub;
+    }
+}
+
+/*
+ * Process the completed submissions of all the requests. If wait_for is
+ * given, block until at least one completion arrives unless this request
+ * is finished already.
+ */
+int mca_fbtl_iouring_reap (mca_fbtl_iouring_request_data_t *wait_for)
+{
+    mca_fbtl_iouring_ring_t *ring = &mca_fbtl_iouring_ring;
+    unsigned head, tail;
+    int ret = OMPI_SUCCESS;
+
+    OPAL_THREAD_LOCK(&mca_fbtl_iouring_lock);
+    head = *ring->cq_head;
+    tail = *ring->cq_tail;
+    if ( head == tail && NULL != wait_for && 0 < wait_for->aio_open_reqs &&
+         0 == wait_for->aio_retry_count && ring->inflight > ring->pending ) {
+        while ( 0 > mca_fbtl_iouring_enter (0, 1, IORING_ENTER_GETEVENTS) ) {
+            if ( EINTR != errno ) {
+                opal_output(1, "mca_fbtl_iouring_reap: error in io_uring_enter(): %s", strerror(errno));
+                ret = OMPI_ERROR;
+                break;
+            }
+        }
+        tail = *ring->cq_tail;
+    }
+    opal_atomic_rmb ();
+
+    while ( head != tail ) {
+        struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+        mca_fbtl_iouring_complete ((mca_fbtl_iouring_sub_t *)(uintptr_t) cqe->user_data, cqe->res);
+        ring->inflight--;
+        head++;
+    }
+    /* the entries have to be consumed before the kernel reuses them */
+    opal_atomic_mb ();
+    *ring->cq_head = head;
+    OPAL_THREAD_UNLOCK(&mca_fbtl_iouring_lock);
+
+    return ret;
+}
+
+bool mca_fbtl_iouring_progress ( mca_ompio_request_t *req)
+{
+    mca_fbtl_iouring_request_data_t *data = (mca_fbtl_iouring_request_data_t *) req->req_data;
+
+    mca_fbtl_iouring_reap (NULL);
+    if ( 0 < data->aio_retry_count || data->aio_next_req < data->aio_req_count ) {
+        mca_fbtl_iouring_submit (data);
+    }
+
+    if ( 0 == data->aio_open_reqs ) {
+        /* all pending operations are finished for this request */
+        req->req_ompi.req_status.MPI_ERROR = (0 < data->aio_req_fail_count) ? OMPI_ERROR : OMPI_SUCCESS;
+        req->req_ompi.req_status._ucount = data->aio_total_len;
+        mca_fbtl_iouring_request_unlock (data);
+        return true;
+    }
+    return false;
+}
+
+void mca_fbtl_iouring_request_free ( mca_ompio_request_t *req)
+{
+    /* Free the fbtl specific data structures */
+    mca_fbtl_iouring_request_data_t *data = (mca_fbtl_iouring_request_data_t *) req->req_data;
+    if ( NULL != data ) {
+        mca_fbtl_iouring_request_release (data);
+        req->req_data = NULL;
+    }
+}
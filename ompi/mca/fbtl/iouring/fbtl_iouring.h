@@ -0,0 +1,111 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef MCA_FBTL_IOURING_H
+#define MCA_FBTL_IOURING_H
+
+#include "ompi_config.h"
+#include "ompi/mca/mca.h"
+#include "ompi/mca/fbtl/fbtl.h"
+#include "ompi/mca/common/ompio/common_ompio.h"
+#include "ompi/mca/common/ompio/common_ompio_request.h"
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+extern int mca_fbtl_iouring_priority;
+extern int mca_fbtl_iouring_entries;
+extern int mca_fbtl_iouring_iov_max;
+
+#define FBTL_IOURING_BASE_PRIORITY  0
+#define FBTL_IOURING_ENTRIES        256
+#define FBTL_IOURING_IOV_MAX        1024
+
+BEGIN_C_DECLS
+
+int mca_fbtl_iouring_component_init_query(bool enable_progress_threads,
+                                          bool enable_mpi_threads);
+struct mca_fbtl_base_module_1_0_0_t *
+mca_fbtl_iouring_component_file_query (ompio_file_t *file, int *priority);
+int mca_fbtl_iouring_component_file_unquery (ompio_file_t *file);
+
+int mca_fbtl_iouring_module_init (ompio_file_t *file);
+int mca_fbtl_iouring_module_finalize (ompio_file_t *file);
+
+OMPI_MODULE_DECLSPEC extern mca_fbtl_base_component_2_0_0_t mca_fbtl_iouring_component;
+/*
+ * ******************************************************************
+ * ********* functions which are implemented in this module *********
+ * ******************************************************************
+ */
+
+ssize_t mca_fbtl_iouring_preadv (ompio_file_t *file );
+ssize_t mca_fbtl_iouring_pwritev (ompio_file_t *file );
+ssize_t mca_fbtl_iouring_ipreadv (ompio_file_t *file,
+                                  ompi_request_t *request);
+ssize_t mca_fbtl_iouring_ipwritev (ompio_file_t *file,
+                                   ompi_request_t *request);
+
+bool mca_fbtl_iouring_progress     (mca_ompio_request_t *req);
+void mca_fbtl_iouring_request_free (mca_ompio_request_t *req);
+
+struct mca_fbtl_iouring_request_data_t;
+
+/* One submission queue entry: a run of contiguous entries of the io_array */
+struct mca_fbtl_iouring_sub_t {
+    struct iovec  *iov;       /* first iovec not transferred yet */
+    int            iovcnt;    /* number of iovecs left */
+    off_t          offset;    /* file offset of iov[0] */
+    struct mca_fbtl_iouring_request_data_t *data;
+};
+typedef struct mca_fbtl_iouring_sub_t mca_fbtl_iouring_sub_t;
+
+struct mca_fbtl_iouring_request_data_t {
+    int            aio_req_count;       /* total number of submissions */
+    int            aio_next_req;        /* next submission never posted */
+    int            aio_open_reqs;       /* number of unfinished submissions */
+    int            aio_retry_count;     /* number of partial submissions to post again */
+    int            aio_req_type;        /* read or write */
+    int            aio_req_fail_count;  /* number of submissions that failed */
+    ssize_t        aio_total_len;       /* total amount of data transferred */
+    struct iovec  *aio_iovecs;          /* iovecs copied from the file handle */
+    mca_fbtl_iouring_sub_t  *aio_reqs;  /* submissions */
+    mca_fbtl_iouring_sub_t **aio_retry; /* partial submissions to post again */
+    struct flock   aio_lock;            /* lock used for certain file systems */
+    bool           aio_locked;
+    ompio_file_t  *aio_fh;              /* pointer back to the mca_io_ompio_fh structure */
+    void          *allocated_data;      /* space for the iovecs and the submissions */
+};
+typedef struct mca_fbtl_iouring_request_data_t mca_fbtl_iouring_request_data_t;
+
+/* define constants for read/write operations */
+#define FBTL_IOURING_READ  1
+#define FBTL_IOURING_WRITE 2
+
+/* ring shared by all the files of this process */
+void mca_fbtl_iouring_ring_open (void);
+int  mca_fbtl_iouring_ring_init (void);
+void mca_fbtl_iouring_ring_fini (void);
+
+mca_fbtl_iouring_request_data_t *mca_fbtl_iouring_request_create (ompio_file_t *fh, int io_op);
+void mca_fbtl_iouring_request_unlock (mca_fbtl_iouring_request_data_t *data);
+void mca_fbtl_iouring_request_release (mca_fbtl_iouring_request_data_t *data);
+int  mca_fbtl_iouring_submit (mca_fbtl_iouring_request_data_t *data);
+int  mca_fbtl_iouring_reap (mca_fbtl_iouring_request_data_t *wait_for);
+
+/*
+ * ******************************************************************
+ * ************ functions implemented in this module end ************
+ * ******************************************************************
+ */
+
+END_C_DECLS
+
+#endif /* MCA_FBTL_IOURING_H */
@@ -0,0 +1,73 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "fbtl_iouring.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/mca/fbtl/fbtl.h"
+
+static ssize_t mca_fbtl_iouring_blocking_op (ompio_file_t *fh, int io_op);
+
+ssize_t mca_fbtl_iouring_preadv (ompio_file_t *fh)
+{
+    return mca_fbtl_iouring_blocking_op (fh, FBTL_IOURING_READ);
+}
+
+ssize_t mca_fbtl_iouring_pwritev (ompio_file_t *fh)
+{
+    return mca_fbtl_iouring_blocking_op (fh, FBTL_IOURING_WRITE);
+}
+
+/*
+ * All the blocks are submitted at once, as far as the ring allows, and the
+ * call returns when the last one completed.
+ */
+static ssize_t mca_fbtl_iouring_blocking_op (ompio_file_t *fh, int io_op)
+{
+    mca_fbtl_iouring_request_data_t *data;
+    ssize_t bytes_processed;
+    int ret = OMPI_SUCCESS;
+
+    data = mca_fbtl_iouring_request_create (fh, io_op);
+    if ( NULL == data ) {
+        return OMPI_ERROR;
+    }
+
+    while ( 1 ) {
+        if ( 0 < data->aio_retry_count || data->aio_next_req < data->aio_req_count ) {
+            mca_fbtl_iouring_submit (data);
+        }
+        if ( 0 == data->aio_open_reqs ) {
+            break;
+        }
+        ret = mca_fbtl_iouring_reap (data);
+        if ( OMPI_SUCCESS != ret ) {
+            break;
+        }
+    }
+
+    bytes_processed = data->aio_total_len;
+    if ( OMPI_SUCCESS != ret || 0 < data->aio_req_fail_count ) {
+        opal_output(1, "mca_fbtl_iouring_blocking_op: error in %s",
+                    (FBTL_IOURING_READ == io_op) ? "readv" : "writev");
+        bytes_processed = OMPI_ERROR;
+    }
+    if ( OMPI_SUCCESS == ret ) {
+        mca_fbtl_iouring_request_release (data);
+    }
+    else {
+        /* the kernel may still reference the iovecs, leak them, but do
+           not keep other processes out of the range */
+        mca_fbtl_iouring_request_unlock (data);
+    }
+
+    return bytes_processed;
+}
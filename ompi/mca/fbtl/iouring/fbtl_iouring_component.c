@@ -0,0 +1,109 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * These symbols are in a file by themselves to provide nice linker
+ * semantics.  Since linkers generally pull in symbols by object
+ * files, keeping these symbols as the only symbols in this file
+ * prevents utility programs such as "ompi_info" from having to import
+ * entire components just to query their version and parameters.
+ */
+
+#include "ompi_config.h"
+#include "fbtl_iouring.h"
+#include "mpi.h"
+
+int mca_fbtl_iouring_priority = FBTL_IOURING_BASE_PRIORITY;
+int mca_fbtl_iouring_entries = FBTL_IOURING_ENTRIES;
+int mca_fbtl_iouring_iov_max = FBTL_IOURING_IOV_MAX;
+
+/*
+ * Private functions
+ */
+static int register_component(void);
+static int open_component(void);
+static int open_component(void)
+{
+    mca_fbtl_iouring_ring_open ();
+    return OMPI_SUCCESS;
+}
+
+static int close_component(void);
+
+/*
+ * Public string showing the fbtl iouring component version number
+ */
+const char *mca_fbtl_iouring_component_version_string =
+  "OMPI/MPI io_uring FBTL MCA component version " OMPI_VERSION;
+
+
+/*
+ * Instantiate the public struct with all of our public information
+ * and pointers to our public functions in it
+ */
+mca_fbtl_base_component_2_0_0_t mca_fbtl_iouring_component = {
+
+    /* First, the mca_component_t struct containing meta information
+       about the component itself */
+
+    .fbtlm_version = {
+        MCA_FBTL_BASE_VERSION_2_0_0,
+
+        /* Component name and version */
+        .mca_component_name = "iouring",
+        MCA_BASE_MAKE_VERSION(component, OMPI_MAJOR_VERSION, OMPI_MINOR_VERSION,
+                              OMPI_RELEASE_VERSION),
+        .mca_open_component = open_component,
+        .mca_close_component = close_component,
+        .mca_register_component_params = register_component,
+    },
+    .fbtlm_data = {
+        /* This component is checkpointable */
+      MCA_BASE_METADATA_PARAM_CHECKPOINT
+    },
+    .fbtlm_init_query = mca_fbtl_iouring_component_init_query,      /* get thread level */
+    .fbtlm_file_query = mca_fbtl_iouring_component_file_query,      /* get priority and actions */
+    .fbtlm_file_unquery = mca_fbtl_iouring_component_file_unquery,  /* undo what was done by previous function */
+};
+
+static int register_component(void)
+{
+    mca_fbtl_iouring_priority = FBTL_IOURING_BASE_PRIORITY;
+    (void) mca_base_component_var_register(&mca_fbtl_iouring_component.fbtlm_version,
+                                           "priority", "Priority of the fbtl iouring component. "
+                                           "The posix component uses 50 on local file systems.",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_fbtl_iouring_priority);
+
+    mca_fbtl_iouring_entries = FBTL_IOURING_ENTRIES;
+    (void) mca_base_component_var_register(&mca_fbtl_iouring_component.fbtlm_version,
+                                           "entries", "Number of entries of the submission queue, "
+                                           "i.e. maximum number of operations submitted at once. Default: 256.",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_fbtl_iouring_entries);
+
+    mca_fbtl_iouring_iov_max = FBTL_IOURING_IOV_MAX;
+    (void) mca_base_component_var_register(&mca_fbtl_iouring_component.fbtlm_version,
+                                           "iov_max", "Maximum number of contiguous blocks combined "
+                                           "into one operation. Default: 1024.",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_fbtl_iouring_iov_max );
+
+    return OMPI_SUCCESS;
+}
+
+static int close_component(void)
+{
+    mca_fbtl_iouring_ring_fini ();
+    return OMPI_SUCCESS;
+}
@@ -0,0 +1,53 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "fbtl_iouring.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/mca/fbtl/fbtl.h"
+
+static ssize_t mca_fbtl_iouring_nonblocking_op (ompio_file_t *fh,
+                                                ompi_request_t *request, int io_op);
+
+ssize_t mca_fbtl_iouring_ipreadv (ompio_file_t *fh, ompi_request_t *request)
+{
+    return mca_fbtl_iouring_nonblocking_op (fh, request, FBTL_IOURING_READ);
+}
+
+ssize_t mca_fbtl_iouring_ipwritev (ompio_file_t *fh, ompi_request_t *request)
+{
+    return mca_fbtl_iouring_nonblocking_op (fh, request, FBTL_IOURING_WRITE);
+}
+
+/*
+ * Start the operation and let the progress function post whatever did not
+ * fit in the ring. An error of the submission itself is reported through
+ * the status of the request, since part of the blocks may be in flight.
+ */
+static ssize_t mca_fbtl_iouring_nonblocking_op (ompio_file_t *fh,
+                                                ompi_request_t *request, int io_op)
+{
+    mca_ompio_request_t *req = (mca_ompio_request_t *) request;
+    mca_fbtl_iouring_request_data_t *data;
+
+    data = mca_fbtl_iouring_request_create (fh, io_op);
+    if ( NULL == data ) {
+        return OMPI_ERROR;
+    }
+
+    mca_fbtl_iouring_submit (data);
+
+    req->req_data = data;
+    req->req_progress_fn = mca_fbtl_iouring_progress;
+    req->req_free_fn     = mca_fbtl_iouring_request_free;
+
+    return OMPI_SUCCESS;
+}
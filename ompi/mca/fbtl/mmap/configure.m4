@@ -0,0 +1,26 @@
+# -*- shell-script -*-
+#
+# $COPYRIGHT$
+#
+# Additional copyrights may follow
+#
+# $HEADER$
+#
+
+# MCA_fbtl_mmap_CONFIG(action-if-can-compile,
+#                        [action-if-cant-compile])
+# ------------------------------------------------
+AC_DEFUN([MCA_ompi_fbtl_mmap_CONFIG],[
+    AC_CONFIG_FILES([ompi/mca/fbtl/mmap/Makefile])
+
+    dnl posix_fallocate is optional, without it writes are
+    dnl handed to pwrite
+    fbtl_mmap_happy=no
+    AC_CHECK_HEADER([sys/mman.h],
+                    [AC_CHECK_FUNCS([mmap], [fbtl_mmap_happy="yes"], [])])
+    AC_CHECK_FUNCS([posix_fallocate])
+
+    AS_IF([test "$fbtl_mmap_happy" = "yes"],
+          [$1],
+          [$2])
+])dnl
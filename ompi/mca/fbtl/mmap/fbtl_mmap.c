@@ -0,0 +1,122 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "mpi.h"
+
+#include <stdlib.h>
+#include <sys/mman.h>
+
+#include "opal/util/path.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/group/group.h"
+#include "ompi/proc/proc.h"
+#include "ompi/mca/fbtl/fbtl.h"
+#include "ompi/mca/fbtl/base/base.h"
+#include "ompi/mca/fbtl/mmap/fbtl_mmap.h"
+
+/*
+ * *******************************************************************
+ * ************************ actions structure ************************
+ * *******************************************************************
+ */
+static mca_fbtl_base_module_1_0_0_t mmap_module =  {
+    mca_fbtl_mmap_module_init,     /* initalise after being selected */
+    mca_fbtl_mmap_module_finalize, /* close a module on a communicator */
+    mca_fbtl_mmap_preadv,          /* blocking read */
+    NULL,                          /* non-blocking read */
+    mca_fbtl_mmap_pwritev,         /* blocking write */
+    NULL,                          /* non-blocking write */
+    NULL,                          /* module specific progress */
+    NULL,                          /* free module specific data items on the request */
+    mca_fbtl_base_check_atomicity  /* check whether atomicity is supported on this fs */
+};
+/*
+ * *******************************************************************
+ * ************************* structure ends **************************
+ * *******************************************************************
+ */
+
+int mca_fbtl_mmap_component_init_query(bool enable_progress_threads,
+                                       bool enable_mpi_threads)
+{
+    /* Nothing to do */
+   return OMPI_SUCCESS;
+}
+
+struct mca_fbtl_base_module_1_0_0_t *
+mca_fbtl_mmap_component_file_query (ompio_file_t *fh, int *priority)
+{
+   ompi_proc_t *proc;
+   int i;
+
+   *priority = mca_fbtl_mmap_priority;
+   if ( 0 >= mca_fbtl_mmap_priority ) {
+       return NULL;
+   }
+
+   /* The page cache is only shared by the processes of one node, hence
+      the file has to live on a file system which is not shared with
+      other nodes and all processes have to run on this node. Every
+      process comes to the same conclusion, which keeps the choice of
+      the fcoll component consistent. */
+   if ( UFS != fh->f_fstype || opal_path_nfs ((char *) fh->f_filename, NULL) ) {
+       return NULL;
+   }
+   for ( i = 0; i < fh->f_size; i++ ) {
+       if ( i == fh->f_rank ) {
+           continue;
+       }
+       proc = ompi_group_peer_lookup (fh->f_comm->c_local_group, i);
+       if ( !OPAL_PROC_ON_LOCAL_NODE(proc->super.proc_flags) ) {
+           return NULL;
+       }
+   }
+
+   return &mmap_module;
+}
+
+int mca_fbtl_mmap_component_file_unquery (ompio_file_t *file)
+{
+   /* This function might be needed for some purposes later. for now it
+    * does not have anything to do since there are no steps which need
+    * to be undone if this module is not selected */
+
+   return OMPI_SUCCESS;
+}
+
+int mca_fbtl_mmap_module_init (ompio_file_t *file)
+{
+    mca_fbtl_mmap_data_t *data;
+
+    data = (mca_fbtl_mmap_data_t *) calloc (1, sizeof(mca_fbtl_mmap_data_t));
+    if ( NULL == data ) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    file->f_fbtl_ptr = data;
+
+    /* every process accesses the file directly, there is nothing to
+       gain from aggregating collective operations */
+    file->f_flags |= OMPIO_FILE_NODE_LOCAL;
+    return OMPI_SUCCESS;
+}
+
+int mca_fbtl_mmap_module_finalize (ompio_file_t *file)
+{
+    mca_fbtl_mmap_data_t *data = (mca_fbtl_mmap_data_t *) file->f_fbtl_ptr;
+
+    if ( NULL != data ) {
+        if ( NULL != data->base ) {
+            munmap (data->base, data->len);
+        }
+        free (data);
+        file->f_fbtl_ptr = NULL;
+    }
+    return OMPI_SUCCESS;
+}
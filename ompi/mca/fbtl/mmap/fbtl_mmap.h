@@ -0,0 +1,64 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef MCA_FBTL_MMAP_H
+#define MCA_FBTL_MMAP_H
+
+#include "ompi_config.h"
+#include "ompi/mca/mca.h"
+#include "ompi/mca/fbtl/fbtl.h"
+#include "ompi/mca/common/ompio/common_ompio.h"
+
+#include <fcntl.h>
+#include <sys/uio.h>
+
+extern int mca_fbtl_mmap_priority;
+
+#define FBTL_MMAP_BASE_PRIORITY  0
+
+BEGIN_C_DECLS
+
+int mca_fbtl_mmap_component_init_query(bool enable_progress_threads,
+                                       bool enable_mpi_threads);
+struct mca_fbtl_base_module_1_0_0_t *
+mca_fbtl_mmap_component_file_query (ompio_file_t *file, int *priority);
+int mca_fbtl_mmap_component_file_unquery (ompio_file_t *file);
+
+int mca_fbtl_mmap_module_init (ompio_file_t *file);
+int mca_fbtl_mmap_module_finalize (ompio_file_t *file);
+
+OMPI_MODULE_DECLSPEC extern mca_fbtl_base_component_2_0_0_t mca_fbtl_mmap_component;
+/*
+ * ******************************************************************
+ * ********* functions which are implemented in this module *********
+ * ******************************************************************
+ */
+
+ssize_t mca_fbtl_mmap_preadv (ompio_file_t *file );
+ssize_t mca_fbtl_mmap_pwritev (ompio_file_t *file );
+
+/* Mapping of the file, hung off fh->f_fbtl_ptr. The mapping covers
+   [0, len) of the file and is grown on demand; only the part below
+   the current end of the file is ever touched. */
+struct mca_fbtl_mmap_data_t {
+    char    *base;
+    size_t   len;
+    bool     failed;   /* file cannot be mapped, use pread/pwrite */
+};
+typedef struct mca_fbtl_mmap_data_t mca_fbtl_mmap_data_t;
+
+/*
+ * ******************************************************************
+ * ************ functions implemented in this module end ************
+ * ******************************************************************
+ */
+
+END_C_DECLS
+
+#endif /* MCA_FBTL_MMAP_H */
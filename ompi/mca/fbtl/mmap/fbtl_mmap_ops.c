@@ -0,0 +1,285 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "fbtl_mmap.h"
+
+#include "mpi.h"
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "opal/util/sys_limits.h"
+#include "ompi/constants.h"
+#include "ompi/mca/fbtl/fbtl.h"
+#include "ompi/mca/fbtl/base/base.h"
+
+/*
+** Accesses are served by copying between the user buffer and a shared
+** mapping of the file. Pages of a node-local file live in the page cache
+** of the node, so the data written through the mapping is immediately
+** visible to the other processes, whether they use the mapping or read().
+**
+** Pages beyond the end of the file must never be touched (SIGBUS), hence
+** reads are cut at the current size of the file. Storing into a hole of a
+** sparse file raises SIGBUS as well when the file system is full, hence
+** writes allocate the whole written range first, extending the file if
+** needed. If the file cannot be mapped or allocated, the operation falls
+** back to pread()/pwrite().
+*/
+
+static void mca_fbtl_mmap_extent (ompio_file_t *fh, off_t *start, off_t *end)
+{
+    off_t off;
+    int i;
+
+    *start = (off_t) fh->f_io_array[0].offset;
+    *end   = *start;
+    for ( i = 0; i < fh->f_num_of_io_entries; i++ ) {
+        off = (off_t) fh->f_io_array[i].offset;
+        if ( off < *start ) {
+            *start = off;
+        }
+        if ( off + (off_t) fh->f_io_array[i].length > *end ) {
+            *end = off + (off_t) fh->f_io_array[i].length;
+        }
+    }
+}
+
+static int mca_fbtl_mmap_lock (ompio_file_t *fh, struct flock *lock, short type,
+                               off_t start, off_t end)
+{
+    int ret;
+
+    lock->l_type   = type;
+    lock->l_whence = SEEK_SET;
+    lock->l_start  = start;
+    lock->l_len    = end - start;
+    lock->l_pid    = 0;
+    do {
+        ret = fcntl (fh->fd, F_SETLKW, lock);
+    } while ( -1 == ret && EINTR == errno );
+
+    if ( -1 == ret ) {
+        opal_output(1, "mca_fbtl_mmap: error in fcntl(): %s", strerror(errno));
+        return OMPI_ERROR;
+    }
+    return OMPI_SUCCESS;
+}
+
+static void mca_fbtl_mmap_unlock (ompio_file_t *fh, struct flock *lock)
+{
+    lock->l_type = F_UNLCK;
+    fcntl (fh->fd, F_SETLK, lock);
+}
+
+/* Make sure that [0, end) of the file is mapped. */
+static int mca_fbtl_mmap_map (ompio_file_t *fh, mca_fbtl_mmap_data_t *data, size_t end)
+{
+    size_t len, page = (size_t) opal_getpagesize();
+    int prot = PROT_READ;
+    void *base;
+
+    if ( end <= data->len ) {
+        return OMPI_SUCCESS;
+    }
+
+    /* grow geometrically to keep remapping rare for growing files */
+    len = 2 * data->len;
+    if ( len < end ) {
+        len = end;
+    }
+    len = (len + page - 1) & ~(page - 1);
+
+    if ( !(fh->f_amode & MPI_MODE_RDONLY) ) {
+        prot |= PROT_WRITE;
+    }
+    if ( NULL != data->base ) {
+        munmap (data->base, data->len);
+        data->base = NULL;
+        data->len  = 0;
+    }
+
+    base = mmap (NULL, len, prot, MAP_SHARED, fh->fd, 0);
+    if ( MAP_FAILED == base ) {
+        opal_output_verbose(10, ompi_fbtl_base_framework.framework_output,
+                            "fbtl:mmap: could not map %s, using pread/pwrite: %s",
+                            fh->f_filename, strerror(errno));
+        data->failed = true;
+        return OMPI_ERROR;
+    }
+    data->base = (char *) base;
+    data->len  = len;
+    return OMPI_SUCCESS;
+}
+
+static ssize_t mca_fbtl_mmap_pio (ompio_file_t *fh, bool write)
+{
+    ssize_t ret_code, total_bytes = 0;
+    size_t done;
+    char *addr;
+    off_t off;
+    int i;
+
+    for ( i = 0; i < fh->f_num_of_io_entries; i++ ) {
+        addr = (char *) fh->f_io_array[i].memory_address;
+        off  = (off_t) fh->f_io_array[i].offset;
+        done = 0;
+        while ( done < fh->f_io_array[i].length ) {
+            if ( write ) {
+                ret_code = pwrite (fh->fd, addr + done, fh->f_io_array[i].length - done,
+                                   off + (off_t) done);
+            }
+            else {
+                ret_code = pread (fh->fd, addr + done, fh->f_io_array[i].length - done,
+                                  off + (off_t) done);
+            }
+            if ( -1 == ret_code ) {
+                if ( EINTR == errno ) {
+                    continue;
+                }
+                opal_output(1, "mca_fbtl_mmap: error in %s(): %s",
+                            write ? "pwrite" : "pread", strerror(errno));
+                return OMPI_ERROR;
+            }
+            if ( 0 == ret_code ) {
+                /* end of file */
+                return total_bytes + (ssize_t) done;
+            }
+            done += (size_t) ret_code;
+        }
+        total_bytes += (ssize_t) done;
+    }
+
+    return total_bytes;
+}
+
+ssize_t mca_fbtl_mmap_preadv (ompio_file_t *fh)
+{
+    mca_fbtl_mmap_data_t *data = (mca_fbtl_mmap_data_t *) fh->f_fbtl_ptr;
+    ssize_t total_bytes = 0;
+    struct flock lock;
+    struct stat st;
+    off_t start, end, off;
+    size_t len;
+    int i;
+
+    if ( NULL == fh->f_io_array ) {
+        return OMPI_ERROR;
+    }
+    if ( 0 == fh->f_num_of_io_entries ) {
+        return 0;
+    }
+
+    mca_fbtl_mmap_extent (fh, &start, &end);
+    if ( fh->f_atomicity &&
+         OMPI_SUCCESS != mca_fbtl_mmap_lock (fh, &lock, F_RDLCK, start, end) ) {
+        return OMPI_ERROR;
+    }
+
+    if ( data->failed ) {
+        total_bytes = mca_fbtl_mmap_pio (fh, false);
+        goto exit;
+    }
+
+    if ( 0 != fstat (fh->fd, &st) ) {
+        opal_output(1, "mca_fbtl_mmap: error in fstat(): %s", strerror(errno));
+        total_bytes = OMPI_ERROR;
+        goto exit;
+    }
+    if ( end > st.st_size ) {
+        end = st.st_size;
+    }
+    if ( end > 0 && OMPI_SUCCESS != mca_fbtl_mmap_map (fh, data, (size_t) end) ) {
+        total_bytes = mca_fbtl_mmap_pio (fh, false);
+        goto exit;
+    }
+
+    for ( i = 0; i < fh->f_num_of_io_entries; i++ ) {
+        off = (off_t) fh->f_io_array[i].offset;
+        if ( off >= st.st_size ) {
+            break;
+        }
+        len = fh->f_io_array[i].length;
+        if ( off + (off_t) len > st.st_size ) {
+            len = (size_t) (st.st_size - off);
+        }
+        memcpy (fh->f_io_array[i].memory_address, data->base + off, len);
+        total_bytes += (ssize_t) len;
+        if ( len < fh->f_io_array[i].length ) {
+            break;
+        }
+    }
+
+ exit:
+    if ( fh->f_atomicity ) {
+        mca_fbtl_mmap_unlock (fh, &lock);
+    }
+    return total_bytes;
+}
+
+ssize_t mca_fbtl_mmap_pwritev (ompio_file_t *fh)
+{
+    mca_fbtl_mmap_data_t *data = (mca_fbtl_mmap_data_t *) fh->f_fbtl_ptr;
+    ssize_t total_bytes = 0;
+    struct flock lock;
+    off_t start, end;
+    int i;
+
+    if ( NULL == fh->f_io_array ) {
+        return OMPI_ERROR;
+    }
+    if ( 0 == fh->f_num_of_io_entries ) {
+        return 0;
+    }
+
+    mca_fbtl_mmap_extent (fh, &start, &end);
+    if ( fh->f_atomicity &&
+         OMPI_SUCCESS != mca_fbtl_mmap_lock (fh, &lock, F_WRLCK, start, end) ) {
+        return OMPI_ERROR;
+    }
+
+    if ( data->failed ) {
+        total_bytes = mca_fbtl_mmap_pio (fh, true);
+        goto exit;
+    }
+
+    /* Unlike ftruncate(), posix_fallocate() never shrinks the file, so
+       processes extending the file at the same time cannot undo each
+       other's work. Blocks already allocated are left untouched. */
+#if defined(HAVE_POSIX_FALLOCATE)
+    if ( 0 != posix_fallocate (fh->fd, start, end - start) ) {
+        total_bytes = mca_fbtl_mmap_pio (fh, true);
+        goto exit;
+    }
+#else
+    total_bytes = mca_fbtl_mmap_pio (fh, true);
+    goto exit;
+#endif
+
+    if ( OMPI_SUCCESS != mca_fbtl_mmap_map (fh, data, (size_t) end) ) {
+        total_bytes = mca_fbtl_mmap_pio (fh, true);
+        goto exit;
+    }
+
+    for ( i = 0; i < fh->f_num_of_io_entries; i++ ) {
+        memcpy (data->base + (off_t) fh->f_io_array[i].offset,
+                fh->f_io_array[i].memory_address,
+                fh->f_io_array[i].length);
+        total_bytes += (ssize_t) fh->f_io_array[i].length;
+    }
+
+ exit:
+    if ( fh->f_atomicity ) {
+        mca_fbtl_mmap_unlock (fh, &lock);
+    }
+    return total_bytes;
+}
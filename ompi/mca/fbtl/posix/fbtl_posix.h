@@ -31,6 +31,7 @@
 extern int mca_fbtl_posix_priority;
 extern bool mca_fbtl_posix_read_datasieving;
 extern bool mca_fbtl_posix_write_datasieving;
+extern bool mca_fbtl_posix_indep_write_datasieving;
 extern size_t mca_fbtl_posix_max_block_size;
 extern size_t mca_fbtl_posix_max_gap_size;
 extern size_t mca_fbtl_posix_max_tmpbuf_size;
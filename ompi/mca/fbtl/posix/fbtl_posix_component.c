@@ -39,6 +39,7 @@ const char *mca_fbtl_posix_component_version_string =
 int mca_fbtl_posix_priority = 10;
 bool mca_fbtl_posix_read_datasieving  = true;
 bool mca_fbtl_posix_write_datasieving = true;
+bool mca_fbtl_posix_indep_write_datasieving = false;
 size_t mca_fbtl_posix_max_block_size  = 1048576;  // 1MB
 size_t mca_fbtl_posix_max_gap_size    = 4096;     // Size of a block in many linux fs
 size_t mca_fbtl_posix_max_tmpbuf_size = 67108864; // 64 MB
@@ -129,6 +130,16 @@ static int register_component(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &mca_fbtl_posix_write_datasieving );
 
+    mca_fbtl_posix_indep_write_datasieving  = false;
+    (void) mca_base_component_var_register(&mca_fbtl_posix_component.fbtlm_version,
+                                           "indep_write_datasieving", "Parameter indicating whether to perform data sieving for independent "
+                                           "write operations. The sieved range is locked for the read-modify-write, and the blocks are written "
+                                           "one by one if the file system does not support byte-range locks. Default: false.",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_fbtl_posix_indep_write_datasieving );
+
     
     return OMPI_SUCCESS;
 }
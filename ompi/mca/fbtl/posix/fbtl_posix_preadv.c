@@ -53,16 +53,21 @@ ssize_t mca_fbtl_posix_preadv (ompio_file_t *fh )
         bool do_data_sieving = true;
 
         size_t avg_gap_size=0;
-        size_t avg_block_size = 0;
-        off_t prev_offset = (off_t)fh->f_io_array[0].offset;
+        size_t avg_block_size = fh->f_io_array[0].length;
+        off_t prev_end = (off_t)fh->f_io_array[0].offset + (off_t)fh->f_io_array[0].length;
         int i;
-        for ( i=0; i< fh->f_num_of_io_entries; i++ ) {
+        for ( i=1; i< fh->f_num_of_io_entries; i++ ) {
+            if ( (off_t)fh->f_io_array[i].offset < prev_end ) {
+                /* the sieve buffer only covers blocks in increasing order */
+                do_data_sieving = false;
+                break;
+            }
             avg_block_size += fh->f_io_array[i].length;
-            avg_gap_size   += (size_t)((off_t)fh->f_io_array[i].offset - prev_offset);
-            prev_offset     = (off_t)fh->f_io_array[i].offset;
+            avg_gap_size   += (size_t)((off_t)fh->f_io_array[i].offset - prev_end);
+            prev_end        = (off_t)fh->f_io_array[i].offset + (off_t)fh->f_io_array[i].length;
         }
         avg_block_size = avg_block_size / fh->f_num_of_io_entries;
-        avg_gap_size = avg_gap_size / fh->f_num_of_io_entries;
+        avg_gap_size = avg_gap_size / (fh->f_num_of_io_entries - 1);
 
         if ( false == mca_fbtl_posix_read_datasieving       ||
              0     == avg_gap_size                          ||
@@ -231,12 +236,12 @@ ssize_t mca_fbtl_posix_preadv_datasieving (ompio_file_t *fh, struct flock *lock,
         size_t start_offset = (size_t) fh->f_io_array[startindex].offset;
         for ( i = startindex ; i < endindex ; i++) {
             pos = (size_t) fh->f_io_array[i].offset - start_offset;
-            if ( (ssize_t) pos > ret_code ) {
+            if ( pos >= total_bytes ) {
                 break;
             }
             num_bytes = fh->f_io_array[i].length;
-            if ( ((ssize_t) pos + (ssize_t)num_bytes) > ret_code ) {
-                num_bytes = ret_code - (ssize_t)pos;
+            if ( (pos + num_bytes) > total_bytes ) {
+                num_bytes = total_bytes - pos;
             }
             
             memcpy (fh->f_io_array[i].memory_address, temp_buf + pos, num_bytes);
@@ -31,7 +31,7 @@
 #include "ompi/mca/fbtl/fbtl.h"
 
 static ssize_t mca_fbtl_posix_pwritev_datasieving (ompio_file_t *fh, struct flock *lock, int *lock_counter );
-static ssize_t mca_fbtl_posix_pwritev_generic (ompio_file_t *fh, struct flock *lock, int *lock_counter );
+static ssize_t mca_fbtl_posix_pwritev_generic (ompio_file_t *fh, struct flock *lock, int *lock_counter, int first );
 static ssize_t mca_fbtl_posix_pwritev_single (ompio_file_t *fh, struct flock *lock, int *lock_counter );
 
 #define MAX_RETRIES 10
@@ -54,23 +54,29 @@ ssize_t  mca_fbtl_posix_pwritev(ompio_file_t *fh )
         bool do_data_sieving = true;
 
         size_t avg_gap_size=0;
-        size_t avg_block_size = 0;
-        off_t prev_offset = (off_t)fh->f_io_array[0].offset;
+        size_t avg_block_size = fh->f_io_array[0].length;
+        off_t prev_end = (off_t)fh->f_io_array[0].offset + (off_t)fh->f_io_array[0].length;
         int i;
-        for ( i=0; i< fh->f_num_of_io_entries; i++ ) {
+        for ( i=1; i< fh->f_num_of_io_entries; i++ ) {
+            if ( (off_t)fh->f_io_array[i].offset < prev_end ) {
+                /* the sieve buffer only covers blocks in increasing order */
+                do_data_sieving = false;
+                break;
+            }
             avg_block_size += fh->f_io_array[i].length;
-            avg_gap_size   += (size_t)((off_t)fh->f_io_array[i].offset - prev_offset);
-            prev_offset     = (off_t)fh->f_io_array[i].offset;
+            avg_gap_size   += (size_t)((off_t)fh->f_io_array[i].offset - prev_end);
+            prev_end        = (off_t)fh->f_io_array[i].offset + (off_t)fh->f_io_array[i].length;
         }
         avg_block_size = avg_block_size / fh->f_num_of_io_entries;
-        avg_gap_size = avg_gap_size / fh->f_num_of_io_entries;
+        avg_gap_size = avg_gap_size / (fh->f_num_of_io_entries - 1);
 
         if ( false == mca_fbtl_posix_write_datasieving      ||
              0     == avg_gap_size                          ||
              avg_block_size > mca_fbtl_posix_max_block_size ||
              avg_gap_size   > mca_fbtl_posix_max_gap_size   ||
              ompi_mpi_thread_multiple                       ||
-             !(fh->f_flags & OMPIO_COLLECTIVE_OP)            ) {
+             (!(fh->f_flags & OMPIO_COLLECTIVE_OP) &&
+              false == mca_fbtl_posix_indep_write_datasieving) ) {
             do_data_sieving = false;
         }
                 
@@ -78,7 +84,7 @@ ssize_t  mca_fbtl_posix_pwritev(ompio_file_t *fh )
             bytes_written = mca_fbtl_posix_pwritev_datasieving (fh, &lock, &lock_counter);
         }
         else {
-            bytes_written =  mca_fbtl_posix_pwritev_generic (fh, &lock, &lock_counter);
+            bytes_written =  mca_fbtl_posix_pwritev_generic (fh, &lock, &lock_counter, 0);
         }
     }
     else {
@@ -139,6 +145,8 @@ ssize_t mca_fbtl_posix_pwritev_datasieving (ompio_file_t *fh, struct flock *lock
     int endindex   = 0;
     bool done = false;
     size_t total_bytes = 0;
+    bool independent = !(fh->f_flags & OMPIO_COLLECTIVE_OP);
+    int32_t orig_flags = fh->f_flags;
     
     while (!done) {
         // Break the io_array into chunks such that the size of the temporary
@@ -181,8 +189,25 @@ ssize_t mca_fbtl_posix_pwritev_datasieving (ompio_file_t *fh, struct flock *lock
             bufsize = len;
         }
         
-        // Read the entire block.
+        // Read the entire block. Outside of a collective operation the gaps
+        // may belong to other processes, so the range is locked even if
+        // the file system does not require it for plain writes.
+        if ( independent ) {
+            fh->f_flags &= ~(OMPIO_LOCK_NEVER | OMPIO_LOCK_NOT_THIS_OP);
+        }
         ret = mca_fbtl_posix_lock ( lock, fh, F_WRLCK, start, len, OMPIO_LOCK_ENTIRE_REGION, lock_counter ); 
+        fh->f_flags = orig_flags;
+        if ( independent && 0 != ret ) {
+            // No byte-range locks here, write the remaining blocks one by one
+            // instead. The chunks before this one are already written.
+            mca_fbtl_posix_unlock ( lock, fh, lock_counter);
+            free ( temp_buf);
+            ret_code = mca_fbtl_posix_pwritev_generic (fh, lock, lock_counter, startindex);
+            if ( 0 > ret_code ) {
+                return ret_code;
+            }
+            return bytes_written + ret_code;
+        }
         if ( 0 < ret ) {
             opal_output(1, "mca_fbtl_posix_pwritev_datasieving: error in mca_fbtl_posix_lock() ret=%d: %s",
                         ret, strerror(errno));
@@ -193,8 +218,9 @@ ssize_t mca_fbtl_posix_pwritev_datasieving (ompio_file_t *fh, struct flock *lock
         }
         
         int retries=0;
+        total_bytes = 0;
         while ( total_bytes < len ) {
-            ret_code = pread (fh->fd, temp_buf, len, start);
+            ret_code = pread (fh->fd, temp_buf+total_bytes, len-total_bytes, start+total_bytes);
             if ( ret_code == -1 ) {
                 opal_output(1, "mca_fbtl_posix_pwritev_datasieving: error in pread:%s", strerror(errno));
                 mca_fbtl_posix_unlock ( lock, fh, lock_counter);
@@ -213,6 +239,10 @@ ssize_t mca_fbtl_posix_pwritev_datasieving (ompio_file_t *fh, struct flock *lock
             }
             total_bytes += ret_code;
         }
+        if ( total_bytes < len ) {
+            // The range extends past the end of file, which reads as zeros.
+            memset ( temp_buf+total_bytes, 0, len-total_bytes);
+        }
         
         // Copy the elements to write into temporary buffer.
         size_t pos = 0;
@@ -245,7 +275,8 @@ ssize_t mca_fbtl_posix_pwritev_datasieving (ompio_file_t *fh, struct flock *lock
 }
 
 
-ssize_t mca_fbtl_posix_pwritev_generic (ompio_file_t *fh, struct flock *lock, int *lock_counter )
+/* write the entries of fh->f_io_array starting at index first */
+ssize_t mca_fbtl_posix_pwritev_generic (ompio_file_t *fh, struct flock *lock, int *lock_counter, int first )
 {
     /*int *fp = NULL;*/
     int i, block = 1, ret;
@@ -266,7 +297,7 @@ ssize_t mca_fbtl_posix_pwritev_generic (ompio_file_t *fh, struct flock *lock, in
         return OMPI_ERR_OUT_OF_RESOURCE;
     }
 
-    for (i=0 ; i<fh->f_num_of_io_entries ; i++) {
+    for (i=first ; i<fh->f_num_of_io_entries ; i++) {
 	if (0 == iov_count) {
 	    iov[iov_count].iov_base = fh->f_io_array[i].memory_address;
 	    iov[iov_count].iov_len = fh->f_io_array[i].length;
@@ -260,6 +260,9 @@ int mca_fcoll_base_file_select (struct ompio_file_t *file,
 int mca_fcoll_base_query_table (struct ompio_file_t *file, char *name)
 {
     if (!strcmp (name, "individual")) {
+        if ( file->f_flags & OMPIO_FILE_NODE_LOCAL ) {
+            return 1;
+        }
         if ((int)file->f_cc_size >= file->f_bytes_per_agg &&
             file->f_cc_size >= file->f_stripe_size) {
             return 1;
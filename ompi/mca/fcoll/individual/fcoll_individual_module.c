@@ -69,6 +69,11 @@ mca_fcoll_individual_component_file_query (ompio_file_t *fh, int *priority)
 	if ( 2 >= fh->f_size ) {
 	    *priority = 100;
 	}
+        /* the fbtl accesses the file through a mapping shared by all
+           processes, aggregating the data would only add copies */
+        if ( fh->f_flags & OMPIO_FILE_NODE_LOCAL ) {
+            *priority = 100;
+        }
     }
 
     return &individual;
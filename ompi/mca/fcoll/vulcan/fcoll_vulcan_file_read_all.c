@@ -28,6 +28,7 @@
 #include "ompi/mca/fcoll/base/fcoll_base_coll_array.h"
 #include "ompi/mca/common/ompio/common_ompio.h"
 #include "ompi/mca/io/io.h"
+#include "ompi/mca/common/ompio/common_ompio_request.h"
 #include "math.h"
 #include "ompi/mca/pml/pml.h"
 #include <unistd.h>
@@ -46,6 +47,20 @@ static int read_heap_sort (mca_io_ompio_local_io_array *io_array,
                            int num_entries,
                            int *sorted);
 
+static int read_init (ompio_file_t *fh,
+                      int read_synchType,
+                      ompi_request_t **request);
+
+static int read_shuffle (ompio_file_t *fh,
+                         int aggregator,
+                         char *global_buf,
+                         ompi_datatype_t **sendtype,
+                         MPI_Request *send_req,
+                         ompi_request_t **read_req,
+                         int bytes_received,
+                         struct iovec *decoded_iov,
+                         int *iov_index,
+                         size_t *current_position);
 
 
 int
@@ -65,7 +80,7 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
     MPI_Aint bytes_remaining = 0; /* how many bytes have been read from the current
                                      value from total_bytes_per_process */
     int *sorted_file_offsets=NULL, entries_per_aggregator=0;
-    int bytes_received = 0;
+    int bytes_received[2] = {0, 0};
     int blocks = 0;
     /* iovec structure and count of the buffer passed in */
     uint32_t iov_count = 0;
@@ -82,7 +97,10 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
     int current_index=0, temp_index=0;
     int **blocklen_per_process=NULL;
     MPI_Aint **displs_per_process=NULL;
-    char *global_buf = NULL;
+    /* two cycles are in flight: one being read while the other is being
+       sent, each with its own buffer and send types */
+    char *global_buf[2] = {NULL, NULL};
+    int slot = 0, read_synch_type = 0;
     MPI_Aint global_count = 0;
     mca_io_ompio_local_io_array *file_offsets_for_agg=NULL;
 
@@ -92,14 +110,11 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
     int vulcan_num_io_procs;
     size_t max_data = 0;
     MPI_Aint *total_bytes_per_process = NULL;
-    ompi_datatype_t **sendtype = NULL;
+    ompi_datatype_t **sendtype[2] = {NULL, NULL};
     MPI_Request *send_req = NULL;
-    MPI_Request recv_req = MPI_REQUEST_NULL;
+    ompi_request_t *read_req[2] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL};
     int my_aggregator =-1;
 
-    int* blocklength_proc       = NULL;
-    ptrdiff_t* displs_proc      = NULL;
-
 #if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     double read_time = 0.0, start_read_time = 0.0, end_read_time = 0.0;
     double rcomm_time = 0.0, start_rcomm_time = 0.0, end_rcomm_time = 0.0;
@@ -132,6 +147,12 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
         goto exit;
     }
 
+    if( (1 == mca_fcoll_vulcan_async_io) && (NULL == fh->f_fbtl->fbtl_ipreadv) ) {
+        opal_output (1, "vulcan_read_all: fbtl Does NOT support ipreadv() (asynchrounous read) \n");
+        ret = MPI_ERR_UNSUPPORTED_OPERATION;
+        goto exit;
+    }
+
     ret = mca_common_ompio_set_aggregator_props ((struct ompio_file_t *) fh,
                                                  vulcan_num_io_procs,
                                                  max_data);
@@ -321,6 +342,14 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
      ***    operation
      *************************************************************/
     bytes_per_cycle = fh->f_bytes_per_agg;
+    if( (1 == mca_fcoll_vulcan_async_io) ||
+        ( (0 == mca_fcoll_vulcan_async_io) && (NULL != fh->f_fbtl->fbtl_ipreadv) &&
+          (total_bytes > bytes_per_cycle) ) ) {
+        /* the next cycle is read while the current one is sent, each one
+           with half of the buffer the user requested */
+        read_synch_type = 1;
+        bytes_per_cycle = bytes_per_cycle/2;
+    }
     cycles = ceil((double)total_bytes/bytes_per_cycle);
 
     if ( my_aggregator == fh->f_rank) {
@@ -357,23 +386,36 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
 	    goto exit;
 	}
 
-	global_buf = (char *) malloc (bytes_per_cycle);
-	if (NULL == global_buf){
+	global_buf[0] = (char *) malloc (bytes_per_cycle);
+	if (NULL == global_buf[0]){
 	    opal_output(1, "OUT OF MEMORY\n");
 	    ret = OMPI_ERR_OUT_OF_RESOURCE;
 	    goto exit;
 	}
+        /* synchronous reads only happen once the previous cycle was sent */
+        global_buf[1] = global_buf[0];
+        if (1 == read_synch_type) {
+            global_buf[1] = (char *) malloc (bytes_per_cycle);
+            if (NULL == global_buf[1]){
+                opal_output(1, "OUT OF MEMORY\n");
+                ret = OMPI_ERR_OUT_OF_RESOURCE;
+                goto exit;
+            }
+            mca_common_ompio_register_progress ();
+        }
 
-	sendtype = (ompi_datatype_t **) malloc (fh->f_procs_per_group * sizeof(ompi_datatype_t *));
-	if (NULL == sendtype) {
-            opal_output (1, "OUT OF MEMORY\n");
-	    ret = OMPI_ERR_OUT_OF_RESOURCE;
-	    goto exit;
-	}
+        for (slot = 0; slot < 2; slot++) {
+            sendtype[slot] = (ompi_datatype_t **) malloc (fh->f_procs_per_group * sizeof(ompi_datatype_t *));
+            if (NULL == sendtype[slot]) {
+                opal_output (1, "OUT OF MEMORY\n");
+                ret = OMPI_ERR_OUT_OF_RESOURCE;
+                goto exit;
+            }
 
-	for(l=0;l<fh->f_procs_per_group;l++){
-            sendtype[l] = MPI_DATATYPE_NULL;
-	}
+            for(l=0;l<fh->f_procs_per_group;l++){
+                sendtype[slot][l] = MPI_DATATYPE_NULL;
+            }
+        }
     }
 
 
@@ -387,6 +429,10 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
     current_index = 0;
 
     for (index = 0; index < cycles; index++) {
+        /* cycle index uses the buffer and send types of slot index%2, while
+           the data of the previous cycle is sent from the other slot */
+        slot = index % 2;
+
         /**********************************************************************
          ***  7a. Getting ready for next cycle: initializing and freeing buffers
 	 **********************************************************************/
@@ -397,11 +443,11 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
             }
             fh->f_num_of_io_entries = 0;
 
-            if (NULL != sendtype){
+            if (NULL != sendtype[slot]){
                 for (i =0; i< fh->f_procs_per_group; i++) {
-		    if ( MPI_DATATYPE_NULL != sendtype[i] ) {
-                        ompi_datatype_destroy(&sendtype[i]);
-                        sendtype[i] = MPI_DATATYPE_NULL;
+		    if ( MPI_DATATYPE_NULL != sendtype[slot][i] ) {
+                        ompi_datatype_destroy(&sendtype[slot][i]);
+                        sendtype[slot][i] = MPI_DATATYPE_NULL;
                     }
 		}
             }
@@ -469,7 +515,7 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
          *** 7c. Calculate how much data will be contributed in this cycle
 	 ***     by each process
          *****************************************************************/
-        bytes_received = 0;
+        bytes_received[slot] = 0;
 
         while (bytes_to_read_in_cycle) {
             /* This next block identifies which process is the holder
@@ -505,7 +551,7 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
                         disp_index[n] += 1;
                     }
                     if (fh->f_procs_in_group[n] == fh->f_rank) {
-                        bytes_received += bytes_remaining;
+                        bytes_received[slot] += bytes_remaining;
                     }
                     current_index ++;
                     bytes_to_read_in_cycle -= bytes_remaining;
@@ -523,7 +569,7 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
                              - bytes_remaining);
                     }
                     if (fh->f_procs_in_group[n] == fh->f_rank) {
-                        bytes_received += bytes_to_read_in_cycle;
+                        bytes_received[slot] += bytes_to_read_in_cycle;
                     }
                     bytes_remaining -= bytes_to_read_in_cycle;
                     bytes_to_read_in_cycle = 0;
@@ -542,7 +588,7 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
                     }
 
                     if (fh->f_procs_in_group[n] == fh->f_rank) {
-                        bytes_received += bytes_to_read_in_cycle;
+                        bytes_received[slot] += bytes_to_read_in_cycle;
                     }
                     bytes_remaining = global_iov_array[sorted[current_index]].iov_len -
                         bytes_to_read_in_cycle;
@@ -565,7 +611,7 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
                         disp_index[n] += 1;
                     }
                     if (fh->f_procs_in_group[n] == fh->f_rank) {
-                        bytes_received +=
+                        bytes_received[slot] +=
                             global_iov_array[sorted[current_index]].iov_len;
                     }
                     bytes_to_read_in_cycle -=
@@ -620,10 +666,9 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
                     }
                 }
             }
-            else{
-                continue;
-            }
+        }
 
+        if (my_aggregator == fh->f_rank && 0 < entries_per_aggregator) {
              /* Sort the displacements for each aggregator */
             read_heap_sort (file_offsets_for_agg,
                             entries_per_aggregator,
@@ -655,7 +700,7 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
             fh->f_io_array[0].length =
                 file_offsets_for_agg[sorted_file_offsets[0]].length;
             fh->f_io_array[0].memory_address =
-                global_buf+memory_displacements[sorted_file_offsets[0]];
+                global_buf[slot]+memory_displacements[sorted_file_offsets[0]];
             fh->f_num_of_io_entries++;
             for (i=1;i<entries_per_aggregator;i++){
                 if (file_offsets_for_agg[sorted_file_offsets[i-1]].offset +
@@ -670,31 +715,30 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
                     fh->f_io_array[fh->f_num_of_io_entries].length =
                         file_offsets_for_agg[sorted_file_offsets[i]].length;
                     fh->f_io_array[fh->f_num_of_io_entries].memory_address =
-                        global_buf+memory_displacements[sorted_file_offsets[i]];
+                        global_buf[slot]+memory_displacements[sorted_file_offsets[i]];
                     fh->f_num_of_io_entries++;
                 }
             }
 
 
+            /**********************************************************
+             *** 7f. Start reading the data of this cycle. Asynchronous
+             ***     reads overlap with sending the previous cycle, the
+             ***     synchronous ones wait until it is sent.
+             *********************************************************/
+            if (1 == read_synch_type && fh->f_num_of_io_entries) {
 #if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
-            start_read_time = MPI_Wtime();
+                start_read_time = MPI_Wtime();
 #endif
-
-            if (fh->f_num_of_io_entries) {
-                if ( 0 >  fh->f_fbtl->fbtl_preadv (fh)) {
-                    opal_output (1, "READ FAILED\n");
-                    ret = OMPI_ERROR;
+                ret = read_init (fh, read_synch_type, &read_req[slot]);
+                if (OMPI_SUCCESS != ret){
                     goto exit;
                 }
-            }
-
 #if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
-            end_read_time = MPI_Wtime();
-            read_time += end_read_time - start_read_time;
+                end_read_time = MPI_Wtime();
+                read_time += end_read_time - start_read_time;
 #endif
-            /**********************************************************
-             ******************** DONE READING ************************
-             *********************************************************/
+            }
 
             temp_disp_index = (int *)calloc (1, fh->f_procs_per_group * sizeof (int));
             if (NULL == temp_disp_index) {
@@ -721,141 +765,68 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
                 temp_disp_index = NULL;
             }
 
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
-            start_rcomm_time = MPI_Wtime();
-#endif
             for (i=0;i<fh->f_procs_per_group;i++){
-                size_t datatype_size;
-                send_req[i] = MPI_REQUEST_NULL;
                 if ( 0 < disp_index[i] ) {
                     ompi_datatype_create_hindexed(disp_index[i],
                                                   blocklen_per_process[i],
                                                   displs_per_process[i],
                                                   MPI_BYTE,
-                                                  &sendtype[i]);
-                    ompi_datatype_commit(&sendtype[i]);
-                    opal_datatype_type_size(&sendtype[i]->super, &datatype_size);
-
-                    if(datatype_size) {
-                        ret = MCA_PML_CALL (isend(global_buf,
-                                                  1,
-                                                  sendtype[i],
-                                                  fh->f_procs_in_group[i],
-                                                  FCOLL_VULCAN_SHUFFLE_TAG,
-                                                  MCA_PML_BASE_SEND_STANDARD,
-                                                  fh->f_comm,
-                                                  &send_req[i]));
-                        if(OMPI_SUCCESS != ret){
-                            goto exit;
-                        }
-                    }
+                                                  &sendtype[slot][i]);
+                    ompi_datatype_commit(&sendtype[slot][i]);
                 }
             }
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
-            end_rcomm_time = MPI_Wtime();
-            rcomm_time += end_rcomm_time - start_rcomm_time;
-#endif
         }
 
         /**********************************************************
-         *** 7f.  Scatter the Data from the readers
+         *** 7g. Scatter the data of the previous cycle from the readers
          *********************************************************/
-        if(bytes_received) {
-            size_t remaining            = bytes_received;
-            int block_index             = -1;
-            int blocklength_size        = INIT_LEN;
-
-            ptrdiff_t recv_mem_address  = 0;
-            ompi_datatype_t *newType    = MPI_DATATYPE_NULL;
-
-            blocklength_proc            = (int *)       calloc (blocklength_size, sizeof (int));
-            displs_proc                 = (ptrdiff_t *) calloc (blocklength_size, sizeof (ptrdiff_t));
-
-            if (NULL == blocklength_proc || NULL == displs_proc ) {
-                opal_output (1, "OUT OF MEMORY\n");
-                ret = OMPI_ERR_OUT_OF_RESOURCE;
-                goto exit;
-            }
-
-            while (remaining) {
-                block_index++;
-
-                if(0 == block_index) {
-                    recv_mem_address = (ptrdiff_t) (decoded_iov[iov_index].iov_base) + current_position;
-                }
-                else {
-                    // Reallocate more memory if blocklength_size is not enough
-                    if(0 == block_index % INIT_LEN) {
-                        blocklength_size += INIT_LEN;
-                        blocklength_proc = (int *)       realloc(blocklength_proc, blocklength_size * sizeof(int));
-                        displs_proc      = (ptrdiff_t *) realloc(displs_proc, blocklength_size * sizeof(ptrdiff_t));
-                    }
-                    displs_proc[block_index] = (ptrdiff_t) (decoded_iov[iov_index].iov_base) +
-                                                            current_position - recv_mem_address;
-                }
-
-                if (remaining >= (decoded_iov[iov_index].iov_len - current_position)) {
-                    blocklength_proc[block_index] = decoded_iov[iov_index].iov_len - current_position;
-
-                    remaining = remaining - blocklength_proc[block_index];
-                    iov_index = iov_index + 1;
-                    current_position = 0;
-                }
-                else {
-                    blocklength_proc[block_index] = remaining;
-                    current_position += remaining;
-                    remaining = 0;
-                }
-            }
-
-            ompi_datatype_create_hindexed(block_index+1,
-                                          blocklength_proc,
-                                          displs_proc,
-                                          MPI_BYTE,
-                                          &newType);
-            ompi_datatype_commit(&newType);
-
+        if (0 < index) {
 #if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
             start_rcomm_time = MPI_Wtime();
 #endif
-            ret = MCA_PML_CALL(irecv((char *)recv_mem_address,
-                                     1,
-                                     newType,
-                                     my_aggregator,
-                                     FCOLL_VULCAN_SHUFFLE_TAG,
-                                     fh->f_comm,
-                                     &recv_req));
-
-            if ( MPI_DATATYPE_NULL != newType ) {
-                ompi_datatype_destroy(&newType);
-            }
-
+            ret = read_shuffle (fh, my_aggregator, global_buf[1 - slot], sendtype[1 - slot],
+                                send_req, &read_req[1 - slot], bytes_received[1 - slot],
+                                decoded_iov, &iov_index, &current_position);
             if (OMPI_SUCCESS != ret){
                 goto exit;
             }
+#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
+            end_rcomm_time = MPI_Wtime();
+            rcomm_time += end_rcomm_time - start_rcomm_time;
+#endif
         }
 
-        if (my_aggregator == fh->f_rank){
-            ret = ompi_request_wait_all (fh->f_procs_per_group,
-                                         send_req,
-                                         MPI_STATUS_IGNORE);
+        if (0 == read_synch_type && my_aggregator == fh->f_rank && fh->f_num_of_io_entries) {
+#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
+            start_read_time = MPI_Wtime();
+#endif
+            ret = read_init (fh, read_synch_type, &read_req[slot]);
             if (OMPI_SUCCESS != ret){
                 goto exit;
             }
+#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
+            end_read_time = MPI_Wtime();
+            read_time += end_read_time - start_read_time;
+#endif
         }
+    } /* end for (index=0; index < cycles; index ++) */
 
-        ret = ompi_request_wait (&recv_req, MPI_STATUS_IGNORE);
+    if (0 < cycles) {
+#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
+        start_rcomm_time = MPI_Wtime();
+#endif
+        slot = (cycles - 1) % 2;
+        ret = read_shuffle (fh, my_aggregator, global_buf[slot], sendtype[slot],
+                            send_req, &read_req[slot], bytes_received[slot],
+                            decoded_iov, &iov_index, &current_position);
         if (OMPI_SUCCESS != ret){
             goto exit;
         }
-
 #if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
-        if(bytes_received) {
-            end_rcomm_time = MPI_Wtime();
-            rcomm_time += end_rcomm_time - start_rcomm_time;
-        }
+        end_rcomm_time = MPI_Wtime();
+        rcomm_time += end_rcomm_time - start_rcomm_time;
 #endif
-    } /* end for (index=0; index < cycles; index ++) */
+    }
 
 #if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     end_rexch = MPI_Wtime();
@@ -875,9 +846,16 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
 #endif
 
 exit:
-    if (NULL != global_buf) {
-        free (global_buf);
-        global_buf = NULL;
+    for (slot = 0; slot < 2; slot++) {
+        if (MPI_REQUEST_NULL != read_req[slot]) {
+            ompi_request_wait (&read_req[slot], MPI_STATUS_IGNORE);
+        }
+    }
+    if (NULL != global_buf[1] && global_buf[1] != global_buf[0]) {
+        free (global_buf[1]);
+    }
+    if (NULL != global_buf[0]) {
+        free (global_buf[0]);
     }
     if (NULL != sorted) {
         free (sorted);
@@ -905,16 +883,6 @@ exit:
         displs = NULL;
     }
 
-    if (NULL != blocklength_proc) {
-        free (blocklength_proc);
-        blocklength_proc = NULL;
-    }
-
-    if (NULL != displs_proc) {
-        free (displs_proc);
-        displs_proc = NULL;
-    }
-
     if (my_aggregator == fh->f_rank) {
 
         if (NULL != sorted_file_offsets){
@@ -929,14 +897,16 @@ exit:
             free(memory_displacements);
             memory_displacements= NULL;
         }
-        if (NULL != sendtype){
-            for (i = 0; i < fh->f_procs_per_group; i++) {
-                if ( MPI_DATATYPE_NULL != sendtype[i] ) {
-                    ompi_datatype_destroy(&sendtype[i]);
+        for (slot = 0; slot < 2; slot++) {
+            if (NULL != sendtype[slot]){
+                for (i = 0; i < fh->f_procs_per_group; i++) {
+                    if ( MPI_DATATYPE_NULL != sendtype[slot][i] ) {
+                        ompi_datatype_destroy(&sendtype[slot][i]);
+                    }
                 }
+                free(sendtype[slot]);
+                sendtype[slot]=NULL;
             }
-            free(sendtype);
-            sendtype=NULL;
         }
 
         if (NULL != disp_index){
@@ -975,6 +945,184 @@ exit:
 }
 
 
+static int read_init (ompio_file_t *fh, int read_synchType, ompi_request_t **request)
+{
+    int ret = OMPI_SUCCESS;
+    ssize_t ret_temp = 0;
+    mca_ompio_request_t *ompio_req = NULL;
+
+    mca_common_ompio_request_alloc ( &ompio_req, MCA_OMPIO_REQUEST_READ );
+
+    if (1 == read_synchType) {
+        ret = fh->f_fbtl->fbtl_ipreadv(fh, (ompi_request_t *) ompio_req);
+        if(0 > ret) {
+            opal_output (1, "vulcan_read_all: fbtl_ipreadv failed\n");
+            ompio_req->req_ompi.req_status.MPI_ERROR = ret;
+            ompio_req->req_ompi.req_status._ucount = 0;
+            ompi_request_complete (&ompio_req->req_ompi, false);
+        }
+    }
+    else {
+        ret_temp = fh->f_fbtl->fbtl_preadv(fh);
+        if(0 > ret_temp) {
+            opal_output (1, "READ FAILED\n");
+            ret = OMPI_ERROR;
+            ret_temp = 0;
+        }
+
+        ompio_req->req_ompi.req_status.MPI_ERROR = ret;
+        ompio_req->req_ompi.req_status._ucount = ret_temp;
+        ompi_request_complete (&ompio_req->req_ompi, false);
+    }
+
+    free(fh->f_io_array);
+    fh->f_io_array=NULL;
+    fh->f_num_of_io_entries=0;
+
+    *request = (ompi_request_t *) ompio_req;
+    return ret;
+}
+
+/*
+ * Send the data read in one cycle from the aggregator to the processes of its
+ * group, and receive the part of this process. The read into global_buf is
+ * completed first.
+ */
+static int read_shuffle (ompio_file_t *fh, int aggregator, char *global_buf,
+                         ompi_datatype_t **sendtype, MPI_Request *send_req,
+                         ompi_request_t **read_req, int bytes_received,
+                         struct iovec *decoded_iov, int *iov_index,
+                         size_t *current_position)
+{
+    int i, ret = OMPI_SUCCESS;
+    MPI_Request recv_req = MPI_REQUEST_NULL;
+    int* blocklength_proc  = NULL;
+    ptrdiff_t* displs_proc = NULL;
+
+    if (aggregator == fh->f_rank) {
+        if (MPI_REQUEST_NULL != *read_req) {
+            ret = ompi_request_wait (read_req, MPI_STATUS_IGNORE);
+            if (OMPI_SUCCESS != ret) {
+                goto exit;
+            }
+        }
+
+        for (i = 0; i < fh->f_procs_per_group; i++) {
+            size_t datatype_size;
+            send_req[i] = MPI_REQUEST_NULL;
+            if ( MPI_DATATYPE_NULL == sendtype[i] ) {
+                continue;
+            }
+            opal_datatype_type_size(&sendtype[i]->super, &datatype_size);
+            if (datatype_size) {
+                ret = MCA_PML_CALL (isend(global_buf,
+                                          1,
+                                          sendtype[i],
+                                          fh->f_procs_in_group[i],
+                                          FCOLL_VULCAN_SHUFFLE_TAG,
+                                          MCA_PML_BASE_SEND_STANDARD,
+                                          fh->f_comm,
+                                          &send_req[i]));
+                if(OMPI_SUCCESS != ret){
+                    goto exit;
+                }
+            }
+        }
+    }
+
+    if (bytes_received) {
+        size_t remaining            = bytes_received;
+        int block_index             = -1;
+        int blocklength_size        = INIT_LEN;
+
+        ptrdiff_t recv_mem_address  = 0;
+        ompi_datatype_t *newType    = MPI_DATATYPE_NULL;
+
+        blocklength_proc            = (int *)       calloc (blocklength_size, sizeof (int));
+        displs_proc                 = (ptrdiff_t *) calloc (blocklength_size, sizeof (ptrdiff_t));
+
+        if (NULL == blocklength_proc || NULL == displs_proc ) {
+            opal_output (1, "OUT OF MEMORY\n");
+            ret = OMPI_ERR_OUT_OF_RESOURCE;
+            goto exit;
+        }
+
+        while (remaining) {
+            block_index++;
+
+            if(0 == block_index) {
+                recv_mem_address = (ptrdiff_t) (decoded_iov[*iov_index].iov_base) + *current_position;
+            }
+            else {
+                // Reallocate more memory if blocklength_size is not enough
+                if(0 == block_index % INIT_LEN) {
+                    blocklength_size += INIT_LEN;
+                    blocklength_proc = (int *)       realloc(blocklength_proc, blocklength_size * sizeof(int));
+                    displs_proc      = (ptrdiff_t *) realloc(displs_proc, blocklength_size * sizeof(ptrdiff_t));
+                }
+                displs_proc[block_index] = (ptrdiff_t) (decoded_iov[*iov_index].iov_base) +
+                                                        *current_position - recv_mem_address;
+            }
+
+            if (remaining >= (decoded_iov[*iov_index].iov_len - *current_position)) {
+                blocklength_proc[block_index] = decoded_iov[*iov_index].iov_len - *current_position;
+
+                remaining = remaining - blocklength_proc[block_index];
+                *iov_index = *iov_index + 1;
+                *current_position = 0;
+            }
+            else {
+                blocklength_proc[block_index] = remaining;
+                *current_position += remaining;
+                remaining = 0;
+            }
+        }
+
+        ompi_datatype_create_hindexed(block_index+1,
+                                      blocklength_proc,
+                                      displs_proc,
+                                      MPI_BYTE,
+                                      &newType);
+        ompi_datatype_commit(&newType);
+
+        ret = MCA_PML_CALL(irecv((char *)recv_mem_address,
+                                 1,
+                                 newType,
+                                 aggregator,
+                                 FCOLL_VULCAN_SHUFFLE_TAG,
+                                 fh->f_comm,
+                                 &recv_req));
+
+        if ( MPI_DATATYPE_NULL != newType ) {
+            ompi_datatype_destroy(&newType);
+        }
+        if (OMPI_SUCCESS != ret){
+            goto exit;
+        }
+    }
+
+    if (aggregator == fh->f_rank){
+        ret = ompi_request_wait_all (fh->f_procs_per_group,
+                                     send_req,
+                                     MPI_STATUS_IGNORE);
+        if (OMPI_SUCCESS != ret){
+            goto exit;
+        }
+    }
+
+    ret = ompi_request_wait (&recv_req, MPI_STATUS_IGNORE);
+
+exit:
+    if (NULL != blocklength_proc) {
+        free (blocklength_proc);
+    }
+    if (NULL != displs_proc) {
+        free (displs_proc);
+    }
+    return ret;
+}
+
+
 static int read_heap_sort (mca_io_ompio_local_io_array *io_array,
                            int num_entries,
                            int *sorted)
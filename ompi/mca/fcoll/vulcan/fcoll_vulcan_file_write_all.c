@@ -1383,6 +1383,16 @@ static int mca_fcoll_vulcan_minmax ( ompio_file_t *fh, struct iovec *iov, int io
       stripe_size++;
     }
 
+    /* With the topology aware grouping the number of aggregators matches the
+    ** striping of the file. Assigning the stripes round-robin to the aggregators
+    ** keeps every aggregator on the same OSTs and never lets two aggregators
+    ** write into the same stripe.
+    */
+    if ( TOPOLOGY_AWARE == OMPIO_MCA_GET(fh, grouping_option) &&
+         fh->f_stripe_count > 1 && fh->f_stripe_size > 0 ) {
+        stripe_size = (long) fh->f_stripe_size;
+    }
+
     *new_stripe_size  = stripe_size;
     //    if ( fh->f_rank == 0 ) 
     //    printf(" partition size is %ld\n", stripe_size);
@@ -46,6 +46,7 @@ int mca_io_ompio_bytes_per_agg = OMPIO_PREALLOC_MAX_BUF_SIZE;
 int mca_io_ompio_num_aggregators = -1;
 int mca_io_ompio_record_offset_info = 0;
 int mca_io_ompio_coll_timing_info = 0;
+int mca_io_ompio_write_behind_size = 0;
 int mca_io_ompio_max_aggregators_ratio=8;
 int mca_io_ompio_aggregators_cutoff_threshold=3;
 int mca_io_ompio_overwrite_amode = 1;
@@ -182,6 +183,18 @@ static int register_component(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &mca_io_ompio_cycle_buffer_size);
 
+    mca_io_ompio_write_behind_size = 0;
+    (void) mca_base_component_var_register(&mca_io_ompio_component.io_version,
+                                           "write_behind_size",
+                                           "Size of the per-file cache used to combine small adjacent "
+                                           "independent writes into larger ones. The cache is written "
+                                           "out when full, on sync, close, and on overlapping reads. "
+                                           "0 disables the cache (default)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_io_ompio_write_behind_size);
+
     mca_io_ompio_bytes_per_agg = OMPIO_PREALLOC_MAX_BUF_SIZE;
     (void) mca_base_component_var_register(&mca_io_ompio_component.io_version,
                                            "bytes_per_agg",
@@ -207,7 +220,8 @@ static int register_component(void)
                                            "Option for grouping of processes in the aggregator selection "
                                            "1: Data volume based grouping 2: maximizing group size uniformity 3: maximimze "
                                            "data contiguity 4: hybrid optimization  5: simple (default) "
-                                           "6: skip refinement step 7: simple+: grouping based on default file view",
+                                           "6: skip refinement step 7: simple+: grouping based on default file view "
+                                           "8: topology aware: aggregators spread across nodes, one per stripe of the file",
                                            MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
                                            OPAL_INFO_LVL_9,
                                            MCA_BASE_VAR_SCOPE_READONLY,
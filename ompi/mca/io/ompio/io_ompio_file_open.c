@@ -132,8 +132,8 @@ int mca_io_ompio_file_preallocate (ompi_file_t *fh,
         OPAL_THREAD_UNLOCK(&fh->f_lock);
         return OMPI_ERROR;
     }
-    ret = data->ompio_fh.f_fs->fs_file_get_size (&data->ompio_fh,
-                                                 &current_size);
+    ret = mca_common_ompio_file_get_size (&data->ompio_fh,
+                                          &current_size);
     if ( OMPI_SUCCESS != ret ) {
         OPAL_THREAD_UNLOCK(&fh->f_lock);
         return OMPI_ERROR;
@@ -205,6 +205,8 @@ int mca_io_ompio_file_preallocate (ompi_file_t *fh,
             }
         }
 
+        ret = mca_common_ompio_wbcache_flush (&data->ompio_fh);
+
         // This operation should not affect file pointer position.
         mca_common_ompio_set_explicit_offset ( &data->ompio_fh, prev_offset);
     }
@@ -251,7 +253,10 @@ int mca_io_ompio_file_set_size (ompi_file_t *fh,
         return OMPI_ERROR;
     }
 
-    ret = data->ompio_fh.f_fs->fs_file_set_size (&data->ompio_fh, size);
+    ret = mca_common_ompio_wbcache_flush (&data->ompio_fh);
+    if ( OMPI_SUCCESS == ret ) {
+        ret = data->ompio_fh.f_fs->fs_file_set_size (&data->ompio_fh, size);
+    }
     if ( OMPI_SUCCESS != ret ) {
         opal_output(1, ",mca_io_ompio_file_set_size: error in fs->set_size\n");
         OPAL_THREAD_UNLOCK(&fh->f_lock);
@@ -335,6 +340,13 @@ int mca_io_ompio_file_set_atomicity (ompi_file_t *fh,
         return OMPI_ERROR;
     }
 
+    /* writes are not cached in atomic mode */
+    ret = mca_common_ompio_wbcache_flush (&data->ompio_fh);
+    if ( OMPI_SUCCESS != ret ) {
+        OPAL_THREAD_UNLOCK(&fh->f_lock);
+        return ret;
+    }
+
     bool result;
     if ( flag ) {
         result = data->ompio_fh.f_fbtl->fbtl_check_atomicity(&data->ompio_fh);
@@ -384,6 +396,11 @@ int mca_io_ompio_file_sync (ompi_file_t *fh)
         OPAL_THREAD_UNLOCK(&fh->f_lock);
         return MPI_ERR_ACCESS;
     }        
+    ret = mca_common_ompio_wbcache_flush (&data->ompio_fh);
+    if ( OMPI_SUCCESS != ret ) {
+        OPAL_THREAD_UNLOCK(&fh->f_lock);
+        return ret;
+    }
     // Make sure all processes reach this point before syncing the file.
     ret = data->ompio_fh.f_comm->c_coll->coll_barrier (data->ompio_fh.f_comm,
                                                        data->ompio_fh.f_comm->c_coll->coll_barrier_module);
@@ -467,8 +484,8 @@ int mca_io_ompio_file_seek (ompi_file_t *fh,
         }
         break;
     case MPI_SEEK_END:
-        ret = data->ompio_fh.f_fs->fs_file_get_size (&data->ompio_fh,
-                                                     &temp_offset2);
+        ret = mca_common_ompio_file_get_size (&data->ompio_fh,
+                                              &temp_offset2);
         mca_io_ompio_file_get_eof_offset (&data->ompio_fh,
                                           temp_offset2, &temp_offset);
         offset += temp_offset;
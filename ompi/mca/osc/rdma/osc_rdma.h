@@ -31,6 +31,7 @@
 #include "opal/class/opal_hash_table.h"
 #include "opal/mca/threads/threads.h"
 #include "opal/util/output.h"
+#include "opal/util/trace.h"
 
 #include "opal/mca/shmem/shmem.h"
 #include "opal/mca/shmem/base/base.h"
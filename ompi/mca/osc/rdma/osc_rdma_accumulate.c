@@ -924,6 +924,9 @@ int ompi_osc_rdma_rget_accumulate_internal (ompi_win_t *win, const void *origin_
         return ret;
     }
 
+    OPAL_TRACE("osc_rdma_accumulate", ompi_comm_peer_vpid(module->comm, peer->rank), target_disp,
+               target_span);
+
     /* to ensure order wait until the previous accumulate completes */
     while (!ompi_osc_rdma_peer_test_set_flag (peer, OMPI_OSC_RDMA_PEER_ACCUMULATING)) {
         ompi_osc_rdma_progress (module);
@@ -481,6 +481,8 @@ int ompi_osc_rdma_complete_atomic (ompi_win_t *win)
 
     OPAL_THREAD_UNLOCK(&(module->lock));
 
+    OPAL_TRACE("osc_rdma_complete_begin", -1, group_size, module->comm->c_contextid);
+
     ompi_osc_rdma_sync_rdma_complete (sync);
 
     /* for each process in the group increment their number of complete messages */
@@ -500,6 +502,7 @@ int ompi_osc_rdma_complete_atomic (ompi_win_t *win)
     ompi_osc_rdma_release_peers (peers, group_size);
 
     OSC_RDMA_VERBOSE(MCA_BASE_VERBOSE_TRACE, "complete complete");
+    OPAL_TRACE("osc_rdma_complete_end", -1, group_size, module->comm->c_contextid);
 
     return OMPI_SUCCESS;
 }
@@ -525,6 +528,7 @@ int ompi_osc_rdma_wait_atomic (ompi_win_t *win)
 
     OSC_RDMA_VERBOSE(MCA_BASE_VERBOSE_TRACE, "waiting on complete message. have %d of %d",
                      (int) state->num_complete_msgs, group_size);
+    OPAL_TRACE("osc_rdma_wait_begin", -1, group_size, module->comm->c_contextid);
 
     while (group_size != state->num_complete_msgs) {
         ompi_osc_rdma_progress (module);
@@ -539,6 +543,7 @@ int ompi_osc_rdma_wait_atomic (ompi_win_t *win)
     OBJ_RELEASE(group);
 
     OSC_RDMA_VERBOSE(MCA_BASE_VERBOSE_TRACE, "wait complete");
+    OPAL_TRACE("osc_rdma_wait_end", -1, group_size, module->comm->c_contextid);
 
     return OMPI_SUCCESS;
 }
@@ -621,6 +626,8 @@ int ompi_osc_rdma_fence_atomic (int mpi_assert, ompi_win_t *win)
      * may be local stores that will not be visible as they should if we do not barrier. since that is the
      * case there is no optimization for NOPRECEDE */
 
+    OPAL_TRACE("osc_rdma_fence_begin", -1, mpi_assert, module->comm->c_contextid);
+
     ompi_osc_rdma_sync_rdma_complete (&module->all_sync);
 
     /* ensure all writes to my memory are complete (both local stores, and RMA operations) */
@@ -633,6 +640,7 @@ int ompi_osc_rdma_fence_atomic (int mpi_assert, ompi_win_t *win)
     }
 
     OSC_RDMA_VERBOSE(MCA_BASE_VERBOSE_TRACE, "fence complete");
+    OPAL_TRACE("osc_rdma_fence_end", -1, mpi_assert, ret);
 
     OPAL_THREAD_UNLOCK(&module->lock);
 
@@ -763,6 +763,8 @@ static inline int ompi_osc_rdma_put_w_req (ompi_osc_rdma_sync_t *sync, const voi
         return ret;
     }
 
+    OPAL_TRACE("osc_rdma_put", ompi_comm_peer_vpid(module->comm, peer->rank), target_disp, len);
+
     /* optimize communication with peers that we can do direct load and store operations on */
     if (ompi_osc_rdma_peer_local_base (peer)) {
         return ompi_osc_rdma_copy_local (origin_addr, origin_count, origin_datatype, (void *) (intptr_t) target_address,
@@ -804,6 +806,9 @@ static inline int ompi_osc_rdma_get_w_req (ompi_osc_rdma_sync_t *sync, void *ori
         return ret;
     }
 
+    OPAL_TRACE("osc_rdma_get", ompi_comm_peer_vpid(module->comm, peer->rank), source_disp,
+               source_span);
+
     /* optimize self/local communication */
     if (ompi_osc_rdma_peer_local_base (peer)) {
         return ompi_osc_rdma_copy_local ((void *) (intptr_t) source_address, source_count, source_datatype,
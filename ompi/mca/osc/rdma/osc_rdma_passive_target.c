@@ -56,10 +56,15 @@ int ompi_osc_rdma_flush (int target, struct ompi_win_t *win)
     }
     OPAL_THREAD_UNLOCK(&module->lock);
 
+    OPAL_TRACE("osc_rdma_flush_begin", ompi_comm_peer_vpid(module->comm, target), 0,
+               module->comm->c_contextid);
+
     /* finish all outstanding fragments */
     ompi_osc_rdma_sync_rdma_complete (lock);
 
     OSC_RDMA_VERBOSE(MCA_BASE_VERBOSE_TRACE, "flush on target %d complete", target);
+    OPAL_TRACE("osc_rdma_flush_end", ompi_comm_peer_vpid(module->comm, target), 0,
+               module->comm->c_contextid);
 
     return OMPI_SUCCESS;
 }
@@ -286,6 +291,9 @@ int ompi_osc_rdma_unlock_atomic (int target, ompi_win_t *win)
 
     ompi_osc_rdma_module_lock_remove (module, lock);
 
+    OPAL_TRACE("osc_rdma_unlock_begin", ompi_comm_peer_vpid(module->comm, target), 0,
+               module->comm->c_contextid);
+
     /* finish all outstanding fragments */
     ompi_osc_rdma_sync_rdma_complete (lock);
 
@@ -297,6 +305,7 @@ int ompi_osc_rdma_unlock_atomic (int target, ompi_win_t *win)
     OBJ_RELEASE(peer);
 
     OSC_RDMA_VERBOSE(MCA_BASE_VERBOSE_TRACE, "unlock %d complete", target);
+    OPAL_TRACE("osc_rdma_unlock_end", ompi_comm_peer_vpid(module->comm, target), 0, ret);
 
     --module->passive_target_access_epoch;
 
@@ -165,6 +165,9 @@ int mca_pml_ob1_enable(bool enable)
     /* missing communicator pending list */
     OBJ_CONSTRUCT(&mca_pml_ob1.non_existing_communicator_pending, opal_list_t);
 
+    /* pack ahead helper thread, started on first use */
+    mca_pml_ob1_pack_ahead_init ();
+
     /**
      * If we get here this is the PML who get selected for the run. We
      * should get ownership for the send and receive requests list, and
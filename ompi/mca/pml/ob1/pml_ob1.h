@@ -41,6 +41,7 @@
 #include "ompi/mca/bml/base/base.h"
 #include "ompi/proc/proc.h"
 #include "opal/mca/allocator/base/base.h"
+#include "opal/mca/threads/threads.h"
 
 BEGIN_C_DECLS
 
@@ -61,10 +62,20 @@ struct mca_pml_ob1_t {
     int max_rdma_per_request;
     int max_send_per_range;
     bool use_all_rdma;
+    size_t pack_ahead_size;     /* size of each pack ahead buffer (0: disabled) */
+    size_t pack_ahead_min;      /* smallest message packed ahead */
 
     /* lock queue access */
     opal_mutex_t lock;
 
+    /* pack ahead helper thread and the requests waiting for it */
+    opal_mutex_t pack_ahead_lock;
+    opal_cond_t pack_ahead_cond;
+    opal_list_t pack_ahead_jobs;
+    opal_thread_t pack_ahead_thread;
+    bool pack_ahead_started;
+    bool pack_ahead_stop;
+
     /* free lists */
     opal_free_list_t rdma_frags;
     opal_free_list_t recv_frags;
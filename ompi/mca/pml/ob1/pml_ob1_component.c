@@ -222,6 +222,21 @@ static int mca_pml_ob1_component_register(void)
                                            "(default: false)", MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
                                            OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_GROUP, &mca_pml_ob1.use_all_rdma);
 
+    mca_pml_ob1.pack_ahead_size = 0;
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "pack_ahead_size",
+                                           "Size of the two buffers used to pack the next part of a large "
+                                           "non-contiguous message in a helper thread while the previous part "
+                                           "is being sent (0: pack each fragment when it is sent, default: 0)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_pml_ob1.pack_ahead_size);
+
+    mca_pml_ob1.pack_ahead_min = 4 * 1024 * 1024;
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "pack_ahead_min",
+                                           "Smallest non-contiguous message packed ahead when "
+                                           "pml_ob1_pack_ahead_size is set (default: 4MiB)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_pml_ob1.pack_ahead_min);
+
     mca_pml_ob1.allocator_name = "bucket";
     (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "allocator",
                                            "Name of allocator component for unexpected messages",
@@ -347,6 +362,8 @@ int mca_pml_ob1_component_fini(void)
         mca_pml_ob1_sendreq = NULL;
     }
 
+    mca_pml_ob1_pack_ahead_finalize ();
+
     OBJ_DESTRUCT(&mca_pml_ob1.rdma_pending);
     OBJ_DESTRUCT(&mca_pml_ob1.pckt_pending);
     OBJ_DESTRUCT(&mca_pml_ob1.recv_pending);
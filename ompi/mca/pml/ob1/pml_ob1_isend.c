@@ -141,6 +141,8 @@ static inline int mca_pml_ob1_send_inline (const void *buf, size_t count,
 	return rc;
     }
 
+    OPAL_TRACE("pml_ob1_send_inline", ompi_comm_peer_vpid(comm, dst), tag, size);
+
     return (int) size;
 }
 
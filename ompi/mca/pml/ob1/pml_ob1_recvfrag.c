@@ -708,6 +708,10 @@ void mca_pml_ob1_recv_frag_callback_ack (mca_btl_base_module_t *btl,
         size = sendreq->req_send.req_bytes_packed - hdr->hdr_ack.hdr_send_offset;
     }
 
+    OPAL_TRACE("pml_ob1_rndv_ack",
+               (int) sendreq->req_send.req_base.req_proc->super.proc_name.vpid,
+               sendreq, hdr->hdr_ack.hdr_send_offset);
+
     mca_pml_ob1_send_request_copy_in_out(sendreq, hdr->hdr_ack.hdr_send_offset, size);
 
     if (sendreq->req_state != 0) {
@@ -1283,6 +1283,9 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
     req->req_ack_sent = false;
 
     MCA_PML_BASE_RECV_START(&req->req_recv);
+    OPAL_TRACE("pml_ob1_recv_post",
+               ompi_comm_peer_vpid(req->req_recv.req_base.req_comm, req->req_recv.req_base.req_peer),
+               req, req->req_recv.req_bytes_packed);
 
     OB1_MATCHING_LOCK(&ob1_comm->matching_lock);
     /**
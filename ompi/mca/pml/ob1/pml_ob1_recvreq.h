@@ -35,6 +35,7 @@
 #include "ompi/proc/proc.h"
 #include "ompi/mca/pml/ob1/pml_ob1_comm.h"
 #include "opal/mca/mpool/base/base.h"
+#include "opal/util/trace.h"
 #include "ompi/mca/pml/base/pml_base_recvreq.h"
 
 BEGIN_C_DECLS
@@ -126,6 +127,10 @@ do {                                                                \
     do {                                                                              \
         PERUSE_TRACE_COMM_EVENT( PERUSE_COMM_REQ_COMPLETE,                            \
                                  &(recvreq->req_recv.req_base), PERUSE_RECV );        \
+        OPAL_TRACE("pml_ob1_recv_complete",                                           \
+                   ompi_comm_peer_vpid((recvreq)->req_recv.req_base.req_comm,         \
+                       (recvreq)->req_recv.req_base.req_ompi.req_status.MPI_SOURCE),  \
+                   (recvreq), (recvreq)->req_bytes_received);                         \
         ompi_request_complete( &(recvreq->req_recv.req_base.req_ompi), true );        \
     } while (0)
 
@@ -248,6 +253,8 @@ static inline void recv_req_matched(mca_pml_ob1_recv_request_t *req,
     req->req_recv.req_base.req_ompi.req_status.MPI_SOURCE = hdr->hdr_src;
     req->req_recv.req_base.req_ompi.req_status.MPI_TAG = hdr->hdr_tag;
     req->req_match_received = true;
+    OPAL_TRACE("pml_ob1_recv_match", ompi_comm_peer_vpid(req->req_recv.req_base.req_comm, hdr->hdr_src),
+               req, hdr->hdr_tag);
 
     opal_atomic_wmb();
 
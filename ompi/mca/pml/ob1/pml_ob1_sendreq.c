@@ -175,6 +175,7 @@ static void mca_pml_ob1_send_request_construct(mca_pml_ob1_send_request_t* req)
     req->req_rdma_cnt = 0;
     req->req_throttle_sends = false;
     req->rdma_frag = NULL;
+    req->req_pack_ahead = NULL;
     OBJ_CONSTRUCT(&req->req_send_ranges, opal_list_t);
     OBJ_CONSTRUCT(&req->req_send_range_lock, opal_mutex_t);
 }
@@ -184,6 +185,7 @@ static void mca_pml_ob1_send_request_destruct(mca_pml_ob1_send_request_t* req)
     OBJ_DESTRUCT(&req->req_send_ranges);
     OBJ_DESTRUCT(&req->req_send_range_lock);
     assert( NULL == req->rdma_frag );
+    assert( NULL == req->req_pack_ahead );
 }
 
 OBJ_CLASS_INSTANCE( mca_pml_ob1_send_request_t,
@@ -1028,6 +1030,311 @@ get_next_send_range(mca_pml_ob1_send_request_t* sendreq,
     return range;
 }
 
+static void mca_pml_ob1_pack_ahead_construct (mca_pml_ob1_pack_ahead_t *pa)
+{
+    OBJ_CONSTRUCT(&pa->pa_convertor, opal_convertor_t);
+    pa->pa_request = NULL;
+    pa->pa_total = pa->pa_sent = 0;
+    pa->pa_packing = NULL;
+    pa->pa_queued = pa->pa_packed = pa->pa_stop = false;
+    for (int i = 0 ; i < MCA_PML_OB1_PACK_AHEAD_SLOTS ; ++i) {
+        mca_pml_ob1_pack_slot_t *slot = pa->pa_slots + i;
+
+        slot->slot_owner = pa;
+        slot->slot_buffer = NULL;
+        slot->slot_offset = slot->slot_length = 0;
+        slot->slot_pending = 0;
+        OBJ_CONSTRUCT(&slot->slot_convertor, opal_convertor_t);
+    }
+}
+
+static void mca_pml_ob1_pack_ahead_destruct (mca_pml_ob1_pack_ahead_t *pa)
+{
+    assert (!pa->pa_queued);
+    for (int i = 0 ; i < MCA_PML_OB1_PACK_AHEAD_SLOTS ; ++i) {
+        OBJ_DESTRUCT(&pa->pa_slots[i].slot_convertor);
+        free (pa->pa_slots[i].slot_buffer);
+    }
+    OBJ_DESTRUCT(&pa->pa_convertor);
+}
+
+OBJ_CLASS_INSTANCE(mca_pml_ob1_pack_ahead_t, opal_list_item_t,
+                   mca_pml_ob1_pack_ahead_construct,
+                   mca_pml_ob1_pack_ahead_destruct);
+
+/**
+ * Body of the helper thread: pack the pa_packing slot of the requests
+ * queued on pack_ahead_jobs, in order.
+ */
+static void *mca_pml_ob1_pack_ahead_run (opal_object_t *arg)
+{
+    opal_mutex_lock (&mca_pml_ob1.pack_ahead_lock);
+    while (!mca_pml_ob1.pack_ahead_stop) {
+        mca_pml_ob1_pack_ahead_t *pa;
+        mca_pml_ob1_pack_slot_t *slot;
+
+        pa = (mca_pml_ob1_pack_ahead_t *) opal_list_remove_first (&mca_pml_ob1.pack_ahead_jobs);
+        if (NULL == pa) {
+            opal_cond_wait (&mca_pml_ob1.pack_ahead_cond, &mca_pml_ob1.pack_ahead_lock);
+            continue;
+        }
+        pa->pa_queued = false;
+        slot = pa->pa_packing;
+
+        if (!pa->pa_stop) {
+            struct iovec iov;
+            uint32_t iov_count = 1;
+            size_t max_data;
+
+            opal_mutex_unlock (&mca_pml_ob1.pack_ahead_lock);
+            iov.iov_base = slot->slot_buffer;
+            iov.iov_len = max_data = mca_pml_ob1.pack_ahead_size;
+            (void) opal_convertor_pack (&pa->pa_convertor, &iov, &iov_count, &max_data);
+            slot->slot_length = max_data;
+            opal_mutex_lock (&mca_pml_ob1.pack_ahead_lock);
+        }
+
+        pa->pa_packed = true;
+        opal_cond_broadcast (&mca_pml_ob1.pack_ahead_cond);
+        /* the reference of the queue */
+        OBJ_RELEASE(pa);
+    }
+    opal_mutex_unlock (&mca_pml_ob1.pack_ahead_lock);
+    return NULL;
+}
+
+void mca_pml_ob1_pack_ahead_init (void)
+{
+    OBJ_CONSTRUCT(&mca_pml_ob1.pack_ahead_lock, opal_mutex_t);
+    opal_cond_init (&mca_pml_ob1.pack_ahead_cond);
+    OBJ_CONSTRUCT(&mca_pml_ob1.pack_ahead_jobs, opal_list_t);
+    OBJ_CONSTRUCT(&mca_pml_ob1.pack_ahead_thread, opal_thread_t);
+    mca_pml_ob1.pack_ahead_started = mca_pml_ob1.pack_ahead_stop = false;
+}
+
+void mca_pml_ob1_pack_ahead_finalize (void)
+{
+    mca_pml_ob1_pack_ahead_t *pa;
+
+    if (mca_pml_ob1.pack_ahead_started) {
+        opal_mutex_lock (&mca_pml_ob1.pack_ahead_lock);
+        mca_pml_ob1.pack_ahead_stop = true;
+        opal_cond_broadcast (&mca_pml_ob1.pack_ahead_cond);
+        opal_mutex_unlock (&mca_pml_ob1.pack_ahead_lock);
+        opal_thread_join (&mca_pml_ob1.pack_ahead_thread, NULL);
+        mca_pml_ob1.pack_ahead_started = false;
+    }
+    while (NULL != (pa = (mca_pml_ob1_pack_ahead_t *) opal_list_remove_first (&mca_pml_ob1.pack_ahead_jobs))) {
+        pa->pa_queued = false;
+        OBJ_RELEASE(pa);
+    }
+    OBJ_DESTRUCT(&mca_pml_ob1.pack_ahead_thread);
+    OBJ_DESTRUCT(&mca_pml_ob1.pack_ahead_jobs);
+    opal_cond_destroy (&mca_pml_ob1.pack_ahead_cond);
+    OBJ_DESTRUCT(&mca_pml_ob1.pack_ahead_lock);
+}
+
+static bool mca_pml_ob1_pack_ahead_packed (mca_pml_ob1_pack_ahead_t *pa)
+{
+    bool packed;
+
+    opal_mutex_lock (&mca_pml_ob1.pack_ahead_lock);
+    packed = pa->pa_packed;
+    opal_mutex_unlock (&mca_pml_ob1.pack_ahead_lock);
+    return packed;
+}
+
+/**
+ * Wait for the helper thread to fill pa_packing. The packed bytes are exposed
+ * through a contiguous convertor, which BTLs may send without any further copy.
+ */
+static void mca_pml_ob1_pack_ahead_wait (mca_pml_ob1_pack_ahead_t *pa)
+{
+    mca_pml_ob1_pack_slot_t *slot = pa->pa_packing;
+
+    opal_mutex_lock (&mca_pml_ob1.pack_ahead_lock);
+    while (!pa->pa_packed) {
+        opal_cond_wait (&mca_pml_ob1.pack_ahead_cond, &mca_pml_ob1.pack_ahead_lock);
+    }
+    pa->pa_packing = NULL;
+    opal_mutex_unlock (&mca_pml_ob1.pack_ahead_lock);
+    if (OPAL_UNLIKELY(0 == slot->slot_length)) {
+        /* nothing could be packed, fall back on packing each fragment */
+        pa->pa_total = 0;
+        return;
+    }
+    opal_convertor_cleanup (&slot->slot_convertor);
+    opal_convertor_copy_and_prepare_for_send (ompi_mpi_local_convertor, &opal_datatype_uint1,
+                                              slot->slot_length, slot->slot_buffer, 0,
+                                              &slot->slot_convertor);
+}
+
+/**
+ * Recycle the slots the fragments went past and that completed, and queue
+ * a free slot for the helper thread if none is being packed.
+ */
+static void mca_pml_ob1_pack_ahead_fill (mca_pml_ob1_pack_ahead_t *pa)
+{
+    if (NULL != pa->pa_packing || pa->pa_convertor.bConverted >= pa->pa_total) {
+        return;
+    }
+
+    for (int i = 0 ; i < MCA_PML_OB1_PACK_AHEAD_SLOTS ; ++i) {
+        mca_pml_ob1_pack_slot_t *slot = pa->pa_slots + i;
+
+        if (0 != slot->slot_length) {
+            if (pa->pa_sent < slot->slot_offset + slot->slot_length || 0 != slot->slot_pending) {
+                continue;
+            }
+            slot->slot_length = 0;
+        }
+
+        slot->slot_offset = pa->pa_convertor.bConverted;
+        opal_mutex_lock (&mca_pml_ob1.pack_ahead_lock);
+        if (!mca_pml_ob1.pack_ahead_started) {
+            mca_pml_ob1.pack_ahead_thread.t_run = mca_pml_ob1_pack_ahead_run;
+            if (OPAL_UNLIKELY(OPAL_SUCCESS != opal_thread_start (&mca_pml_ob1.pack_ahead_thread))) {
+                opal_mutex_unlock (&mca_pml_ob1.pack_ahead_lock);
+                /* no helper thread, the request is packed as usual */
+                pa->pa_total = 0;
+                return;
+            }
+            mca_pml_ob1.pack_ahead_started = true;
+        }
+        pa->pa_packing = slot;
+        pa->pa_packed = false;
+        pa->pa_queued = true;
+        OBJ_RETAIN(pa);
+        opal_list_append (&mca_pml_ob1.pack_ahead_jobs, &pa->super);
+        opal_cond_broadcast (&mca_pml_ob1.pack_ahead_cond);
+        opal_mutex_unlock (&mca_pml_ob1.pack_ahead_lock);
+        return;
+    }
+}
+
+static mca_pml_ob1_pack_ahead_t *
+mca_pml_ob1_pack_ahead_create (mca_pml_ob1_send_request_t *sendreq, size_t offset)
+{
+    opal_convertor_t *convertor = &sendreq->req_send.req_base.req_convertor;
+    mca_pml_ob1_pack_ahead_t *pa;
+    size_t position = offset;
+
+    pa = OBJ_NEW(mca_pml_ob1_pack_ahead_t);
+    if (OPAL_UNLIKELY(NULL == pa)) {
+        return NULL;
+    }
+    pa->pa_request = sendreq;
+    sendreq->req_pack_ahead = pa;
+
+    opal_convertor_clone (convertor, &pa->pa_convertor, 0);
+    opal_convertor_set_position (&pa->pa_convertor, &position);
+    if (OPAL_UNLIKELY(position != offset)) {
+        /* pa_total is left at 0, the request is packed as usual */
+        return pa;
+    }
+    for (int i = 0 ; i < MCA_PML_OB1_PACK_AHEAD_SLOTS ; ++i) {
+        pa->pa_slots[i].slot_buffer = (unsigned char *) malloc (mca_pml_ob1.pack_ahead_size);
+        if (OPAL_UNLIKELY(NULL == pa->pa_slots[i].slot_buffer)) {
+            return pa;
+        }
+    }
+    pa->pa_total = sendreq->req_send.req_bytes_packed;
+    return pa;
+}
+
+/**
+ * Find the pack ahead slot holding the data at OFFSET, starting the pack
+ * ahead for large non-contiguous messages. Returns NULL if the fragment has
+ * to be packed from the user buffer.
+ */
+static mca_pml_ob1_pack_slot_t *
+mca_pml_ob1_pack_ahead_slot (mca_pml_ob1_send_request_t *sendreq, size_t offset)
+{
+    opal_convertor_t *convertor = &sendreq->req_send.req_base.req_convertor;
+    mca_pml_ob1_pack_ahead_t *pa = sendreq->req_pack_ahead;
+
+    if (NULL == pa) {
+        if (OPAL_LIKELY(0 == mca_pml_ob1.pack_ahead_size ||
+                        sendreq->req_send.req_bytes_packed < mca_pml_ob1.pack_ahead_min ||
+                        !opal_convertor_need_buffers (convertor) ||
+                        (convertor->flags & (CONVERTOR_CUDA | CONVERTOR_WITH_CHECKSUM)))) {
+            return NULL;
+        }
+        pa = mca_pml_ob1_pack_ahead_create (sendreq, offset);
+        if (OPAL_UNLIKELY(NULL == pa)) {
+            return NULL;
+        }
+    }
+    if (0 == pa->pa_total) {
+        return NULL;
+    }
+
+    mca_pml_ob1_pack_ahead_fill (pa);
+    if (NULL != pa->pa_packing) {
+        mca_pml_ob1_pack_slot_t *slot = pa->pa_packing;
+
+        /* collect the slot once packed, or wait for it if the pipeline is
+         * stalled, then keep the helper busy */
+        if (mca_pml_ob1_pack_ahead_packed (pa) ||
+            (offset >= slot->slot_offset && offset < slot->slot_offset + mca_pml_ob1.pack_ahead_size)) {
+            mca_pml_ob1_pack_ahead_wait (pa);
+            if (0 == pa->pa_total) {
+                return NULL;
+            }
+            mca_pml_ob1_pack_ahead_fill (pa);
+        }
+    }
+    for (int i = 0 ; i < MCA_PML_OB1_PACK_AHEAD_SLOTS ; ++i) {
+        mca_pml_ob1_pack_slot_t *slot = pa->pa_slots + i;
+
+        if (slot != pa->pa_packing && 0 != slot->slot_length &&
+            offset >= slot->slot_offset && offset < slot->slot_offset + slot->slot_length) {
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Completion of a fragment built from a pack ahead slot.
+ */
+static void
+mca_pml_ob1_frag_pack_ahead_completion( mca_btl_base_module_t* btl,
+                                        struct mca_btl_base_endpoint_t* ep,
+                                        struct mca_btl_base_descriptor_t* des,
+                                        int status )
+{
+    mca_pml_ob1_pack_slot_t *slot = (mca_pml_ob1_pack_slot_t *) des->des_cbdata;
+    mca_pml_ob1_pack_ahead_t *pa = slot->slot_owner;
+
+    des->des_cbdata = pa->pa_request;
+    OPAL_THREAD_ADD_FETCH32(&slot->slot_pending, -1);
+    mca_pml_ob1_frag_completion (btl, ep, des, status);
+    OBJ_RELEASE(pa);
+}
+
+void mca_pml_ob1_pack_ahead_fini (mca_pml_ob1_send_request_t *sendreq)
+{
+    mca_pml_ob1_pack_ahead_t *pa = sendreq->req_pack_ahead;
+
+    /* a slot is sent only once packed, so the helper thread is done with a
+     * request that completed normally. Do not wait for it anyway: a queued
+     * slot is dropped, and one being packed keeps its reference until the
+     * helper thread is done with it */
+    opal_mutex_lock (&mca_pml_ob1.pack_ahead_lock);
+    pa->pa_stop = true;
+    if (pa->pa_queued) {
+        opal_list_remove_item (&mca_pml_ob1.pack_ahead_jobs, &pa->super);
+        pa->pa_queued = false;
+        OBJ_RELEASE(pa);
+    }
+    pa->pa_packing = NULL;
+    opal_mutex_unlock (&mca_pml_ob1.pack_ahead_lock);
+    sendreq->req_pack_ahead = NULL;
+    /* fragments still in flight keep the buffers alive */
+    OBJ_RELEASE(pa);
+}
+
 /**
  *  Schedule pipeline of send descriptors for the given request.
  *  Up to the rdma threshold. If this is a send based protocol,
@@ -1057,6 +1364,8 @@ mca_pml_ob1_send_request_schedule_once(mca_pml_ob1_send_request_t* sendreq)
         int rc, btl_idx;
         size_t size, offset, data_remaining = 0;
         mca_bml_base_btl_t* bml_btl;
+        mca_pml_ob1_pack_slot_t* slot;
+        opal_convertor_t* convertor;
 
         assert(range->range_send_length != 0);
 
@@ -1108,11 +1417,21 @@ cannot_pack:
             }
         }
 
-        /* pack into a descriptor */
+        /* pack into a descriptor, or take the data already packed ahead */
         offset = (size_t)range->range_send_offset;
-        opal_convertor_set_position(&sendreq->req_send.req_base.req_convertor,
-                                    &offset);
-        range->range_send_offset = (uint64_t)offset;
+        slot = mca_pml_ob1_pack_ahead_slot(sendreq, offset);
+        if(NULL != slot) {
+            convertor = &slot->slot_convertor;
+            offset -= slot->slot_offset;
+            if(size > slot->slot_length - offset) {
+                size = slot->slot_length - offset;
+            }
+            opal_convertor_set_position(convertor, &offset);
+        } else {
+            convertor = &sendreq->req_send.req_base.req_convertor;
+            opal_convertor_set_position(convertor, &offset);
+            range->range_send_offset = (uint64_t)offset;
+        }
 
         data_remaining = size;
         MEMCHECKER(
@@ -1121,7 +1440,7 @@ cannot_pack:
                             sendreq->req_send.req_base.req_count,
                             sendreq->req_send.req_base.req_datatype);
         );
-        mca_bml_base_prepare_src(bml_btl, &sendreq->req_send.req_base.req_convertor,
+        mca_bml_base_prepare_src(bml_btl, convertor,
                                  MCA_BTL_NO_ORDER, sizeof(mca_pml_ob1_frag_hdr_t),
                                  &size, MCA_BTL_DES_FLAGS_BTL_OWNERSHIP | MCA_BTL_DES_SEND_ALWAYS_CALLBACK |
                                  MCA_BTL_DES_FLAGS_SIGNAL, &des);
@@ -1185,10 +1504,22 @@ cannot_pack:
         }
 #endif /* OPAL_CUDA_SUPPORT */
 
+        if(NULL != slot) {
+            /* the slot can only be reused once this fragment completed */
+            des->des_cbfunc = mca_pml_ob1_frag_pack_ahead_completion;
+            des->des_cbdata = slot;
+            OPAL_THREAD_ADD_FETCH32(&slot->slot_pending, 1);
+            OBJ_RETAIN(slot->slot_owner);
+        }
+
         /* initiate send - note that this may complete before the call returns */
         rc = mca_bml_base_send(bml_btl, des, MCA_PML_OB1_HDR_TYPE_FRAG);
         if( OPAL_LIKELY(rc >= 0) ) {
             /* update state */
+            if(NULL != sendreq->req_pack_ahead &&
+               sendreq->req_pack_ahead->pa_sent < range->range_send_offset + size) {
+                sendreq->req_pack_ahead->pa_sent = range->range_send_offset + size;
+            }
             range->range_btls[btl_idx].length -= size;
             range->range_send_length -= size;
             range->range_send_offset += size;
@@ -1199,6 +1530,10 @@ cannot_pack:
             }
         } else {
             mca_bml_base_free(bml_btl,des);
+            if(NULL != slot) {
+                OPAL_THREAD_ADD_FETCH32(&slot->slot_pending, -1);
+                OBJ_RELEASE(slot->slot_owner);
+            }
         }
     }
 
@@ -27,6 +27,8 @@
 
 #include "opal/datatype/opal_convertor.h"
 #include "opal/mca/mpool/base/base.h"
+#include "opal/mca/threads/threads.h"
+#include "opal/util/trace.h"
 #include "ompi/mca/pml/base/pml_base_sendreq.h"
 #include "pml_ob1_comm.h"
 #include "pml_ob1_hdr.h"
@@ -43,6 +45,8 @@ typedef enum {
     MCA_PML_OB1_SEND_PENDING_START
 } mca_pml_ob1_send_pending_t;
 
+struct mca_pml_ob1_pack_ahead_t;
+
 struct mca_pml_ob1_send_request_t {
     mca_pml_base_send_request_t req_send;
     mca_bml_base_endpoint_t* req_endpoint;
@@ -56,6 +60,7 @@ struct mca_pml_ob1_send_request_t {
     mca_pml_ob1_send_pending_t req_pending;
     opal_mutex_t req_send_range_lock;
     opal_list_t req_send_ranges;
+    struct mca_pml_ob1_pack_ahead_t *req_pack_ahead;
     mca_pml_ob1_rdma_frag_t *rdma_frag;
     /** The size of this array is set from mca_pml_ob1.max_rdma_per_request */
     mca_pml_ob1_com_btl_t req_rdma[];
@@ -76,6 +81,55 @@ struct mca_pml_ob1_send_range_t {
 typedef struct mca_pml_ob1_send_range_t mca_pml_ob1_send_range_t;
 OBJ_CLASS_DECLARATION(mca_pml_ob1_send_range_t);
 
+/**
+ * Double buffering of the pack of large non-contiguous messages (see the
+ * pml_ob1_pack_ahead_size MCA parameter). While the fragments built from one
+ * slot are in flight, a helper thread packs the next part of the message in
+ * the other slot. The fragments are then built from the packed data through
+ * a contiguous convertor. A single helper thread, started with the first
+ * slot of any request and stopped with the PML, takes the slots to pack
+ * from the pack_ahead_jobs queue of mca_pml_ob1.
+ */
+#define MCA_PML_OB1_PACK_AHEAD_SLOTS 2
+
+struct mca_pml_ob1_pack_slot_t {
+    struct mca_pml_ob1_pack_ahead_t *slot_owner;
+    unsigned char *slot_buffer;
+    size_t slot_offset;                 /**< offset of the packed data in the message */
+    size_t slot_length;                 /**< packed bytes, 0 if the slot is free */
+    opal_atomic_int32_t slot_pending;   /**< descriptors not yet completed */
+    opal_convertor_t slot_convertor;    /**< contiguous convertor over the packed bytes */
+};
+typedef struct mca_pml_ob1_pack_slot_t mca_pml_ob1_pack_slot_t;
+
+struct mca_pml_ob1_pack_ahead_t {
+    opal_list_item_t super;             /**< queued on pack_ahead_jobs */
+    mca_pml_ob1_send_request_t *pa_request;
+    opal_convertor_t pa_convertor;      /**< walks the user data, in order */
+    size_t pa_total;                    /**< bytes to pack, 0 once pack ahead gave up */
+    size_t pa_sent;                     /**< end of the data given to the BTLs so far */
+    /* the fields below are protected by mca_pml_ob1.pack_ahead_lock */
+    mca_pml_ob1_pack_slot_t *pa_packing; /**< slot being filled by the helper thread */
+    bool pa_queued;                     /**< on pack_ahead_jobs, the queue holds a reference */
+    bool pa_packed;                     /**< the helper thread is done with pa_packing */
+    bool pa_stop;                       /**< the request completed, do not pack anymore */
+    mca_pml_ob1_pack_slot_t pa_slots[MCA_PML_OB1_PACK_AHEAD_SLOTS];
+};
+typedef struct mca_pml_ob1_pack_ahead_t mca_pml_ob1_pack_ahead_t;
+OBJ_CLASS_DECLARATION(mca_pml_ob1_pack_ahead_t);
+
+/**
+ * Detach a request from the helper thread and drop its pack ahead
+ * buffers. It does not wait for the helper thread.
+ */
+void mca_pml_ob1_pack_ahead_fini (mca_pml_ob1_send_request_t *sendreq);
+
+/**
+ * Set up and tear down the helper thread and its queue.
+ */
+void mca_pml_ob1_pack_ahead_init (void);
+void mca_pml_ob1_pack_ahead_finalize (void);
+
 static inline bool lock_send_request(mca_pml_ob1_send_request_t *sendreq)
 {
     return OPAL_THREAD_ADD_FETCH32(&sendreq->req_lock,  1) == 1;
@@ -208,6 +262,9 @@ do {
         (sendreq)->req_send.req_bytes_packed;                                        \
    PERUSE_TRACE_COMM_EVENT( PERUSE_COMM_REQ_COMPLETE,                                \
                             &(sendreq->req_send.req_base), PERUSE_SEND);             \
+   OPAL_TRACE("pml_ob1_send_complete",                                               \
+              (int) (sendreq)->req_send.req_base.req_proc->super.proc_name.vpid,     \
+              (sendreq), (sendreq)->req_send.req_bytes_packed);                      \
                                                                                      \
    ompi_request_complete( &((sendreq)->req_send.req_base.req_ompi), (with_signal) ); \
 } while(0)
@@ -262,6 +319,10 @@ send_request_pml_complete(mca_pml_ob1_send_request_t *sendreq)
         /* return mpool resources */
         mca_pml_ob1_free_rdma_resources(sendreq);
 
+        if (NULL != sendreq->req_pack_ahead) {
+            mca_pml_ob1_pack_ahead_fini (sendreq);
+        }
+
         if (sendreq->req_send.req_send_mode == MCA_PML_BASE_SEND_BUFFERED &&
             sendreq->req_send.req_addr != sendreq->req_send.req_base.req_addr) {
             mca_pml_base_bsend_request_fini((ompi_request_t*)sendreq);
@@ -467,6 +528,9 @@ mca_pml_ob1_send_request_start_seq (mca_pml_ob1_send_request_t* sendreq, mca_bml
     sendreq->req_send.req_base.req_sequence = seqn;
 
     MCA_PML_BASE_SEND_START( &sendreq->req_send );
+    OPAL_TRACE("pml_ob1_send_post",
+               (int) sendreq->req_send.req_base.req_proc->super.proc_name.vpid,
+               sendreq, sendreq->req_send.req_bytes_packed);
 
     for(size_t i = 0; i < mca_bml_base_btl_array_get_size(&endpoint->btl_eager); i++) {
         mca_bml_base_btl_t* bml_btl;
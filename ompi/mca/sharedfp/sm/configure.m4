@@ -27,21 +27,11 @@
 AC_DEFUN([MCA_ompi_sharedfp_sm_CONFIG],[
     AC_CONFIG_FILES([ompi/mca/sharedfp/sm/Makefile])
 
+    dnl the shared file pointer lives in a mmap'ed file and is
+    dnl advanced with atomic operations, no semaphores are required
     sharedfp_sm_happy=no
-    AC_CHECK_HEADER([semaphore.h],
-                    [dnl requires potentially pthread library
-                     OPAL_SEARCH_LIBS_COMPONENT([sharedfp_sm],
-                                    [sem_open], [pthread],
-                                    [AC_CHECK_FUNCS([sem_open],
-                                                    [sharedfp_sm_happy="yes"],[])]
-                                                )])
-    AC_CHECK_HEADER([semaphore.h],
-                    [dnl requires potentially pthread library
-                     OPAL_SEARCH_LIBS_COMPONENT([sharedfp_sm],
-                                    [sem_init], [pthread],
-                                    [AC_CHECK_FUNCS([sem_init],
-                                                    [sharedfp_sm_happy="yes"],[])]
-                                                )])
+    AC_CHECK_HEADER([sys/mman.h],
+                    [AC_CHECK_FUNCS([mmap], [sharedfp_sm_happy="yes"], [])])
     AS_IF([test "$sharedfp_sm_happy" = "yes"],
           [$1],
           [$2])
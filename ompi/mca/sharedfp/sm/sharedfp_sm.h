@@ -28,7 +28,7 @@
 #include "ompi/mca/mca.h"
 #include "ompi/mca/sharedfp/sharedfp.h"
 #include "ompi/mca/common/ompio/common_ompio.h"
-#include <semaphore.h>
+#include "opal/sys/atomic.h"
 
 BEGIN_C_DECLS
 
@@ -105,8 +105,9 @@ int mca_sharedfp_sm_iwrite (ompio_file_t *fh,
  *Structures and definitions only for this component
  *--------------------------------------------------------------*/
 struct mca_sharedfp_sm_offset{
-    sem_t mutex;      /* the mutex: a POSIX memory-based unnamed semaphore */
-    long long offset;  /* and the shared file pointer offset */
+    /* the shared file pointer offset. It is only ever advanced with an
+       atomic fetch-add, so no lock is required to request a position. */
+    opal_atomic_int64_t offset;
 };
 
 /*This structure will hang off of the mca_sharedfp_base_data_t's
@@ -117,11 +118,6 @@ struct mca_sharedfp_sm_data
     struct mca_sharedfp_sm_offset * sm_offset_ptr;
     /*save filename so that we can remove the file on close*/
     char * sm_filename;
-    /* The mutex: it will either point to a POSIX memory-based named
-       semaphore, or it will point to the a POSIX memory-based unnamed
-       semaphore located in sm_offset_ptr->mutex. */
-    sem_t *mutex;
-    char *sem_name;    /* Name of the semaphore */
 };
 
 typedef struct mca_sharedfp_sm_data sm_data;
@@ -130,6 +126,12 @@ typedef struct mca_sharedfp_sm_data sm_data;
 int mca_sharedfp_sm_request_position (ompio_file_t *fh,
                                       int bytes_requested,
                                       OMPI_MPI_OFFSET_TYPE * offset);
+/* Collective version used by the ordered operations: every process
+** gets the offset following the data of all lower ranks.
+*/
+int mca_sharedfp_sm_request_position_ordered (ompio_file_t *fh,
+                                              OMPI_MPI_OFFSET_TYPE bytes_requested,
+                                              OMPI_MPI_OFFSET_TYPE * offset);
 /*
  * ******************************************************************
  * ************ functions implemented in this module end ************
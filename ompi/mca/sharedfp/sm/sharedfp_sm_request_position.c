@@ -27,66 +27,77 @@
 #include "ompi/mca/sharedfp/sharedfp.h"
 #include "ompi/mca/sharedfp/base/base.h"
 
-/*use a semaphore to lock the shared memory*/
-#include <semaphore.h>
-
 int mca_sharedfp_sm_request_position(ompio_file_t *fh, 
                                      int bytes_requested,
                                      OMPI_MPI_OFFSET_TYPE *offset)
 {
-    int ret = OMPI_SUCCESS;
-    OMPI_MPI_OFFSET_TYPE position = 0;
-    OMPI_MPI_OFFSET_TYPE old_offset;
     struct mca_sharedfp_sm_data * sm_data = NULL;
-    struct mca_sharedfp_sm_offset * sm_offset_ptr = NULL;
     struct mca_sharedfp_base_data_t *sh = NULL;
 
     sh = fh->f_sharedfp_data;
     sm_data = sh->selected_module_data;
 
-    *offset = 0;
+    /* A single fetch-add on the shared memory segment both reads the
+    ** current position and advances it, so concurrent requests of
+    ** the processes on the node never serialize on a lock.
+    */
+    *offset = opal_atomic_fetch_add_64 (&sm_data->sm_offset_ptr->offset,
+                                        (int64_t) bytes_requested);
     if ( mca_sharedfp_sm_verbose ) {
         opal_output(ompi_sharedfp_base_framework.framework_output,
-                    "Aquiring lock, rank=%d...",fh->f_rank);
+                    "rank=%d: old_offset=%lld, bytes_requested=%d, new offset=%lld!\n",
+                    fh->f_rank, *offset, bytes_requested, *offset + bytes_requested);
     }
 
-    sm_offset_ptr = sm_data->sm_offset_ptr;
+    return OMPI_SUCCESS;
+}
 
-    /* Aquire an exclusive lock */
+int mca_sharedfp_sm_request_position_ordered(ompio_file_t *fh,
+                                             OMPI_MPI_OFFSET_TYPE bytes_requested,
+                                             OMPI_MPI_OFFSET_TYPE *offset)
+{
+    int ret = OMPI_SUCCESS;
+    int last = fh->f_size - 1;
+    OMPI_MPI_OFFSET_TYPE prefix = 0, base = 0;
+    struct mca_sharedfp_sm_data * sm_data = NULL;
+    struct mca_sharedfp_base_data_t *sh = NULL;
 
-    sem_wait(sm_data->mutex);
+    sh = fh->f_sharedfp_data;
+    sm_data = sh->selected_module_data;
 
-    if ( mca_sharedfp_sm_verbose ) {
-        opal_output(ompi_sharedfp_base_framework.framework_output,
-                    "Succeeded! Acquired sm lock.for rank=%d\n",fh->f_rank);
+    /* The position of each process within the block accessed by the
+    ** ordered operation is the sum of the bytes of all lower ranks.
+    */
+    ret = fh->f_comm->c_coll->coll_exscan ( &bytes_requested, &prefix, 1, OMPI_OFFSET_DATATYPE,
+                                            MPI_SUM, fh->f_comm,
+                                            fh->f_comm->c_coll->coll_exscan_module );
+    if ( OMPI_SUCCESS != ret ) {
+        return ret;
     }
-
-    old_offset=sm_offset_ptr->offset;
-    if ( mca_sharedfp_sm_verbose ) {
-        opal_output(ompi_sharedfp_base_framework.framework_output,
-                    "Read last_offset=%lld!\n",old_offset);
+    /* the receive buffer of the first process is undefined after exscan */
+    if ( 0 == fh->f_rank ) {
+        prefix = 0;
     }
 
-    position = old_offset + bytes_requested;
-    if ( mca_sharedfp_sm_verbose ) {
-        opal_output(ompi_sharedfp_base_framework.framework_output,
-                    "old_offset=%lld, bytes_requested=%d, new offset=%lld!\n",old_offset,bytes_requested,position);
+    /* The last process knows the size of the whole block, it moves the
+    ** shared file pointer once and tells the others where the block starts.
+    */
+    if ( last == fh->f_rank ) {
+        base = opal_atomic_fetch_add_64 (&sm_data->sm_offset_ptr->offset,
+                                         (int64_t) (prefix + bytes_requested));
     }
-    sm_offset_ptr->offset=position;
-
-
-    if ( mca_sharedfp_sm_verbose ) {
-        opal_output(ompi_sharedfp_base_framework.framework_output,
-                    "Releasing sm lock...rank=%d",fh->f_rank);
+    ret = fh->f_comm->c_coll->coll_bcast ( &base, 1, OMPI_OFFSET_DATATYPE, last,
+                                           fh->f_comm, fh->f_comm->c_coll->coll_bcast_module );
+    if ( OMPI_SUCCESS != ret ) {
+        return ret;
     }
 
-    sem_post(sm_data->mutex);
+    *offset = base + prefix;
     if ( mca_sharedfp_sm_verbose ) {
         opal_output(ompi_sharedfp_base_framework.framework_output,
-                    "Released lock! released lock.for rank=%d\n",fh->f_rank);
+                    "rank=%d: ordered block starts at %lld, own offset=%lld\n",
+                    fh->f_rank, base, *offset);
     }
 
-    *offset = old_offset;
-
     return ret;
 }
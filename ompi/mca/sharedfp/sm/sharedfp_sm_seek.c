@@ -29,9 +29,6 @@
 #include "ompi/mca/sharedfp/sharedfp.h"
 #include "ompi/mca/sharedfp/base/base.h"
 
-/*use a semaphore to lock the shared memory location*/
-#include <semaphore.h>
-
 int
 mca_sharedfp_sm_seek (ompio_file_t *fh,
                       OMPI_MPI_OFFSET_TYPE off, int whence)
@@ -107,29 +104,9 @@ mca_sharedfp_sm_seek (ompio_file_t *fh,
         sm_data = sh->selected_module_data;
         sm_offset_ptr = sm_data->sm_offset_ptr;
 
-        /*-------------------*/
-        /*lock the file  */
-        /*--------------------*/
-        if ( mca_sharedfp_sm_verbose ) {
-            opal_output(ompi_sharedfp_base_framework.framework_output,
-                        "sharedfp_sm_seek: Aquiring lock, rank=%d...",fh->f_rank); fflush(stdout);
-        }
-
-        /* Aquire an exclusive lock */
-        sm_offset_ptr = sm_data->sm_offset_ptr;
-
-        sem_wait(sm_data->mutex);
-
-        if ( mca_sharedfp_sm_verbose ) {
-            opal_output(ompi_sharedfp_base_framework.framework_output,
-                        "sharedfp_sm_seek: Success! Acquired sm lock.for rank=%d\n",fh->f_rank);
-        }
-        sm_offset_ptr->offset=offset;
-        if ( mca_sharedfp_sm_verbose ) {
-            opal_output(ompi_sharedfp_base_framework.framework_output,
-                        "sharedfp_sm_seek: Releasing sm lock...rank=%d",fh->f_rank); fflush(stdout);
-        }
-        sem_post(sm_data->mutex);
+        /* the other processes do not touch the pointer until the barrier below */
+        sm_offset_ptr->offset = offset;
+        opal_atomic_wmb();
     }
 
     /* since we are only letting process 0, update the current pointer
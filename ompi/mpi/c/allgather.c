@@ -50,6 +50,9 @@ int MPI_Allgather(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
                   MPI_Comm comm)
 {
     int err;
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
 
     SPC_RECORD(OMPI_SPC_ALLGATHER, 1);
 
@@ -132,9 +135,11 @@ int MPI_Allgather(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
 
     /* Invoke the coll component to perform the back-end operation */
 
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_ALLGATHER, &spc_cycles);
     err = comm->c_coll->coll_allgather(sendbuf, sendcount, sendtype,
                                       recvbuf, recvcount, recvtype, comm,
                                       comm->c_coll->coll_allgather_module);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_ALLGATHER, &spc_cycles);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
 
@@ -50,6 +50,9 @@ int MPI_Allgatherv(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
                    const int displs[], MPI_Datatype recvtype, MPI_Comm comm)
 {
     int i, size, err;
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
 
     SPC_RECORD(OMPI_SPC_ALLGATHERV, 1);
 
@@ -152,10 +155,12 @@ int MPI_Allgatherv(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
        something */
 
     /* Invoke the coll component to perform the back-end operation */
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_ALLGATHERV, &spc_cycles);
     err = comm->c_coll->coll_allgatherv(sendbuf, sendcount, sendtype,
                                        recvbuf, (int *) recvcounts,
                                        (int *) displs, recvtype, comm,
                                        comm->c_coll->coll_allgatherv_module);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_ALLGATHERV, &spc_cycles);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
 
@@ -52,6 +52,9 @@ int MPI_Alltoall(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
 {
     int err;
     size_t recvtype_size;
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
 
     SPC_RECORD(OMPI_SPC_ALLTOALL, 1);
 
@@ -117,9 +120,11 @@ int MPI_Alltoall(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
     }
 
     /* Invoke the coll component to perform the back-end operation */
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_ALLTOALL, &spc_cycles);
     err = comm->c_coll->coll_alltoall(sendbuf, sendcount, sendtype,
                                      recvbuf, recvcount, recvtype,
                                      comm, comm->c_coll->coll_alltoall_module);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_ALLTOALL, &spc_cycles);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
 
@@ -50,6 +50,9 @@ int MPI_Alltoallv(const void *sendbuf, const int sendcounts[],
                   MPI_Datatype recvtype, MPI_Comm comm)
 {
     int i, size, err;
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
 
     SPC_RECORD(OMPI_SPC_ALLTOALLV, 1);
 
@@ -136,9 +139,11 @@ int MPI_Alltoallv(const void *sendbuf, const int sendcounts[],
 #endif
 
     /* Invoke the coll component to perform the back-end operation */
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_ALLTOALLV, &spc_cycles);
     err = comm->c_coll->coll_alltoallv(sendbuf, sendcounts, sdispls, sendtype,
                                       recvbuf, recvcounts, rdispls, recvtype,
                                       comm, comm->c_coll->coll_alltoallv_module);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_ALLTOALLV, &spc_cycles);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
 
@@ -50,6 +50,9 @@ int MPI_Alltoallw(const void *sendbuf, const int sendcounts[],
                   const MPI_Datatype recvtypes[], MPI_Comm comm)
 {
     int i, size, err;
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
 
     SPC_RECORD(OMPI_SPC_ALLTOALLW, 1);
 
@@ -126,9 +129,11 @@ int MPI_Alltoallw(const void *sendbuf, const int sendcounts[],
 #endif
 
     /* Invoke the coll component to perform the back-end operation */
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_ALLTOALLW, &spc_cycles);
     err = comm->c_coll->coll_alltoallw(sendbuf, sendcounts, sdispls, (ompi_datatype_t **) sendtypes,
                                       recvbuf, recvcounts, rdispls, (ompi_datatype_t **) recvtypes,
                                       comm, comm->c_coll->coll_alltoallw_module);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_ALLTOALLW, &spc_cycles);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
 
@@ -41,6 +41,9 @@ static const char FUNC_NAME[] = "MPI_Barrier";
 int MPI_Barrier(MPI_Comm comm)
 {
   int err = MPI_SUCCESS;
+#if SPC_ENABLE == 1
+  opal_timer_t spc_cycles = 0;
+#endif
 
   SPC_RECORD(OMPI_SPC_BARRIER, 1);
 
@@ -71,6 +74,7 @@ int MPI_Barrier(MPI_Comm comm)
   /* Intracommunicators: Only invoke the back-end coll module barrier
      function if there's more than one process in the communicator */
 
+  SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_BARRIER, &spc_cycles);
   if (OMPI_COMM_IS_INTRA(comm)) {
     if (ompi_comm_size(comm) > 1) {
       err = comm->c_coll->coll_barrier(comm, comm->c_coll->coll_barrier_module);
@@ -83,6 +87,7 @@ int MPI_Barrier(MPI_Comm comm)
   else {
       err = comm->c_coll->coll_barrier(comm, comm->c_coll->coll_barrier_module);
   }
+  SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_BARRIER, &spc_cycles);
 
   /* All done */
 
@@ -43,6 +43,9 @@ int MPI_Bcast(void *buffer, int count, MPI_Datatype datatype,
               int root, MPI_Comm comm)
 {
     int err;
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
 
     SPC_RECORD(OMPI_SPC_BCAST, 1);
 
@@ -122,7 +125,9 @@ int MPI_Bcast(void *buffer, int count, MPI_Datatype datatype,
 
     /* Invoke the coll component to perform the back-end operation */
 
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_BCAST, &spc_cycles);
     err = comm->c_coll->coll_bcast(buffer, count, datatype, root, comm,
                                   comm->c_coll->coll_bcast_module);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_BCAST, &spc_cycles);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
@@ -47,6 +47,9 @@ int MPI_Exscan(const void *sendbuf, void *recvbuf, int count,
                MPI_Datatype datatype, MPI_Op op, MPI_Comm comm)
 {
     int err;
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
 
     SPC_RECORD(OMPI_SPC_EXSCAN, 1);
 
@@ -106,9 +109,11 @@ int MPI_Exscan(const void *sendbuf, void *recvbuf, int count,
     /* Invoke the coll component to perform the back-end operation */
 
     OBJ_RETAIN(op);
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_EXSCAN, &spc_cycles);
     err = comm->c_coll->coll_exscan(sendbuf, recvbuf, count,
                                    datatype, op, comm,
                                    comm->c_coll->coll_exscan_module);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_EXSCAN, &spc_cycles);
     OBJ_RELEASE(op);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
@@ -50,6 +50,9 @@ int MPI_Gather(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
                int root, MPI_Comm comm)
 {
     int err;
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
 
     SPC_RECORD(OMPI_SPC_GATHER, 1);
 
@@ -191,8 +194,10 @@ int MPI_Gather(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
     }
 
     /* Invoke the coll component to perform the back-end operation */
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_GATHER, &spc_cycles);
     err = comm->c_coll->coll_gather(sendbuf, sendcount, sendtype, recvbuf,
                                    recvcount, recvtype, root, comm,
                                    comm->c_coll->coll_gather_module);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_GATHER, &spc_cycles);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
@@ -52,6 +52,9 @@ int MPI_Neighbor_allgather(const void *sendbuf, int sendcount, MPI_Datatype send
                            MPI_Comm comm)
 {
     int err;
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
 
     SPC_RECORD(OMPI_SPC_NEIGHBOR_ALLGATHER, 1);
 
@@ -135,9 +138,11 @@ int MPI_Neighbor_allgather(const void *sendbuf, int sendcount, MPI_Datatype send
 #endif
 
     /* Invoke the coll component to perform the back-end operation */
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_NEIGHBOR_ALLGATHER, &spc_cycles);
     err = comm->c_coll->coll_neighbor_allgather(sendbuf, sendcount, sendtype,
                                                recvbuf, recvcount, recvtype, comm,
                                                comm->c_coll->coll_neighbor_allgather_module);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_NEIGHBOR_ALLGATHER, &spc_cycles);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
 
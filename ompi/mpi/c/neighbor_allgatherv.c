@@ -53,6 +53,9 @@ int MPI_Neighbor_allgatherv(const void *sendbuf, int sendcount, MPI_Datatype sen
                             MPI_Datatype recvtype, MPI_Comm comm)
 {
     int in_size, out_size, err;
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
 
     SPC_RECORD(OMPI_SPC_NEIGHBOR_ALLGATHERV, 1);
 
@@ -151,8 +154,10 @@ int MPI_Neighbor_allgatherv(const void *sendbuf, int sendcount, MPI_Datatype sen
 #endif
 
     /* Invoke the coll component to perform the back-end operation */
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_NEIGHBOR_ALLGATHERV, &spc_cycles);
     err = comm->c_coll->coll_neighbor_allgatherv(sendbuf, sendcount, sendtype,
                                                 recvbuf, recvcounts, displs,
                                                 recvtype, comm, comm->c_coll->coll_neighbor_allgatherv_module);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_NEIGHBOR_ALLGATHERV, &spc_cycles);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
@@ -52,6 +52,9 @@ int MPI_Neighbor_alltoall(const void *sendbuf, int sendcount, MPI_Datatype sendt
 {
     size_t sendtype_size, recvtype_size;
     int err;
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
 
     SPC_RECORD(OMPI_SPC_NEIGHBOR_ALLTOALL, 1);
 
@@ -138,9 +141,11 @@ int MPI_Neighbor_alltoall(const void *sendbuf, int sendcount, MPI_Datatype sendt
 #endif
 
     /* Invoke the coll component to perform the back-end operation */
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_NEIGHBOR_ALLTOALL, &spc_cycles);
     err = comm->c_coll->coll_neighbor_alltoall(sendbuf, sendcount, sendtype, recvbuf,
                                               recvcount, recvtype, comm,
                                               comm->c_coll->coll_neighbor_alltoall_module);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_NEIGHBOR_ALLTOALL, &spc_cycles);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
 
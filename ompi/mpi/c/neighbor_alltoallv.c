@@ -53,6 +53,9 @@ int MPI_Neighbor_alltoallv(const void *sendbuf, const int sendcounts[], const in
 {
     int i, err;
     int indegree, outdegree;
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
 
     SPC_RECORD(OMPI_SPC_NEIGHBOR_ALLTOALLV, 1);
 
@@ -154,9 +157,11 @@ int MPI_Neighbor_alltoallv(const void *sendbuf, const int sendcounts[], const in
 #endif
 
     /* Invoke the coll component to perform the back-end operation */
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_NEIGHBOR_ALLTOALLV, &spc_cycles);
     err = comm->c_coll->coll_neighbor_alltoallv(sendbuf, sendcounts, sdispls, sendtype,
                                                recvbuf, recvcounts, rdispls, recvtype,
                                                comm, comm->c_coll->coll_neighbor_alltoallv_module);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_NEIGHBOR_ALLTOALLV, &spc_cycles);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
 
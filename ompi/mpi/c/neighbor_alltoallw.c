@@ -53,6 +53,9 @@ int MPI_Neighbor_alltoallw(const void *sendbuf, const int sendcounts[], const MP
 {
     int i, err;
     int indegree, outdegree;
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
 
     SPC_RECORD(OMPI_SPC_NEIGHBOR_ALLTOALLW, 1);
 
@@ -150,9 +153,11 @@ int MPI_Neighbor_alltoallw(const void *sendbuf, const int sendcounts[], const MP
 #endif
 
     /* Invoke the coll component to perform the back-end operation */
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_NEIGHBOR_ALLTOALLW, &spc_cycles);
     err = comm->c_coll->coll_neighbor_alltoallw(sendbuf, sendcounts, sdispls, sendtypes,
                                                recvbuf, recvcounts, rdispls, recvtypes,
                                                comm, comm->c_coll->coll_neighbor_alltoallw_module);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_NEIGHBOR_ALLTOALLW, &spc_cycles);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
 
@@ -48,6 +48,9 @@ int MPI_Reduce(const void *sendbuf, void *recvbuf, int count,
                MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm)
 {
     int err;
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
 
     SPC_RECORD(OMPI_SPC_REDUCE, 1);
 
@@ -146,9 +149,11 @@ int MPI_Reduce(const void *sendbuf, void *recvbuf, int count,
     /* Invoke the coll component to perform the back-end operation */
 
     OBJ_RETAIN(op);
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_REDUCE, &spc_cycles);
     err = comm->c_coll->coll_reduce(sendbuf, recvbuf, count,
                                    datatype, op, root, comm,
                                    comm->c_coll->coll_reduce_module);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_REDUCE, &spc_cycles);
     OBJ_RELEASE(op);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
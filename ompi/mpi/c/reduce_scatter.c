@@ -48,6 +48,9 @@ int MPI_Reduce_scatter(const void *sendbuf, void *recvbuf, const int recvcounts[
                        MPI_Datatype datatype, MPI_Op op, MPI_Comm comm)
 {
     int i, err, size, count;
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
 
     SPC_RECORD(OMPI_SPC_REDUCE_SCATTER, 1);
 
@@ -141,9 +144,11 @@ int MPI_Reduce_scatter(const void *sendbuf, void *recvbuf, const int recvcounts[
     /* Invoke the coll component to perform the back-end operation */
 
     OBJ_RETAIN(op);
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_REDUCE_SCATTER, &spc_cycles);
     err = comm->c_coll->coll_reduce_scatter(sendbuf, recvbuf, recvcounts,
                                            datatype, op, comm,
                                            comm->c_coll->coll_reduce_scatter_module);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_REDUCE_SCATTER, &spc_cycles);
     OBJ_RELEASE(op);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
@@ -48,6 +48,9 @@ int MPI_Reduce_scatter_block(const void *sendbuf, void *recvbuf, int recvcount,
                              MPI_Datatype datatype, MPI_Op op, MPI_Comm comm)
 {
     int err;
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
 
     SPC_RECORD(OMPI_SPC_REDUCE_SCATTER_BLOCK, 1);
 
@@ -112,9 +115,11 @@ int MPI_Reduce_scatter_block(const void *sendbuf, void *recvbuf, int recvcount,
     /* Invoke the coll component to perform the back-end operation */
 
     OBJ_RETAIN(op);
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_REDUCE_SCATTER_BLOCK, &spc_cycles);
     err = comm->c_coll->coll_reduce_scatter_block(sendbuf, recvbuf, recvcount,
                                                  datatype, op, comm,
                                                  comm->c_coll->coll_reduce_scatter_block_module);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_REDUCE_SCATTER_BLOCK, &spc_cycles);
     OBJ_RELEASE(op);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
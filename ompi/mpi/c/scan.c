@@ -48,6 +48,9 @@ int MPI_Scan(const void *sendbuf, void *recvbuf, int count,
              MPI_Datatype datatype, MPI_Op op, MPI_Comm comm)
 {
     int err;
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
 
     SPC_RECORD(OMPI_SPC_SCAN, 1);
 
@@ -115,9 +118,11 @@ int MPI_Scan(const void *sendbuf, void *recvbuf, int count,
     /* Call the coll component to actually perform the allgather */
 
     OBJ_RETAIN(op);
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_SCAN, &spc_cycles);
     err = comm->c_coll->coll_scan(sendbuf, recvbuf, count,
                                  datatype, op, comm,
                                  comm->c_coll->coll_scan_module);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_SCAN, &spc_cycles);
     OBJ_RELEASE(op);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
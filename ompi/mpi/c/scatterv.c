@@ -48,6 +48,9 @@ int MPI_Scatterv(const void *sendbuf, const int sendcounts[], const int displs[]
                  MPI_Datatype recvtype, int root, MPI_Comm comm)
 {
     int i, size, err;
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
 
     SPC_RECORD(OMPI_SPC_SCATTERV, 1);
 
@@ -203,8 +206,10 @@ int MPI_Scatterv(const void *sendbuf, const int sendcounts[], const int displs[]
 #endif
 
     /* Invoke the coll component to perform the back-end operation */
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_SCATTERV, &spc_cycles);
     err = comm->c_coll->coll_scatterv(sendbuf, sendcounts, displs,
                                      sendtype, recvbuf, recvcount, recvtype, root, comm,
                                      comm->c_coll->coll_scatterv_module);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_SCATTERV, &spc_cycles);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
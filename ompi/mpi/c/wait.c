@@ -41,6 +41,11 @@ static const char FUNC_NAME[] = "MPI_Wait";
 
 int MPI_Wait(MPI_Request *request, MPI_Status *status)
 {
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
+    int ret;
+
     SPC_RECORD(OMPI_SPC_WAIT, 1);
 
     MEMCHECKER(
@@ -69,7 +74,10 @@ int MPI_Wait(MPI_Request *request, MPI_Status *status)
         return MPI_SUCCESS;
     }
 
-    if (OMPI_SUCCESS == ompi_request_wait(request, status)) {
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_WAIT, &spc_cycles);
+    ret = ompi_request_wait(request, status);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_WAIT, &spc_cycles);
+    if (OMPI_SUCCESS == ret) {
         /*
          * Per MPI-1, the MPI_ERROR field is not defined for single-completion calls
          */
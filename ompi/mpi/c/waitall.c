@@ -43,6 +43,11 @@ static const char FUNC_NAME[] = "MPI_Waitall";
 
 int MPI_Waitall(int count, MPI_Request requests[], MPI_Status statuses[])
 {
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
+    int ret;
+
     SPC_RECORD(OMPI_SPC_WAITALL, 1);
 
     MEMCHECKER(
@@ -75,7 +80,10 @@ int MPI_Waitall(int count, MPI_Request requests[], MPI_Status statuses[])
         return MPI_SUCCESS;
     }
 
-    if (OMPI_SUCCESS == ompi_request_wait_all(count, requests, statuses)) {
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_WAITALL, &spc_cycles);
+    ret = ompi_request_wait_all(count, requests, statuses);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_WAITALL, &spc_cycles);
+    if (OMPI_SUCCESS == ret) {
         return MPI_SUCCESS;
     }
 
@@ -44,6 +44,11 @@ static const char FUNC_NAME[] = "MPI_Waitany";
 
 int MPI_Waitany(int count, MPI_Request requests[], int *indx, MPI_Status *status)
 {
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
+    int ret;
+
     SPC_RECORD(OMPI_SPC_WAITANY, 1);
 
     MEMCHECKER(
@@ -81,7 +86,10 @@ int MPI_Waitany(int count, MPI_Request requests[], int *indx, MPI_Status *status
         return MPI_SUCCESS;
     }
 
-    if (OMPI_SUCCESS == ompi_request_wait_any(count, requests, indx, status)) {
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_WAITANY, &spc_cycles);
+    ret = ompi_request_wait_any(count, requests, indx, status);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_WAITANY, &spc_cycles);
+    if (OMPI_SUCCESS == ret) {
         return MPI_SUCCESS;
     }
 
@@ -46,6 +46,11 @@ int MPI_Waitsome(int incount, MPI_Request requests[],
                  int *outcount, int indices[],
                  MPI_Status statuses[])
 {
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
+    int ret;
+
     SPC_RECORD(OMPI_SPC_WAITSOME, 1);
 
     MEMCHECKER(
@@ -80,8 +85,10 @@ int MPI_Waitsome(int incount, MPI_Request requests[],
         return MPI_SUCCESS;
     }
 
-    if (OMPI_SUCCESS == ompi_request_wait_some( incount, requests,
-                                                outcount, indices, statuses )) {
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_WAITSOME, &spc_cycles);
+    ret = ompi_request_wait_some(incount, requests, outcount, indices, statuses);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_WAITSOME, &spc_cycles);
+    if (OMPI_SUCCESS == ret) {
         return MPI_SUCCESS;
     }
 
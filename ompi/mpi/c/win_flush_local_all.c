@@ -29,6 +29,7 @@
 #include "ompi/info/info.h"
 #include "ompi/win/win.h"
 #include "ompi/memchecker.h"
+#include "ompi/runtime/ompi_spc.h"
 
 #if OMPI_BUILD_MPI_PROFILING
 #if OPAL_HAVE_WEAK_SYMBOLS
@@ -42,6 +43,9 @@ static const char FUNC_NAME[] = "MPI_Win_flush_local_all";
 int MPI_Win_flush_local_all(MPI_Win win)
 {
     int ret = MPI_SUCCESS;
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
 
     /* argument checking */
     if (MPI_PARAM_CHECK) {
@@ -54,6 +58,8 @@ int MPI_Win_flush_local_all(MPI_Win win)
     }
 
     /* create window and return */
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_WIN_FLUSH_LOCAL_ALL, &spc_cycles);
     ret = win->w_osc_module->osc_flush_local_all(win);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_WIN_FLUSH_LOCAL_ALL, &spc_cycles);
     OMPI_ERRHANDLER_RETURN(ret, win, ret, FUNC_NAME);
 }
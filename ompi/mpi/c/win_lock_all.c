@@ -26,6 +26,7 @@
 #include "ompi/errhandler/errhandler.h"
 #include "ompi/win/win.h"
 #include "ompi/mca/osc/osc.h"
+#include "ompi/runtime/ompi_spc.h"
 
 #if OMPI_BUILD_MPI_PROFILING
 #if OPAL_HAVE_WEAK_SYMBOLS
@@ -40,6 +41,9 @@ static const char FUNC_NAME[] = "MPI_Win_lock_all";
 int MPI_Win_lock_all(int mpi_assert, MPI_Win win)
 {
     int rc;
+#if SPC_ENABLE == 1
+    opal_timer_t spc_cycles = 0;
+#endif
 
     if (MPI_PARAM_CHECK) {
         OMPI_ERR_INIT_FINALIZE(FUNC_NAME);
@@ -53,6 +57,8 @@ int MPI_Win_lock_all(int mpi_assert, MPI_Win win)
         }
     }
 
+    SPC_HISTOGRAM_START(OMPI_SPC_LATENCY_WIN_LOCK_ALL, &spc_cycles);
     rc = win->w_osc_module->osc_lock_all(mpi_assert, win);
+    SPC_HISTOGRAM_STOP(OMPI_SPC_LATENCY_WIN_LOCK_ALL, &spc_cycles);
     OMPI_ERRHANDLER_RETURN(rc, win, rc, FUNC_NAME);
 }
@@ -460,8 +460,10 @@ redo:
         assert(REQUEST_COMPLETE(req));
         WAIT_SYNC_RELEASE(&sync);
     } else {
+        uint64_t idle_since = 0;
+
         while(!REQUEST_COMPLETE(req)) {
-            opal_progress();
+            opal_progress_wait(&idle_since);
 #if OPAL_ENABLE_FT_MPI
             /* Check to make sure that process failure did not break the
              * request. */
@@ -61,6 +61,7 @@
 #include "opal/mca/allocator/base/base.h"
 #include "opal/mca/pmix/pmix-internal.h"
 #include "opal/util/timings.h"
+#include "opal/util/trace.h"
 
 #include "mpi.h"
 #include "ompi/constants.h"
@@ -137,6 +138,9 @@ int ompi_mpi_finalize(void)
     opal_atomic_wmb();
     opal_atomic_swap_32(&ompi_mpi_state, OMPI_MPI_STATE_FINALIZE_STARTED);
 
+    /* nothing may progress behind our back while tearing down */
+    opal_progress_async_stop();
+
     ompi_mpiext_fini();
 
     /* Per MPI-2:4.8, we have to free MPI_COMM_SELF before doing
@@ -302,6 +306,10 @@ int ompi_mpi_finalize(void)
         OMPI_LAZY_WAIT_FOR_COMPLETION(active);
     }
 
+    /* All the communications are done: write the event trace. It
+       cannot wait for opal_finalize(), which MPI does not call. */
+    OPAL_TRACE_FINI();
+
     /* Shut down any bindings-specific issues: C++, F77, F90 */
 
     /* Remove all memory associated by MPI_REGISTER_DATAREP (per
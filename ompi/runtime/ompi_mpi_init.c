@@ -470,6 +470,15 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
         goto error;
     }
 
+    /* The progress thread enters the PML, BTLs and collectives behind
+       the back of the application, so they have to be set up as for
+       MPI_THREAD_MULTIPLE.  The level reported to the user is not
+       changed. */
+    if (ompi_mpi_async_progress) {
+        ompi_mpi_thread_multiple = true;
+        opal_set_using_threads(true);
+    }
+
     if (OPAL_SUCCESS != (ret = opal_arch_set_fortran_logical_size(sizeof(ompi_fortran_logical_t)))) {
         error = "ompi_mpi_init: opal_arch_set_fortran_logical_size failed";
         goto error;
@@ -988,6 +997,14 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
         opal_progress_set_event_poll_rate(ompi_mpi_event_tick_rate);
     }
 
+    if (ompi_mpi_async_progress) {
+        if (OMPI_SUCCESS != (ret = opal_progress_async_start(ompi_mpi_async_progress_core,
+                                                             ompi_mpi_async_progress_idle))) {
+            error = "opal_progress_async_start() failed";
+            goto error;
+        }
+    }
+
     /* At this point, we are fully configured and in MPI mode.  Any
        communication calls here will work exactly like they would in
        the user's code.  Setup the connections between procs and warm
@@ -75,6 +75,10 @@ bool ompi_mpi_preconnect_mpi = false;
 bool ompi_async_mpi_init = false;
 bool ompi_async_mpi_finalize = false;
 
+bool ompi_mpi_async_progress = false;
+int ompi_mpi_async_progress_core = -1;
+int ompi_mpi_async_progress_idle = 0;
+
 #define OMPI_ADD_PROCS_CUTOFF_DEFAULT 0
 uint32_t ompi_add_procs_cutoff = OMPI_ADD_PROCS_CUTOFF_DEFAULT;
 bool ompi_mpi_dynamics_enabled = true;
@@ -173,6 +177,30 @@ int ompi_mpi_register_params(void)
                                  MCA_BASE_VAR_SCOPE_READONLY,
                                  &ompi_mpi_event_tick_rate);
 
+    ompi_mpi_async_progress = false;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "async_progress",
+                                 "Progress communication (rendezvous, RDMA pipelines, nonblocking collectives, one-sided) in a background thread. Implies thread safe operation of the library",
+                                 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                 OPAL_INFO_LVL_5,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_async_progress);
+
+    ompi_mpi_async_progress_core = -1;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "async_progress_core",
+                                 "Logical index of the core to bind the progress thread to (-1 = keep the binding of the process)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_5,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_async_progress_core);
+
+    ompi_mpi_async_progress_idle = 0;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "async_progress_idle",
+                                 "Time (in microseconds) the progress thread sleeps when there was nothing to progress (0 = only yield the processor)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_async_progress_idle);
+
     /* Whether or not to show MPI handle leaks */
     ompi_debug_show_handle_leaks = false;
     (void) mca_base_var_register("ompi", "mpi", NULL, "show_handle_leaks",
@@ -168,9 +168,94 @@ static const ompi_spc_event_t ompi_spc_events_desc[OMPI_SPC_NUM_COUNTERS] = {
                                              "contained at once since the last reset of this counter. Note: This counter is reset each time it is read.", true, false)
 };
 
+#define SET_HISTOGRAM_ARRAY(NAME, FUNC)   [NAME] = { .counter_name = #NAME, \
+                                                   .counter_description = "Latency histogram of " FUNC ". Bucket i counts " \
+                                                   "the calls that took between 2^i and 2^(i+1) nanoseconds.", \
+                                                   .is_high_watermark = false, .is_timer_event = false }
+
+static const ompi_spc_event_t ompi_spc_histograms_desc[OMPI_SPC_NUM_HISTOGRAMS] = {
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_WAIT, "MPI_Wait"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_WAITALL, "MPI_Waitall"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_WAITANY, "MPI_Waitany"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_WAITSOME, "MPI_Waitsome"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_BARRIER, "MPI_Barrier"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_BCAST, "MPI_Bcast"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_REDUCE, "MPI_Reduce"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_ALLREDUCE, "MPI_Allreduce"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_SCATTER, "MPI_Scatter"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_SCATTERV, "MPI_Scatterv"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_GATHER, "MPI_Gather"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_GATHERV, "MPI_Gatherv"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_ALLGATHER, "MPI_Allgather"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_ALLGATHERV, "MPI_Allgatherv"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_ALLTOALL, "MPI_Alltoall"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_ALLTOALLV, "MPI_Alltoallv"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_ALLTOALLW, "MPI_Alltoallw"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_REDUCE_SCATTER, "MPI_Reduce_scatter"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_REDUCE_SCATTER_BLOCK, "MPI_Reduce_scatter_block"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_SCAN, "MPI_Scan"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_EXSCAN, "MPI_Exscan"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_NEIGHBOR_ALLGATHER, "MPI_Neighbor_allgather"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_NEIGHBOR_ALLGATHERV, "MPI_Neighbor_allgatherv"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_NEIGHBOR_ALLTOALL, "MPI_Neighbor_alltoall"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_NEIGHBOR_ALLTOALLV, "MPI_Neighbor_alltoallv"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_NEIGHBOR_ALLTOALLW, "MPI_Neighbor_alltoallw"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_WIN_FENCE, "MPI_Win_fence"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_WIN_LOCK, "MPI_Win_lock"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_WIN_UNLOCK, "MPI_Win_unlock"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_WIN_LOCK_ALL, "MPI_Win_lock_all"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_WIN_UNLOCK_ALL, "MPI_Win_unlock_all"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_WIN_FLUSH, "MPI_Win_flush"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_WIN_FLUSH_ALL, "MPI_Win_flush_all"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_WIN_FLUSH_LOCAL, "MPI_Win_flush_local"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_WIN_FLUSH_LOCAL_ALL, "MPI_Win_flush_local_all"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_WIN_START, "MPI_Win_start"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_WIN_COMPLETE, "MPI_Win_complete"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_WIN_POST, "MPI_Win_post"),
+    SET_HISTOGRAM_ARRAY(OMPI_SPC_LATENCY_WIN_WAIT, "MPI_Win_wait")
+};
+
 /* An array of event structures to store the event data (value, attachments, flags) */
 ompi_spc_t ompi_spc_events[OMPI_SPC_NUM_COUNTERS];
 
+/* The attachments of the latency histograms */
+ompi_spc_t ompi_spc_histograms[OMPI_SPC_NUM_HISTOGRAMS];
+
+/* The counts of the events, one copy per group of threads */
+ompi_spc_shard_t ompi_spc_shards[OMPI_SPC_NUM_SHARDS];
+
+#if OPAL_HAVE_THREAD_LOCAL
+opal_thread_local int ompi_spc_shard_index = -1;
+static opal_atomic_int32_t ompi_spc_num_threads = 0;
+
+/* Assigns a shard to the calling thread, in the order the threads
+ * first record an event.
+ */
+int ompi_spc_shard_assign(void)
+{
+    ompi_spc_shard_index = opal_atomic_fetch_add_32(&ompi_spc_num_threads, 1) % OMPI_SPC_NUM_SHARDS;
+    return ompi_spc_shard_index;
+}
+#endif
+
+/* Returns the current value of a counter: the sum of its shards, or the
+ * value itself for a high watermark.
+ */
+ompi_spc_value_t ompi_spc_value(unsigned int event_id)
+{
+    ompi_spc_value_t value = 0;
+    int i;
+
+    if( ompi_spc_events[event_id].is_high_watermark ) {
+        return (ompi_spc_value_t)ompi_spc_events[event_id].value;
+    }
+
+    for(i = 0; i < OMPI_SPC_NUM_SHARDS; i++) {
+        value += (ompi_spc_value_t)ompi_spc_shards[i].value[event_id];
+    }
+    return value;
+}
+
 /* ##############################################################
  * ################# Begin MPI_T Functions ######################
  * ##############################################################
@@ -186,6 +271,19 @@ static int ompi_spc_notify(mca_base_pvar_t *pvar, mca_base_pvar_event_t event, v
 
     index = (int)(uintptr_t)pvar->ctx;  /* Convert from MPI_T pvar index to SPC index */
 
+    /* Latency histograms come after the counters */
+    if(index >= OMPI_SPC_NUM_COUNTERS) {
+        index -= OMPI_SPC_NUM_COUNTERS;
+        if(MCA_BASE_PVAR_HANDLE_BIND == event) {
+            *count = OMPI_SPC_HISTOGRAM_BUCKETS;
+        } else if(MCA_BASE_PVAR_HANDLE_START == event) {
+            opal_atomic_fetch_add_32(&ompi_spc_histograms[index].num_attached, 1);
+        } else if(MCA_BASE_PVAR_HANDLE_STOP == event) {
+            opal_atomic_fetch_add_32(&ompi_spc_histograms[index].num_attached, -1);
+        }
+        return MPI_SUCCESS;
+    }
+
     /* For this event, we need to set count to the number of long long type
      * values for this counter.  All SPC counters are one long long, so we
      * always set count to 1.
@@ -228,7 +326,7 @@ static int ompi_spc_get_count(const struct mca_base_pvar_t *pvar, void *value, v
     /* Convert from MPI_T pvar index to SPC index */
     int index = (int)(uintptr_t)pvar->ctx;
     /* Set the counter value to the current SPC value */
-    counter_value = (long long)ompi_spc_events[index].value;
+    counter_value = (long long)ompi_spc_value(index);
     /* If this is a timer-based counter, convert from cycles to microseconds */
     if( ompi_spc_events[index].is_timer_event ) {
         counter_value /= sys_clock_freq_mhz;
@@ -243,6 +341,55 @@ static int ompi_spc_get_count(const struct mca_base_pvar_t *pvar, void *value, v
     return MPI_SUCCESS;
 }
 
+/* Sums up the buckets of a latency histogram over the shards. */
+static void ompi_spc_histogram_value(int index, unsigned long long *buckets)
+{
+    int i, j;
+
+    for(j = 0; j < OMPI_SPC_HISTOGRAM_BUCKETS; j++) {
+        buckets[j] = 0;
+    }
+    for(i = 0; i < OMPI_SPC_NUM_SHARDS; i++) {
+        for(j = 0; j < OMPI_SPC_HISTOGRAM_BUCKETS; j++) {
+            buckets[j] += (unsigned long long)ompi_spc_shards[i].histogram[index][j];
+        }
+    }
+}
+
+/* Returns the buckets of a latency histogram registered as an MPI_T pvar. */
+static int ompi_spc_get_histogram(const struct mca_base_pvar_t *pvar, void *value, void *obj_handle)
+{
+    unsigned long long *buckets = (unsigned long long*)value;
+    int j;
+
+    if(OPAL_LIKELY(!mpi_t_enabled)) {
+        for(j = 0; j < OMPI_SPC_HISTOGRAM_BUCKETS; j++) {
+            buckets[j] = 0;
+        }
+        return MPI_SUCCESS;
+    }
+
+    ompi_spc_histogram_value((int)(uintptr_t)pvar->ctx - OMPI_SPC_NUM_COUNTERS, buckets);
+
+    return MPI_SUCCESS;
+}
+
+/* Adds an operation that took the given number of cycles to the bucket of
+ * its latency in the shard of the calling thread.
+ */
+void ompi_spc_histogram_record(unsigned int histogram_id, opal_timer_t cycles)
+{
+    uint64_t nsecs = (0 == sys_clock_freq_mhz) ? 0 : (uint64_t)cycles * 1000 / sys_clock_freq_mhz;
+    int bucket = 0;
+
+    while(nsecs > 1 && bucket < OMPI_SPC_HISTOGRAM_BUCKETS - 1) {
+        nsecs >>= 1;
+        bucket++;
+    }
+
+    OPAL_THREAD_ADD_FETCH64(&(ompi_spc_shard()->histogram[histogram_id][bucket]), 1);
+}
+
 /* Allocate and initializes the events data structure. */
 static void ompi_spc_events_init(void)
 {
@@ -251,12 +398,19 @@ static void ompi_spc_events_init(void)
     /* Initialize all of the counters with an initial count of 0.
      * Also copy over the flags for faster access later.
      */
+    memset(ompi_spc_shards, 0, sizeof(ompi_spc_shards));
     for(i = 0; i < OMPI_SPC_NUM_COUNTERS; i++) {
         ompi_spc_events[i].value = 0;
         ompi_spc_events[i].num_attached = 0;
         ompi_spc_events[i].is_high_watermark = ompi_spc_events_desc[i].is_high_watermark;
         ompi_spc_events[i].is_timer_event = ompi_spc_events_desc[i].is_timer_event;
     }
+    for(i = 0; i < OMPI_SPC_NUM_HISTOGRAMS; i++) {
+        ompi_spc_histograms[i].value = 0;
+        ompi_spc_histograms[i].num_attached = 0;
+        ompi_spc_histograms[i].is_high_watermark = false;
+        ompi_spc_histograms[i].is_timer_event = false;
+    }
 
     if (ompi_mpi_spc_dump_enabled) {
         ompi_comm_dup(&ompi_mpi_comm_world.comm, &ompi_spc_comm);
@@ -322,6 +476,31 @@ void ompi_spc_init(void)
         }
     }
 
+    for(i = 0; i < OMPI_SPC_NUM_HISTOGRAMS && mpi_t_enabled; i++) {
+        matched = all_on;
+
+        for(j = 0; j < num_args && !matched; j++) {
+            matched = (0 == strcmp(ompi_spc_histograms_desc[i].counter_name, arg_strings[j]));
+        }
+
+        if (matched) {
+            opal_atomic_fetch_add_32(&ompi_spc_histograms[i].num_attached, 1);
+        }
+
+        ret = mca_base_pvar_register("ompi", "runtime", "spc", ompi_spc_histograms_desc[i].counter_name,
+                                     ompi_spc_histograms_desc[i].counter_description,
+                                     OPAL_INFO_LVL_4, MPI_T_PVAR_CLASS_COUNTER,
+                                     MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG, NULL, MPI_T_BIND_NO_OBJECT,
+                                     MCA_BASE_PVAR_FLAG_READONLY,
+                                     ompi_spc_get_histogram, NULL, ompi_spc_notify,
+                                     (void*)(uintptr_t)(OMPI_SPC_NUM_COUNTERS + i));
+        if( ret < 0 ) {
+            mpi_t_enabled = false;
+            opal_show_help("help-mpi-runtime.txt", "spc: MPI_T disabled", true);
+            break;
+        }
+    }
+
     opal_argv_free(arg_strings);
 }
 
@@ -330,39 +509,46 @@ void ompi_spc_init(void)
  */
 static void ompi_spc_dump(void)
 {
-    int i, j, world_size, offset;
+    int i, j, k, world_size, offset, len;
     long long *recv_buffer = NULL, *send_buffer;
+    unsigned long long buckets[OMPI_SPC_HISTOGRAM_BUCKETS];
+    char line[OMPI_SPC_HISTOGRAM_BUCKETS * 32];
+    /* The counters are followed by the buckets of the latency histograms */
+    const int num_values = OMPI_SPC_NUM_COUNTERS + OMPI_SPC_NUM_HISTOGRAMS * OMPI_SPC_HISTOGRAM_BUCKETS;
 
     int rank = ompi_comm_rank(ompi_spc_comm);
     world_size = ompi_comm_size(ompi_spc_comm);
 
-    /* Convert from cycles to usecs before sending */
-    for(i = 0; i < OMPI_SPC_NUM_COUNTERS; i++) {
-        if( ompi_spc_events[i].is_timer_event ) {
-            ompi_spc_events[i].value = ompi_spc_cycles_to_usecs_internal(ompi_spc_events[i].value);
-        }
-    }
-
     /* Aggregate all of the information on rank 0 using MPI_Gather on MPI_COMM_WORLD */
-    send_buffer = (long long*)malloc(OMPI_SPC_NUM_COUNTERS * sizeof(long long));
+    send_buffer = (long long*)malloc(num_values * sizeof(long long));
     if (NULL == send_buffer) {
         opal_show_help("help-mpi-runtime.txt", "lib-call-fail", true,
                        "malloc", __FILE__, __LINE__);
         return;
     }
     for(i = 0; i < OMPI_SPC_NUM_COUNTERS; i++) {
-        send_buffer[i] = (long long)ompi_spc_events[i].value;
+        send_buffer[i] = (long long)ompi_spc_value(i);
+        /* Convert from cycles to usecs before sending */
+        if( ompi_spc_events[i].is_timer_event ) {
+            send_buffer[i] = ompi_spc_cycles_to_usecs_internal(send_buffer[i]);
+        }
+    }
+    for(i = 0; i < OMPI_SPC_NUM_HISTOGRAMS; i++) {
+        ompi_spc_histogram_value(i, buckets);
+        for(k = 0; k < OMPI_SPC_HISTOGRAM_BUCKETS; k++) {
+            send_buffer[OMPI_SPC_NUM_COUNTERS + i * OMPI_SPC_HISTOGRAM_BUCKETS + k] = (long long)buckets[k];
+        }
     }
     if( 0 == rank ) {
-        recv_buffer = (long long*)malloc(world_size * OMPI_SPC_NUM_COUNTERS * sizeof(long long));
+        recv_buffer = (long long*)malloc(world_size * num_values * sizeof(long long));
         if (NULL == recv_buffer) {
             opal_show_help("help-mpi-runtime.txt", "lib-call-fail", true,
                            "malloc", __FILE__, __LINE__);
             return;
         }
     }
-    (void)ompi_spc_comm->c_coll->coll_gather(send_buffer, OMPI_SPC_NUM_COUNTERS, MPI_LONG_LONG,
-                                             recv_buffer, OMPI_SPC_NUM_COUNTERS, MPI_LONG_LONG,
+    (void)ompi_spc_comm->c_coll->coll_gather(send_buffer, num_values, MPI_LONG_LONG,
+                                             recv_buffer, num_values, MPI_LONG_LONG,
                                              0, ompi_spc_comm,
                                              ompi_spc_comm->c_coll->coll_gather_module);
 
@@ -378,8 +564,22 @@ static void ompi_spc_dump(void)
                 }
                 opal_output(0, "%s -> %lld\n", ompi_spc_events_desc[i].counter_name, recv_buffer[offset+i]);
             }
+            /* Histograms are printed as the non-empty buckets, in nanoseconds */
+            for(i = 0; i < OMPI_SPC_NUM_HISTOGRAMS; i++) {
+                long long *hist = recv_buffer + offset + OMPI_SPC_NUM_COUNTERS + i * OMPI_SPC_HISTOGRAM_BUCKETS;
+
+                line[0] = '\0';
+                for(k = 0, len = 0; k < OMPI_SPC_HISTOGRAM_BUCKETS; k++) {
+                    if( 0 != hist[k] ) {
+                        len += snprintf(line + len, sizeof(line) - len, " 2^%d:%lld", k, hist[k]);
+                    }
+                }
+                if( 0 != len ) {
+                    opal_output(0, "%s ->%s\n", ompi_spc_histograms_desc[i].counter_name, line);
+                }
+            }
             opal_output(0, "\n");
-            offset += OMPI_SPC_NUM_COUNTERS;
+            offset += num_values;
         }
         printf("###########################################################################\n");
         printf("NOTE: Any counters not shown here were either disabled or had a value of 0.\n");
@@ -155,19 +155,86 @@ typedef enum ompi_spc_counters {
     OMPI_SPC_NUM_COUNTERS /* This serves as the number of counters.  It must be last. */
 } ompi_spc_counters_t;
 
+/* Latency histograms of the blocking operations. Like the counters, each
+ * one needs a name and a description in ompi_spc.c and is recorded with the
+ * SPC_HISTOGRAM_START and SPC_HISTOGRAM_STOP macros around the operation.
+ */
+typedef enum ompi_spc_histograms {
+    OMPI_SPC_LATENCY_WAIT,
+    OMPI_SPC_LATENCY_WAITALL,
+    OMPI_SPC_LATENCY_WAITANY,
+    OMPI_SPC_LATENCY_WAITSOME,
+    OMPI_SPC_LATENCY_BARRIER,
+    OMPI_SPC_LATENCY_BCAST,
+    OMPI_SPC_LATENCY_REDUCE,
+    OMPI_SPC_LATENCY_ALLREDUCE,
+    OMPI_SPC_LATENCY_SCATTER,
+    OMPI_SPC_LATENCY_SCATTERV,
+    OMPI_SPC_LATENCY_GATHER,
+    OMPI_SPC_LATENCY_GATHERV,
+    OMPI_SPC_LATENCY_ALLGATHER,
+    OMPI_SPC_LATENCY_ALLGATHERV,
+    OMPI_SPC_LATENCY_ALLTOALL,
+    OMPI_SPC_LATENCY_ALLTOALLV,
+    OMPI_SPC_LATENCY_ALLTOALLW,
+    OMPI_SPC_LATENCY_REDUCE_SCATTER,
+    OMPI_SPC_LATENCY_REDUCE_SCATTER_BLOCK,
+    OMPI_SPC_LATENCY_SCAN,
+    OMPI_SPC_LATENCY_EXSCAN,
+    OMPI_SPC_LATENCY_NEIGHBOR_ALLGATHER,
+    OMPI_SPC_LATENCY_NEIGHBOR_ALLGATHERV,
+    OMPI_SPC_LATENCY_NEIGHBOR_ALLTOALL,
+    OMPI_SPC_LATENCY_NEIGHBOR_ALLTOALLV,
+    OMPI_SPC_LATENCY_NEIGHBOR_ALLTOALLW,
+    OMPI_SPC_LATENCY_WIN_FENCE,
+    OMPI_SPC_LATENCY_WIN_LOCK,
+    OMPI_SPC_LATENCY_WIN_UNLOCK,
+    OMPI_SPC_LATENCY_WIN_LOCK_ALL,
+    OMPI_SPC_LATENCY_WIN_UNLOCK_ALL,
+    OMPI_SPC_LATENCY_WIN_FLUSH,
+    OMPI_SPC_LATENCY_WIN_FLUSH_ALL,
+    OMPI_SPC_LATENCY_WIN_FLUSH_LOCAL,
+    OMPI_SPC_LATENCY_WIN_FLUSH_LOCAL_ALL,
+    OMPI_SPC_LATENCY_WIN_START,
+    OMPI_SPC_LATENCY_WIN_COMPLETE,
+    OMPI_SPC_LATENCY_WIN_POST,
+    OMPI_SPC_LATENCY_WIN_WAIT,
+    OMPI_SPC_NUM_HISTOGRAMS /* This serves as the number of histograms.  It must be last. */
+} ompi_spc_histograms_t;
+
+/* Bucket i of a latency histogram counts the operations that took between
+ * 2^i and 2^(i+1) nanoseconds; the first and last buckets also count the
+ * shorter and longer ones.
+ */
+#define OMPI_SPC_HISTOGRAM_BUCKETS 32
+
 /* There is currently no support for atomics on long long values so we will default to
  * size_t for now until support for such atomics is implemented.
  */
 typedef long long ompi_spc_value_t;
 
-/* A structure for storing the event data */
+/* A structure for storing the event data. It is only read on the fast path,
+ * the counts themselves live in the shards below (except for high watermarks).
+ */
 typedef struct ompi_spc_s{
-    opal_atomic_int64_t value;
+    opal_atomic_int64_t value;    /* value of a high watermark counter */
     opal_atomic_int32_t num_attached;
     bool is_high_watermark;
     bool is_timer_event;
 } ompi_spc_t;
 
+/* Number of copies of the counters. Each thread updates the copy it was
+ * assigned when it first recorded an event, so threads do not bounce the
+ * same cache lines; the copies are summed up when a counter is read.
+ */
+#define OMPI_SPC_NUM_SHARDS 16
+
+/* One copy of the counters, padded to a multiple of the cache line size */
+typedef struct ompi_spc_shard_s {
+    opal_atomic_int64_t value[OMPI_SPC_NUM_COUNTERS];
+    opal_atomic_int64_t histogram[OMPI_SPC_NUM_HISTOGRAMS][OMPI_SPC_HISTOGRAM_BUCKETS];
+} __opal_attribute_aligned__(64) ompi_spc_shard_t;
+
 /* Definitions for using the SPC utility functions throughout the codebase.
  * If SPC_ENABLE is not 1, the macros become no-ops.
  */
@@ -184,6 +251,24 @@ void ompi_spc_cycles_to_usecs(opal_timer_t *cycles);
 OPAL_DECLSPEC extern
 ompi_spc_t ompi_spc_events[OMPI_SPC_NUM_COUNTERS] __opal_attribute_aligned__(sizeof(ompi_spc_t));
 
+/* Attachments of the latency histograms */
+OPAL_DECLSPEC extern ompi_spc_t ompi_spc_histograms[OMPI_SPC_NUM_HISTOGRAMS];
+
+/* The counts of the events, see OMPI_SPC_NUM_SHARDS */
+OPAL_DECLSPEC extern ompi_spc_shard_t ompi_spc_shards[OMPI_SPC_NUM_SHARDS];
+
+#if OPAL_HAVE_THREAD_LOCAL
+/* Shard of the calling thread, -1 until assigned */
+OPAL_DECLSPEC extern opal_thread_local int ompi_spc_shard_index;
+OPAL_DECLSPEC int ompi_spc_shard_assign(void);
+#endif
+
+/* Sum of the shards of a counter */
+OPAL_DECLSPEC ompi_spc_value_t ompi_spc_value(unsigned int event_id);
+
+/* Adds an operation that took the given number of cycles to a histogram */
+OPAL_DECLSPEC void ompi_spc_histogram_record(unsigned int histogram_id, opal_timer_t cycles);
+
 #define SPC_INIT()  \
     ompi_spc_init()
 
@@ -208,14 +293,38 @@ ompi_spc_t ompi_spc_events[OMPI_SPC_NUM_COUNTERS] __opal_attribute_aligned__(siz
 #define SPC_UPDATE_WATERMARK(watermark_enum, value_enum) \
     ompi_spc_update_watermark(watermark_enum, value_enum)
 
+#define SPC_HISTOGRAM_START(histogram_id, cycles)  \
+    ompi_spc_histogram_start(histogram_id, cycles)
+
+#define SPC_HISTOGRAM_STOP(histogram_id, cycles)  \
+    ompi_spc_histogram_stop(histogram_id, cycles)
+
 
-/* Records an update to a counter using an atomic add operation. */
+/* Returns the shard of the counters the calling thread updates. */
+static inline
+ompi_spc_shard_t *ompi_spc_shard(void)
+{
+#if OPAL_HAVE_THREAD_LOCAL
+    int index = ompi_spc_shard_index;
+
+    if( OPAL_UNLIKELY(index < 0) ) {
+        index = ompi_spc_shard_assign();
+    }
+    return &ompi_spc_shards[index];
+#else
+    return &ompi_spc_shards[0];
+#endif
+}
+
+/* Records an update to a counter using an atomic add operation on the
+ * shard of the calling thread.
+ */
 static inline
 void ompi_spc_record(unsigned int event_id, ompi_spc_value_t value)
 {
     /* Denoted unlikely because counters will often be turned off. */
     if( ompi_spc_events[event_id].num_attached > 0 ) {
-        OPAL_THREAD_ADD_FETCH64(&(ompi_spc_events[event_id].value), value);
+        OPAL_THREAD_ADD_FETCH64(&(ompi_spc_shard()->value[event_id]), value);
     }
 }
 
@@ -241,7 +350,7 @@ void ompi_spc_update_watermark(unsigned int watermark_enum, unsigned int value_e
     if( watermark_event->num_attached &&
         value_event->num_attached ) {
         int64_t watermark = watermark_event->value;
-        int64_t value = watermark_event->value;
+        int64_t value = ompi_spc_value(value_enum);
         /* Try to atomically replace the watermark while the value is larger
          * (i.e, while no thread has replaced it with a larger value, including this thread) */
         while (value > watermark &&
@@ -276,10 +385,29 @@ void ompi_spc_timer_stop(unsigned int event_id, opal_timer_t *cycles)
 {
     if( ompi_spc_events[event_id].num_attached > 0 && *cycles > 0 ) {
         *cycles = opal_timer_base_get_cycles() - *cycles;
-        OPAL_THREAD_ADD_FETCH64(&ompi_spc_events[event_id].value, *cycles);
+        OPAL_THREAD_ADD_FETCH64(&(ompi_spc_shard()->value[event_id]), *cycles);
     }
 }
 
+/* Starts timing an operation for a latency histogram, see ompi_spc_timer_start */
+static inline
+void ompi_spc_histogram_start(unsigned int histogram_id, opal_timer_t *cycles)
+{
+    *cycles = 0;
+
+    if( ompi_spc_histograms[histogram_id].num_attached > 0 ) {
+        *cycles = opal_timer_base_get_cycles();
+    }
+}
+
+/* Stops timing an operation and adds it to its latency histogram */
+static inline
+void ompi_spc_histogram_stop(unsigned int histogram_id, opal_timer_t *cycles)
+{
+    if( ompi_spc_histograms[histogram_id].num_attached > 0 && *cycles > 0 ) {
+        ompi_spc_histogram_record(histogram_id, opal_timer_base_get_cycles() - *cycles);
+    }
+}
 
 #else /* SPCs are not enabled */
 
@@ -307,6 +435,12 @@ void ompi_spc_timer_stop(unsigned int event_id, opal_timer_t *cycles)
 #define SPC_UPDATE_WATERMARK(watermark_enum, value_enum) \
     ((void)0)
 
+#define SPC_HISTOGRAM_START(histogram_id, cycles)  \
+    ((void)0)
+
+#define SPC_HISTOGRAM_STOP(histogram_id, cycles)  \
+    ((void)0)
+
 #endif
 
 #endif
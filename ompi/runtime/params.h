@@ -154,6 +154,25 @@ OMPI_DECLSPEC extern bool ompi_async_mpi_init;
 /* EXPERIMENTAL: do not perform an RTE barrier at the beginning of MPI_Finalize */
 OMPI_DECLSPEC extern bool ompi_async_mpi_finalize;
 
+/**
+ * Whether to run a thread which progresses communication in the
+ * background.  Enabling it puts the library in thread safe mode
+ * whatever thread level the application asked for.
+ */
+OMPI_DECLSPEC extern bool ompi_mpi_async_progress;
+
+/**
+ * Logical index of the core the progress thread is bound to, -1 to
+ * keep the binding of the process
+ */
+OMPI_DECLSPEC extern int ompi_mpi_async_progress_core;
+
+/**
+ * Microseconds the progress thread sleeps after a pass which made no
+ * progress, 0 to only yield the processor
+ */
+OMPI_DECLSPEC extern int ompi_mpi_async_progress_idle;
+
 #if OPAL_ENABLE_FT_MPI
 OMPI_DECLSPEC extern int ompi_ftmpi_output_handle;
 OMPI_DECLSPEC extern bool ompi_ftmpi_enabled;
@@ -34,6 +34,14 @@
 
 typedef struct opal_free_list_item_t opal_free_list_memory_t;
 
+int opal_free_list_thread_cache_size = 32;
+int opal_free_list_thread_caches = 8;
+
+#if OPAL_HAVE_THREAD_LOCAL
+opal_thread_local int opal_free_list_thread_index = -1;
+static opal_atomic_int32_t opal_free_list_thread_count = 0;
+#endif /* OPAL_HAVE_THREAD_LOCAL */
+
 OBJ_CLASS_INSTANCE(opal_free_list_item_t,
                    opal_list_item_t,
                    NULL, NULL);
@@ -57,6 +65,7 @@ static void opal_free_list_construct(opal_free_list_t* fl)
     fl->fl_rcache_reg_flags = MCA_RCACHE_FLAGS_CACHE_BYPASS |
         MCA_RCACHE_FLAGS_CUDA_REGISTER_MEM;
     fl->ctx = NULL;
+    fl->fl_magazines = NULL;
     OBJ_CONSTRUCT(&(fl->fl_allocations), opal_list_t);
 }
 
@@ -90,6 +99,12 @@ static void opal_free_list_destruct(opal_free_list_t *fl)
     }
 #endif
 
+    if (NULL != fl->fl_magazines) {
+        opal_free_list_magazines_flush (fl);
+        free (fl->fl_magazines);
+        fl->fl_magazines = NULL;
+    }
+
     while(NULL != (item = opal_lifo_pop(&(fl->super)))) {
         fl_item = (opal_free_list_item_t*)item;
 
@@ -154,6 +169,23 @@ int opal_free_list_init (opal_free_list_t *flist, size_t frag_size, size_t frag_
     flist->fl_rcache_reg_flags |= rcache_reg_flags;
     flist->ctx = ctx;
 
+#if OPAL_HAVE_THREAD_LOCAL
+    /* magazines are only worth it if several threads share the list */
+    if (opal_using_threads () && NULL == flist->fl_magazines &&
+        0 < opal_free_list_thread_cache_size && 0 < opal_free_list_thread_caches) {
+        if (0 == posix_memalign ((void **) &flist->fl_magazines, sizeof (opal_free_list_magazine_t),
+                                 opal_free_list_thread_caches * sizeof (opal_free_list_magazine_t))) {
+            for (int i = 0 ; i < opal_free_list_thread_caches ; ++i) {
+                opal_atomic_lock_init (&flist->fl_magazines[i].lock, OPAL_ATOMIC_LOCK_UNLOCKED);
+                flist->fl_magazines[i].count = 0;
+                flist->fl_magazines[i].items = NULL;
+            }
+        } else {
+            flist->fl_magazines = NULL;
+        }
+    }
+#endif /* OPAL_HAVE_THREAD_LOCAL */
+
     if (num_elements_to_alloc) {
         return opal_free_list_grow_st (flist, num_elements_to_alloc, NULL);
     }
@@ -317,3 +349,65 @@ int opal_free_list_resize_mt(opal_free_list_t *flist, size_t size)
 
     return ret;
 }
+
+#if OPAL_HAVE_THREAD_LOCAL
+int opal_free_list_thread_index_assign (void)
+{
+    int32_t count = opal_atomic_fetch_add_32 (&opal_free_list_thread_count, 1);
+
+    /* threads are spread over the magazines in the order they first use a
+     * free list */
+    opal_free_list_thread_index = count % opal_free_list_thread_caches;
+    return opal_free_list_thread_index;
+}
+#endif /* OPAL_HAVE_THREAD_LOCAL */
+
+void opal_free_list_magazine_fill (opal_free_list_t *flist, opal_free_list_magazine_t *mag)
+{
+    size_t count = (opal_free_list_thread_cache_size + 1) / 2;
+    opal_list_item_t *item;
+
+    /* each pop is still atomic but the head stays in the cache of this
+     * thread for the whole batch */
+    while (count-- && NULL != (item = opal_lifo_pop_atomic (&flist->super))) {
+        item->opal_list_next = mag->items;
+        mag->items = item;
+        mag->count++;
+    }
+}
+
+void opal_free_list_magazine_drain (opal_free_list_t *flist, opal_free_list_magazine_t *mag,
+                                    size_t count)
+{
+    opal_list_item_t *first, *last;
+    opal_list_item_t *original;
+
+    if (0 == count || NULL == mag->items) {
+        return;
+    }
+
+    first = last = mag->items;
+    for (size_t i = 1 ; i < count && NULL != last->opal_list_next ; ++i) {
+        last = (opal_list_item_t *) last->opal_list_next;
+        --mag->count;
+    }
+    --mag->count;
+
+    mag->items = (opal_list_item_t *) last->opal_list_next;
+
+    original = opal_lifo_push_chain_atomic (&flist->super, first, last);
+    if (&flist->super.opal_lifo_ghost == original && 0 < flist->fl_num_waiting) {
+        opal_condition_broadcast (&flist->fl_condition);
+    }
+}
+
+void opal_free_list_magazines_flush (opal_free_list_t *flist)
+{
+    for (int i = 0 ; i < opal_free_list_thread_caches ; ++i) {
+        opal_free_list_magazine_t *mag = flist->fl_magazines + i;
+
+        opal_atomic_lock (&mag->lock);
+        opal_free_list_magazine_drain (flist, mag, mag->count);
+        opal_atomic_unlock (&mag->lock);
+    }
+}
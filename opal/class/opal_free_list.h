@@ -36,6 +36,31 @@ BEGIN_C_DECLS
 struct mca_mem_pool_t;
 struct opal_free_list_item_t;
 
+/**
+ * Per-thread cache (magazine) of free list items.
+ *
+ * When threads are in use each free list has opal_free_list_thread_caches
+ * magazines and every thread sticks to one of them. Items are taken from
+ * and returned to the magazine of the thread, which is refilled from and
+ * drained to the shared LIFO in batches, so the head of the LIFO is only
+ * touched once every few operations. The magazine lock is normally only
+ * taken by its thread; a thread finding it busy uses the LIFO.
+ */
+struct opal_free_list_magazine_t {
+    /** Held while the magazine is used */
+    opal_atomic_lock_t lock;
+    /** Number of items in the magazine */
+    size_t count;
+    /** Items linked through opal_list_next */
+    opal_list_item_t *items;
+} __opal_attribute_aligned__(64);
+typedef struct opal_free_list_magazine_t opal_free_list_magazine_t;
+
+/** MCA parameter: number of items a magazine holds (0 disables magazines) */
+OPAL_DECLSPEC extern int opal_free_list_thread_cache_size;
+/** MCA parameter: number of magazines of a free list */
+OPAL_DECLSPEC extern int opal_free_list_thread_caches;
+
 /**
  * Free list item initializtion function.
  *
@@ -92,6 +117,8 @@ struct opal_free_list_t {
     opal_free_list_item_init_fn_t item_init;
     /** Initialization function context */
     void *ctx;
+    /** Per-thread magazines (NULL if not used) */
+    opal_free_list_magazine_t *fl_magazines;
 };
 typedef struct opal_free_list_t opal_free_list_t;
 OPAL_DECLSPEC OBJ_CLASS_DECLARATION(opal_free_list_t);
@@ -182,6 +209,97 @@ OPAL_DECLSPEC int opal_free_list_grow_st (opal_free_list_t *flist, size_t num_el
 OPAL_DECLSPEC int opal_free_list_resize_mt (opal_free_list_t *flist, size_t size);
 
 
+/**
+ * Move items between a magazine and the shared LIFO.
+ *
+ * These are internal functions used by opal_free_list_get_mt and
+ * opal_free_list_return_mt. The caller must hold the magazine lock.
+ */
+OPAL_DECLSPEC void opal_free_list_magazine_fill (opal_free_list_t *flist, opal_free_list_magazine_t *mag);
+OPAL_DECLSPEC void opal_free_list_magazine_drain (opal_free_list_t *flist, opal_free_list_magazine_t *mag,
+                                                  size_t count);
+
+/**
+ * Return the items held in all the magazines of a free list to the shared
+ * LIFO. Used when the free list cannot grow anymore so no item stays
+ * hidden in the magazine of another thread.
+ */
+OPAL_DECLSPEC void opal_free_list_magazines_flush (opal_free_list_t *flist);
+
+#if OPAL_HAVE_THREAD_LOCAL
+/** Magazine used by this thread, -1 until assigned */
+OPAL_DECLSPEC extern opal_thread_local int opal_free_list_thread_index;
+
+OPAL_DECLSPEC int opal_free_list_thread_index_assign (void);
+
+static inline opal_free_list_magazine_t *opal_free_list_magazine (opal_free_list_t *flist)
+{
+    int index = opal_free_list_thread_index;
+
+    if (OPAL_UNLIKELY(0 > index)) {
+        index = opal_free_list_thread_index_assign ();
+    }
+
+    return flist->fl_magazines + index;
+}
+
+static inline opal_free_list_item_t *opal_free_list_magazine_get (opal_free_list_t *flist)
+{
+    opal_free_list_magazine_t *mag = opal_free_list_magazine (flist);
+    opal_list_item_t *item;
+
+    if (opal_atomic_trylock (&mag->lock)) {
+        return NULL;
+    }
+
+    if (0 == mag->count) {
+        opal_free_list_magazine_fill (flist, mag);
+    }
+
+    item = mag->items;
+    if (NULL != item) {
+        mag->items = (opal_list_item_t *) item->opal_list_next;
+        mag->count--;
+        item->opal_list_next = NULL;
+    }
+
+    opal_atomic_unlock (&mag->lock);
+
+    return (opal_free_list_item_t *) item;
+}
+
+static inline bool opal_free_list_magazine_return (opal_free_list_t *flist,
+                                                   opal_free_list_item_t *item)
+{
+    opal_free_list_magazine_t *mag = opal_free_list_magazine (flist);
+
+    /* waiting threads only look at the shared LIFO */
+    if (0 < flist->fl_num_waiting || opal_atomic_trylock (&mag->lock)) {
+        return false;
+    }
+
+    /* a thread may have started waiting since the check above. it flushes
+     * the magazines after raising fl_num_waiting, so either it sees this
+     * item or this check sees it waiting */
+    if (0 < flist->fl_num_waiting) {
+        opal_atomic_unlock (&mag->lock);
+        return false;
+    }
+
+    if ((size_t) opal_free_list_thread_cache_size <= mag->count) {
+        opal_free_list_magazine_drain (flist, mag, mag->count / 2);
+    }
+
+    item->super.opal_list_next = mag->items;
+    mag->items = &item->super;
+    mag->count++;
+
+    opal_atomic_unlock (&mag->lock);
+
+    return true;
+}
+#endif /* OPAL_HAVE_THREAD_LOCAL */
+
 /**
  * Attemp to obtain an item from a free list.
  *
@@ -197,12 +315,26 @@ OPAL_DECLSPEC int opal_free_list_resize_mt (opal_free_list_t *flist, size_t size
  */
 static inline opal_free_list_item_t *opal_free_list_get_mt (opal_free_list_t *flist)
 {
-    opal_free_list_item_t *item =
-        (opal_free_list_item_t*) opal_lifo_pop_atomic (&flist->super);
+    opal_free_list_item_t *item;
+
+#if OPAL_HAVE_THREAD_LOCAL
+    if (NULL != flist->fl_magazines) {
+        item = opal_free_list_magazine_get (flist);
+        if (OPAL_LIKELY(NULL != item)) {
+            return item;
+        }
+    }
+#endif /* OPAL_HAVE_THREAD_LOCAL */
+
+    item = (opal_free_list_item_t*) opal_lifo_pop_atomic (&flist->super);
 
     if (OPAL_UNLIKELY(NULL == item)) {
         opal_mutex_lock (&flist->fl_lock);
-        opal_free_list_grow_st (flist, flist->fl_num_per_alloc, &item);
+        if (OPAL_SUCCESS != opal_free_list_grow_st (flist, flist->fl_num_per_alloc, &item) &&
+            NULL != flist->fl_magazines) {
+            opal_free_list_magazines_flush (flist);
+            item = (opal_free_list_item_t*) opal_lifo_pop_atomic (&flist->super);
+        }
         opal_mutex_unlock (&flist->fl_lock);
     }
 
@@ -252,15 +384,31 @@ static inline opal_free_list_item_t *opal_free_list_get (opal_free_list_t *flist
 
 static inline opal_free_list_item_t *opal_free_list_wait_mt (opal_free_list_t *fl)
 {
-    opal_free_list_item_t *item =
-        (opal_free_list_item_t *) opal_lifo_pop_atomic (&fl->super);
+    opal_free_list_item_t *item = NULL;
+
+#if OPAL_HAVE_THREAD_LOCAL
+    if (NULL != fl->fl_magazines) {
+        item = opal_free_list_magazine_get (fl);
+    }
+#endif /* OPAL_HAVE_THREAD_LOCAL */
+
+    if (NULL == item) {
+        item = (opal_free_list_item_t *) opal_lifo_pop_atomic (&fl->super);
+    }
 
     while (NULL == item) {
         if (!opal_mutex_trylock (&fl->fl_lock)) {
             if (fl->fl_max_to_alloc <= fl->fl_num_allocated ||
                 OPAL_SUCCESS != opal_free_list_grow_st (fl, fl->fl_num_per_alloc, &item)) {
                 fl->fl_num_waiting++;
-                opal_condition_wait (&fl->fl_condition, &fl->fl_lock);
+                if (NULL != fl->fl_magazines) {
+                    /* items returned from now on go to the shared LIFO */
+                    opal_free_list_magazines_flush (fl);
+                    item = (opal_free_list_item_t *) opal_lifo_pop_atomic (&fl->super);
+                }
+                if (NULL == item) {
+                    opal_condition_wait (&fl->fl_condition, &fl->fl_lock);
+                }
                 fl->fl_num_waiting--;
             } else {
                 if (0 < fl->fl_num_waiting) {
@@ -327,14 +475,22 @@ static inline void opal_free_list_return_mt (opal_free_list_t *flist,
 {
     opal_list_item_t* original;
 
+#if OPAL_HAVE_THREAD_LOCAL
+    if (NULL != flist->fl_magazines && opal_free_list_magazine_return (flist, item)) {
+        return;
+    }
+#endif /* OPAL_HAVE_THREAD_LOCAL */
+
     original = opal_lifo_push_atomic (&flist->super, &item->super);
     if (&flist->super.opal_lifo_ghost == original) {
         if (flist->fl_num_waiting > 0) {
             /* one one item is being returned so it doesn't make sense to wake
-             * more than a single waiting thread. additionally, posix thread
-             * semantics do not require that the lock be held to signal the
-             * condition variable. */
+             * more than a single waiting thread. a waiting thread holds the
+             * lock from its last look at the LIFO until it sleeps, so take it
+             * or the signal may come before the wait and be lost. */
+            opal_mutex_lock (&flist->fl_lock);
             opal_condition_signal (&flist->fl_condition);
+            opal_mutex_unlock (&flist->fl_lock);
         }
     }
 }
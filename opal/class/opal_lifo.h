@@ -161,6 +161,25 @@ static inline opal_list_item_t *opal_lifo_push_atomic (opal_lifo_t *lifo,
     } while (1);
 }
 
+/* Add a chain of elements linked through opal_list_next, from first to last,
+ * to the LIFO with a single update of the head.
+ */
+static inline opal_list_item_t *opal_lifo_push_chain_atomic (opal_lifo_t *lifo,
+                                                             opal_list_item_t *first,
+                                                             opal_list_item_t *last)
+{
+    opal_list_item_t *next = (opal_list_item_t *) lifo->opal_lifo_head.data.item;
+
+    do {
+        last->opal_list_next = next;
+        opal_atomic_wmb ();
+
+        if (opal_atomic_compare_exchange_strong_ptr (&lifo->opal_lifo_head.data.item, (intptr_t *) &next, (intptr_t) first)) {
+            return next;
+        }
+    } while (1);
+}
+
 /* Retrieve one element from the LIFO. If we reach the ghost element then the LIFO
  * is empty so we return NULL.
  */
@@ -213,6 +232,33 @@ static inline opal_list_item_t *opal_lifo_push_atomic (opal_lifo_t *lifo,
     } while (1);
 }
 
+/* Add a chain of elements linked through opal_list_next, from first to last,
+ * to the LIFO with a single update of the head.
+ */
+static inline opal_list_item_t *opal_lifo_push_chain_atomic (opal_lifo_t *lifo,
+                                                             opal_list_item_t *first,
+                                                             opal_list_item_t *last)
+{
+    opal_list_item_t *next = (opal_list_item_t *) lifo->opal_lifo_head.data.item;
+
+    /* only the head of the chain can be seen by a concurrent pop before the
+     * chain is in place */
+    for (opal_list_item_t *item = first ; item != last ; item = (opal_list_item_t *) item->opal_list_next) {
+        ((opal_list_item_t *) item->opal_list_next)->item_free = 0;
+    }
+    first->item_free = 1;
+
+    do {
+        last->opal_list_next = next;
+        opal_atomic_wmb();
+        if (opal_atomic_compare_exchange_strong_ptr (&lifo->opal_lifo_head.data.item, (intptr_t *) &next, (intptr_t) first)) {
+            opal_atomic_wmb ();
+            first->item_free = 0;
+            return next;
+        }
+    } while (1);
+}
+
 #if OPAL_HAVE_ATOMIC_LLSC_PTR
 
 /* Retrieve one element from the LIFO. If we reach the ghost element then the LIFO
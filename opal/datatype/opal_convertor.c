@@ -31,6 +31,7 @@
 #include "opal/prefetch.h"
 #include "opal/util/arch.h"
 #include "opal/util/output.h"
+#include "opal/mca/threads/threads.h"
 
 #include "opal/datatype/opal_datatype_internal.h"
 #include "opal/datatype/opal_datatype.h"
@@ -194,6 +195,274 @@ opal_convertor_t* opal_convertor_create( int32_t remote_arch, int32_t mode )
     return convertor;
 }
 
+/**
+ * A range of the packed stream converted by a helper thread, using its own clone
+ * of the convertor already moved at the beginning of the range.
+ */
+typedef struct {
+    opal_convertor_t convertor;
+    struct iovec     iov;
+    size_t           length;     /**< bytes in the range */
+    size_t           converted;  /**< bytes actually converted */
+} opal_convertor_range_t;
+
+static void opal_convertor_range_run( opal_convertor_range_t* range )
+{
+    uint32_t iov_count = 1;
+
+    range->converted = range->iov.iov_len;
+    range->convertor.fAdvance( &range->convertor, &range->iov, &iov_count, &range->converted );
+}
+
+/**
+ * The helper threads are started by the first split call, and live until the
+ * datatype engine is finalized. A split call posts its ranges as a batch, then
+ * the workers and the caller, once done with its own range, take them one
+ * after the other. A call finding the workers busy with another batch converts
+ * all its ranges itself.
+ */
+static opal_mutex_t opal_convertor_workers_lock = OPAL_MUTEX_STATIC_INIT;
+static opal_cond_t opal_convertor_workers_post_cond = OPAL_CONDITION_STATIC_INIT;
+static opal_cond_t opal_convertor_workers_done_cond = OPAL_CONDITION_STATIC_INIT;
+static opal_thread_t* opal_convertor_workers = NULL;
+static uint32_t opal_convertor_nworkers = 0;
+static bool opal_convertor_workers_shutdown = false;
+static bool opal_convertor_workers_busy = false;
+static opal_convertor_range_t* opal_convertor_batch = NULL;
+static uint32_t opal_convertor_batch_length = 0;
+static uint32_t opal_convertor_batch_next = 0;
+static uint32_t opal_convertor_batch_done = 0;
+
+/* convert the next range of the batch, called and returns with the lock held */
+static void opal_convertor_batch_run_next( void )
+{
+    opal_convertor_range_t* range = &opal_convertor_batch[opal_convertor_batch_next++];
+
+    opal_mutex_unlock( &opal_convertor_workers_lock );
+    opal_convertor_range_run( range );
+    opal_mutex_lock( &opal_convertor_workers_lock );
+    if( ++opal_convertor_batch_done == opal_convertor_batch_length ) {
+        opal_cond_broadcast( &opal_convertor_workers_done_cond );
+    }
+}
+
+static void* opal_convertor_worker_run( opal_object_t* obj )
+{
+    opal_mutex_lock( &opal_convertor_workers_lock );
+    while( !opal_convertor_workers_shutdown ) {
+        if( opal_convertor_batch_next < opal_convertor_batch_length ) {
+            opal_convertor_batch_run_next();
+        } else {
+            opal_cond_wait( &opal_convertor_workers_post_cond, &opal_convertor_workers_lock );
+        }
+    }
+    opal_mutex_unlock( &opal_convertor_workers_lock );
+    return NULL;
+}
+
+/* start the helper threads, called with the lock held */
+static void opal_convertor_workers_start( void )
+{
+    uint32_t i, nworkers = opal_ddt_parallel_threads - 1;
+
+    opal_convertor_workers = (opal_thread_t*)calloc( nworkers, sizeof(opal_thread_t) );
+    if( NULL == opal_convertor_workers ) return;
+    for( i = 0; i < nworkers; i++ ) {
+        OBJ_CONSTRUCT( &opal_convertor_workers[i], opal_thread_t );
+        opal_convertor_workers[i].t_run = opal_convertor_worker_run;
+        if( OPAL_SUCCESS != opal_thread_start( &opal_convertor_workers[i] ) ) {
+            OBJ_DESTRUCT( &opal_convertor_workers[i] );
+            break;
+        }
+    }
+    opal_convertor_nworkers = i;
+}
+
+/**
+ * Post the NRANGES ranges to the helper threads. Returns false if the
+ * workers are not available, in which case the caller converts them.
+ */
+static bool opal_convertor_batch_post( opal_convertor_range_t* ranges, uint32_t nranges )
+{
+    opal_mutex_lock( &opal_convertor_workers_lock );
+    if( opal_convertor_workers_busy ) {
+        opal_mutex_unlock( &opal_convertor_workers_lock );
+        return false;
+    }
+    if( NULL == opal_convertor_workers ) {
+        opal_convertor_workers_start();
+    }
+    if( 0 == opal_convertor_nworkers ) {
+        opal_mutex_unlock( &opal_convertor_workers_lock );
+        return false;
+    }
+    opal_convertor_workers_busy = true;
+    opal_convertor_batch = ranges;
+    opal_convertor_batch_length = nranges;
+    opal_convertor_batch_next = 0;
+    opal_convertor_batch_done = 0;
+    opal_cond_broadcast( &opal_convertor_workers_post_cond );
+    opal_mutex_unlock( &opal_convertor_workers_lock );
+    return true;
+}
+
+/* help with the ranges not yet taken, then wait for the whole batch */
+static void opal_convertor_batch_wait( void )
+{
+    opal_mutex_lock( &opal_convertor_workers_lock );
+    while( opal_convertor_batch_next < opal_convertor_batch_length ) {
+        opal_convertor_batch_run_next();
+    }
+    while( opal_convertor_batch_done < opal_convertor_batch_length ) {
+        opal_cond_wait( &opal_convertor_workers_done_cond, &opal_convertor_workers_lock );
+    }
+    opal_convertor_batch = NULL;
+    opal_convertor_batch_length = opal_convertor_batch_next = opal_convertor_batch_done = 0;
+    opal_convertor_workers_busy = false;
+    opal_mutex_unlock( &opal_convertor_workers_lock );
+}
+
+void opal_convertor_destroy_workers( void )
+{
+    uint32_t i;
+
+    if( NULL == opal_convertor_workers ) return;
+    opal_mutex_lock( &opal_convertor_workers_lock );
+    opal_convertor_workers_shutdown = true;
+    opal_cond_broadcast( &opal_convertor_workers_post_cond );
+    opal_mutex_unlock( &opal_convertor_workers_lock );
+    for( i = 0; i < opal_convertor_nworkers; i++ ) {
+        opal_thread_join( &opal_convertor_workers[i], NULL );
+        OBJ_DESTRUCT( &opal_convertor_workers[i] );
+    }
+    free( opal_convertor_workers );
+    opal_convertor_workers = NULL;
+    opal_convertor_nworkers = 0;
+    opal_convertor_workers_shutdown = false;
+}
+
+static inline bool
+opal_convertor_need_parallel( const opal_convertor_t* pConv,
+                              const struct iovec* iov, uint32_t out_size )
+{
+    return (opal_ddt_parallel_threads > 1) && (1 == out_size) && (NULL != iov[0].iov_base) &&
+        (iov[0].iov_len >= opal_ddt_parallel_min) &&
+        ((pConv->local_size - pConv->bConverted) >= opal_ddt_parallel_min) &&
+        (0 == pConv->partial_length) && (pConv->flags & CONVERTOR_HOMOGENEOUS) &&
+        !(pConv->flags & (CONVERTOR_WITH_CHECKSUM | CONVERTOR_CUDA | CONVERTOR_CUDA_UNIFIED));
+}
+
+/**
+ * Prepare CONVERTOR as a copy of SOURCE moved at POSITION, rounded down to the
+ * beginning of a predefined type. The position is always computed from the
+ * beginning of the data, as chained repositionings of the same convertor are
+ * not supported by the generic engine.
+ */
+static void
+opal_convertor_range_position( const opal_convertor_t* source,
+                               opal_convertor_t* convertor,
+                               size_t* position )
+{
+    OBJ_CONSTRUCT( convertor, opal_convertor_t );
+    opal_convertor_clone( source, convertor, 0 );
+    convertor->flags |= CONVERTOR_SEND;  /* only send convertors are kept on predefined types */
+    opal_convertor_set_position( convertor, position );
+    convertor->flags = (convertor->flags & ~CONVERTOR_SEND) | (source->flags & CONVERTOR_SEND);
+}
+
+/**
+ * Split a large homogeneous pack or unpack between opal_ddt_parallel_threads
+ * threads. The packed stream is cut in ranges starting on predefined types
+ * boundaries, so that no range has to deal with partial elements, and each
+ * helper thread gets its own clone of the convertor moved at the beginning
+ * of its range. The caller converts the first range with the original
+ * convertor, then moves it after the last range and converts whatever is
+ * left, usually less than a predefined type, sequentially.
+ */
+static int32_t
+opal_convertor_parallel_advance( opal_convertor_t* pConv,
+                                 struct iovec* iov, uint32_t* out_size,
+                                 size_t* max_data )
+{
+    uint32_t i, iov_count, nranges = opal_ddt_parallel_threads;
+    unsigned char* buffer = (unsigned char*)iov[0].iov_base;
+    size_t start = pConv->bConverted, length, position, total;
+    opal_convertor_range_t* ranges;
+    opal_convertor_t last;
+    struct iovec tail;
+    bool posted;
+
+    length = pConv->local_size - start;
+    if( length > iov[0].iov_len ) length = iov[0].iov_len;
+
+    ranges = (opal_convertor_range_t*)calloc( nranges, sizeof(opal_convertor_range_t) );
+    if( NULL == ranges ) {
+        return pConv->fAdvance( pConv, iov, out_size, max_data );
+    }
+
+    ranges[0].iov.iov_base = buffer;
+    for( i = 1; i < nranges; i++ ) {
+        position = start + (length / nranges) * i;
+        opal_convertor_range_position( pConv, &ranges[i].convertor, &position );
+        if( position < start ) position = start;
+        ranges[i].iov.iov_base = buffer + (position - start);
+        ranges[i - 1].length = (unsigned char*)ranges[i].iov.iov_base - (unsigned char*)ranges[i - 1].iov.iov_base;
+    }
+    ranges[nranges - 1].length = buffer + length - (unsigned char*)ranges[nranges - 1].iov.iov_base;
+
+    for( i = 1; i < nranges; i++ ) {
+        ranges[i].iov.iov_len = ranges[i].length;
+    }
+    posted = opal_convertor_batch_post( ranges + 1, nranges - 1 );
+
+    iov_count = 1;
+    ranges[0].iov.iov_len = ranges[0].length;
+    ranges[0].converted = ranges[0].length;
+    pConv->fAdvance( pConv, &ranges[0].iov, &iov_count, &ranges[0].converted );
+
+    if( posted ) {
+        opal_convertor_batch_wait();
+    } else {  /* no helper thread available, do it ourselves */
+        for( i = 1; i < nranges; i++ ) {
+            opal_convertor_range_run( &ranges[i] );
+        }
+    }
+
+    /* the data is only valid up to the first range not entirely converted */
+    for( total = 0, i = 0; i < nranges; i++ ) {
+        total += ranges[i].converted;
+        if( ranges[i].converted != ranges[i].length ) break;
+    }
+    for( i = 1; i < nranges; i++ ) {
+        OBJ_DESTRUCT( &ranges[i].convertor );
+    }
+    free( ranges );
+
+    position = start + total;
+    if( position != pConv->bConverted ) {  /* move the original convertor after the ranges */
+        opal_convertor_range_position( pConv, &last, &position );
+        memcpy( pConv->pStack, last.pStack, sizeof(dt_stack_t) * (last.stack_pos + 1) );
+        pConv->stack_pos      = last.stack_pos;
+        pConv->bConverted     = last.bConverted;
+        pConv->partial_length = 0;
+        pConv->flags         |= (last.flags & CONVERTOR_COMPLETED);
+        OBJ_DESTRUCT( &last );
+    }
+    total = pConv->bConverted - start;
+    if( (total < length) && !(pConv->flags & CONVERTOR_COMPLETED) ) {
+        tail.iov_base = buffer + total;
+        tail.iov_len  = length - total;
+        iov_count = 1;
+        *max_data = tail.iov_len;
+        pConv->fAdvance( pConv, &tail, &iov_count, max_data );
+        total += *max_data;
+    }
+    iov[0].iov_len = total;
+    *max_data = total;
+    *out_size = 1;
+    return !!(pConv->flags & CONVERTOR_COMPLETED);
+}
+
 #define OPAL_CONVERTOR_SET_STATUS_BEFORE_PACK_UNPACK( CONVERTOR, IOV, OUT, MAX_DATA ) \
     do {                                                                \
         /* protect against over packing data */                         \
@@ -269,6 +538,9 @@ complete_contiguous_data_pack:
         return 1;
     }
 
+    if( OPAL_UNLIKELY(opal_convertor_need_parallel( pConv, iov, *out_size )) ) {
+        return opal_convertor_parallel_advance( pConv, iov, out_size, max_data );
+    }
     return pConv->fAdvance( pConv, iov, out_size, max_data );
 }
 
@@ -321,6 +593,9 @@ complete_contiguous_data_unpack:
         return 1;
     }
 
+    if( OPAL_UNLIKELY(opal_convertor_need_parallel( pConv, iov, *out_size )) ) {
+        return opal_convertor_parallel_advance( pConv, iov, out_size, max_data );
+    }
     return pConv->fAdvance( pConv, iov, out_size, max_data );
 }
 
@@ -371,6 +646,42 @@ opal_convertor_create_stack_with_pos_contig( opal_convertor_t* pConvertor,
     return OPAL_SUCCESS;
 }
 
+/**
+ * Position a convertor using the flattened description of the datatype. See
+ * opal_pack_homogeneous_flat for the meaning of the stack entries.
+ */
+static inline int
+opal_convertor_create_stack_with_pos_flat( opal_convertor_t* pConvertor,
+                                           size_t starting_point )
+{
+    dt_stack_t* pStack = pConvertor->pStack;
+    const opal_datatype_t* pData = pConvertor->pDesc;
+    const opal_datatype_flat_elem_t* flat = pData->flat_desc.desc;
+    size_t count = starting_point / pData->size;
+    uint32_t index = 0;
+
+    pStack[0].type  = OPAL_DATATYPE_LOOP;
+    pStack[0].count = pConvertor->count - count;
+    pStack[0].index = -1;
+    pStack[0].disp  = count * (pData->ub - pData->lb);
+
+    /* find the block containing the remaining bytes */
+    count = starting_point % pData->size;
+    while( count >= (flat[index].length * flat[index].count) ) {
+        count -= flat[index].length * flat[index].count;
+        index++;
+    }
+    pStack[1].type  = OPAL_DATATYPE_UINT1;
+    pStack[1].index = index;
+    pStack[1].count = count / flat[index].length;
+    pStack[1].disp  = count % flat[index].length;
+
+    pConvertor->bConverted     = starting_point;
+    pConvertor->stack_pos      = 1;
+    pConvertor->partial_length = 0;
+    return OPAL_SUCCESS;
+}
+
 static inline int
 opal_convertor_create_stack_at_begining( opal_convertor_t* convertor,
                                          const size_t* sizes )
@@ -399,7 +710,10 @@ opal_convertor_create_stack_at_begining( opal_convertor_t* convertor,
 
     pStack[1].index = 0;
     pStack[1].disp = 0;
-    if( pElems[0].elem.common.type == OPAL_DATATYPE_LOOP ) {
+    if( convertor->flags & CONVERTOR_FLAT ) {
+        pStack[1].count = 0;
+        pStack[1].type  = OPAL_DATATYPE_UINT1;
+    } else if( pElems[0].elem.common.type == OPAL_DATATYPE_LOOP ) {
         pStack[1].count = pElems[0].loop.loops;
         pStack[1].type  = OPAL_DATATYPE_LOOP;
     } else {
@@ -424,6 +738,8 @@ int32_t opal_convertor_set_position_nocheck( opal_convertor_t* convertor,
     if( OPAL_LIKELY(convertor->flags & OPAL_DATATYPE_FLAG_CONTIGUOUS) ) {
         rc = opal_convertor_create_stack_with_pos_contig( convertor, (*position),
                                                           opal_datatype_local_sizes );
+    } else if( convertor->flags & CONVERTOR_FLAT ) {
+        rc = opal_convertor_create_stack_with_pos_flat( convertor, (*position) );
     } else {
         if( (0 == (*position)) || ((*position) < convertor->bConverted) ) {
             rc = opal_convertor_create_stack_at_begining( convertor, opal_datatype_local_sizes );
@@ -548,6 +864,10 @@ size_t opal_convertor_compute_remote_size( opal_convertor_t* pConvertor )
             return OPAL_SUCCESS;                                        \
         }                                                               \
         convertor->flags &= ~CONVERTOR_NO_OP;                           \
+        if( (convertor->flags & CONVERTOR_HOMOGENEOUS) &&               \
+            (0 != datatype->flat_desc.used) ) {                         \
+            convertor->flags |= CONVERTOR_FLAT;                         \
+        }                                                               \
         {                                                               \
             uint32_t required_stack_length = datatype->loops + 1;       \
                                                                         \
@@ -586,6 +906,8 @@ int32_t opal_convertor_prepare_for_recv( opal_convertor_t* convertor,
         } else {
             if( convertor->pDesc->flags & OPAL_DATATYPE_FLAG_CONTIGUOUS ) {
                 convertor->fAdvance = opal_unpack_homogeneous_contig_checksum;
+            } else if( convertor->flags & CONVERTOR_FLAT ) {
+                convertor->fAdvance = opal_unpack_homogeneous_flat_checksum;
             } else {
                 convertor->fAdvance = opal_generic_simple_unpack_checksum;
             }
@@ -597,6 +919,8 @@ int32_t opal_convertor_prepare_for_recv( opal_convertor_t* convertor,
         } else {
             if( convertor->pDesc->flags & OPAL_DATATYPE_FLAG_CONTIGUOUS ) {
                 convertor->fAdvance = opal_unpack_homogeneous_contig;
+            } else if( convertor->flags & CONVERTOR_FLAT ) {
+                convertor->fAdvance = opal_unpack_homogeneous_flat;
             } else {
                 convertor->fAdvance = opal_generic_simple_unpack;
             }
@@ -630,6 +954,8 @@ int32_t opal_convertor_prepare_for_send( opal_convertor_t* convertor,
                     convertor->fAdvance = opal_pack_homogeneous_contig_checksum;
                 else
                     convertor->fAdvance = opal_pack_homogeneous_contig_with_gaps_checksum;
+            } else if( convertor->flags & CONVERTOR_FLAT ) {
+                convertor->fAdvance = opal_pack_homogeneous_flat_checksum;
             } else {
                 convertor->fAdvance = opal_generic_simple_pack_checksum;
             }
@@ -645,6 +971,8 @@ int32_t opal_convertor_prepare_for_send( opal_convertor_t* convertor,
                     convertor->fAdvance = opal_pack_homogeneous_contig;
                 else
                     convertor->fAdvance = opal_pack_homogeneous_contig_with_gaps;
+            } else if( convertor->flags & CONVERTOR_FLAT ) {
+                convertor->fAdvance = opal_pack_homogeneous_flat;
             } else {
                 convertor->fAdvance = opal_generic_simple_pack;
             }
@@ -716,6 +1044,7 @@ void opal_convertor_dump( opal_convertor_t* convertor )
     if( convertor->flags & CONVERTOR_HOMOGENEOUS ) opal_output( 0, "homogeneous " );
     else opal_output( 0, "heterogeneous ");
     if( convertor->flags & CONVERTOR_NO_OP ) opal_output( 0, "no_op ");
+    if( convertor->flags & CONVERTOR_FLAT ) opal_output( 0, "flat ");
     if( convertor->flags & CONVERTOR_WITH_CHECKSUM ) opal_output( 0, "checksum ");
     if( convertor->flags & CONVERTOR_CUDA ) opal_output( 0, "CUDA ");
     if( convertor->flags & CONVERTOR_CUDA_ASYNC ) opal_output( 0, "CUDA Async ");
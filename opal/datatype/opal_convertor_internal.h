@@ -49,6 +49,11 @@ opal_convertor_master_t* opal_convertor_find_or_create_master( uint32_t remote_a
  */
 void opal_convertor_destroy_masters( void );
 
+/*
+ * Stop the helper threads of the parallel pack and unpack, if they were started.
+ */
+void opal_convertor_destroy_workers( void );
+
 
 END_C_DECLS
 
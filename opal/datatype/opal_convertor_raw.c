@@ -53,6 +53,60 @@ opal_convertor_merge_iov( struct iovec* iov, uint32_t* iov_count,
     return 0;
 }
 
+/**
+ * Walk the flattened description of the datatype and generate the
+ * corresponding iovecs. The stack is used as in opal_pack_homogeneous_flat.
+ */
+static int32_t
+opal_convertor_raw_flat( opal_convertor_t* pConvertor,
+                         struct iovec* iov, uint32_t* iov_count,
+                         size_t* length )
+{
+    const opal_datatype_t *pData = pConvertor->pDesc;
+    const opal_datatype_flat_elem_t* flat = pData->flat_desc.desc;
+    dt_stack_t* stack = pConvertor->pStack;
+    ptrdiff_t extent = pData->ub - pData->lb;
+    unsigned char *source_base;
+    size_t sum_iov_len = 0, blength;
+    uint32_t index = 0;
+
+    iov[index].iov_len = 0;
+    while( 0 != stack[0].count ) {
+        const opal_datatype_flat_elem_t* elem = &(flat[stack[1].index]);
+
+        source_base = pConvertor->pBaseBuf + stack[0].disp + elem->disp +
+            (ptrdiff_t)stack[1].count * elem->extent + stack[1].disp;
+        blength = elem->length - stack[1].disp;
+        OPAL_DATATYPE_SAFEGUARD_POINTER( source_base, blength, pConvertor->pBaseBuf,
+                                         pConvertor->pDesc, pConvertor->count );
+        DO_DEBUG( opal_output( 0, "raw flat iov[%d] = {base %p, length %" PRIsize_t "}\n",
+                               index, (void*)source_base, blength ); );
+        if( opal_convertor_merge_iov( iov, iov_count,
+                                      (IOVBASE_TYPE *) source_base, blength, &index ) )
+            break;  /* no more iovec available, bail out */
+        sum_iov_len += blength;
+        stack[1].disp = 0;
+        if( ++stack[1].count == elem->count ) {
+            stack[1].count = 0;
+            if( ++stack[1].index == pData->flat_desc.used ) {
+                stack[1].index = 0;
+                stack[0].disp += extent;
+                stack[0].count--;
+            }
+        }
+    }
+    if( 0 == stack[0].count ) index++;  /* account for the currently updating iovec */
+
+    pConvertor->bConverted += sum_iov_len;  /* update the already converted bytes */
+    *length = sum_iov_len;
+    *iov_count = index;
+    if( pConvertor->bConverted == pConvertor->local_size ) {
+        pConvertor->flags |= CONVERTOR_COMPLETED;
+        return 1;
+    }
+    return 0;
+}
+
 /**
  * This function always work in local representation. This means no representation
  * conversion (i.e. no heterogeneity) is taken into account, and that all
@@ -98,6 +152,10 @@ opal_convertor_raw( opal_convertor_t* pConvertor,
     DO_DEBUG( opal_output( 0, "opal_convertor_raw( %p, {%p, %" PRIu32 "}, %"PRIsize_t " )\n", (void*)pConvertor,
                            (void*)iov, *iov_count, *length ); );
 
+    if( pConvertor->flags & CONVERTOR_FLAT ) {
+        return opal_convertor_raw_flat( pConvertor, iov, iov_count, length );
+    }
+
     description = pConvertor->use_desc->desc;
 
     /* For the first step we have to add both displacement to the source. After in the
@@ -100,6 +100,26 @@ struct dt_type_desc_t {
 };
 typedef struct dt_type_desc_t dt_type_desc_t;
 
+/**
+ * One entry of the flattened representation of a datatype: count blocks of
+ * length bytes each, the first one starting at disp and the following ones
+ * every extent bytes. The displacements are relative to the beginning of
+ * the datatype, exactly as the disp of the basic elements in the description.
+ */
+struct opal_datatype_flat_elem_t {
+    ptrdiff_t              disp;    /**< displacement of the first block */
+    size_t                 length;  /**< length in bytes of each block */
+    size_t                 count;   /**< number of blocks */
+    ptrdiff_t              extent;  /**< distance between the beginning of two consecutive blocks */
+};
+typedef struct opal_datatype_flat_elem_t opal_datatype_flat_elem_t;
+
+struct opal_datatype_flat_desc_t {
+    uint32_t                   used;  /**< the number of valid entries (0 if not available) */
+    opal_datatype_flat_elem_t* desc;
+};
+typedef struct opal_datatype_flat_desc_t opal_datatype_flat_desc_t;
+
 
 /*
  * The datatype description.
@@ -125,6 +145,8 @@ struct opal_datatype_t {
     dt_type_desc_t     desc;     /**< the data description */
     dt_type_desc_t     opt_desc; /**< short description of the data used when conversion is useless
                                       or in the send case (without conversion) */
+    opal_datatype_flat_desc_t flat_desc; /**< flattened version of the optimized description built at
+                                              commit time, used by the homogeneous convertors */
 
     size_t             *ptypes;  /**< array of basic predefined types that facilitate the computing
                                       of the remote size in heterogeneous environments. The length of the
@@ -132,10 +154,10 @@ struct opal_datatype_t {
                                       all language interfaces (because Fortran is not known at the OPAL
                                       layer). This field should never be initialized in homogeneous
                                       environments */
-    /* --- cacheline 5 boundary (320 bytes) was 32-36 bytes ago --- */
+    /* --- cacheline 5 boundary (320 bytes) was 48-52 bytes ago --- */
 
-    /* size: 352, cachelines: 6, members: 15 */
-    /* last cacheline: 28-32 bytes */
+    /* size: 368, cachelines: 6, members: 16 */
+    /* last cacheline: 44-48 bytes */
 };
 
 typedef struct opal_datatype_t opal_datatype_t;
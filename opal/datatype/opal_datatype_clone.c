@@ -45,6 +45,16 @@ int32_t opal_datatype_clone( const opal_datatype_t * src_type, opal_datatype_t *
     dest_type->flags &= (~OPAL_DATATYPE_FLAG_PREDEFINED);
     dest_type->ptypes = NULL;
     dest_type->desc.desc = temp;
+    dest_type->flat_desc.desc = NULL;
+    if( 0 != src_type->flat_desc.used ) {
+        dest_type->flat_desc.desc = (opal_datatype_flat_elem_t*)malloc( src_type->flat_desc.used * sizeof(opal_datatype_flat_elem_t) );
+        if( NULL == dest_type->flat_desc.desc ) {
+            dest_type->flat_desc.used = 0;  /* the flattened description is optional */
+        } else {
+            memcpy( dest_type->flat_desc.desc, src_type->flat_desc.desc,
+                    src_type->flat_desc.used * sizeof(opal_datatype_flat_elem_t) );
+        }
+    }
 
     /**
      * Allow duplication of MPI_UB and MPI_LB.
@@ -53,6 +53,9 @@ static void opal_datatype_construct( opal_datatype_t* pData )
     pData->opt_desc.length    = 0;
     pData->opt_desc.used      = 0;
 
+    pData->flat_desc.desc     = NULL;
+    pData->flat_desc.used     = 0;
+
     pData->ptypes             = NULL;
     pData->loops              = 0;
 }
@@ -63,6 +66,11 @@ static void opal_datatype_destruct( opal_datatype_t* datatype )
      * As the default description and the optimized description might point to the
      * same data description we should start by cleaning the optimized description.
      */
+    if( NULL != datatype->flat_desc.desc ) {
+        free( datatype->flat_desc.desc );
+        datatype->flat_desc.used = 0;
+        datatype->flat_desc.desc = NULL;
+    }
     if( NULL != datatype->opt_desc.desc ) {
         if( datatype->opt_desc.desc != datatype->desc.desc )
             free( datatype->opt_desc.desc );
@@ -606,6 +606,10 @@ extern bool opal_ddt_copy_debug;
 extern bool opal_ddt_unpack_debug;
 extern bool opal_ddt_pack_debug;
 extern bool opal_ddt_raw_debug;
+extern unsigned int opal_ddt_flatten_max;
+extern bool opal_ddt_simd_enable;
+extern unsigned int opal_ddt_parallel_threads;
+extern size_t opal_ddt_parallel_min;
 
 END_C_DECLS
 #endif  /* OPAL_DATATYPE_INTERNAL_H_HAS_BEEN_INCLUDED */
@@ -37,6 +37,7 @@
 #include "opal/datatype/opal_datatype_internal.h"
 #include "opal/datatype/opal_datatype.h"
 #include "opal/datatype/opal_convertor_internal.h"
+#include "opal/datatype/opal_datatype_simd.h"
 #include "opal/mca/base/mca_base_var.h"
 
 /* by default the debuging is turned off */
@@ -47,6 +48,10 @@ bool opal_ddt_position_debug = false;
 bool opal_ddt_copy_debug = false;
 bool opal_ddt_raw_debug = false;
 int opal_ddt_verbose = -1;  /* Has the datatype verbose it's own output stream */
+unsigned int opal_ddt_flatten_max = 0;  /* by default no flattened description is built */
+bool opal_ddt_simd_enable = true;
+unsigned int opal_ddt_parallel_threads = 0;  /* by default pack and unpack are not split */
+size_t opal_ddt_parallel_min = 16 * 1024 * 1024;
 
 extern int opal_cuda_verbose;
 
@@ -158,9 +163,49 @@ OPAL_DECLSPEC const opal_datatype_t* opal_datatype_basicDatatypes[OPAL_DATATYPE_
 
 int opal_datatype_register_params(void)
 {
-#if OPAL_ENABLE_DEBUG
     int ret;
 
+    ret = mca_base_var_register ("opal", "mpi", NULL, "ddt_flatten_max",
+                                 "Maximum number of entries in the flattened (displacement, length, count, "
+                                 "extent) description built when a non-contiguous datatype is committed. "
+                                 "Homogeneous pack, unpack and raw operations walk this list instead of the "
+                                 "datatype description. Datatypes requiring more entries keep using the "
+                                 "generic engine (0 = disabled)",
+                                 MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                 MCA_BASE_VAR_SCOPE_LOCAL, &opal_ddt_flatten_max);
+    if (0 > ret) {
+        return ret;
+    }
+
+    ret = mca_base_var_register ("opal", "mpi", NULL, "ddt_simd",
+                                 "Whether to use the SIMD (AVX2, AVX-512 or NEON) kernels to pack and unpack "
+                                 "strided datatypes made of 4 or 8 bytes blocks (nonzero = enabled)",
+                                 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                 MCA_BASE_VAR_SCOPE_READONLY, &opal_ddt_simd_enable);
+    if (0 > ret) {
+        return ret;
+    }
+
+    ret = mca_base_var_register ("opal", "mpi", NULL, "ddt_parallel_threads",
+                                 "Number of threads, including the caller, packing or unpacking concurrently "
+                                 "independent ranges of a large non-contiguous homogeneous buffer (0 or 1 = disabled)",
+                                 MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                 MCA_BASE_VAR_SCOPE_LOCAL, &opal_ddt_parallel_threads);
+    if (0 > ret) {
+        return ret;
+    }
+
+    ret = mca_base_var_register ("opal", "mpi", NULL, "ddt_parallel_min",
+                                 "Minimum amount of bytes converted by a single pack or unpack call before it is "
+                                 "split between mpi_ddt_parallel_threads threads",
+                                 MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                 MCA_BASE_VAR_SCOPE_LOCAL, &opal_ddt_parallel_min);
+    if (0 > ret) {
+        return ret;
+    }
+
+#if OPAL_ENABLE_DEBUG
+
     ret = mca_base_var_register ("opal", "mpi", NULL, "ddt_unpack_debug",
                                  "Whether to output debugging information in the ddt unpack functions (nonzero = enabled)",
                                  MCA_BASE_VAR_TYPE_BOOL, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_3,
@@ -237,6 +282,7 @@ static void opal_datatype_finalize (void)
      */
     /* clear all master convertors */
     opal_convertor_destroy_masters();
+    opal_convertor_destroy_workers();
 
     opal_output_close (opal_datatype_dfd);
     opal_datatype_dfd = -1;
@@ -273,6 +319,8 @@ int32_t opal_datatype_init( void )
         datatype->desc.desc[1].end_loop.size            = datatype->size;
     }
 
+    opal_datatype_simd_init();
+
     /* Enable a private output stream for datatype */
     if( opal_ddt_verbose > 0 ) {
         opal_datatype_dfd = opal_output_open(NULL);
@@ -258,6 +258,137 @@ opal_datatype_optimize_short( opal_datatype_t* pData,
     return OPAL_SUCCESS;
 }
 
+/**
+ * Append count blocks of length bytes, starting at disp and separated by extent,
+ * to the flattened description. Whenever possible the new blocks are merged with
+ * the last entry, either by extending the length of the last block (contiguous
+ * blocks), or by increasing the count of a repeated pattern.
+ */
+static int32_t
+opal_datatype_flat_append( opal_datatype_flat_desc_t* flat, uint32_t* length,
+                           ptrdiff_t disp, size_t blength, size_t count, ptrdiff_t extent )
+{
+    opal_datatype_flat_elem_t* last;
+
+    if( (0 == blength) || (0 == count) ) return OPAL_SUCCESS;
+    if( (1 == count) || ((ptrdiff_t)blength == extent) ) {  /* a single contiguous block */
+        blength *= count;
+        extent   = (ptrdiff_t)blength;
+        count    = 1;
+    }
+    if( 0 != flat->used ) {
+        last = &(flat->desc[flat->used - 1]);
+        if( (1 == last->count) && (1 == count) &&
+            ((last->disp + (ptrdiff_t)last->length) == disp) ) {
+            last->length += blength;
+            last->extent  = (ptrdiff_t)last->length;
+            return OPAL_SUCCESS;
+        }
+        if( last->length == blength ) {
+            if( 1 == last->count ) {
+                if( 1 == count ) {
+                    last->extent = disp - last->disp;
+                    last->count  = 2;
+                    return OPAL_SUCCESS;
+                }
+                if( (last->disp + extent) == disp ) {
+                    last->extent = extent;
+                    last->count += count;
+                    return OPAL_SUCCESS;
+                }
+            } else if( (last->disp + (ptrdiff_t)last->count * last->extent) == disp ) {
+                if( (1 == count) || (last->extent == extent) ) {
+                    last->count += count;
+                    return OPAL_SUCCESS;
+                }
+            }
+        }
+    }
+    if( flat->used == *length ) {
+        opal_datatype_flat_elem_t* desc;
+
+        if( *length == opal_ddt_flatten_max ) return OPAL_ERR_OUT_OF_RESOURCE;
+        *length = (2 * (*length) > opal_ddt_flatten_max) ? opal_ddt_flatten_max : 2 * (*length);
+        desc = (opal_datatype_flat_elem_t*)realloc( flat->desc, (*length) * sizeof(opal_datatype_flat_elem_t) );
+        if( NULL == desc ) return OPAL_ERR_OUT_OF_RESOURCE;
+        flat->desc = desc;
+    }
+    last = &(flat->desc[flat->used++]);
+    last->disp   = disp;
+    last->length = blength;
+    last->count  = count;
+    last->extent = extent;
+    return OPAL_SUCCESS;
+}
+
+/**
+ * Flatten the description starting at pElem up to the matching OPAL_DATATYPE_END_LOOP.
+ * Contiguous loops are represented by a single entry, all others are unrolled and
+ * rely on opal_datatype_flat_append to detect the repeated patterns.
+ */
+static int32_t
+opal_datatype_flatten_desc( opal_datatype_flat_desc_t* flat, uint32_t* length,
+                            const dt_elem_desc_t* pElem, ptrdiff_t disp )
+{
+    int32_t rc = OPAL_SUCCESS;
+
+    while( OPAL_DATATYPE_END_LOOP != pElem->elem.common.type ) {
+        if( OPAL_DATATYPE_LOOP == pElem->elem.common.type ) {
+            const ddt_loop_desc_t* loop = &(pElem->loop);
+            const ddt_endloop_desc_t* end_loop = &((pElem + loop->items)->end_loop);
+
+            if( loop->common.flags & OPAL_DATATYPE_FLAG_CONTIGUOUS ) {
+                rc = opal_datatype_flat_append( flat, length, disp + end_loop->first_elem_disp,
+                                                end_loop->size, loop->loops, loop->extent );
+            } else {
+                for( uint32_t i = 0; (i < loop->loops) && (OPAL_SUCCESS == rc); i++ ) {
+                    rc = opal_datatype_flatten_desc( flat, length, pElem + 1,
+                                                     disp + (ptrdiff_t)i * loop->extent );
+                }
+            }
+            pElem += loop->items + 1;
+        } else {
+            const ddt_elem_desc_t* elem = &(pElem->elem);
+
+            rc = opal_datatype_flat_append( flat, length, disp + elem->disp,
+                                            elem->blocklen * opal_datatype_basicDatatypes[elem->common.type]->size,
+                                            elem->count, elem->extent );
+            pElem++;
+        }
+        if( OPAL_SUCCESS != rc ) return rc;
+    }
+    return OPAL_SUCCESS;
+}
+
+/**
+ * Build the flattened description of a committed, non-contiguous datatype. This
+ * description is optional: if it would need more than opal_ddt_flatten_max entries
+ * the datatype is left without one, and the convertor keeps using the generic
+ * pack/unpack functions.
+ */
+static void
+opal_datatype_flatten( opal_datatype_t* pData )
+{
+    opal_datatype_flat_desc_t* flat = &(pData->flat_desc);
+    uint32_t length = (opal_ddt_flatten_max < 8) ? opal_ddt_flatten_max : 8;
+
+    flat->used = 0;
+    flat->desc = (opal_datatype_flat_elem_t*)malloc( length * sizeof(opal_datatype_flat_elem_t) );
+    if( NULL == flat->desc ) return;
+
+    if( OPAL_SUCCESS != opal_datatype_flatten_desc( flat, &length, pData->opt_desc.desc, 0 ) ) {
+        free( flat->desc );
+        flat->desc = NULL;
+        flat->used = 0;
+        return;
+    }
+    if( flat->used < length ) {  /* release the unused entries */
+        opal_datatype_flat_elem_t* desc = (opal_datatype_flat_elem_t*)realloc( flat->desc,
+                                                                               flat->used * sizeof(opal_datatype_flat_elem_t) );
+        if( NULL != desc ) flat->desc = desc;
+    }
+}
+
 int32_t opal_datatype_commit( opal_datatype_t * pData )
 {
     ddt_endloop_desc_t* pLast = &(pData->desc.desc[pData->desc.used].end_loop);
@@ -309,6 +440,10 @@ int32_t opal_datatype_commit( opal_datatype_t * pData )
         pLast->items           = pData->opt_desc.used;
         pLast->first_elem_disp = first_elem_disp;
         pLast->size            = pData->size;
+
+        if( (0 != opal_ddt_flatten_max) && !(pData->flags & OPAL_DATATYPE_FLAG_CONTIGUOUS) ) {
+            opal_datatype_flatten( pData );
+        }
     }
     return OPAL_SUCCESS;
 }
@@ -21,6 +21,7 @@
 
 #include "opal_config.h"
 #include "opal/datatype/opal_datatype_pack_unpack_predefined.h"
+#include "opal/datatype/opal_datatype_simd.h"
 
 #if !defined(CHECKSUM) && OPAL_CUDA_SUPPORT
 /* Make use of existing macro to do CUDA style memcpy */
@@ -109,6 +110,26 @@ pack_predefined_data( opal_convertor_t* CONVERTOR,
     /* premptively update the number of COUNT we will return. */
     *(COUNT) -= cando_count;
 
+#if !defined(CHECKSUM)
+    /* strided 4 or 8 bytes blocks: gather all full blocks at once */
+    if( (1 < _elem->count) && !(CONVERTOR->flags & CONVERTOR_CUDA) ) {
+        size_t block_bytes = blocklen_bytes * _elem->blocklen;
+        size_t blocks = cando_count / _elem->blocklen;
+        opal_datatype_strided_fn_t gather = opal_datatype_simd_kernel( opal_datatype_simd_gather,
+                                                                   block_bytes, _elem->extent );
+
+        if( (NULL != gather) && (0 != blocks) ) {
+            OPAL_DATATYPE_SAFEGUARD_POINTER( _memory, (blocks - 1) * _elem->extent + block_bytes,
+                                             (CONVERTOR)->pBaseBuf, (CONVERTOR)->pDesc, (CONVERTOR)->count );
+            gather( _packed, _memory, blocks, _elem->extent );
+            _packed     += blocks * block_bytes;
+            _memory     += blocks * _elem->extent;
+            cando_count -= blocks * _elem->blocklen;
+            if( 0 == cando_count ) goto update_and_return;
+        }
+    }
+#endif  /* !defined(CHECKSUM) */
+
     if(_elem->blocklen < 9) {
         if((!(CONVERTOR->flags & CONVERTOR_CUDA)) && OPAL_LIKELY(OPAL_SUCCESS ==
                     opal_datatype_pack_predefined_element(&_memory, &_packed, cando_count, _elem)))   {
@@ -68,6 +68,14 @@ opal_generic_simple_pack_checksum( opal_convertor_t* pConvertor,
                                    struct iovec* iov, uint32_t* out_size,
                                    size_t* max_data );
 int32_t
+opal_pack_homogeneous_flat( opal_convertor_t* pConv,
+                            struct iovec* iov, uint32_t* out_size,
+                            size_t* max_data );
+int32_t
+opal_pack_homogeneous_flat_checksum( opal_convertor_t* pConv,
+                                     struct iovec* iov, uint32_t* out_size,
+                                     size_t* max_data );
+int32_t
 opal_unpack_homogeneous_contig( opal_convertor_t* pConv,
                                 struct iovec* iov, uint32_t* out_size,
                                 size_t* max_data );
@@ -76,6 +84,14 @@ opal_unpack_homogeneous_contig_checksum( opal_convertor_t* pConv,
                                          struct iovec* iov, uint32_t* out_size,
                                          size_t* max_data );
 int32_t
+opal_unpack_homogeneous_flat( opal_convertor_t* pConv,
+                              struct iovec* iov, uint32_t* out_size,
+                              size_t* max_data );
+int32_t
+opal_unpack_homogeneous_flat_checksum( opal_convertor_t* pConv,
+                                       struct iovec* iov, uint32_t* out_size,
+                                       size_t* max_data );
+int32_t
 opal_generic_simple_unpack( opal_convertor_t* pConvertor,
                             struct iovec* iov, uint32_t* out_size,
                             size_t* max_data );
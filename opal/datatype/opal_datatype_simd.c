@@ -0,0 +1,247 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2004-2021 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "opal/datatype/opal_datatype_internal.h"
+#include "opal/datatype/opal_datatype_simd.h"
+
+#if defined(__x86_64__) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ >= 5)))
+#define OPAL_DATATYPE_SIMD_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define OPAL_DATATYPE_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+opal_datatype_strided_fn_t opal_datatype_simd_gather[OPAL_DATATYPE_SIMD_CLASSES] = { NULL, NULL };
+opal_datatype_strided_fn_t opal_datatype_simd_scatter[OPAL_DATATYPE_SIMD_CLASSES] = { NULL, NULL };
+
+/* the leftovers are moved one block at a time, with a constant size memcpy */
+#define OPAL_DATATYPE_SIMD_GATHER_TAIL( BYTES )                 \
+    for( ; i < count; i++ ) {                                   \
+        memcpy( packed, memory, (BYTES) );                      \
+        packed += (BYTES);                                      \
+        memory += stride;                                       \
+    }
+
+#define OPAL_DATATYPE_SIMD_SCATTER_TAIL( BYTES )                \
+    for( ; i < count; i++ ) {                                   \
+        memcpy( memory, packed, (BYTES) );                      \
+        packed += (BYTES);                                      \
+        memory += stride;                                       \
+    }
+
+#if defined(OPAL_DATATYPE_SIMD_X86)
+
+/* The gather and scatter instructions use byte offsets (scale of 1) so that
+ * any stride, including one not multiple of the block size, can be used.
+ */
+__attribute__((target("avx2")))
+static void gather4_avx2( unsigned char* packed, unsigned char* memory,
+                          size_t count, ptrdiff_t stride )
+{
+    const __m256i vindex = _mm256_set_epi64x( 3 * stride, 2 * stride, stride, 0 );
+    size_t i = 0;
+
+    for( ; (i + 4) <= count; i += 4 ) {
+        __m128i v = _mm256_i64gather_epi32( (const int*)memory, vindex, 1 );
+        _mm_storeu_si128( (__m128i*)packed, v );
+        packed += 16;
+        memory += 4 * stride;
+    }
+    OPAL_DATATYPE_SIMD_GATHER_TAIL( 4 );
+}
+
+__attribute__((target("avx2")))
+static void gather8_avx2( unsigned char* packed, unsigned char* memory,
+                          size_t count, ptrdiff_t stride )
+{
+    const __m256i vindex = _mm256_set_epi64x( 3 * stride, 2 * stride, stride, 0 );
+    size_t i = 0;
+
+    for( ; (i + 4) <= count; i += 4 ) {
+        __m256i v = _mm256_i64gather_epi64( (const long long*)memory, vindex, 1 );
+        _mm256_storeu_si256( (__m256i*)packed, v );
+        packed += 32;
+        memory += 4 * stride;
+    }
+    OPAL_DATATYPE_SIMD_GATHER_TAIL( 8 );
+}
+
+#define OPAL_DATATYPE_SIMD_AVX512_INDEX( STRIDE )                       \
+    _mm512_set_epi64( 7 * (STRIDE), 6 * (STRIDE), 5 * (STRIDE), 4 * (STRIDE), \
+                      3 * (STRIDE), 2 * (STRIDE), (STRIDE), 0 )
+
+__attribute__((target("avx512f")))
+static void gather4_avx512( unsigned char* packed, unsigned char* memory,
+                            size_t count, ptrdiff_t stride )
+{
+    const __m512i vindex = OPAL_DATATYPE_SIMD_AVX512_INDEX( stride );
+    size_t i = 0;
+
+    for( ; (i + 8) <= count; i += 8 ) {
+        __m256i v = _mm512_i64gather_epi32( vindex, memory, 1 );
+        _mm256_storeu_si256( (__m256i*)packed, v );
+        packed += 32;
+        memory += 8 * stride;
+    }
+    OPAL_DATATYPE_SIMD_GATHER_TAIL( 4 );
+}
+
+__attribute__((target("avx512f")))
+static void gather8_avx512( unsigned char* packed, unsigned char* memory,
+                            size_t count, ptrdiff_t stride )
+{
+    const __m512i vindex = OPAL_DATATYPE_SIMD_AVX512_INDEX( stride );
+    size_t i = 0;
+
+    for( ; (i + 8) <= count; i += 8 ) {
+        __m512i v = _mm512_i64gather_epi64( vindex, memory, 1 );
+        _mm512_storeu_si512( (void*)packed, v );
+        packed += 64;
+        memory += 8 * stride;
+    }
+    OPAL_DATATYPE_SIMD_GATHER_TAIL( 8 );
+}
+
+__attribute__((target("avx512f")))
+static void scatter4_avx512( unsigned char* packed, unsigned char* memory,
+                             size_t count, ptrdiff_t stride )
+{
+    const __m512i vindex = OPAL_DATATYPE_SIMD_AVX512_INDEX( stride );
+    size_t i = 0;
+
+    for( ; (i + 8) <= count; i += 8 ) {
+        __m256i v = _mm256_loadu_si256( (const __m256i*)packed );
+        _mm512_i64scatter_epi32( memory, vindex, v, 1 );
+        packed += 32;
+        memory += 8 * stride;
+    }
+    OPAL_DATATYPE_SIMD_SCATTER_TAIL( 4 );
+}
+
+__attribute__((target("avx512f")))
+static void scatter8_avx512( unsigned char* packed, unsigned char* memory,
+                             size_t count, ptrdiff_t stride )
+{
+    const __m512i vindex = OPAL_DATATYPE_SIMD_AVX512_INDEX( stride );
+    size_t i = 0;
+
+    for( ; (i + 8) <= count; i += 8 ) {
+        __m512i v = _mm512_loadu_si512( (const void*)packed );
+        _mm512_i64scatter_epi64( memory, vindex, v, 1 );
+        packed += 64;
+        memory += 8 * stride;
+    }
+    OPAL_DATATYPE_SIMD_SCATTER_TAIL( 8 );
+}
+
+#elif defined(OPAL_DATATYPE_SIMD_NEON)
+
+/* NEON has no gather or scatter, but loading (or storing) each lane
+ * separately still saves half of the memory operations.
+ */
+static void gather4_neon( unsigned char* packed, unsigned char* memory,
+                          size_t count, ptrdiff_t stride )
+{
+    uint32x4_t v = vdupq_n_u32( 0 );
+    size_t i = 0;
+
+    for( ; (i + 4) <= count; i += 4 ) {
+        v = vld1q_lane_u32( (const uint32_t*)(memory             ), v, 0 );
+        v = vld1q_lane_u32( (const uint32_t*)(memory +     stride), v, 1 );
+        v = vld1q_lane_u32( (const uint32_t*)(memory + 2 * stride), v, 2 );
+        v = vld1q_lane_u32( (const uint32_t*)(memory + 3 * stride), v, 3 );
+        vst1q_u32( (uint32_t*)packed, v );
+        packed += 16;
+        memory += 4 * stride;
+    }
+    OPAL_DATATYPE_SIMD_GATHER_TAIL( 4 );
+}
+
+static void gather8_neon( unsigned char* packed, unsigned char* memory,
+                          size_t count, ptrdiff_t stride )
+{
+    uint64x2_t v = vdupq_n_u64( 0 );
+    size_t i = 0;
+
+    for( ; (i + 2) <= count; i += 2 ) {
+        v = vld1q_lane_u64( (const uint64_t*)(memory         ), v, 0 );
+        v = vld1q_lane_u64( (const uint64_t*)(memory + stride), v, 1 );
+        vst1q_u64( (uint64_t*)packed, v );
+        packed += 16;
+        memory += 2 * stride;
+    }
+    OPAL_DATATYPE_SIMD_GATHER_TAIL( 8 );
+}
+
+static void scatter4_neon( unsigned char* packed, unsigned char* memory,
+                           size_t count, ptrdiff_t stride )
+{
+    size_t i = 0;
+
+    for( ; (i + 4) <= count; i += 4 ) {
+        uint32x4_t v = vld1q_u32( (const uint32_t*)packed );
+        vst1q_lane_u32( (uint32_t*)(memory             ), v, 0 );
+        vst1q_lane_u32( (uint32_t*)(memory +     stride), v, 1 );
+        vst1q_lane_u32( (uint32_t*)(memory + 2 * stride), v, 2 );
+        vst1q_lane_u32( (uint32_t*)(memory + 3 * stride), v, 3 );
+        packed += 16;
+        memory += 4 * stride;
+    }
+    OPAL_DATATYPE_SIMD_SCATTER_TAIL( 4 );
+}
+
+static void scatter8_neon( unsigned char* packed, unsigned char* memory,
+                           size_t count, ptrdiff_t stride )
+{
+    size_t i = 0;
+
+    for( ; (i + 2) <= count; i += 2 ) {
+        uint64x2_t v = vld1q_u64( (const uint64_t*)packed );
+        vst1q_lane_u64( (uint64_t*)(memory         ), v, 0 );
+        vst1q_lane_u64( (uint64_t*)(memory + stride), v, 1 );
+        packed += 16;
+        memory += 2 * stride;
+    }
+    OPAL_DATATYPE_SIMD_SCATTER_TAIL( 8 );
+}
+
+#endif  /* OPAL_DATATYPE_SIMD_X86 || OPAL_DATATYPE_SIMD_NEON */
+
+void opal_datatype_simd_init( void )
+{
+    if( !opal_ddt_simd_enable ) return;
+
+#if defined(OPAL_DATATYPE_SIMD_X86)
+    __builtin_cpu_init();
+    if( __builtin_cpu_supports("avx512f") ) {
+        opal_datatype_simd_gather[0]  = gather4_avx512;
+        opal_datatype_simd_gather[1]  = gather8_avx512;
+        opal_datatype_simd_scatter[0] = scatter4_avx512;
+        opal_datatype_simd_scatter[1] = scatter8_avx512;
+    } else if( __builtin_cpu_supports("avx2") ) {
+        /* AVX2 has no scatter, the unpack keeps using the predefined copy loops */
+        opal_datatype_simd_gather[0]  = gather4_avx2;
+        opal_datatype_simd_gather[1]  = gather8_avx2;
+    }
+#elif defined(OPAL_DATATYPE_SIMD_NEON)
+    opal_datatype_simd_gather[0]  = gather4_neon;
+    opal_datatype_simd_gather[1]  = gather8_neon;
+    opal_datatype_simd_scatter[0] = scatter4_neon;
+    opal_datatype_simd_scatter[1] = scatter8_neon;
+#endif  /* OPAL_DATATYPE_SIMD_X86 || OPAL_DATATYPE_SIMD_NEON */
+}
@@ -0,0 +1,72 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2004-2021 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef OPAL_DATATYPE_SIMD_H_HAS_BEEN_INCLUDED
+#define OPAL_DATATYPE_SIMD_H_HAS_BEEN_INCLUDED
+
+#include "opal_config.h"
+
+#include <stddef.h>
+
+BEGIN_C_DECLS
+
+/**
+ * Kernels moving COUNT blocks of a fixed size between a strided memory
+ * layout, with STRIDE bytes between the beginning of two consecutive blocks,
+ * and a packed buffer. The gather kernels copy from memory into packed, the
+ * scatter kernels from packed into memory.
+ */
+typedef void (*opal_datatype_strided_fn_t)( unsigned char* packed, unsigned char* memory,
+                                            size_t count, ptrdiff_t stride );
+
+/**
+ * Kernels are indexed by the size of the block they move: 4 or 8 bytes. Larger
+ * blocks are already efficiently handled by the predefined copy loops.
+ */
+#define OPAL_DATATYPE_SIMD_CLASSES  2
+
+OPAL_DECLSPEC extern opal_datatype_strided_fn_t opal_datatype_simd_gather[OPAL_DATATYPE_SIMD_CLASSES];
+OPAL_DECLSPEC extern opal_datatype_strided_fn_t opal_datatype_simd_scatter[OPAL_DATATYPE_SIMD_CLASSES];
+
+/**
+ * Return the kernel class for blocks of BYTES bytes, or -1 if there is none.
+ */
+static inline int opal_datatype_simd_class( size_t bytes )
+{
+    if( 4 == bytes ) return 0;
+    if( 8 == bytes ) return 1;
+    return -1;
+}
+
+/**
+ * Return the kernel from TABLE moving blocks of BYTES bytes with a STRIDE larger
+ * than the block, or NULL if there is none.
+ */
+static inline opal_datatype_strided_fn_t
+opal_datatype_simd_kernel( const opal_datatype_strided_fn_t* table, size_t bytes, ptrdiff_t stride )
+{
+    int kind = opal_datatype_simd_class( bytes );
+
+    if( (kind < 0) || (stride <= (ptrdiff_t)bytes) ) return NULL;
+    return table[kind];
+}
+
+/**
+ * Select the kernels supported by the processor we are running on. Called once
+ * from opal_datatype_init, the tables are left empty if the mpi_ddt_simd MCA
+ * parameter is disabled.
+ */
+void opal_datatype_simd_init( void );
+
+END_C_DECLS
+
+#endif  /* OPAL_DATATYPE_SIMD_H_HAS_BEEN_INCLUDED */
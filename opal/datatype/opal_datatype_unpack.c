@@ -46,10 +46,12 @@
 #define opal_unpack_general_function            opal_unpack_general_checksum
 #define opal_unpack_homogeneous_contig_function opal_unpack_homogeneous_contig_checksum
 #define opal_generic_simple_unpack_function     opal_generic_simple_unpack_checksum
+#define opal_unpack_homogeneous_flat_function   opal_unpack_homogeneous_flat_checksum
 #else
 #define opal_unpack_general_function            opal_unpack_general
 #define opal_unpack_homogeneous_contig_function opal_unpack_homogeneous_contig
 #define opal_generic_simple_unpack_function     opal_generic_simple_unpack
+#define opal_unpack_homogeneous_flat_function   opal_unpack_homogeneous_flat
 #endif  /* defined(CHECKSUM) */
 
 
@@ -148,6 +150,106 @@ opal_unpack_homogeneous_contig_function( opal_convertor_t* pConv,
     return !!(pConv->flags & CONVERTOR_COMPLETED);  /* done or not */
 }
 
+/**
+ * Unpack using the flattened description of the datatype. The stack is used
+ * exactly as in opal_pack_homogeneous_flat. As the data is moved byte by
+ * byte, a block split between two fragments does not require any special
+ * handling of the partial predefined types.
+ */
+int32_t
+opal_unpack_homogeneous_flat_function( opal_convertor_t* pConv,
+                                       struct iovec* iov,
+                                       uint32_t* out_size,
+                                       size_t* max_data )
+{
+    const opal_datatype_t* pData = pConv->pDesc;
+    const opal_datatype_flat_elem_t* flat = pData->flat_desc.desc;
+    dt_stack_t* stack = pConv->pStack;
+    ptrdiff_t extent = pData->ub - pData->lb;
+    unsigned char *user_memory, *packed_buffer;
+    size_t total_unpacked = 0, remaining, length;
+    uint32_t iov_count;
+
+    DO_DEBUG( opal_output( 0, "unpack_homogeneous_flat( %p:%p, {%p, %lu}, %d )\n",
+                           (void*)pConv, (void*)pConv->pBaseBuf,
+                           (void*)iov[0].iov_base, (unsigned long)iov[0].iov_len, *out_size ); );
+
+    for( iov_count = 0; (iov_count < (*out_size)) && (0 != stack[0].count); iov_count++ ) {
+        packed_buffer = (unsigned char*)iov[iov_count].iov_base;
+        remaining     = iov[iov_count].iov_len;
+
+        while( 0 != remaining ) {
+            const opal_datatype_flat_elem_t* elem = &(flat[stack[1].index]);
+
+            user_memory = pConv->pBaseBuf + stack[0].disp + elem->disp + (ptrdiff_t)stack[1].count * elem->extent;
+            if( 0 != stack[1].disp ) {  /* complete the block left over from the last call */
+                length = elem->length - stack[1].disp;
+                if( length > remaining ) length = remaining;
+                OPAL_DATATYPE_SAFEGUARD_POINTER( user_memory + stack[1].disp, length, pConv->pBaseBuf,
+                                                 pData, pConv->count );
+                MEMCPY_CSUM( user_memory + stack[1].disp, packed_buffer, length, pConv );
+                packed_buffer += length;
+                remaining     -= length;
+                stack[1].disp += length;
+                if( stack[1].disp != elem->length ) break;
+                stack[1].disp = 0;
+                stack[1].count++;
+                user_memory += elem->extent;
+            }
+#if !defined(CHECKSUM)
+            if( (1 < elem->count) && !(pConv->flags & CONVERTOR_CUDA) ) {  /* strided 4 or 8 bytes blocks */
+                opal_datatype_strided_fn_t scatter = opal_datatype_simd_kernel( opal_datatype_simd_scatter,
+                                                                                elem->length, elem->extent );
+                size_t blocks = elem->count - stack[1].count;
+
+                if( blocks > (remaining / elem->length) ) blocks = remaining / elem->length;
+                if( (NULL != scatter) && (0 != blocks) ) {
+                    scatter( packed_buffer, user_memory, blocks, elem->extent );
+                    packed_buffer  += blocks * elem->length;
+                    remaining      -= blocks * elem->length;
+                    user_memory    += blocks * elem->extent;
+                    stack[1].count += blocks;
+                }
+            }
+#endif  /* !defined(CHECKSUM) */
+            for( ; (stack[1].count < elem->count) && (elem->length <= remaining); stack[1].count++ ) {
+                OPAL_DATATYPE_SAFEGUARD_POINTER( user_memory, elem->length, pConv->pBaseBuf,
+                                                 pData, pConv->count );
+                MEMCPY_CSUM( user_memory, packed_buffer, elem->length, pConv );
+                packed_buffer += elem->length;
+                remaining     -= elem->length;
+                user_memory   += elem->extent;
+            }
+            if( stack[1].count != elem->count ) {  /* not enough data left for a full block */
+                if( 0 != remaining ) {
+                    OPAL_DATATYPE_SAFEGUARD_POINTER( user_memory, remaining, pConv->pBaseBuf,
+                                                     pData, pConv->count );
+                    MEMCPY_CSUM( user_memory, packed_buffer, remaining, pConv );
+                    stack[1].disp = remaining;
+                    remaining = 0;
+                }
+                break;
+            }
+            stack[1].count = 0;
+            if( ++stack[1].index == pData->flat_desc.used ) {  /* one full datatype completed */
+                stack[1].index = 0;
+                stack[0].disp += extent;
+                if( 0 == --stack[0].count ) break;
+            }
+        }
+        iov[iov_count].iov_len -= remaining;
+        total_unpacked += iov[iov_count].iov_len;
+    }
+    *max_data = total_unpacked;
+    pConv->bConverted += total_unpacked;
+    *out_size = iov_count;
+    if( pConv->bConverted == pConv->local_size ) {
+        pConv->flags |= CONVERTOR_COMPLETED;
+        return 1;
+    }
+    return 0;
+}
+
 /**
  * This function handle partial types. Depending on the send operation it might happens
  * that we receive only a partial type (always predefined type). In fact the outcome is
@@ -58,6 +58,7 @@
 #include "opal/mca/rcache/rcache.h"
 #include "opal/sys/atomic.h"
 #include "opal/util/proc.h"
+#include "opal/util/trace.h"
 
 #include "opal/mca/pmix/pmix-internal.h"
 
@@ -94,6 +95,16 @@ static inline void sm_memmove(void *dst, void *src, size_t size)
     }
 }
 
+/* account for a send to a peer on another NUMA node */
+static inline void sm_count_remote_numa(struct mca_btl_base_endpoint_t *endpoint, size_t size)
+{
+    if (OPAL_UNLIKELY(endpoint->numa_node != mca_btl_sm_component.numa_node &&
+                      0 <= endpoint->numa_node && 0 <= mca_btl_sm_component.numa_node)) {
+        OPAL_THREAD_ADD_FETCH_SIZE_T(&mca_btl_sm_component.remote_numa_sends, 1);
+        OPAL_THREAD_ADD_FETCH_SIZE_T(&mca_btl_sm_component.remote_numa_bytes, size);
+    }
+}
+
 /**
  * Initiate a send to the peer.
  *
@@ -30,11 +30,13 @@
  */
 #include "opal_config.h"
 
+#include "opal/mca/base/mca_base_pvar.h"
 #include "opal/mca/btl/base/btl_base_error.h"
 #include "opal/mca/threads/mutex.h"
 #include "opal/util/output.h"
 #include "opal/util/printf.h"
 #include "opal/util/show_help.h"
+#include "opal/util/sys_limits.h"
 
 #include "opal/mca/btl/sm/btl_sm.h"
 #include "opal/mca/btl/sm/btl_sm_fbox.h"
@@ -239,6 +241,31 @@ static int mca_btl_sm_component_register(void)
         MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0, OPAL_INFO_LVL_3, MCA_BASE_VAR_SCOPE_READONLY,
         &mca_btl_sm_component.backing_directory);
 
+    mca_btl_sm_component.numa_bind = true;
+    (void) mca_base_component_var_register(
+        &mca_btl_sm_component.super.btl_version, "numa_bind",
+        "Bind the receive fifo and the incoming fast boxes of a process to its NUMA node "
+        "instead of relying on first touch. Only effective for processes bound within a "
+        "single NUMA node (default: true)",
+        MCA_BASE_VAR_TYPE_BOOL, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+        MCA_BASE_VAR_SCOPE_LOCAL, &mca_btl_sm_component.numa_bind);
+
+    mca_btl_sm_component.remote_numa_sends = 0;
+    (void) mca_base_component_pvar_register(
+        &mca_btl_sm_component.super.btl_version, "remote_numa_sends",
+        "Number of messages sent to peers on another NUMA node", OPAL_INFO_LVL_4,
+        MCA_BASE_PVAR_CLASS_COUNTER, MCA_BASE_VAR_TYPE_UNSIGNED_LONG, NULL, MCA_BASE_VAR_BIND_NO_OBJECT,
+        MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS, NULL, NULL, NULL,
+        (void *) &mca_btl_sm_component.remote_numa_sends);
+
+    mca_btl_sm_component.remote_numa_bytes = 0;
+    (void) mca_base_component_pvar_register(
+        &mca_btl_sm_component.super.btl_version, "remote_numa_bytes",
+        "Number of bytes sent to peers on another NUMA node", OPAL_INFO_LVL_4,
+        MCA_BASE_PVAR_CLASS_COUNTER, MCA_BASE_VAR_TYPE_UNSIGNED_LONG, NULL, MCA_BASE_VAR_BIND_NO_OBJECT,
+        MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS, NULL, NULL, NULL,
+        (void *) &mca_btl_sm_component.remote_numa_bytes);
+
 #if OPAL_BTL_SM_HAVE_KNEM
     /* Currently disabling DMA mode by default; it's not clear that this is useful in all
      * applications and architectures. */
@@ -370,6 +397,7 @@ static int mca_btl_base_sm_modex_send(void)
         modex.xpmem.seg_id = mca_btl_sm_component.my_seg_id;
         modex.xpmem.segment_base = mca_btl_sm_component.my_segment;
         modex.xpmem.address_max = mca_btl_sm_component.my_address_max;
+        modex.xpmem.numa_node = mca_btl_sm_component.numa_node;
 
         modex_size = sizeof(modex.xpmem);
     } else {
@@ -377,6 +405,7 @@ static int mca_btl_base_sm_modex_send(void)
         modex.other.seg_ds_size = opal_shmem_sizeof_shmem_ds(&mca_btl_sm_component.seg_ds);
         memmove(&modex.other.seg_ds, &mca_btl_sm_component.seg_ds, modex.other.seg_ds_size);
         modex.other.user_ns_id = mca_btl_sm_get_user_ns_id();
+        modex.other.numa_node = mca_btl_sm_component.numa_node;
         /*
          * If modex.other.user_ns_id is '0' something did not work out
          * during user namespace detection. Assuming there are no
@@ -502,6 +531,7 @@ mca_btl_sm_component_init(int *num_btls, bool enable_progress_threads, bool enab
 {
     mca_btl_sm_component_t *component = &mca_btl_sm_component;
     mca_btl_base_module_t **btls = NULL;
+    size_t page_size;
     int rc;
 
     *num_btls = 0;
@@ -579,6 +609,26 @@ mca_btl_sm_component_init(int *num_btls, bool enable_progress_threads, bool enab
         }
     }
 
+    /* memory is bound in pages of the segment, which may be huge pages */
+    page_size = opal_getpagesize();
+    if (MCA_BTL_SM_XPMEM != component->single_copy_mechanism &&
+        component->seg_ds.seg_page_size > page_size) {
+        page_size = component->seg_ds.seg_page_size;
+    }
+
+    /* fast boxes can only be bound to the NUMA node of their receiver if they own whole
+     * pages */
+    component->numa_node = opal_shmem_base_local_numa();
+    component->fbox_numa_bind = component->numa_bind &&
+                                0 == component->fbox_size % page_size;
+
+    /* the fifo is written by the peers, make sure it is not placed next to the first of
+     * them to touch it */
+    if (component->numa_bind && 0 <= component->numa_node) {
+        (void) opal_shmem_base_bind_numa(component->my_segment, page_size,
+                                         component->numa_node);
+    }
+
     /* initialize my fifo */
     sm_fifo_init((struct sm_fifo_t *) component->my_segment);
 
@@ -598,6 +648,7 @@ mca_btl_sm_component_init(int *num_btls, bool enable_progress_threads, bool enab
 
     return btls;
 failed:
+    opal_progress_set_doorbell(NULL);
 #if OPAL_BTL_SM_HAVE_XPMEM
     if (MCA_BTL_SM_XPMEM == mca_btl_sm_component.single_copy_mechanism) {
         munmap(component->my_segment, component->segment_size);
@@ -628,6 +679,8 @@ void mca_btl_sm_poll_handle_frag(mca_btl_sm_hdr_t *hdr, struct mca_btl_base_endp
                                               .tag = hdr->tag,
                                               .cbdata = reg->cbdata};
 
+    OPAL_TRACE("btl_sm_recv", (int) endpoint->peer_vpid, hdr->len, hdr->tag);
+
     if (hdr->flags & MCA_BTL_SM_FLAG_SINGLE_COPY) {
 #if OPAL_BTL_SM_HAVE_XPMEM
         mca_rcache_base_registration_t *xpmem_reg;
@@ -221,6 +221,8 @@ static inline bool mca_btl_sm_fbox_sendi(mca_btl_base_endpoint_t *ep, unsigned c
     opal_atomic_wmb();
     OPAL_THREAD_UNLOCK(&ep->lock);
 
+    opal_progress_wakeup(&ep->fifo->doorbell);
+
     return true;
 }
 
@@ -274,6 +276,8 @@ static inline bool mca_btl_sm_check_fboxes(void)
                 segment.seg_len = hdr.data.size;
                 segment.seg_addr.pval = (void *) (ep->fbox_in.buffer + start + sizeof(hdr));
 
+                OPAL_TRACE("btl_sm_recv_fbox", (int) ep->peer_vpid, hdr.data.size, hdr.data.tag);
+
                 /* call the registered callback function */
                 reg->cbfunc(&mca_btl_sm.super, &desc);
             } else if (OPAL_LIKELY(0xfe == hdr.data.tag)) {
@@ -321,6 +325,13 @@ static inline void mca_btl_sm_try_fbox_setup(mca_btl_base_endpoint_t *ep, mca_bt
             opal_free_list_item_t *fbox = opal_free_list_get(&mca_btl_sm_component.sm_fboxes);
 
             if (NULL != fbox) {
+                /* the receiver reads the fast box, so place it on its NUMA node before
+                 * touching it */
+                if (mca_btl_sm_component.fbox_numa_bind && 0 <= ep->numa_node) {
+                    (void) opal_shmem_base_bind_numa(fbox->ptr, mca_btl_sm_component.fbox_size,
+                                                     ep->numa_node);
+                }
+
                 /* zero out the fast box */
                 memset(fbox->ptr, 0, mca_btl_sm_component.fbox_size);
                 mca_btl_sm_endpoint_setup_fbox_send(ep, fbox);
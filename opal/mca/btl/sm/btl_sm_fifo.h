@@ -114,7 +114,10 @@ static inline void sm_fifo_init(sm_fifo_t *fifo)
     fifo->fifo_head = SM_FIFO_FREE;
     fifo->fifo_tail = SM_FIFO_FREE;
     fifo->fbox_available = mca_btl_sm_component.fbox_max;
+    fifo->doorbell.seq = 0;
+    fifo->doorbell.sleepers = 0;
     mca_btl_sm_component.my_fifo = fifo;
+    opal_progress_set_doorbell(&fifo->doorbell);
 }
 
 static inline void sm_fifo_write(sm_fifo_t *fifo, fifo_value_t value)
@@ -135,6 +138,7 @@ static inline void sm_fifo_write(sm_fifo_t *fifo, fifo_value_t value)
     }
 
     opal_atomic_wmb();
+    opal_progress_wakeup(&fifo->doorbell);
 }
 
 /**
@@ -116,7 +116,9 @@ static int sm_btl_first_time_init(mca_btl_sm_t *sm_btl, int n)
 
     rc = opal_free_list_init(&component->sm_fboxes, sizeof(opal_free_list_item_t), 8,
                              OBJ_CLASS(opal_free_list_item_t), mca_btl_sm_component.fbox_size,
-                             opal_cache_line_size, 0, mca_btl_sm_component.fbox_max, 4,
+                             component->fbox_numa_bind ? mca_btl_sm_component.fbox_size
+                                                       : (unsigned int) opal_cache_line_size,
+                             0, mca_btl_sm_component.fbox_max, 4,
                              component->mpool, 0, NULL, NULL, NULL);
     if (OPAL_SUCCESS != rc) {
         return rc;
@@ -195,6 +197,8 @@ static int init_sm_endpoint(struct mca_btl_base_endpoint_t **ep_out, struct opal
     OBJ_CONSTRUCT(ep, mca_btl_sm_endpoint_t);
 
     ep->peer_smp_rank = peer_local_rank;
+    ep->peer_vpid = proc->proc_name.vpid;
+    ep->numa_node = -1;
 
     if (peer_local_rank != MCA_BTL_SM_LOCAL_RANK) {
         OPAL_MODEX_RECV_IMMEDIATE(rc, &component->super.btl_version, &proc->proc_name,
@@ -210,6 +214,7 @@ static int init_sm_endpoint(struct mca_btl_base_endpoint_t **ep_out, struct opal
             ep->segment_data.xpmem.apid = xpmem_get(modex->xpmem.seg_id, XPMEM_RDWR,
                                                     XPMEM_PERMIT_MODE, (void *) 0666);
             ep->segment_data.xpmem.address_max = modex->xpmem.address_max;
+            ep->numa_node = modex->xpmem.numa_node;
             (void) sm_get_registation(ep, modex->xpmem.segment_base,
                                       mca_btl_sm_component.segment_size, MCA_RCACHE_FLAGS_PERSIST,
                                       (void **) &ep->segment_base);
@@ -222,6 +227,7 @@ static int init_sm_endpoint(struct mca_btl_base_endpoint_t **ep_out, struct opal
             }
 
             memcpy(ep->segment_data.other.seg_ds, &modex->other.seg_ds, modex->other.seg_ds_size);
+            ep->numa_node = modex->other.numa_node;
 
             ep->segment_base = opal_shmem_segment_attach(ep->segment_data.other.seg_ds);
             if (NULL == ep->segment_base) {
@@ -273,6 +279,7 @@ static int init_sm_endpoint(struct mca_btl_base_endpoint_t **ep_out, struct opal
     } else {
         /* set up the segment base so we can calculate a virtual to real for local pointers */
         ep->segment_base = component->my_segment;
+        ep->numa_node = component->numa_node;
     }
 
     ep->fifo = (struct sm_fifo_t *) ep->segment_base;
@@ -415,6 +422,9 @@ static int sm_finalize(struct mca_btl_base_module_t *btl)
     free(component->fbox_in_endpoints);
     component->fbox_in_endpoints = NULL;
 
+    /* the doorbell lives in the segment */
+    opal_progress_set_doorbell(NULL);
+
     if (MCA_BTL_SM_XPMEM != mca_btl_sm_component.single_copy_mechanism) {
         opal_shmem_unlink(&mca_btl_sm_component.seg_ds);
         opal_shmem_segment_detach(&mca_btl_sm_component.seg_ds);
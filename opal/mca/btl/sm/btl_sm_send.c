@@ -55,6 +55,9 @@ int mca_btl_sm_send(struct mca_btl_base_module_t *btl, struct mca_btl_base_endpo
     /* clear the complete flag if it has been set */
     frag->hdr->flags &= ~MCA_BTL_SM_FLAG_COMPLETE;
 
+    sm_count_remote_numa(endpoint, total_size);
+    OPAL_TRACE("btl_sm_send", (int) endpoint->peer_vpid, total_size, tag);
+
     /* post the relative address of the descriptor into the peer's fifo */
     if (opal_list_get_size(&endpoint->pending_frags) || !sm_fifo_write_ep(frag->hdr, endpoint)) {
         if (frag->base.des_cbfunc) {
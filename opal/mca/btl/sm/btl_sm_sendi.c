@@ -61,6 +61,8 @@ int mca_btl_sm_sendi(struct mca_btl_base_module_t *btl, struct mca_btl_base_endp
 
     if (!(payload_size && opal_convertor_need_buffers(convertor)) &&
         mca_btl_sm_fbox_sendi(endpoint, tag, header, header_size, data_ptr, payload_size)) {
+        sm_count_remote_numa(endpoint, header_size + payload_size);
+        OPAL_TRACE("btl_sm_sendi", (int) endpoint->peer_vpid, header_size + payload_size, tag);
         return OPAL_SUCCESS;
     }
 
@@ -111,5 +113,8 @@ int mca_btl_sm_sendi(struct mca_btl_base_module_t *btl, struct mca_btl_base_endp
         return OPAL_ERR_OUT_OF_RESOURCE;
     }
 
+    sm_count_remote_numa(endpoint, header_size + payload_size);
+    OPAL_TRACE("btl_sm_sendi", (int) endpoint->peer_vpid, header_size + payload_size, tag);
+
     return OPAL_SUCCESS;
 }
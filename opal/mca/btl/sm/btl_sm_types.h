@@ -35,6 +35,7 @@
 #include "opal_config.h"
 #include "opal/class/opal_free_list.h"
 #include "opal/mca/btl/btl.h"
+#include "opal/runtime/opal_progress.h"
 
 #if OPAL_BTL_SM_HAVE_XPMEM
 
@@ -59,10 +60,12 @@ union sm_modex_t {
         xpmem_segid_t seg_id;
         void *segment_base;
         uintptr_t address_max;
+        int numa_node;
     } xpmem;
 #endif
     struct sm_modex_other_t {
         ino_t user_ns_id;
+        int numa_node;
         int seg_ds_size;
         /* seg_ds needs to be the last element */
         opal_shmem_ds_t seg_ds;
@@ -100,12 +103,15 @@ typedef struct mca_btl_base_endpoint_t {
 
     uint16_t peer_smp_rank;        /**< my peer's SMP process rank.  Used for accessing
                                     *   SMP specfic data structures. */
+    opal_vpid_t peer_vpid;         /**< vpid of the peer, recorded by the trace points */
     opal_atomic_size_t send_count; /**< number of fragments sent to this peer */
     char *segment_base;            /**< start of the peer's segment (in the address space
                                     *   of this process) */
 
     struct sm_fifo_t *fifo; /**< */
 
+    int numa_node; /**< NUMA node of the peer, -1 if not known */
+
     opal_mutex_t lock; /**< lock to protect endpoint structures from concurrent
                         *   access */
 
@@ -177,6 +183,12 @@ struct mca_btl_sm_component_t {
 
     char *backing_directory; /**< directory to place shared memory backing files */
 
+    bool numa_bind;      /**< bind inbound buffers to the NUMA node of the receiver */
+    bool fbox_numa_bind; /**< fast boxes are page aligned, so they can be bound */
+    int numa_node;       /**< NUMA node of this process, -1 if not known */
+    opal_atomic_size_t remote_numa_sends; /**< sends to peers on another NUMA node */
+    opal_atomic_size_t remote_numa_bytes; /**< bytes sent to peers on another NUMA node */
+
     /* knem stuff */
 #if OPAL_BTL_SM_HAVE_KNEM
     unsigned int knem_dma_min; /**< minimum size to enable DMA for knem transfers (0 disables) */
@@ -299,6 +311,8 @@ struct sm_fifo_t {
     atomic_fifo_value_t fifo_head;
     atomic_fifo_value_t fifo_tail;
     opal_atomic_int32_t fbox_available;
+    /* senders wake up the owner when it blocks in opal_progress_wait() */
+    opal_progress_doorbell_t doorbell __opal_attribute_aligned__(64);
 };
 typedef struct sm_fifo_t sm_fifo_t;
 
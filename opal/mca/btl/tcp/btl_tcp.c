@@ -338,6 +338,8 @@ int mca_btl_tcp_send( struct mca_btl_base_module_t* btl,
     frag->hdr.base.tag = tag;
     frag->hdr.type = MCA_BTL_TCP_HDR_TYPE_SEND;
     frag->hdr.count = 0;
+    OPAL_TRACE("btl_tcp_send", (int) endpoint->endpoint_proc->proc_opal->proc_name.vpid,
+               frag->hdr.size, tag);
     if (endpoint->endpoint_nbo) MCA_BTL_TCP_HDR_HTON(frag->hdr);
     return mca_btl_tcp_endpoint_send(endpoint,frag);
 }
@@ -51,6 +51,7 @@
 #include "opal/mca/mpool/mpool.h"
 #include "opal/class/opal_hash_table.h"
 #include "opal/util/fd.h"
+#include "opal/util/trace.h"
 
 #define MCA_BTL_TCP_STATISTICS 0
 BEGIN_C_DECLS
@@ -1029,6 +1029,9 @@ static void mca_btl_tcp_endpoint_recv_handler(int sd, short flags, void* user)
                        .des_segment_count = frag->base.des_segment_count,
                        .tag = frag->hdr.base.tag,
                        .cbdata = reg->cbdata};
+                    OPAL_TRACE("btl_tcp_recv",
+                               (int) btl_endpoint->endpoint_proc->proc_opal->proc_name.vpid,
+                               frag->hdr.size, frag->hdr.base.tag);
                     reg->cbfunc(&frag->btl->super, &desc);
                 }
 #if MCA_BTL_TCP_ENDPOINT_CACHE
@@ -147,6 +147,9 @@ bool mca_btl_tcp_frag_send(mca_btl_tcp_frag_t* frag, int sd)
         }
     } while(cnt < 0);
 
+    OPAL_TRACE("btl_tcp_writev", (int) frag->endpoint->endpoint_proc->proc_opal->proc_name.vpid,
+               cnt, frag->iov_cnt);
+
     /* if the write didn't complete - update the iovec state */
     num_vecs = frag->iov_cnt;
     for( i = 0; i < num_vecs; i++) {
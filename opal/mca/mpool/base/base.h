@@ -55,6 +55,19 @@ OPAL_DECLSPEC mca_mpool_base_module_t* mca_mpool_base_module_lookup(const char*
 
 OPAL_DECLSPEC mca_mpool_base_module_t *mca_mpool_basic_create (void *base, size_t size, unsigned min_align);
 
+/**
+ * Callback of mca_mpool_base_hugetlbfs_mounts, for a hugetlbfs mount point
+ * at PATH with pages of PAGE_SIZE bytes.
+ */
+typedef void (*mca_mpool_base_hugetlbfs_fn_t) (const char *path, unsigned long page_size, void *ctx);
+
+/**
+ * Call FN for each hugetlbfs file system mounted on this node whose page
+ * size is known, in the order of /proc/mounts. Access rights are left to
+ * the caller.
+ */
+OPAL_DECLSPEC void mca_mpool_base_hugetlbfs_mounts (mca_mpool_base_hugetlbfs_fn_t fn, void *ctx);
+
 /*
  * Globals
  */
@@ -0,0 +1,117 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2015-2016 Los Alamos National Security, LLC. All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef HAVE_SYS_VFS_H
+#include <sys/vfs.h>
+#endif
+#ifdef HAVE_SYS_MOUNT_H
+#include <sys/mount.h>
+#endif
+#ifdef HAVE_SYS_PARAM_H
+#include <sys/param.h>
+#endif
+#ifdef HAVE_SYS_STATVFS_H
+#include <sys/statvfs.h>
+#endif
+#ifdef HAVE_MNTENT_H
+#include <mntent.h>
+#endif
+
+#include "opal/mca/mpool/base/base.h"
+
+/*
+ * Note that some OS's (e.g., NetBSD and Solaris) have statfs(), but
+ * no struct statfs (!).  So check to make sure we have struct statfs
+ * before allowing the use of statfs().
+ */
+#if defined(HAVE_STATFS) && (defined(HAVE_STRUCT_STATFS_F_FSTYPENAME) || \
+                             defined(HAVE_STRUCT_STATFS_F_TYPE))
+#define USE_STATFS 1
+#endif
+
+void mca_mpool_base_hugetlbfs_mounts (mca_mpool_base_hugetlbfs_fn_t fn, void *ctx)
+{
+#ifdef HAVE_MNTENT_H
+    FILE *fh;
+    struct mntent *mntent;
+    char *opts, *tok, *ctx_opts;
+
+    fh = setmntent ("/proc/mounts", "r");
+    if (NULL == fh) {
+        return;
+    }
+
+    while (NULL != (mntent = getmntent(fh))) {
+        unsigned long page_size = 0;
+
+        if (0 != strcmp(mntent->mnt_type, "hugetlbfs")) {
+            continue;
+        }
+
+        opts = strdup(mntent->mnt_opts);
+        if (NULL == opts) {
+            break;
+        }
+
+        tok = strtok_r (opts, ",", &ctx_opts);
+
+        while (NULL != tok) {
+            if (0 == strncmp (tok, "pagesize", 8)) {
+                break;
+            }
+            tok = strtok_r (NULL, ",", &ctx_opts);
+        }
+
+        if (!tok) {
+            /* hugetlbfs reports its page size as the block size */
+#if defined(USE_STATFS)
+            struct statfs info;
+
+            if (0 == statfs (mntent->mnt_dir, &info)) {
+                page_size = info.f_bsize;
+            }
+#elif defined(HAVE_STATVFS)
+            struct statvfs info;
+
+            if (0 == statvfs (mntent->mnt_dir, &info)) {
+                page_size = info.f_bsize;
+            }
+#endif
+        } else {
+            /* the kernel shows the size with a unit, as in pagesize=2M */
+            char unit = '\0';
+
+            (void) sscanf (tok, "pagesize=%lu%c", &page_size, &unit);
+            switch (unit) {
+            case 'G': case 'g': page_size <<= 10; /* fall through */
+            case 'M': case 'm': page_size <<= 10; /* fall through */
+            case 'K': case 'k': page_size <<= 10; break;
+            default: break;
+            }
+        }
+        free(opts);
+
+        if (0 == page_size) {
+            /* could not get page size */
+            continue;
+        }
+
+        fn (mntent->mnt_dir, page_size, ctx);
+    }
+
+    endmntent (fh);
+#endif
+}
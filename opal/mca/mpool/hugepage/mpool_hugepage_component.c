@@ -43,35 +43,12 @@
 #ifdef HAVE_MALLOC_H
 #include <malloc.h>
 #endif
-#ifdef HAVE_SYS_VFS_H
-#include <sys/vfs.h>
-#endif
-#ifdef HAVE_SYS_MOUNT_H
-#include <sys/mount.h>
-#endif
-#ifdef HAVE_SYS_PARAM_H
-#include <sys/param.h>
-#endif
 #ifdef HAVE_SYS_MMAN_H
 #include <sys/mman.h>
 #endif
-#ifdef HAVE_MNTENT_H
-#include <mntent.h>
-#endif
 
 #include <fcntl.h>
 
-/*
- * Note that some OS's (e.g., NetBSD and Solaris) have statfs(), but
- * no struct statfs (!).  So check to make sure we have struct statfs
- * before allowing the use of statfs().
- */
-#if defined(HAVE_STATFS) && (defined(HAVE_STRUCT_STATFS_F_FSTYPENAME) || \
-                             defined(HAVE_STRUCT_STATFS_F_TYPE))
-#define USE_STATFS 1
-#endif
-
-
 /*
  * Local functions
  */
@@ -204,83 +181,37 @@ static int page_compare (opal_list_item_t **a, opal_list_item_t **b) {
 }
 #endif
 
-static void mca_mpool_hugepage_find_hugepages (void) {
 #ifdef HAVE_MNTENT_H
+static void mca_mpool_hugepage_add_hugepage (const char *path, unsigned long page_size, void *ctx)
+{
     mca_mpool_hugepage_hugepage_t *hp;
-    FILE *fh;
-    struct mntent *mntent;
-    char *opts, *tok, *ctx;
 
-    fh = setmntent ("/proc/mounts", "r");
-    if (NULL == fh) {
+    hp = OBJ_NEW(mca_mpool_hugepage_hugepage_t);
+    if (NULL == hp) {
         return;
     }
 
-    while (NULL != (mntent = getmntent(fh))) {
-        unsigned long page_size = 0;
-
-        if (0 != strcmp(mntent->mnt_type, "hugetlbfs")) {
-            continue;
-        }
-
-        opts = strdup(mntent->mnt_opts);
-        if (NULL == opts) {
-            break;
-        }
-
-        tok = strtok_r (opts, ",", &ctx);
+    hp->path = strdup (path);
+    hp->page_size = page_size;
 
-        do {
-            if (0 == strncmp (tok, "pagesize", 8)) {
-                break;
-            }
-            tok = strtok_r (NULL, ",", &ctx);
-        } while (tok);
-
-        if (!tok) {
-#if defined(USE_STATFS)
-            struct statfs info;
-
-            statfs (mntent->mnt_dir, &info);
-#elif defined(HAVE_STATVFS)
-            struct statvfs info;
-            statvfs (mntent->mnt_dir, &info);
-#endif
-            page_size = info.f_bsize;
-        } else {
-            (void) sscanf (tok, "pagesize=%lu", &page_size);
-        }
-        free(opts);
-
-        if (0 == page_size) {
-            /* could not get page size */
-            continue;
-        }
-
-        hp = OBJ_NEW(mca_mpool_hugepage_hugepage_t);
-        if (NULL == hp) {
-            break;
-        }
-
-        hp->path = strdup (mntent->mnt_dir);
-        hp->page_size = page_size;
-        
-        if(0 == access (hp->path, R_OK | W_OK)){        
-            opal_output_verbose (MCA_BASE_VERBOSE_INFO, opal_mpool_base_framework.framework_output,
-                                 "found huge page with size = %lu, path = %s, mmap flags = 0x%x, adding to list",
-                                 hp->page_size, hp->path, hp->mmap_flags);
-            opal_list_append (&mca_mpool_hugepage_component.huge_pages, &hp->super);
-        } else {
-            opal_output_verbose (MCA_BASE_VERBOSE_INFO, opal_mpool_base_framework.framework_output,
-                                 "found huge page with size = %lu, path = %s, mmap flags = 0x%x, with invalid " 
-                                 "permissions, skipping", hp->page_size, hp->path, hp->mmap_flags);
-            OBJ_RELEASE(hp);
-        }        
+    if (NULL != hp->path && 0 == access (hp->path, R_OK | W_OK)) {
+        opal_output_verbose (MCA_BASE_VERBOSE_INFO, opal_mpool_base_framework.framework_output,
+                             "found huge page with size = %lu, path = %s, mmap flags = 0x%x, adding to list",
+                             hp->page_size, hp->path, hp->mmap_flags);
+        opal_list_append (&mca_mpool_hugepage_component.huge_pages, &hp->super);
+    } else {
+        opal_output_verbose (MCA_BASE_VERBOSE_INFO, opal_mpool_base_framework.framework_output,
+                             "found huge page with size = %lu, path = %s, mmap flags = 0x%x, with invalid "
+                             "permissions, skipping", hp->page_size, path, hp->mmap_flags);
+        OBJ_RELEASE(hp);
     }
+}
+#endif
 
+static void mca_mpool_hugepage_find_hugepages (void) {
+#ifdef HAVE_MNTENT_H
+    mca_mpool_base_hugetlbfs_mounts (mca_mpool_hugepage_add_hugepage, NULL);
     opal_list_sort (&mca_mpool_hugepage_component.huge_pages, page_compare);
-
-    endmntent (fh);
 #endif
 }
 
@@ -174,6 +174,9 @@ void mca_rcache_gpusm_finalize(struct mca_rcache_base_module_t *rcache)
     /* Need to run the destructor on each item in the free list explicitly.
      * The destruction of the free list only runs the destructor on the
      * main free list, not each item. */
+    if (NULL != rcache_gpusm->reg_list.fl_magazines) {
+        opal_free_list_magazines_flush (&rcache_gpusm->reg_list);
+    }
     while (NULL != (item = (opal_free_list_item_t *)opal_lifo_pop(&(rcache_gpusm->reg_list.super)))) {
         OBJ_DESTRUCT(item);
     }
@@ -57,6 +57,9 @@ struct mca_rcache_grdma_component_t {
     char *rcache_name;
     bool print_stats;
     int leave_pinned;
+    bool thread_cache;
+    /* bumped whenever a registration is destroyed or a range invalidated */
+    opal_atomic_int32_t epoch;
 };
 typedef struct mca_rcache_grdma_component_t mca_rcache_grdma_component_t;
 
@@ -74,6 +77,7 @@ struct mca_rcache_grdma_module_t {
     uint32_t stat_evicted;
     uint32_t stat_cache_found;
     uint32_t stat_cache_notfound;
+    uint32_t stat_thread_hit;
 };
 typedef struct mca_rcache_grdma_module_t mca_rcache_grdma_module_t;
 
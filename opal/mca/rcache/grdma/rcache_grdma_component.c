@@ -87,6 +87,15 @@ static int grdma_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &mca_rcache_grdma_component.print_stats);
 
+    mca_rcache_grdma_component.thread_cache = true;
+    (void) mca_base_component_var_register(&mca_rcache_grdma_component.super.rcache_version,
+                                           "thread_cache", "keep the registrations each thread used last in a "
+                                           "per-thread cache which is searched before the registration cache",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_rcache_grdma_component.thread_cache);
+
     return OPAL_SUCCESS;
 }
 
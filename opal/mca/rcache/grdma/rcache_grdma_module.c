@@ -46,6 +46,7 @@
 
 #include "opal/util/sys_limits.h"
 #include "opal/align.h"
+#include "opal/mca/threads/thread_usage.h"
 #include "rcache_grdma.h"
 
 
@@ -125,6 +126,7 @@ void mca_rcache_grdma_module_init(mca_rcache_grdma_module_t* rcache, mca_rcache_
 
     rcache->stat_cache_hit = rcache->stat_cache_miss = rcache->stat_evicted = 0;
     rcache->stat_cache_found = rcache->stat_cache_notfound = 0;
+    rcache->stat_thread_hit = 0;
 
     OBJ_CONSTRUCT(&rcache->reg_list, opal_free_list_t);
     opal_free_list_init (&rcache->reg_list, rcache->resources.sizeof_reg,
@@ -141,6 +143,9 @@ static inline int dereg_mem(mca_rcache_base_registration_t *reg)
 
     reg->ref_count = 0;
 
+    /* stale entries of the thread caches must not trust this registration any more */
+    (void) opal_atomic_add_fetch_32 (&mca_rcache_grdma_component.epoch, 1);
+
     if (!(reg->flags & MCA_RCACHE_FLAGS_CACHE_BYPASS)) {
         mca_rcache_base_vma_delete (rcache_grdma->cache->vma_module, reg);
     }
@@ -300,6 +305,97 @@ static int mca_rcache_grdma_check_cached (mca_rcache_base_registration_t *grdma_
     return 1;
 }
 
+#if OPAL_HAVE_THREAD_LOCAL
+/*
+ * Per-thread cache of the registrations a thread used last. A hit skips
+ * the walk of the VMA tree and takes no lock. The entries do not hold a
+ * reference, so they are only trusted while the epoch of the component
+ * has not changed, and only registrations which are in use (so not in
+ * the LRU) are taken from them; unused ones go through the tree.
+ */
+#define MCA_RCACHE_GRDMA_THREAD_CACHE_SIZE 4
+
+struct mca_rcache_grdma_thread_cache_t {
+    mca_rcache_base_module_t *rcache;
+    mca_rcache_base_registration_t *reg;
+    unsigned char *base;
+    unsigned char *bound;
+    int32_t epoch;
+};
+typedef struct mca_rcache_grdma_thread_cache_t mca_rcache_grdma_thread_cache_t;
+
+static opal_thread_local mca_rcache_grdma_thread_cache_t
+    grdma_thread_cache[MCA_RCACHE_GRDMA_THREAD_CACHE_SIZE];
+static opal_thread_local unsigned int grdma_thread_cache_next;
+
+static inline void mca_rcache_grdma_thread_cache_insert (mca_rcache_base_registration_t *grdma_reg,
+                                                         int32_t epoch)
+{
+    mca_rcache_grdma_thread_cache_t *entry = NULL;
+
+    for (int i = 0 ; i < MCA_RCACHE_GRDMA_THREAD_CACHE_SIZE ; ++i) {
+        if (grdma_thread_cache[i].reg == grdma_reg) {
+            entry = grdma_thread_cache + i;
+            break;
+        }
+    }
+
+    if (NULL == entry) {
+        entry = grdma_thread_cache + (grdma_thread_cache_next++ % MCA_RCACHE_GRDMA_THREAD_CACHE_SIZE);
+    }
+
+    entry->rcache = grdma_reg->rcache;
+    entry->reg = grdma_reg;
+    entry->base = grdma_reg->base;
+    entry->bound = grdma_reg->bound;
+    entry->epoch = epoch;
+}
+
+static mca_rcache_base_registration_t *
+mca_rcache_grdma_thread_cache_find (mca_rcache_base_module_t *rcache, unsigned char *base,
+                                    unsigned char *bound, int32_t access_flags)
+{
+    const int32_t epoch = mca_rcache_grdma_component.epoch;
+    mca_rcache_base_registration_t *grdma_reg;
+    int32_t ref_cnt;
+
+    for (int i = 0 ; i < MCA_RCACHE_GRDMA_THREAD_CACHE_SIZE ; ++i) {
+        mca_rcache_grdma_thread_cache_t *entry = grdma_thread_cache + i;
+
+        if (entry->rcache != rcache || entry->epoch != epoch ||
+            entry->base > base || entry->bound < bound) {
+            continue;
+        }
+
+        grdma_reg = entry->reg;
+        if ((access_flags & grdma_reg->access_flags) != access_flags) {
+            return NULL;
+        }
+
+        /* take a reference unless the registration is unused */
+        ref_cnt = grdma_reg->ref_count;
+        do {
+            if (ref_cnt <= 0) {
+                return NULL;
+            }
+        } while (!opal_atomic_compare_exchange_strong_32 (&grdma_reg->ref_count, &ref_cnt, ref_cnt + 1));
+
+        /* the registration may have been destroyed in the meantime and the
+         * reference taken on a new one */
+        opal_atomic_rmb ();
+        if (OPAL_UNLIKELY(epoch != mca_rcache_grdma_component.epoch ||
+                          (grdma_reg->flags & MCA_RCACHE_FLAGS_INVALID))) {
+            (void) rcache->rcache_deregister (rcache, grdma_reg);
+            return NULL;
+        }
+
+        return grdma_reg;
+    }
+
+    return NULL;
+}
+#endif /* OPAL_HAVE_THREAD_LOCAL */
+
 /*
  * register memory
  */
@@ -314,6 +410,7 @@ static int mca_rcache_grdma_register (mca_rcache_base_module_t *rcache, void *ad
     opal_free_list_item_t *item;
     unsigned char *base, *bound;
     unsigned int page_size = opal_getpagesize ();
+    int32_t epoch = mca_rcache_grdma_component.epoch;
     int rc;
 
     *reg = NULL;
@@ -341,11 +438,27 @@ static int mca_rcache_grdma_register (mca_rcache_base_module_t *rcache, void *ad
         mca_rcache_base_find_args_t find_args = {.reg = NULL, .rcache_grdma = rcache_grdma,
                                                  .base = base, .bound = bound,
                                                  .access_flags = access_flags};
+
+#if OPAL_HAVE_THREAD_LOCAL
+        if (mca_rcache_grdma_component.thread_cache &&
+            NULL != (*reg = mca_rcache_grdma_thread_cache_find (rcache, base, bound, access_flags))) {
+            if (mca_rcache_grdma_component.print_stats) {
+                (void) opal_atomic_fetch_add_32 ((opal_atomic_int32_t *) &rcache_grdma->stat_thread_hit, 1);
+            }
+            return OPAL_SUCCESS;
+        }
+#endif /* OPAL_HAVE_THREAD_LOCAL */
+
         /* check to see if memory is registered */
         rc = mca_rcache_base_vma_iterate (rcache_grdma->cache->vma_module, base, size, false,
                                           mca_rcache_grdma_check_cached, (void *) &find_args);
         if (1 == rc) {
             *reg = find_args.reg;
+#if OPAL_HAVE_THREAD_LOCAL
+            if (mca_rcache_grdma_component.thread_cache) {
+                mca_rcache_grdma_thread_cache_insert (*reg, epoch);
+            }
+#endif /* OPAL_HAVE_THREAD_LOCAL */
             return OPAL_SUCCESS;
         }
 
@@ -366,7 +479,6 @@ static int mca_rcache_grdma_register (mca_rcache_base_module_t *rcache, void *ad
     grdma_reg->bound = bound;
     grdma_reg->flags = flags;
     grdma_reg->access_flags = access_flags;
-    grdma_reg->ref_count = 1;
 #if OPAL_CUDA_GDR_SUPPORT
     if (flags & MCA_RCACHE_FLAGS_CUDA_GPU_MEM) {
         mca_common_cuda_get_buffer_id(grdma_reg);
@@ -387,6 +499,10 @@ static int mca_rcache_grdma_register (mca_rcache_base_module_t *rcache, void *ad
         return rc;
     }
 
+    /* the reference count stays 0 until the registration is valid so that a
+     * stale entry of a thread cache can not take a reference to it */
+    grdma_reg->ref_count = 1;
+
     if (false == bypass_cache) {
         /* Unless explicitly requested by the caller always store the
          * registration in the rcache. This will speed up the case where
@@ -395,10 +511,18 @@ static int mca_rcache_grdma_register (mca_rcache_base_module_t *rcache, void *ad
          * here is !mca_rcache_grdma_component.leave_pinned. */
         rc = mca_rcache_base_vma_insert (rcache_grdma->cache->vma_module, grdma_reg, 0);
         if (OPAL_UNLIKELY(rc != OPAL_SUCCESS)) {
+            /* wait for the threads which took a reference through a stale entry to drop it */
+            for (int32_t one = 1 ; !opal_atomic_compare_exchange_strong_32 (&grdma_reg->ref_count, &one, 0) ; one = 1);
             rcache_grdma->resources.deregister_mem (rcache_grdma->resources.reg_data, grdma_reg);
             opal_free_list_return_mt (&rcache_grdma->reg_list, item);
             return rc;
         }
+
+#if OPAL_HAVE_THREAD_LOCAL
+        if (mca_rcache_grdma_component.thread_cache && !persist) {
+            mca_rcache_grdma_thread_cache_insert (grdma_reg, epoch);
+        }
+#endif /* OPAL_HAVE_THREAD_LOCAL */
     }
 
     OPAL_OUTPUT_VERBOSE((MCA_BASE_VERBOSE_TRACE, opal_rcache_base_framework.framework_output,
@@ -524,6 +648,9 @@ static int mca_rcache_grdma_invalidate_range (mca_rcache_base_module_t *rcache,
 {
     mca_rcache_grdma_module_t *rcache_grdma = (mca_rcache_grdma_module_t *) rcache;
     gc_add_args_t args = {.base = base, .size = size};
+
+    /* called by the memory hooks: the range may be mapped again with other pages */
+    (void) opal_atomic_add_fetch_32 (&mca_rcache_grdma_component.epoch, 1);
     return mca_rcache_base_vma_iterate (rcache_grdma->cache->vma_module, base, size, true, gc_add, &args);
 }
 
@@ -562,13 +689,16 @@ static void mca_rcache_grdma_finalize (mca_rcache_base_module_t *rcache)
     /* Statistic */
     if (true == mca_rcache_grdma_component.print_stats) {
         opal_output(0, "%s grdma: stats "
-                "(hit/miss/found/not found/evicted/tree size): %d/%d/%d/%d/%d/%ld\n",
+                "(hit/thread hit/miss/found/not found/evicted/tree size): %d/%d/%d/%d/%d/%d/%ld\n",
                 OPAL_NAME_PRINT(OPAL_PROC_MY_NAME),
-                rcache_grdma->stat_cache_hit, rcache_grdma->stat_cache_miss,
+                rcache_grdma->stat_cache_hit, rcache_grdma->stat_thread_hit, rcache_grdma->stat_cache_miss,
                 rcache_grdma->stat_cache_found, rcache_grdma->stat_cache_notfound,
                     rcache_grdma->stat_evicted, (long) mca_rcache_base_vma_size (rcache_grdma->cache->vma_module));
     }
 
+    /* drop the entries of the thread caches which refer to this module */
+    (void) opal_atomic_add_fetch_32 (&mca_rcache_grdma_component.epoch, 1);
+
    do_unregistration_gc (&rcache_grdma->super);
 
     (void) mca_rcache_base_vma_iterate (rcache_grdma->cache->vma_module, NULL, (size_t) -1, true,
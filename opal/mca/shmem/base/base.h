@@ -136,6 +136,71 @@ OPAL_DECLSPEC extern opal_shmem_base_module_t *opal_shmem_base_module;
  */
 OPAL_DECLSPEC extern char *opal_shmem_base_RUNTIME_QUERY_hint;
 
+/**
+ * Values of the shmem_base_huge_pages MCA parameter
+ */
+enum {
+    /** regular pages */
+    OPAL_SHMEM_HUGE_PAGES_NONE = 0,
+    /** transparent huge pages through madvise(MADV_HUGEPAGE) */
+    OPAL_SHMEM_HUGE_PAGES_TRANSPARENT,
+    /** hugetlb pages where the component can get them, else transparent */
+    OPAL_SHMEM_HUGE_PAGES_HUGETLB
+};
+
+/**
+ * Huge page backing requested for new segments
+ */
+OPAL_DECLSPEC extern int opal_shmem_base_huge_pages;
+
+/**
+ * Find a writable hugetlbfs mount point.
+ *
+ * @param page_size (OUT) huge page size of the mount.
+ *
+ * @retval path of the mount point. NULL if there is none.
+ */
+OPAL_DECLSPEC const char *
+opal_shmem_base_hugetlbfs_path(size_t *page_size);
+
+/**
+ * Default hugetlb page size of the system (as used by SHM_HUGETLB).
+ *
+ * @retval page size in bytes. 0 if hugetlb pages are not available.
+ */
+OPAL_DECLSPEC size_t
+opal_shmem_base_hugetlb_page_size(void);
+
+/**
+ * Ask for transparent huge pages on a mapped segment if the
+ * shmem_base_huge_pages MCA parameter requests them.
+ *
+ * @retval page size the mapping can expect.
+ */
+OPAL_DECLSPEC size_t
+opal_shmem_base_advise(void *addr, size_t size);
+
+/**
+ * NUMA node the calling process is bound within.
+ *
+ * @retval logical index of the NUMA node. -1 if the process is not bound
+ *         within a single NUMA node or the node has only one.
+ */
+OPAL_DECLSPEC int
+opal_shmem_base_local_numa(void);
+
+/**
+ * Bind a page aligned range of a mapped segment to a NUMA node, moving
+ * the pages that are already there.
+ *
+ * @param numa_node logical index of the NUMA node.
+ *
+ * @retval OPAL_SUCCESS on success.
+ * @retval OPAL_ERR_NOT_SUPPORTED if the range could not be bound.
+ */
+OPAL_DECLSPEC int
+opal_shmem_base_bind_numa(void *addr, size_t size, int numa_node);
+
 /**
  * Framework structure declaration
  */
@@ -0,0 +1,152 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif /* HAVE_UNISTD_H */
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif /* HAVE_SYS_MMAN_H */
+
+#include "opal/constants.h"
+#include "opal/util/output.h"
+#include "opal/util/string_copy.h"
+#include "opal/util/sys_limits.h"
+#include "opal/mca/mpool/base/base.h"
+#include "opal/mca/shmem/shmem.h"
+#include "opal/mca/shmem/base/base.h"
+
+/* the system is only looked at once: segments are created during startup */
+static bool hugetlbfs_probed = false;
+static char hugetlbfs_path[OPAL_PATH_MAX];
+static size_t hugetlbfs_page_size = 0;
+
+/* ////////////////////////////////////////////////////////////////////////// */
+/* value of a "key: value" line of a /proc or /sys file, 0 if not found */
+static size_t
+read_size(const char *file_name, const char *key, size_t scale)
+{
+    char line[256];
+    unsigned long value = 0;
+    size_t key_len = strlen(key);
+    FILE *fh;
+
+    if (NULL == (fh = fopen(file_name, "r"))) {
+        return 0;
+    }
+    while (NULL != fgets(line, sizeof(line), fh)) {
+        if (0 == strncmp(line, key, key_len) &&
+            1 == sscanf(line + key_len, " %lu", &value)) {
+            break;
+        }
+        value = 0;
+    }
+    fclose(fh);
+
+    return (size_t) value * scale;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+#ifdef HAVE_MNTENT_H
+/* the first hugetlbfs mount this process can create files in */
+static void
+hugetlbfs_mount(const char *path, unsigned long page_size, void *ctx)
+{
+    if (0 != hugetlbfs_page_size || 0 != access(path, R_OK | W_OK)) {
+        return;
+    }
+
+    (void) opal_string_copy(hugetlbfs_path, path, OPAL_PATH_MAX);
+    hugetlbfs_page_size = (size_t) page_size;
+}
+#endif /* HAVE_MNTENT_H */
+
+/* ////////////////////////////////////////////////////////////////////////// */
+const char *
+opal_shmem_base_hugetlbfs_path(size_t *page_size)
+{
+#ifdef HAVE_MNTENT_H
+    if (!hugetlbfs_probed) {
+        hugetlbfs_probed = true;
+
+        mca_mpool_base_hugetlbfs_mounts(hugetlbfs_mount, NULL);
+
+        opal_output_verbose(20, opal_shmem_base_framework.framework_output,
+                            "shmem: base: hugetlbfs mount: %s (page size: %lu)",
+                            (0 != hugetlbfs_page_size) ? hugetlbfs_path : "none",
+                            (unsigned long) hugetlbfs_page_size);
+    }
+
+    if (0 != hugetlbfs_page_size) {
+        *page_size = hugetlbfs_page_size;
+        return hugetlbfs_path;
+    }
+#endif /* HAVE_MNTENT_H */
+
+    return NULL;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+size_t
+opal_shmem_base_hugetlb_page_size(void)
+{
+    return read_size("/proc/meminfo", "Hugepagesize:", 1024);
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+/* page size of transparent huge pages of shared memory, 0 if they are off */
+static size_t
+thp_page_size(void)
+{
+    char line[128];
+    FILE *fh;
+
+    if (NULL == (fh = fopen("/sys/kernel/mm/transparent_hugepage/shmem_enabled", "r"))) {
+        return 0;
+    }
+    if (NULL == fgets(line, sizeof(line), fh)) {
+        line[0] = '\0';
+    }
+    fclose(fh);
+
+    /* the active mode is the one in brackets */
+    if (NULL == strchr(line, '[') || NULL != strstr(line, "[never]") ||
+        NULL != strstr(line, "[deny]")) {
+        return 0;
+    }
+
+    return read_size("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "", 1);
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+size_t
+opal_shmem_base_advise(void *addr, size_t size)
+{
+    size_t page_size = (size_t) opal_getpagesize();
+
+    if (OPAL_SHMEM_HUGE_PAGES_NONE == opal_shmem_base_huge_pages) {
+        return page_size;
+    }
+
+#if defined(MADV_HUGEPAGE)
+    if (0 == madvise(addr, size, MADV_HUGEPAGE)) {
+        size_t thp_size = thp_page_size();
+        return (thp_size > page_size) ? thp_size : page_size;
+    }
+    opal_output_verbose(20, opal_shmem_base_framework.framework_output,
+                        "shmem: base: madvise(MADV_HUGEPAGE) failed: %s", strerror(errno));
+#endif /* MADV_HUGEPAGE */
+
+    return page_size;
+}
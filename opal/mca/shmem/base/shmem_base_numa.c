@@ -0,0 +1,79 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include "opal/constants.h"
+#include "opal/util/output.h"
+#include "opal/mca/hwloc/hwloc-internal.h"
+#include "opal/mca/hwloc/base/base.h"
+#include "opal/mca/shmem/shmem.h"
+#include "opal/mca/shmem/base/base.h"
+
+/* ////////////////////////////////////////////////////////////////////////// */
+int
+opal_shmem_base_local_numa(void)
+{
+    hwloc_cpuset_t cpuset;
+    hwloc_obj_t node;
+    int numa_node = -1;
+    unsigned int i, count;
+
+    if (OPAL_SUCCESS != opal_hwloc_base_get_topology()) {
+        return -1;
+    }
+    /* nothing to choose from */
+    count = hwloc_get_nbobjs_by_type(opal_hwloc_topology, HWLOC_OBJ_NUMANODE);
+    if (count < 2) {
+        return -1;
+    }
+
+    if (NULL == (cpuset = hwloc_bitmap_alloc())) {
+        return -1;
+    }
+    if (0 == hwloc_get_cpubind(opal_hwloc_topology, cpuset, HWLOC_CPUBIND_PROCESS)) {
+        for (i = 0; i < count; ++i) {
+            node = hwloc_get_obj_by_type(opal_hwloc_topology, HWLOC_OBJ_NUMANODE, i);
+            if (NULL != node && hwloc_bitmap_isincluded(cpuset, node->cpuset)) {
+                numa_node = (int) i;
+                break;
+            }
+        }
+    }
+    hwloc_bitmap_free(cpuset);
+
+    return numa_node;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+int
+opal_shmem_base_bind_numa(void *addr, size_t size, int numa_node)
+{
+    hwloc_obj_t node;
+
+    if (0 > numa_node || OPAL_SUCCESS != opal_hwloc_base_get_topology()) {
+        return OPAL_ERR_NOT_AVAILABLE;
+    }
+    node = hwloc_get_obj_by_type(opal_hwloc_topology, HWLOC_OBJ_NUMANODE,
+                                 (unsigned int) numa_node);
+    if (NULL == node) {
+        return OPAL_ERR_NOT_FOUND;
+    }
+
+    /* pages touched already are moved, later ones are allocated there */
+    if (0 != hwloc_set_area_membind(opal_hwloc_topology, addr, size, node->cpuset,
+                                    HWLOC_MEMBIND_BIND, HWLOC_MEMBIND_MIGRATE)) {
+        opal_output_verbose(20, opal_shmem_base_framework.framework_output,
+                            "shmem: base: could not bind %lu bytes at %p to NUMA node %d",
+                            (unsigned long) size, addr, numa_node);
+        return OPAL_ERR_NOT_SUPPORTED;
+    }
+
+    return OPAL_SUCCESS;
+}
@@ -40,6 +40,13 @@
  * globals
  */
 char *opal_shmem_base_RUNTIME_QUERY_hint = NULL;
+int opal_shmem_base_huge_pages = OPAL_SHMEM_HUGE_PAGES_NONE;
+
+static mca_base_var_enum_value_t huge_pages_values[] = {
+    {.value = OPAL_SHMEM_HUGE_PAGES_NONE, .string = "none"},
+    {.value = OPAL_SHMEM_HUGE_PAGES_TRANSPARENT, .string = "transparent"},
+    {.value = OPAL_SHMEM_HUGE_PAGES_HUGETLB, .string = "hugetlb"},
+    {.value = 0, .string = NULL}};
 
 /* ////////////////////////////////////////////////////////////////////////// */
 /**
@@ -48,6 +55,7 @@ char *opal_shmem_base_RUNTIME_QUERY_hint = NULL;
 static int
 opal_shmem_base_register (mca_base_register_flag_t flags)
 {
+    mca_base_var_enum_t *new_enum;
     int ret;
 
     /* register an INTERNAL parameter used to provide a component selection
@@ -65,6 +73,25 @@ opal_shmem_base_register (mca_base_register_flag_t flags)
                                            MCA_BASE_VAR_FLAG_INTERNAL,
                                            OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_ALL,
                                            &opal_shmem_base_RUNTIME_QUERY_hint);
+    if (0 > ret) {
+        return ret;
+    }
+
+    (void) mca_base_var_enum_create("shmem_base_huge_pages", huge_pages_values, &new_enum);
+    opal_shmem_base_huge_pages = OPAL_SHMEM_HUGE_PAGES_NONE;
+    ret = mca_base_framework_var_register (&opal_shmem_base_framework, "huge_pages",
+                                           "Back new shared memory segments with huge "
+                                           "pages: none, transparent (madvise the "
+                                           "mapping) or hugetlb (hugetlbfs or "
+                                           "SHM_HUGETLB pages where the component "
+                                           "supports them, transparent otherwise).  "
+                                           "Segments fall back to regular pages when "
+                                           "huge pages cannot be had.",
+                                           MCA_BASE_VAR_TYPE_INT, new_enum, 0,
+                                           MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &opal_shmem_base_huge_pages);
+    OBJ_RELEASE(new_enum);
 
     return (0 > ret) ? ret : OPAL_SUCCESS;
 }
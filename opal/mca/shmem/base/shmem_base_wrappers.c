@@ -22,6 +22,7 @@
 #include "opal_config.h"
 
 #include "opal/constants.h"
+#include "opal/util/output.h"
 #include "opal/mca/shmem/shmem.h"
 #include "opal/mca/shmem/base/base.h"
 
@@ -31,11 +32,22 @@ opal_shmem_segment_create(opal_shmem_ds_t *ds_buf,
                           const char *file_name,
                           size_t size)
 {
+    int rc;
+
     if (!opal_shmem_base_selected) {
         return OPAL_ERROR;
     }
 
-    return opal_shmem_base_module->segment_create(ds_buf, file_name, size);
+    rc = opal_shmem_base_module->segment_create(ds_buf, file_name, size);
+    if (OPAL_SUCCESS == rc && OPAL_SHMEM_HUGE_PAGES_NONE != opal_shmem_base_huge_pages) {
+        opal_output_verbose(10, opal_shmem_base_framework.framework_output,
+                            "shmem: base: segment of %lu bytes backed by %lu byte %s pages",
+                            (unsigned long) ds_buf->seg_size,
+                            (unsigned long) ds_buf->seg_page_size,
+                            (ds_buf->flags & OPAL_SHMEM_DS_FLAGS_HUGETLB) ? "hugetlb" :
+                            "regular or transparent huge");
+    }
+    return rc;
 }
 
 /* ////////////////////////////////////////////////////////////////////////// */
@@ -57,6 +57,7 @@
 #include "opal/util/path.h"
 #include "opal/util/show_help.h"
 #include "opal/util/string_copy.h"
+#include "opal/mca/pmix/pmix-internal.h"
 #include "opal/mca/shmem/shmem.h"
 #include "opal/mca/shmem/base/base.h"
 
@@ -135,6 +136,7 @@ shmem_ds_reset(opal_shmem_ds_t *ds_buf)
     OPAL_SHMEM_DS_RESET_FLAGS(ds_buf);
     ds_buf->seg_id = OPAL_SHMEM_DS_ID_INVALID;
     ds_buf->seg_size = 0;
+    ds_buf->seg_page_size = 0;
     memset(ds_buf->seg_name, '\0', OPAL_PATH_MAX);
     ds_buf->seg_base_addr = MAP_FAILED;
 }
@@ -295,6 +297,65 @@ get_uniq_file_name(const char *base_path, const char *hash_key)
     return uniq_name_buf;
 }
 
+/* ////////////////////////////////////////////////////////////////////////// */
+/**
+ * places the backing file on a hugetlbfs mount.  failures are not reported:
+ * the caller falls back to a regular backing file.
+ */
+static int
+segment_create_hugetlb(opal_shmem_ds_t *ds_buf,
+                       const char *file_name,
+                       size_t size)
+{
+    const char *mount;
+    char *real_file_name = NULL;
+    size_t page_size = 0;
+    void *segment = MAP_FAILED;
+    int fd = -1;
+
+    if (NULL == (mount = opal_shmem_base_hugetlbfs_path(&page_size))) {
+        return OPAL_ERR_NOT_AVAILABLE;
+    }
+    if (NULL == (real_file_name = get_uniq_file_name(mount, file_name))) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+    /* hugetlbfs files come in whole pages */
+    size = (size + page_size - 1) & ~(page_size - 1);
+
+    if (-1 == (fd = open(real_file_name, O_CREAT | O_RDWR, 0600)) ||
+        0 != ftruncate(fd, size) ||
+        MAP_FAILED == (segment = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                                      MAP_SHARED, fd, 0))) {
+        opal_output_verbose(20, opal_shmem_base_framework.framework_output,
+                            "%s: %s: could not create a hugetlb segment in %s (%s)",
+                            mca_shmem_mmap_component.super.base_version.mca_type_name,
+                            mca_shmem_mmap_component.super.base_version.mca_component_name,
+                            mount, strerror(errno));
+        if (-1 != fd) {
+            close(fd);
+            unlink(real_file_name);
+        }
+        free(real_file_name);
+        return OPAL_ERR_NOT_AVAILABLE;
+    }
+    close(fd);
+    /* the file is not in the session directory, so ask the runtime to remove
+     * it should we not get the chance to unlink it ourselves
+     */
+    (void) opal_pmix_register_cleanup(real_file_name, false, false, false);
+
+    ds_buf->seg_cpid = getpid();
+    ds_buf->seg_size = size;
+    ds_buf->seg_page_size = page_size;
+    ds_buf->seg_base_addr = segment;
+    (void)opal_string_copy(ds_buf->seg_name, real_file_name, OPAL_PATH_MAX);
+    ds_buf->flags |= OPAL_SHMEM_DS_FLAGS_HUGETLB;
+    OPAL_SHMEM_DS_SET_VALID(ds_buf);
+    free(real_file_name);
+
+    return OPAL_SUCCESS;
+}
+
 /* ////////////////////////////////////////////////////////////////////////// */
 static int
 segment_create(opal_shmem_ds_t *ds_buf,
@@ -311,6 +372,13 @@ segment_create(opal_shmem_ds_t *ds_buf,
     /* init the contents of opal_shmem_ds_t */
     shmem_ds_reset(ds_buf);
 
+    if (OPAL_SHMEM_HUGE_PAGES_HUGETLB == opal_shmem_base_huge_pages) {
+        if (OPAL_SUCCESS == segment_create_hugetlb(ds_buf, file_name, size)) {
+            return OPAL_SUCCESS;
+        }
+        shmem_ds_reset(ds_buf);
+    }
+
     /* change the path of shmem mmap's backing store? */
     if (0 != opal_shmem_mmap_relocate_backing_file) {
         int err;
@@ -425,6 +493,7 @@ segment_create(opal_shmem_ds_t *ds_buf,
         ds_buf->seg_cpid = my_pid;
         ds_buf->seg_size = size;
         ds_buf->seg_base_addr = segment;
+        ds_buf->seg_page_size = opal_shmem_base_advise(segment, size);
         (void)opal_string_copy(ds_buf->seg_name, real_file_name, OPAL_PATH_MAX);
 
         /* set "valid" bit because setment creation was successful */
@@ -502,6 +571,9 @@ segment_attach(opal_shmem_ds_t *ds_buf)
             close(ds_buf->seg_id);
             return NULL;
         }
+        if (!(ds_buf->flags & OPAL_SHMEM_DS_FLAGS_HUGETLB)) {
+            (void) opal_shmem_base_advise(ds_buf->seg_base_addr, ds_buf->seg_size);
+        }
         /* all is well */
         /* if close fails here, that's okay.  just let the user know and
          * continue.  if we got this far, open and mmap were successful...
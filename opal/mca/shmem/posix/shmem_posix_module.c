@@ -125,6 +125,7 @@ shmem_ds_reset(opal_shmem_ds_t *ds_buf)
     OPAL_SHMEM_DS_RESET_FLAGS(ds_buf);
     ds_buf->seg_id = OPAL_SHMEM_DS_ID_INVALID;
     ds_buf->seg_size = 0;
+    ds_buf->seg_page_size = 0;
     memset(ds_buf->seg_name, '\0', OPAL_PATH_MAX);
     ds_buf->seg_base_addr = MAP_FAILED;
 }
@@ -227,6 +228,10 @@ segment_create(opal_shmem_ds_t *ds_buf,
         ds_buf->seg_cpid = my_pid;
         ds_buf->seg_size = size;
         ds_buf->seg_base_addr = segment;
+        /* shm_open objects live on tmpfs, so hugetlb pages are out of reach:
+         * transparent huge pages are the best we can do here.
+         */
+        ds_buf->seg_page_size = opal_shmem_base_advise(segment, size);
 
         /* notice that we are not setting ds_buf->name here.  at this point,
          * posix_shm_open was successful, so the contents of ds_buf->name are
@@ -316,6 +321,7 @@ segment_attach(opal_shmem_ds_t *ds_buf)
         }
         /* all is well */
         else {
+            (void) opal_shmem_base_advise(ds_buf->seg_base_addr, ds_buf->seg_size);
             /* if close fails here, that's okay.  just let the user know and
              * continue.  if we got this far, open and mmap were successful...
              */
@@ -49,6 +49,11 @@ BEGIN_C_DECLS
  */
 #define OPAL_SHMEM_DS_FLAGS_VALID 0x01
 
+/**
+ * flag indicating that the segment is backed by hugetlb pages
+ */
+#define OPAL_SHMEM_DS_FLAGS_HUGETLB 0x02
+
 /**
  * 0x1* - reserved for internal flags. that is, flags that will NOT be
  * propagated via ds_copy during inter-process information sharing.
@@ -108,6 +113,8 @@ struct opal_shmem_ds_t {
     size_t seg_size;
     /* base address of shared memory segment */
     void *seg_base_addr;
+    /* page size backing the segment, as far as the creator could tell */
+    size_t seg_page_size;
     /* path to backing store -- last element so we can easily calculate the
      * "real" size of opal_shmem_ds_t. that is, the amount of the struct that
      * is actually being used. for example: if seg_name is something like:
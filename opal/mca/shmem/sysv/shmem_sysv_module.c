@@ -127,6 +127,7 @@ shmem_ds_reset(opal_shmem_ds_t *ds_buf)
     OPAL_SHMEM_DS_RESET_FLAGS(ds_buf);
     ds_buf->seg_id = OPAL_SHMEM_DS_ID_INVALID;
     ds_buf->seg_size = 0;
+    ds_buf->seg_page_size = 0;
     memset(ds_buf->seg_name, '\0', OPAL_PATH_MAX);
     ds_buf->seg_base_addr = (unsigned char *)-1;
 }
@@ -180,6 +181,7 @@ segment_create(opal_shmem_ds_t *ds_buf,
     int rc = OPAL_SUCCESS;
     pid_t my_pid = getpid();
     void *segment = MAP_FAILED;
+    size_t page_size = 0;
 
     /* init the contents of opal_shmem_ds_t */
     shmem_ds_reset(ds_buf);
@@ -188,8 +190,32 @@ segment_create(opal_shmem_ds_t *ds_buf,
      * being located on a network file system... so no check is needed here.
      */
 
+#if defined(SHM_HUGETLB)
+    /* try hugetlb pages first if asked to, quietly falling back to regular
+     * pages when none are reserved.
+     */
+    if (OPAL_SHMEM_HUGE_PAGES_HUGETLB == opal_shmem_base_huge_pages &&
+        0 != (page_size = opal_shmem_base_hugetlb_page_size())) {
+        size_t huge_size = (size + page_size - 1) & ~(page_size - 1);
+
+        if (-1 != (ds_buf->seg_id = shmget(IPC_PRIVATE, huge_size,
+                                           IPC_CREAT | IPC_EXCL | S_IRWXU |
+                                           SHM_HUGETLB))) {
+            size = huge_size;
+            ds_buf->flags |= OPAL_SHMEM_DS_FLAGS_HUGETLB;
+        } else {
+            opal_output_verbose(20, opal_shmem_base_framework.framework_output,
+                                "%s: %s: could not create a hugetlb segment (%s)",
+                                mca_shmem_sysv_component.super.base_version.mca_type_name,
+                                mca_shmem_sysv_component.super.base_version.mca_component_name,
+                                strerror(errno));
+        }
+    }
+#endif /* SHM_HUGETLB */
+
     /* create a new shared memory segment and save the shmid. */
-    if (-1 == (ds_buf->seg_id = shmget(IPC_PRIVATE, size,
+    if (-1 == ds_buf->seg_id &&
+        -1 == (ds_buf->seg_id = shmget(IPC_PRIVATE, size,
                                        IPC_CREAT | IPC_EXCL | S_IRWXU))) {
         int err = errno;
         const char *hn;
@@ -230,6 +256,10 @@ segment_create(opal_shmem_ds_t *ds_buf,
         ds_buf->seg_cpid = my_pid;
         ds_buf->seg_size = size;
         ds_buf->seg_base_addr = (unsigned char *)segment;
+        if (!(ds_buf->flags & OPAL_SHMEM_DS_FLAGS_HUGETLB)) {
+            page_size = opal_shmem_base_advise(segment, size);
+        }
+        ds_buf->seg_page_size = page_size;
 
         /* notice that we are not setting ds_buf->name here. sysv doesn't use
          * it, so don't worry about it - shmem_ds_reset took care of
@@ -286,6 +316,9 @@ segment_attach(opal_shmem_ds_t *ds_buf)
             shmctl(ds_buf->seg_id, IPC_RMID, NULL);
             return NULL;
         }
+        if (!(ds_buf->flags & OPAL_SHMEM_DS_FLAGS_HUGETLB)) {
+            (void) opal_shmem_base_advise(ds_buf->seg_base_addr, ds_buf->seg_size);
+        }
     }
     /* else i was the segment creator.  nothing to do here because all the hard
      * work was done in segment_create :-).
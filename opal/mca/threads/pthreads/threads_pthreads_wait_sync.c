@@ -58,6 +58,8 @@ static opal_atomic_int32_t num_thread_in_progress = 0;
 
 int ompi_sync_wait_mt(ompi_wait_sync_t *sync)
 {
+    uint64_t idle_since = 0;
+
     /* Don't stop if the waiting synchronization is completed. We avoid the
      * race condition around the release of the synchronization using the
      * signaling field.
@@ -119,7 +121,7 @@ int ompi_sync_wait_mt(ompi_wait_sync_t *sync)
     OPAL_THREAD_ADD_FETCH32(&num_thread_in_progress, 1);
     while (sync->count > 0) { /* progress till completion */
         /* don't progress with the sync lock locked or you'll deadlock */
-        opal_progress();
+        opal_progress_wait(&idle_since);
     }
     OPAL_THREAD_ADD_FETCH32(&num_thread_in_progress, -1);
 
@@ -69,6 +69,7 @@ typedef struct ompi_wait_sync_t {
         pthread_mutex_lock(&(sync->lock));            \
         pthread_cond_signal(&sync->condition);        \
         pthread_mutex_unlock(&(sync->lock));          \
+        opal_progress_wakeup(opal_progress_doorbell); \
         sync->signaling = false;                      \
     }
 
@@ -84,12 +85,14 @@ OPAL_DECLSPEC extern ompi_wait_sync_t *wait_sync_list;
 OPAL_DECLSPEC int ompi_sync_wait_mt(ompi_wait_sync_t *sync);
 static inline int sync_wait_st(ompi_wait_sync_t *sync)
 {
+    uint64_t idle_since = 0;
+
     assert( NULL == wait_sync_list );
     assert( NULL == sync->next );
     wait_sync_list = sync;
 
     while (sync->count > 0) {
-        opal_progress();
+        opal_progress_wait(&idle_since);
     }
     wait_sync_list = NULL;
 
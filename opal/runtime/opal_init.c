@@ -78,6 +78,7 @@
 #include "opal/util/keyval_parse.h"
 #include "opal/util/sys_limits.h"
 #include "opal/util/timings.h"
+#include "opal/util/trace.h"
 
 #if OPAL_CC_USE_PRAGMA_IDENT
 #pragma ident OPAL_IDENT_STRING
@@ -690,6 +691,11 @@ opal_init(int* pargc, char*** pargv)
         return opal_init_error ("opal_reachable_base_select", ret);
     }
 
+    /* the event rings, now that the timer is available */
+    if (OPAL_SUCCESS != (ret = OPAL_TRACE_INIT())) {
+        return opal_init_error ("opal_trace_init", ret);
+    }
+
     ++opal_initialized;
 
     return OPAL_SUCCESS;
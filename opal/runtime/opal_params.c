@@ -38,6 +38,7 @@
 
 #include "opal/constants.h"
 #include "opal/runtime/opal.h"
+#include "opal/class/opal_free_list.h"
 #include "opal/datatype/opal_datatype.h"
 #include "opal/mca/base/mca_base_var.h"
 #include "opal/mca/threads/mutex.h"
@@ -48,6 +49,7 @@
 #include "opal/util/opal_environ.h"
 #include "opal/util/show_help.h"
 #include "opal/util/timings.h"
+#include "opal/util/trace.h"
 #include "opal/util/printf.h"
 
 char *opal_signal_string = NULL;
@@ -169,6 +171,31 @@ int opal_register_params(void)
                                  &opal_progress_yield_when_idle);
 #endif
 
+    opal_progress_block_when_idle = false;
+    (void) mca_base_var_register ("opal", "opal", "progress", "block_when_idle",
+                                  "Block instead of spinning when waiting on progress makes no progress "
+                                  "for opal_progress_spin_usec",
+                                  MCA_BASE_VAR_TYPE_BOOL, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                  OPAL_INFO_LVL_8, MCA_BASE_VAR_SCOPE_LOCAL,
+                                  &opal_progress_block_when_idle);
+
+    opal_progress_spin_usec = -1;
+    (void) mca_base_var_register ("opal", "opal", "progress", "spin_usec",
+                                  "Time (in microseconds) to spin before blocking when "
+                                  "opal_progress_block_when_idle is set (-1: the measured cost of "
+                                  "a sleep and wakeup)",
+                                  MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                  OPAL_INFO_LVL_8, MCA_BASE_VAR_SCOPE_LOCAL,
+                                  &opal_progress_spin_usec);
+
+    opal_progress_block_usec = 1000;
+    (void) mca_base_var_register ("opal", "opal", "progress", "block_usec",
+                                  "Longest time (in microseconds) to block before polling again when "
+                                  "opal_progress_block_when_idle is set",
+                                  MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                  OPAL_INFO_LVL_8, MCA_BASE_VAR_SCOPE_LOCAL,
+                                  &opal_progress_block_usec);
+
 #if OPAL_ENABLE_DEBUG
     opal_progress_debug = false;
     ret = mca_base_var_register ("opal", "opal", "progress", "debug",
@@ -359,6 +386,37 @@ int opal_register_params(void)
             MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_8,
             MCA_BASE_VAR_SCOPE_READONLY, &opal_max_thread_in_progress);
 
+    (void) mca_base_var_register ("opal", "opal", "free_list", "thread_cache_size",
+                                  "Number of items each thread keeps in its own cache of a free list "
+                                  "when threads are in use (0: disable the per-thread caches)",
+                                  MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_8,
+                                  MCA_BASE_VAR_SCOPE_READONLY, &opal_free_list_thread_cache_size);
+
+    (void) mca_base_var_register ("opal", "opal", "free_list", "thread_caches",
+                                  "Number of per-thread caches of a free list; threads beyond "
+                                  "this number share them",
+                                  MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_8,
+                                  MCA_BASE_VAR_SCOPE_READONLY, &opal_free_list_thread_caches);
+
+#if OPAL_ENABLE_TRACE
+    (void) mca_base_var_register ("opal", "opal", "trace", "enable",
+                                  "Record the trace points of the communication stack and write "
+                                  "them to a file per process at finalize",
+                                  MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                  MCA_BASE_VAR_SCOPE_READONLY, &opal_trace_enabled);
+
+    (void) mca_base_var_register ("opal", "opal", "trace", "buffer_size",
+                                  "Number of events kept per thread, rounded up to a power "
+                                  "of two; older events are overwritten",
+                                  MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                  MCA_BASE_VAR_SCOPE_READONLY, &opal_trace_buffer_size);
+
+    (void) mca_base_var_register ("opal", "opal", "trace", "filename",
+                                  "Prefix of the trace files, the rank and \".trace\" are appended",
+                                  MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                  MCA_BASE_VAR_SCOPE_READONLY, &opal_trace_filename);
+#endif
+
     /* The ddt engine has a few parameters */
     ret = opal_datatype_register_params();
     if (OPAL_SUCCESS != ret) {
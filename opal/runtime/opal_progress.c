@@ -27,6 +27,16 @@
 
 #include "opal_config.h"
 
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#include <limits.h>
+#include <time.h>
+#if defined(__linux__) && defined(HAVE_SYS_SYSCALL_H)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
 #include "opal/runtime/opal_progress.h"
 #include "opal/util/event.h"
 #include "opal/mca/base/mca_base_var.h"
@@ -36,9 +46,15 @@
 #include "opal/runtime/opal_params.h"
 #include "opal/runtime/opal.h"
 #include "opal/mca/threads/threads.h"
+#include "opal/mca/hwloc/base/base.h"
 
 #define OPAL_PROGRESS_USE_TIMERS (OPAL_TIMER_CYCLE_SUPPORTED || OPAL_TIMER_USEC_SUPPORTED)
 #define OPAL_PROGRESS_ONLY_USEC_NATIVE (OPAL_TIMER_USEC_NATIVE && !OPAL_TIMER_CYCLE_NATIVE)
+#if defined(SYS_futex) && defined(FUTEX_WAIT)
+#define OPAL_PROGRESS_HAVE_FUTEX 1
+#else
+#define OPAL_PROGRESS_HAVE_FUTEX 0
+#endif
 
 #if OPAL_ENABLE_DEBUG
 bool opal_progress_debug = false;
@@ -68,6 +84,20 @@ static size_t callbacks_lp_size = 0;
 /* do we want to yield() if nothing happened */
 bool opal_progress_yield_when_idle = false;
 
+/* do we want to block if nothing happened for a while */
+bool opal_progress_block_when_idle = false;
+int opal_progress_spin_usec = -1;
+int opal_progress_block_usec = 1000;
+
+/* the doorbell used until a component provides one peers can ring */
+static opal_progress_doorbell_t progress_local_doorbell = {0, 0};
+opal_progress_doorbell_t *opal_progress_doorbell = &progress_local_doorbell;
+
+/* asynchronous progress thread */
+static opal_thread_t progress_async_thread;
+static volatile bool progress_async_running = false;
+static int progress_async_idle_usec = 0;
+
 #if OPAL_PROGRESS_USE_TIMERS
 static opal_timer_t event_progress_last_time = 0;
 static opal_timer_t event_progress_delta = 0;
@@ -98,8 +128,12 @@ static int fake_cb(void) { return 0; }
 static int _opal_progress_unregister (opal_progress_callback_t cb, volatile opal_progress_callback_t *callback_array,
                                       size_t *callback_array_len);
 
+static int opal_progress_calibrate_spin(void);
+
 static void opal_progress_finalize (void)
 {
+    opal_progress_async_stop();
+
     /* free memory associated with the callbacks */
     opal_atomic_lock(&progress_lock);
 
@@ -154,10 +188,21 @@ opal_progress_init(void)
         callbacks_lp[i] = fake_cb;
     }
 
+    if (opal_progress_block_when_idle) {
+        if (opal_progress_block_usec <= 0) {
+            opal_progress_block_usec = 1000;
+        }
+        if (opal_progress_spin_usec < 0) {
+            opal_progress_spin_usec = opal_progress_calibrate_spin();
+        }
+    }
+
     OPAL_OUTPUT((debug_output, "progress: initialized event flag to: %x",
                  opal_progress_event_flag));
     OPAL_OUTPUT((debug_output, "progress: initialized yield_when_idle to: %s",
                  opal_progress_yield_when_idle ? "true" : "false"));
+    OPAL_OUTPUT((debug_output, "progress: initialized block_when_idle to: %s (spin %d usec)",
+                 opal_progress_block_when_idle ? "true" : "false", opal_progress_spin_usec));
     OPAL_OUTPUT((debug_output, "progress: initialized num users to: %d",
                  num_event_users));
     OPAL_OUTPUT((debug_output, "progress: initialized poll rate to: %ld",
@@ -215,8 +260,7 @@ static int opal_progress_events(void)
  * care, as the cost of that happening is far outweighed by the cost
  * of the if checks (they were resulting in bad pipe stalling behavior)
  */
-void
-opal_progress(void)
+static inline int opal_progress_once(void)
 {
     static uint32_t num_calls = 0;
     size_t i;
@@ -243,6 +287,25 @@ opal_progress(void)
         opal_progress_events();
     }
 
+    return events;
+}
+
+/*
+ * Progress the event library and any functions that have registered to
+ * be called.  We don't propogate errors from the progress functions,
+ * so no action is taken if they return failures.  The functions are
+ * expected to return the number of events progressed, to determine
+ * whether or not we should yield the CPU during MPI progress.
+ * This is only losely tracked, as an error return can cause the number
+ * of progressed events to appear lower than it actually is.  We don't
+ * care, as the cost of that happening is far outweighed by the cost
+ * of the if checks (they were resulting in bad pipe stalling behavior)
+ */
+void
+opal_progress(void)
+{
+    int events = opal_progress_once();
+
     if (opal_progress_yield_when_idle && events <= 0) {
         /* If there is nothing to do - yield the processor - otherwise
          * we could consume the processor for the entire time slice. If
@@ -255,6 +318,190 @@ opal_progress(void)
     }
 }
 
+/*
+ * Blocking waits. A waiting thread spins for opal_progress_spin_usec
+ * and then sleeps on the doorbell; on Linux it is a futex on shared
+ * memory, so a peer process can wake it up. The sleeper announces
+ * itself before it polls one last time and the waker checks for
+ * sleepers after it published its data, so either the poll sees the
+ * data or the waker sees the sleeper.
+ */
+static void opal_progress_sleep(opal_atomic_int32_t *addr, int32_t val, int usec)
+{
+    struct timespec ts = {.tv_sec = usec / 1000000, .tv_nsec = (usec % 1000000) * 1000};
+
+#if OPAL_PROGRESS_HAVE_FUTEX
+    (void) syscall(SYS_futex, addr, FUTEX_WAIT, val, &ts, NULL, 0);
+#else
+    (void) addr;
+    (void) val;
+    (void) nanosleep(&ts, NULL);
+#endif
+}
+
+void
+opal_progress_ring(opal_progress_doorbell_t *bell)
+{
+    (void) opal_atomic_add_fetch_32(&bell->seq, 1);
+#if OPAL_PROGRESS_HAVE_FUTEX
+    (void) syscall(SYS_futex, &bell->seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#endif
+}
+
+static void opal_progress_block(void)
+{
+    opal_progress_doorbell_t *bell = opal_progress_doorbell;
+    int32_t seq = bell->seq;
+
+    (void) opal_atomic_add_fetch_32(&bell->sleepers, 1);
+    opal_atomic_mb();
+
+    if (opal_progress_once() <= 0) {
+        opal_progress_sleep(&bell->seq, seq, opal_progress_block_usec);
+    }
+
+    (void) opal_atomic_add_fetch_32(&bell->sleepers, -1);
+}
+
+/*
+ * Spinning for as long as a sleep and a wakeup cost before blocking is
+ * never more than twice as slow as the best choice in hindsight, so use
+ * the measured cost of a short sleep as the spin interval.
+ */
+static int opal_progress_calibrate_spin(void)
+{
+    opal_atomic_int32_t dummy = 0;
+    opal_timer_t start, elapsed;
+    const int reps = 16;
+
+    start = opal_timer_base_get_usec();
+    for (int i = 0 ; i < reps ; ++i) {
+        opal_progress_sleep(&dummy, 0, 1);
+    }
+    elapsed = (opal_timer_base_get_usec() - start) / reps;
+
+    if (elapsed < 1) {
+        return 1;
+    }
+    return (elapsed > (opal_timer_t) opal_progress_block_usec) ?
+        opal_progress_block_usec : (int) elapsed;
+}
+
+void
+opal_progress_wait(uint64_t *idle_since)
+{
+    opal_timer_t now;
+
+    if (!opal_progress_block_when_idle) {
+        opal_progress();
+        return;
+    }
+
+    if (opal_progress_once() > 0) {
+        *idle_since = 0;
+        return;
+    }
+
+    now = opal_timer_base_get_usec();
+    if (0 == *idle_since) {
+        *idle_since = now;
+    } else if (now - *idle_since >= (opal_timer_t) opal_progress_spin_usec) {
+        opal_progress_block();
+        return;
+    }
+
+    if (opal_progress_yield_when_idle) {
+        opal_thread_yield();
+    }
+}
+
+void
+opal_progress_set_doorbell(opal_progress_doorbell_t *bell)
+{
+    opal_progress_doorbell = (NULL != bell) ? bell : &progress_local_doorbell;
+    opal_atomic_wmb();
+}
+
+/*
+ * Asynchronous progress: a thread which calls the progress callbacks
+ * while the application computes, so that protocols needing more than
+ * one round trip (rendezvous, pipelined RDMA, nonblocking collective
+ * schedules) advance without calls into the library.
+ */
+static void *opal_progress_async_engine(opal_object_t *obj)
+{
+    opal_thread_t *thread = (opal_thread_t *) obj;
+
+    if (NULL != thread->t_arg &&
+        0 != hwloc_set_cpubind(opal_hwloc_topology, (hwloc_const_cpuset_t) thread->t_arg,
+                               HWLOC_CPUBIND_THREAD)) {
+        opal_output(0, "progress: unable to bind the asynchronous progress thread");
+    }
+
+    while (progress_async_running) {
+        if (opal_progress_once() <= 0) {
+            if (progress_async_idle_usec > 0) {
+                usleep(progress_async_idle_usec);
+            } else {
+                opal_thread_yield();
+            }
+        }
+    }
+
+    return NULL;
+}
+
+int
+opal_progress_async_start(int core, int idle_usec)
+{
+    hwloc_obj_t obj = NULL;
+    int rc;
+
+    if (progress_async_running) {
+        return OPAL_SUCCESS;
+    }
+
+    if (core >= 0) {
+        if (OPAL_SUCCESS != opal_hwloc_base_get_topology() ||
+            NULL == (obj = opal_hwloc_base_get_obj_by_type(opal_hwloc_topology,
+                                                           HWLOC_OBJ_CORE, 0, core,
+                                                           OPAL_HWLOC_LOGICAL))) {
+            return OPAL_ERR_NOT_FOUND;
+        }
+    }
+
+    OBJ_CONSTRUCT(&progress_async_thread, opal_thread_t);
+    progress_async_thread.t_run = opal_progress_async_engine;
+    progress_async_thread.t_arg = (NULL != obj) ? obj->cpuset : NULL;
+    progress_async_idle_usec = idle_usec;
+    progress_async_running = true;
+    opal_atomic_wmb();
+
+    rc = opal_thread_start(&progress_async_thread);
+    if (OPAL_SUCCESS != rc) {
+        progress_async_running = false;
+        OBJ_DESTRUCT(&progress_async_thread);
+        return rc;
+    }
+
+    OPAL_OUTPUT((debug_output, "progress: asynchronous progress thread started (core %d)", core));
+
+    return OPAL_SUCCESS;
+}
+
+void
+opal_progress_async_stop(void)
+{
+    if (!progress_async_running) {
+        return;
+    }
+
+    progress_async_running = false;
+    opal_atomic_wmb();
+    opal_thread_join(&progress_async_thread, NULL);
+    OBJ_DESTRUCT(&progress_async_thread);
+}
+
 
 int
 opal_progress_set_event_flag(int flag)
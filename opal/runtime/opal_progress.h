@@ -132,6 +132,90 @@ OPAL_DECLSPEC bool opal_progress_set_yield_when_idle(bool yieldopt);
 OPAL_DECLSPEC void opal_progress_set_event_poll_rate(int microseconds);
 
 
+/**
+ * Start the asynchronous progress thread
+ *
+ * Start a thread which calls the registered progress callbacks in a
+ * loop, so that communication advances while the application does not
+ * call into the library.  The caller has to make sure the library is in
+ * thread safe mode (opal_set_using_threads(true)) before any component
+ * which registers a callback is initialized.
+ *
+ * @param core       Logical index of the core to bind the thread to,
+ *                   or -1 to leave the binding alone
+ * @param idle_usec  Time (in microseconds) to sleep when a pass made
+ *                   no progress, 0 to just yield the processor
+ */
+OPAL_DECLSPEC int opal_progress_async_start(int core, int idle_usec);
+
+/**
+ * Stop the asynchronous progress thread
+ *
+ * Wait for the thread started by opal_progress_async_start() to exit.
+ * Does nothing if no thread is running.
+ */
+OPAL_DECLSPEC void opal_progress_async_stop(void);
+
+
+/**
+ * Doorbell of a process blocked in opal_progress_wait()
+ *
+ * A process which finds nothing to progress for a while goes to sleep
+ * on its doorbell.  Components place the doorbell in memory the peers
+ * can write (see opal_progress_set_doorbell()) and ring it with
+ * opal_progress_wakeup() after they queued something for the process.
+ */
+typedef struct opal_progress_doorbell_t {
+    opal_atomic_int32_t seq;       /**< bumped by every ring */
+    opal_atomic_int32_t sleepers;  /**< number of threads asleep */
+} opal_progress_doorbell_t;
+
+/* block instead of spinning when progress is idle for a while */
+OPAL_DECLSPEC extern bool opal_progress_block_when_idle;
+
+/* doorbell the threads of this process sleep on */
+OPAL_DECLSPEC extern opal_progress_doorbell_t *opal_progress_doorbell;
+
+/**
+ * Set the doorbell the threads of this process sleep on
+ *
+ * @param bell  Initialized doorbell, or NULL to go back to the private
+ *              doorbell of the process
+ */
+OPAL_DECLSPEC void opal_progress_set_doorbell(opal_progress_doorbell_t *bell);
+
+/**
+ * Progress on behalf of a thread waiting for a completion
+ *
+ * Same as opal_progress(), but when opal_progress_block_when_idle is
+ * set and no progress was made for the spin interval the thread sleeps
+ * on the doorbell until it is rung or the block interval expires.  The
+ * timeout keeps the progress of the sources which cannot ring the
+ * doorbell going.
+ *
+ * @param idle_since  State of the wait loop, initialized to 0
+ */
+OPAL_DECLSPEC void opal_progress_wait(uint64_t *idle_since);
+
+/* slow path of opal_progress_wakeup() */
+OPAL_DECLSPEC void opal_progress_ring(opal_progress_doorbell_t *bell);
+
+/**
+ * Wake up the threads sleeping on a doorbell
+ *
+ * Call after the data the sleepers wait for has been made visible.
+ */
+static inline void opal_progress_wakeup(opal_progress_doorbell_t *bell)
+{
+    if (OPAL_UNLIKELY(opal_progress_block_when_idle)) {
+        opal_atomic_mb();
+        if (bell->sleepers > 0) {
+            opal_progress_ring(bell);
+        }
+    }
+}
+
+
 /**
  * Progress callback function typedef
  *
@@ -172,6 +256,13 @@ OPAL_DECLSPEC extern int opal_progress_spin_count;
 /* do we want to call sched_yield() if nothing happened */
 OPAL_DECLSPEC extern bool opal_progress_yield_when_idle;
 
+/* time (in microseconds) opal_progress_wait() spins before it blocks,
+   -1 to calibrate it */
+OPAL_DECLSPEC extern int opal_progress_spin_usec;
+
+/* longest time (in microseconds) opal_progress_wait() blocks */
+OPAL_DECLSPEC extern int opal_progress_block_usec;
+
 /**
  * Progress until flag is true or poll iterations completed
  */
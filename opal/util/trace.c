@@ -0,0 +1,245 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+
+#include "opal/constants.h"
+#include "opal/mca/threads/mutex.h"
+#include "opal/runtime/opal.h"
+#include "opal/util/bit_ops.h"
+#include "opal/util/output.h"
+#include "opal/util/printf.h"
+#include "opal/util/proc.h"
+#include "opal/util/trace.h"
+
+/*
+ * Trace file layout, in the byte order of the process:
+ *
+ *   char     magic[8]        "OPALTRC"
+ *   uint32_t version         OPAL_TRACE_VERSION
+ *   uint32_t rank            vpid of the process
+ *   uint64_t frequency       of the timer, in Hz
+ *   uint64_t start_time      timer value at opal_trace_init()
+ *   uint64_t start_usec      gettimeofday() at opal_trace_init()
+ *   uint32_t nnames
+ *   uint32_t nbuffers
+ *   nnames times:
+ *     uint32_t length
+ *     char     name[length]  the event of id i is the i-th name
+ *   nbuffers times:
+ *     uint32_t thread
+ *     uint32_t reserved
+ *     uint64_t nevents
+ *     uint64_t dropped       events overwritten because the ring was full
+ *     opal_trace_event_t events[nevents], oldest first
+ */
+#define OPAL_TRACE_MAGIC   "OPALTRC"
+#define OPAL_TRACE_VERSION 1
+#define OPAL_TRACE_MAX_EVENTS 4096
+
+bool opal_trace_enabled = false;
+unsigned int opal_trace_buffer_size = 65536;
+char *opal_trace_filename = "opal_trace";
+
+#if OPAL_HAVE_THREAD_LOCAL
+opal_thread_local opal_trace_buffer_t *opal_trace_buffer = NULL;
+#else
+opal_trace_buffer_t *opal_trace_buffer = NULL;
+#endif
+
+static opal_mutex_t opal_trace_lock = OPAL_MUTEX_STATIC_INIT;
+static opal_trace_buffer_t *opal_trace_buffers = NULL;
+static uint32_t opal_trace_nbuffers = 0;
+static char *opal_trace_names[OPAL_TRACE_MAX_EVENTS];
+static uint32_t opal_trace_nnames = 0;
+static bool opal_trace_initialized = false;
+static uint64_t opal_trace_start_time = 0;
+static uint64_t opal_trace_start_usec = 0;
+
+int opal_trace_event_id(const char *name)
+{
+    int id = -1;
+    uint32_t i;
+
+    OPAL_THREAD_LOCK(&opal_trace_lock);
+    for (i = 0; i < opal_trace_nnames; ++i) {
+        if (0 == strcmp(opal_trace_names[i], name)) {
+            id = (int) i;
+            break;
+        }
+    }
+    if (id < 0 && opal_trace_nnames < OPAL_TRACE_MAX_EVENTS &&
+        NULL != (opal_trace_names[opal_trace_nnames] = strdup(name))) {
+        id = (int) opal_trace_nnames++;
+    }
+    OPAL_THREAD_UNLOCK(&opal_trace_lock);
+
+    return id;
+}
+
+opal_trace_buffer_t *opal_trace_buffer_attach(void)
+{
+    opal_trace_buffer_t *buffer;
+    unsigned int size;
+
+    OPAL_THREAD_LOCK(&opal_trace_lock);
+#if !OPAL_HAVE_THREAD_LOCAL
+    /* somebody else might have been faster */
+    if (NULL != (buffer = opal_trace_buffer)) {
+        OPAL_THREAD_UNLOCK(&opal_trace_lock);
+        return buffer;
+    }
+#endif
+
+    size = (unsigned int) opal_next_poweroftwo_inclusive((int) opal_trace_buffer_size);
+    buffer = (opal_trace_buffer_t *) calloc(1, sizeof(*buffer) + size * sizeof(opal_trace_event_t));
+    if (NULL == buffer) {
+        opal_output(0, "trace: cannot allocate %u events, tracing disabled", size);
+        opal_trace_enabled = false;
+        OPAL_THREAD_UNLOCK(&opal_trace_lock);
+        return NULL;
+    }
+    buffer->thread = opal_trace_nbuffers++;
+    buffer->mask = size - 1;
+    buffer->next = opal_trace_buffers;
+    opal_trace_buffers = buffer;
+    opal_trace_buffer = buffer;
+    OPAL_THREAD_UNLOCK(&opal_trace_lock);
+
+    return buffer;
+}
+
+int opal_trace_init(void)
+{
+    struct timeval tv;
+
+    if (!opal_trace_enabled || opal_trace_initialized) {
+        return OPAL_SUCCESS;
+    }
+    if (0 == opal_trace_buffer_size || (unsigned int) INT_MAX / 2 < opal_trace_buffer_size) {
+        opal_output(0, "trace: invalid opal_trace_buffer_size %u, tracing disabled",
+                    opal_trace_buffer_size);
+        opal_trace_enabled = false;
+        return OPAL_SUCCESS;
+    }
+
+    /* a pair of timestamps to place the events of all the processes
+       on the same time line */
+    gettimeofday(&tv, NULL);
+    opal_trace_start_time = (uint64_t) opal_timer_base_get_cycles();
+    opal_trace_start_usec = (uint64_t) tv.tv_sec * 1000000 + tv.tv_usec;
+    opal_trace_initialized = true;
+
+    /* MPI does not finalize OPAL completely: it calls opal_trace_finalize() itself */
+    opal_finalize_register_cleanup(opal_trace_finalize);
+
+    return OPAL_SUCCESS;
+}
+
+static int opal_trace_write(FILE *fh)
+{
+    uint32_t u32[2];
+    uint64_t u64[3];
+    opal_trace_buffer_t *buffer;
+    uint32_t i;
+
+    if (1 != fwrite(OPAL_TRACE_MAGIC, 8, 1, fh)) {
+        return OPAL_ERROR;
+    }
+    u32[0] = OPAL_TRACE_VERSION;
+    u32[1] = (uint32_t) OPAL_PROC_MY_NAME.vpid;
+    u64[0] = (uint64_t) opal_timer_base_get_freq();
+    u64[1] = opal_trace_start_time;
+    u64[2] = opal_trace_start_usec;
+    if (1 != fwrite(u32, sizeof(u32), 1, fh) || 1 != fwrite(u64, sizeof(u64), 1, fh)) {
+        return OPAL_ERROR;
+    }
+
+    u32[0] = opal_trace_nnames;
+    u32[1] = opal_trace_nbuffers;
+    if (1 != fwrite(u32, sizeof(u32), 1, fh)) {
+        return OPAL_ERROR;
+    }
+    for (i = 0; i < opal_trace_nnames; ++i) {
+        u32[0] = (uint32_t) strlen(opal_trace_names[i]);
+        if (1 != fwrite(u32, sizeof(u32[0]), 1, fh) ||
+            u32[0] != fwrite(opal_trace_names[i], 1, u32[0], fh)) {
+            return OPAL_ERROR;
+        }
+    }
+
+    for (buffer = opal_trace_buffers; NULL != buffer; buffer = buffer->next) {
+        size_t head = buffer->head, size = (size_t) buffer->mask + 1;
+        size_t count = (head < size) ? head : size;
+        size_t first = (head - count) & buffer->mask;
+
+        u32[0] = buffer->thread;
+        u32[1] = 0;
+        u64[0] = count;
+        u64[1] = head - count;
+        if (1 != fwrite(u32, sizeof(u32), 1, fh) || 1 != fwrite(u64, 2 * sizeof(u64[0]), 1, fh)) {
+            return OPAL_ERROR;
+        }
+        /* the ring wraps around: oldest events first */
+        if (first + count > size) {
+            if (size - first != fwrite(buffer->events + first, sizeof(opal_trace_event_t),
+                                       size - first, fh) ||
+                count - (size - first) != fwrite(buffer->events, sizeof(opal_trace_event_t),
+                                                 count - (size - first), fh)) {
+                return OPAL_ERROR;
+            }
+        } else if (count != fwrite(buffer->events + first, sizeof(opal_trace_event_t), count, fh)) {
+            return OPAL_ERROR;
+        }
+    }
+
+    return OPAL_SUCCESS;
+}
+
+void opal_trace_finalize(void)
+{
+    char *filename = NULL;
+    FILE *fh;
+
+    if (!opal_trace_initialized) {
+        return;
+    }
+    opal_trace_initialized = false;
+    /* no more events from here on */
+    opal_trace_enabled = false;
+    opal_atomic_mb();
+
+    if (NULL != opal_trace_filename && '\0' != opal_trace_filename[0]) {
+        opal_asprintf(&filename, "%s.%u.trace", opal_trace_filename,
+                      (unsigned int) OPAL_PROC_MY_NAME.vpid);
+    }
+    if (NULL != filename) {
+        if (NULL == (fh = fopen(filename, "w"))) {
+            opal_output(0, "trace: cannot open %s: %s", filename, strerror(errno));
+        } else {
+            if (OPAL_SUCCESS != opal_trace_write(fh)) {
+                opal_output(0, "trace: cannot write %s: %s", filename, strerror(errno));
+            }
+            fclose(fh);
+        }
+        free(filename);
+    }
+
+    /* the rings and the names stay allocated until exit: other threads
+       may still be in the middle of opal_trace_record() */
+}
@@ -0,0 +1,178 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ * Binary event tracing of the communication stack.
+ *
+ * A trace point records a timestamped event with a peer and two
+ * arguments in a ring owned by the calling thread, so recording takes
+ * neither a lock nor an atomic operation. When the ring is full the
+ * oldest events are overwritten: the rings keep the last
+ * opal_trace_buffer_size events of every thread. At finalize every
+ * process writes its rings to <opal_trace_filename>.<rank>.trace, and
+ * opal_trace2json converts these files to the Chrome trace event
+ * format.
+ *
+ * Trace points are compiled out unless Open MPI was configured with
+ * --enable-trace, and do nothing but test a flag unless the
+ * opal_trace_enable MCA parameter is set.
+ *
+ * Events are named at the trace point, e.g.
+ *
+ *     OPAL_TRACE("pml_ob1_send_post", dst, req, size);
+ *
+ * The peer is the vpid of the peer process, i.e. its rank in
+ * MPI_COMM_WORLD for the processes of the initial job, whatever the
+ * rank space of the layer recording the event. The name is only
+ * resolved to an event id the first time a trace point fires. Names ending with "_begin" and "_end" delimit a
+ * duration in the converted trace.
+ */
+
+#ifndef OPAL_UTIL_TRACE_H
+#define OPAL_UTIL_TRACE_H
+
+#include "opal_config.h"
+
+#include <stdint.h>
+
+#if OPAL_ENABLE_TRACE
+#include "opal/prefetch.h"
+#include "opal/sys/atomic.h"
+#include "opal/mca/threads/thread_usage.h"
+#include "opal/mca/timer/base/base.h"
+#endif
+
+BEGIN_C_DECLS
+
+#if OPAL_ENABLE_TRACE
+
+/** One event, as it is written in the trace file */
+typedef struct opal_trace_event_t {
+    /** timer cycles, see opal_timer_base_get_cycles() */
+    uint64_t time;
+    /** event id, the index of its name in the trace file */
+    uint32_t id;
+    /** vpid of the peer process of the event, -1 if none */
+    int32_t peer;
+    /** event specific arguments */
+    uint64_t arg0;
+    uint64_t arg1;
+} opal_trace_event_t;
+
+/** Event ring of a thread */
+typedef struct opal_trace_buffer_t {
+    /** next ring, all the rings are kept until exit */
+    struct opal_trace_buffer_t *next;
+    /** index of the thread, in the order the threads started tracing */
+    uint32_t thread;
+    /** number of events of the ring minus one (a power of two minus one) */
+    uint32_t mask;
+    /** number of events ever recorded */
+    opal_atomic_size_t head;
+    opal_trace_event_t events[];
+} opal_trace_buffer_t;
+
+/** MCA parameter: record the trace points */
+OPAL_DECLSPEC extern bool opal_trace_enabled;
+/** MCA parameter: number of events kept per thread */
+OPAL_DECLSPEC extern unsigned int opal_trace_buffer_size;
+/** MCA parameter: prefix of the trace files */
+OPAL_DECLSPEC extern char *opal_trace_filename;
+
+#if OPAL_HAVE_THREAD_LOCAL
+/* Ring of the calling thread, NULL until it records its first event */
+OPAL_DECLSPEC extern opal_thread_local opal_trace_buffer_t *opal_trace_buffer;
+#else
+/* Without thread local storage all the threads share a single ring */
+OPAL_DECLSPEC extern opal_trace_buffer_t *opal_trace_buffer;
+#endif
+
+/**
+ * Id of the event of the given name, registering the name if needed.
+ * Returns -1 when there is no room for more events.
+ */
+OPAL_DECLSPEC int opal_trace_event_id(const char *name);
+
+/**
+ * Allocate the ring of the calling thread. Returns NULL and disables
+ * tracing if the memory cannot be found.
+ */
+OPAL_DECLSPEC opal_trace_buffer_t *opal_trace_buffer_attach(void);
+
+/**
+ * Set up tracing. Called by opal_init() once the timer is available.
+ */
+OPAL_DECLSPEC int opal_trace_init(void);
+
+/**
+ * Stop tracing and write the trace file of this process. The rings are
+ * kept until exit. It is safe to call it several times; only the first
+ * call writes the file.
+ */
+OPAL_DECLSPEC void opal_trace_finalize(void);
+
+static inline void opal_trace_record(int id, int peer, uint64_t arg0, uint64_t arg1)
+{
+    opal_trace_buffer_t *buffer = opal_trace_buffer;
+    opal_trace_event_t *event;
+    size_t index;
+
+    if (OPAL_UNLIKELY(NULL == buffer)) {
+        if (NULL == (buffer = opal_trace_buffer_attach())) {
+            return;
+        }
+    }
+
+#if OPAL_HAVE_THREAD_LOCAL
+    index = buffer->head++;
+#else
+    index = opal_atomic_fetch_add_size_t(&buffer->head, 1);
+#endif
+    event = &buffer->events[index & buffer->mask];
+    event->time = (uint64_t) opal_timer_base_get_cycles();
+    event->id = (uint32_t) id;
+    event->peer = (int32_t) peer;
+    event->arg0 = arg0;
+    event->arg1 = arg1;
+}
+
+#define OPAL_TRACE(name, peer, arg0, arg1)                              \
+    do {                                                                \
+        static int opal_trace_id_ = -1;                                 \
+        if (OPAL_UNLIKELY(opal_trace_enabled)) {                        \
+            if (OPAL_UNLIKELY(opal_trace_id_ < 0)) {                    \
+                opal_trace_id_ = opal_trace_event_id(name);             \
+            }                                                           \
+            if (OPAL_LIKELY(opal_trace_id_ >= 0)) {                     \
+                opal_trace_record(opal_trace_id_, (peer),               \
+                                  (uint64_t) (uintptr_t) (arg0),        \
+                                  (uint64_t) (uintptr_t) (arg1));       \
+            }                                                           \
+        }                                                               \
+    } while (0)
+
+#define OPAL_TRACE_INIT() opal_trace_init()
+
+#define OPAL_TRACE_FINI() opal_trace_finalize()
+
+#else /* OPAL_ENABLE_TRACE */
+
+#define OPAL_TRACE(name, peer, arg0, arg1) ((void)0)
+
+#define OPAL_TRACE_INIT() OPAL_SUCCESS
+
+#define OPAL_TRACE_FINI() ((void)0)
+
+#endif /* OPAL_ENABLE_TRACE */
+
+END_C_DECLS
+
+#endif /* OPAL_UTIL_TRACE_H */
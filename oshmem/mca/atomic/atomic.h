@@ -237,6 +237,9 @@ OSHMEM_DECLSPEC OBJ_CLASS_DECLARATION(mca_atomic_base_module_t);
 
 OSHMEM_DECLSPEC extern mca_atomic_base_component_t mca_atomic_base_selected_component;
 OSHMEM_DECLSPEC extern mca_atomic_base_module_t mca_atomic;
+/* module with the next lower priority, used by modules which handle
+   only part of the operations themselves (e.g. atomic:shm) */
+OSHMEM_DECLSPEC extern mca_atomic_base_module_t mca_atomic_base_fallback;
 #define MCA_ATOMIC_CALL(a) mca_atomic.atomic_ ## a
 
 END_C_DECLS
@@ -32,6 +32,7 @@
  * variables
  */
 mca_atomic_base_module_t mca_atomic = {{0}};
+mca_atomic_base_module_t mca_atomic_base_fallback = {{0}};
 
 /*
  * Local types
@@ -92,7 +93,11 @@ int mca_atomic_base_select(void)
             opal_list_remove_first(selectable)) {
         avail_com_t *avail = (avail_com_t *) item;
 
-        /* Set module having the highest priority */
+        /* Set module having the highest priority, keep the previous one
+           for modules which pass some of the operations on */
+        if (NULL != mca_atomic.atomic_fadd) {
+            memcpy(&mca_atomic_base_fallback, &mca_atomic, sizeof(mca_atomic));
+        }
         memcpy(&mca_atomic, avail->ac_module, sizeof(mca_atomic));
 
         OBJ_RELEASE(avail->ac_module);
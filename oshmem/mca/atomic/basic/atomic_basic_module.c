@@ -110,7 +110,7 @@ int mca_atomic_basic_fop(shmem_ctx_t ctx,
 
     memcpy(prev, (void*) &temp_value, size);
 
-    op->o_func.c_fn((void*) value,
+    op->o_func.c_fn((void*) &value,
                     (void*) &temp_value,
                     size / op->dt_size);
 
@@ -0,0 +1,65 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef MCA_ATOMIC_SHM_H
+#define MCA_ATOMIC_SHM_H
+
+#include "oshmem_config.h"
+
+#include "oshmem/mca/mca.h"
+#include "oshmem/mca/atomic/atomic.h"
+#include "oshmem/mca/memheap/memheap.h"
+#include "oshmem/mca/memheap/base/base.h"
+#include "oshmem/util/oshmem_util.h"
+
+BEGIN_C_DECLS
+
+OSHMEM_MODULE_DECLSPEC extern mca_atomic_base_component_1_0_0_t
+mca_atomic_shm_component;
+
+int mca_atomic_shm_startup(bool enable_progress_threads, bool enable_threads);
+int mca_atomic_shm_finalize(void);
+mca_atomic_base_module_t*
+mca_atomic_shm_query(int *priority);
+
+struct mca_atomic_shm_module_t {
+    mca_atomic_base_module_t super;
+};
+typedef struct mca_atomic_shm_module_t mca_atomic_shm_module_t;
+OBJ_CLASS_DECLARATION(mca_atomic_shm_module_t);
+
+/*
+ * Address of the target in the address space of this process, NULL if
+ * the target does not live in a symmetric heap segment which is mapped
+ * from shared memory (e.g. static data). Whether an address is mapped
+ * only depends on its segment, so all PEs agree on which operations are
+ * done with CPU atomics and which are passed on.
+ */
+static inline void *atomic_shm_ptr(shmem_ctx_t ctx, void *target, int pe)
+{
+    sshmem_mkey_t *mkey;
+    void *rva;
+    int i;
+
+    for (i = 0; i < mca_memheap_base_num_transports(); i++) {
+        mkey = mca_memheap_base_get_cached_mkey(ctx, pe, target, i, &rva);
+        if (OPAL_UNLIKELY(NULL == mkey)) {
+            return NULL;
+        }
+        if (mca_memheap_base_mkey_is_shm(mkey)) {
+            return rva;
+        }
+    }
+
+    return NULL;
+}
+
+END_C_DECLS
+
+#endif /* MCA_ATOMIC_SHM_H */
@@ -0,0 +1,76 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "oshmem_config.h"
+
+#include "oshmem/constants.h"
+#include "oshmem/mca/atomic/atomic.h"
+#include "oshmem/mca/atomic/base/base.h"
+#include "atomic_shm.h"
+
+const char *mca_atomic_shm_component_version_string =
+"Open SHMEM shm atomic MCA component version " OSHMEM_VERSION;
+
+
+static int _shm_register(void);
+static int _shm_open(void);
+
+
+mca_atomic_base_component_t mca_atomic_shm_component = {
+
+    /* First, the mca_component_t struct containing meta information
+       about the component itself */
+
+    .atomic_version = {
+        MCA_ATOMIC_BASE_VERSION_2_0_0,
+
+        /* Component name and version */
+        .mca_component_name = "shm",
+        MCA_BASE_MAKE_VERSION(component, OSHMEM_MAJOR_VERSION, OSHMEM_MINOR_VERSION,
+                              OSHMEM_RELEASE_VERSION),
+
+        .mca_open_component = _shm_open,
+        .mca_register_component_params = _shm_register,
+    },
+    .atomic_data = {
+        /* The component is checkpoint ready */
+        MCA_BASE_METADATA_PARAM_CHECKPOINT
+    },
+
+    /* Initialization / querying functions */
+
+    .atomic_startup = mca_atomic_shm_startup,
+    .atomic_finalize = mca_atomic_shm_finalize,
+    .atomic_query = mca_atomic_shm_query,
+};
+
+static int _shm_register(void)
+{
+    mca_atomic_shm_component.priority = 90;
+    mca_base_component_var_register (&mca_atomic_shm_component.atomic_version,
+                                     "priority", "Priority of the atomic:shm "
+                                     "component, only available if all PEs run on "
+                                     "the same node (default: 90)", MCA_BASE_VAR_TYPE_INT,
+                                     NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                     OPAL_INFO_LVL_3,
+                                     MCA_BASE_VAR_SCOPE_ALL_EQ,
+                                     &mca_atomic_shm_component.priority);
+
+    return OSHMEM_SUCCESS;
+}
+
+static int _shm_open(void)
+{
+    return OSHMEM_SUCCESS;
+}
+
+OBJ_CLASS_INSTANCE(mca_atomic_shm_module_t,
+                   mca_atomic_base_module_t,
+                   NULL,
+                   NULL);
@@ -0,0 +1,175 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "oshmem_config.h"
+#include <stdio.h>
+
+#include "opal/sys/atomic.h"
+#include "oshmem/constants.h"
+#include "oshmem/mca/atomic/atomic.h"
+#include "oshmem/mca/atomic/base/base.h"
+#include "oshmem/proc/proc.h"
+#include "atomic_shm.h"
+
+/*
+ * Atomic operations on the symmetric heap of PEs running on this node.
+ * The heap of every PE is mapped into the address space of the others
+ * (sshmem mmap or sysv), hence the operations are plain CPU atomic
+ * instructions on the mapped address. Targets which are not mapped are
+ * passed on to the module with the next lower priority.
+ *
+ * CPU atomics are not atomic with respect to atomics done by a network
+ * adapter, so the component is only used if all PEs share one node.
+ */
+
+#define ATOMIC_SHM_FALLBACK(_op, ...)                                   \
+    ((NULL != mca_atomic_base_fallback.atomic_ ## _op) ?                \
+     mca_atomic_base_fallback.atomic_ ## _op(__VA_ARGS__) :            \
+     OSHMEM_ERR_NOT_SUPPORTED)
+
+/*
+ * Generate the fetching and the non fetching variant of an operation
+ */
+#define ATOMIC_SHM_OP(_name, _opal_op)                                  \
+static int mca_atomic_shm_f ## _name(shmem_ctx_t ctx, void *target,     \
+                                     void *prev, uint64_t value,        \
+                                     size_t size, int pe)               \
+{                                                                       \
+    void *ptr = atomic_shm_ptr(ctx, target, pe);                        \
+                                                                        \
+    if (OPAL_UNLIKELY(NULL == ptr)) {                                   \
+        return ATOMIC_SHM_FALLBACK(f ## _name, ctx, target, prev,       \
+                                   value, size, pe);                    \
+    }                                                                   \
+    if (sizeof(uint64_t) == size) {                                     \
+        *(int64_t *) prev = opal_atomic_fetch_ ## _opal_op ## _64(      \
+            (opal_atomic_int64_t *) ptr, (int64_t) value);              \
+    } else {                                                            \
+        *(int32_t *) prev = opal_atomic_fetch_ ## _opal_op ## _32(      \
+            (opal_atomic_int32_t *) ptr, (int32_t) value);              \
+    }                                                                   \
+    return OSHMEM_SUCCESS;                                              \
+}                                                                       \
+                                                                        \
+static int mca_atomic_shm_ ## _name(shmem_ctx_t ctx, void *target,      \
+                                    uint64_t value, size_t size,        \
+                                    int pe)                             \
+{                                                                       \
+    void *ptr = atomic_shm_ptr(ctx, target, pe);                        \
+                                                                        \
+    if (OPAL_UNLIKELY(NULL == ptr)) {                                   \
+        return ATOMIC_SHM_FALLBACK(_name, ctx, target, value, size, pe); \
+    }                                                                   \
+    if (sizeof(uint64_t) == size) {                                     \
+        (void) opal_atomic_fetch_ ## _opal_op ## _64(                   \
+            (opal_atomic_int64_t *) ptr, (int64_t) value);              \
+    } else {                                                            \
+        (void) opal_atomic_fetch_ ## _opal_op ## _32(                   \
+            (opal_atomic_int32_t *) ptr, (int32_t) value);              \
+    }                                                                   \
+    return OSHMEM_SUCCESS;                                              \
+}
+
+ATOMIC_SHM_OP(add, add)
+ATOMIC_SHM_OP(and, and)
+ATOMIC_SHM_OP(or,  or)
+ATOMIC_SHM_OP(xor, xor)
+
+static int mca_atomic_shm_swap(shmem_ctx_t ctx, void *target, void *prev,
+                               uint64_t value, size_t size, int pe)
+{
+    void *ptr = atomic_shm_ptr(ctx, target, pe);
+
+    if (OPAL_UNLIKELY(NULL == ptr)) {
+        return ATOMIC_SHM_FALLBACK(swap, ctx, target, prev, value, size, pe);
+    }
+    if (sizeof(uint64_t) == size) {
+        *(int64_t *) prev = opal_atomic_swap_64((opal_atomic_int64_t *) ptr,
+                                                (int64_t) value);
+    } else {
+        *(int32_t *) prev = opal_atomic_swap_32((opal_atomic_int32_t *) ptr,
+                                                (int32_t) value);
+    }
+    return OSHMEM_SUCCESS;
+}
+
+static int mca_atomic_shm_cswap(shmem_ctx_t ctx, void *target, uint64_t *prev,
+                                uint64_t cond, uint64_t value, size_t size,
+                                int pe)
+{
+    void *ptr = atomic_shm_ptr(ctx, target, pe);
+    int64_t old64;
+    int32_t old32;
+
+    if (OPAL_UNLIKELY(NULL == ptr)) {
+        return ATOMIC_SHM_FALLBACK(cswap, ctx, target, prev, cond, value, size, pe);
+    }
+
+    /* the previous value is returned in either case */
+    if (sizeof(uint64_t) == size) {
+        old64 = (int64_t) cond;
+        (void) opal_atomic_compare_exchange_strong_64((opal_atomic_int64_t *) ptr,
+                                                      &old64, (int64_t) value);
+        *(int64_t *) prev = old64;
+    } else {
+        old32 = (int32_t) cond;
+        (void) opal_atomic_compare_exchange_strong_32((opal_atomic_int32_t *) ptr,
+                                                      &old32, (int32_t) value);
+        *(int32_t *) prev = old32;
+    }
+    return OSHMEM_SUCCESS;
+}
+
+int mca_atomic_shm_startup(bool enable_progress_threads, bool enable_threads)
+{
+    return OSHMEM_SUCCESS;
+}
+
+int mca_atomic_shm_finalize(void)
+{
+    return OSHMEM_SUCCESS;
+}
+
+mca_atomic_base_module_t *
+mca_atomic_shm_query(int *priority)
+{
+    mca_atomic_shm_module_t *module;
+    ompi_proc_t *proc;
+    int i;
+
+    *priority = mca_atomic_shm_component.priority;
+
+    for (i = 0; i < oshmem_num_procs(); i++) {
+        if (i == oshmem_my_proc_id()) {
+            continue;
+        }
+        proc = oshmem_proc_group_find(oshmem_group_all, i);
+        if (!OPAL_PROC_ON_LOCAL_NODE(proc->super.proc_flags)) {
+            ATOMIC_VERBOSE(10, "PE %d runs on another node, atomic:shm not used", i);
+            return NULL;
+        }
+    }
+
+    module = OBJ_NEW(mca_atomic_shm_module_t);
+    if (module) {
+        module->super.atomic_add   = mca_atomic_shm_add;
+        module->super.atomic_and   = mca_atomic_shm_and;
+        module->super.atomic_or    = mca_atomic_shm_or;
+        module->super.atomic_xor   = mca_atomic_shm_xor;
+        module->super.atomic_fadd  = mca_atomic_shm_fadd;
+        module->super.atomic_fand  = mca_atomic_shm_fand;
+        module->super.atomic_for   = mca_atomic_shm_for;
+        module->super.atomic_fxor  = mca_atomic_shm_fxor;
+        module->super.atomic_swap  = mca_atomic_shm_swap;
+        module->super.atomic_cswap = mca_atomic_shm_cswap;
+        return &(module->super);
+    }
+
+    return NULL ;
+}
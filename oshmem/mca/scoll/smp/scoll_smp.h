@@ -0,0 +1,120 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef MCA_SCOLL_SMP_H
+#define MCA_SCOLL_SMP_H
+
+#include "oshmem_config.h"
+
+#include "shmem.h"
+#include "oshmem/mca/mca.h"
+#include "oshmem/mca/scoll/scoll.h"
+#include "oshmem/proc/proc.h"
+#include "ompi/communicator/communicator.h"
+
+BEGIN_C_DECLS
+
+/*
+ * Layout of the staging area. It lives in the private part of the
+ * symmetric heap, so it has the same address on every PE. Every PE of
+ * the node owns a slot, and has a flag of each kind in the staging area
+ * of the others:
+ *
+ *   SCOLL_SMP_READY(s) - the source buffer of slot s may be read
+ *   SCOLL_SMP_DONE(s)  - slot s is done reading from this PE
+ *   SCOLL_SMP_FLAG(s)  - the buffer of slot s may be read by this PE
+ */
+#define SCOLL_SMP_READY(s)  (s)
+#define SCOLL_SMP_DONE(s)   (mca_scoll_smp_component.nslots + (s))
+#define SCOLL_SMP_FLAG(s)   (2 * mca_scoll_smp_component.nslots + (s))
+
+/**
+ * Globally exported structure
+ */
+struct mca_scoll_smp_component_t {
+    /** Base scoll component */
+    mca_scoll_base_component_1_0_0_t super;
+
+    /** MCA parameter: Priority of this component */
+    int smp_priority;
+
+    /** MCA parameter: Enable the component */
+    int smp_enable;
+
+    /** Staging area in the symmetric heap, see SCOLL_SMP_FLAG */
+    long *staging;
+
+    /** Node id of every PE */
+    uint32_t *node_ids;
+
+    /** Slot of every PE of this node in the staging area, -1 for remote PEs */
+    int *slots;
+
+    /** Number of PEs on the largest node, the same on every PE */
+    int nslots;
+};
+typedef struct mca_scoll_smp_component_t mca_scoll_smp_component_t;
+
+OSHMEM_MODULE_DECLSPEC extern mca_scoll_smp_component_t mca_scoll_smp_component;
+
+/**
+ * Group split into nodes. The first member of the group on a node
+ * is the leader of that node.
+ */
+struct mca_scoll_smp_module_t {
+    mca_scoll_base_module_t super;
+
+    /* Members of the group on this node, in group order */
+    int nlocal;
+    int my_local;
+    int *local_pes;
+
+    /* Communicator of the node leaders; NULL on other PEs and when
+       the group spans a single node */
+    ompi_communicator_t *leader_comm;
+
+    /* Rank in leader_comm of the leader of each group member */
+    int *leader_rank;
+
+    /* Saved handlers - for fallback */
+    mca_scoll_base_module_broadcast_fn_t previous_broadcast;
+    mca_scoll_base_module_t *previous_broadcast_module;
+    mca_scoll_base_module_reduce_fn_t previous_reduce;
+    mca_scoll_base_module_t *previous_reduce_module;
+};
+typedef struct mca_scoll_smp_module_t mca_scoll_smp_module_t;
+
+OBJ_CLASS_DECLARATION(mca_scoll_smp_module_t);
+
+/* API functions */
+int mca_scoll_smp_init_query(bool enable_progress_threads, bool enable_mpi_threads);
+
+mca_scoll_base_module_t *mca_scoll_smp_query(oshmem_group_t *group, int *priority);
+
+int mca_scoll_smp_broadcast(struct oshmem_group_t *group,
+                            int PE_root,
+                            void *target,
+                            const void *source,
+                            size_t nlong,
+                            long *pSync,
+                            bool nlong_type,
+                            int alg);
+
+int mca_scoll_smp_reduce(struct oshmem_group_t *group,
+                         struct oshmem_op_t *op,
+                         void *target,
+                         const void *source,
+                         size_t nlong,
+                         long *pSync,
+                         void *pWrk,
+                         int alg);
+
+END_C_DECLS
+
+#endif /* MCA_SCOLL_SMP_H */
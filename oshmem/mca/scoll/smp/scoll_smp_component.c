@@ -0,0 +1,115 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "oshmem_config.h"
+
+#include "oshmem/constants.h"
+#include "oshmem/mca/memheap/memheap.h"
+#include "oshmem/mca/scoll/scoll.h"
+#include "oshmem/mca/scoll/base/base.h"
+#include "scoll_smp.h"
+
+/*
+ * Public string showing the scoll smp component version number
+ */
+const char *mca_scoll_smp_component_version_string =
+"Open SHMEM smp collective MCA component version " OSHMEM_VERSION;
+
+/*
+ * Local function
+ */
+static int smp_register(void);
+static int smp_open(void);
+static int smp_close(void);
+
+/*
+ * Instantiate the public struct with all of our public information
+ * and pointers to our public functions in it
+ */
+
+mca_scoll_smp_component_t mca_scoll_smp_component = {
+
+    /* First, the mca_component_t struct containing meta information
+       about the component itself */
+    {
+        .scoll_version = {
+            MCA_SCOLL_BASE_VERSION_2_0_0,
+
+            /* Component name and version */
+            .mca_component_name = "smp",
+            MCA_BASE_MAKE_VERSION(component, OSHMEM_MAJOR_VERSION, OSHMEM_MINOR_VERSION,
+                                  OSHMEM_RELEASE_VERSION),
+
+            /* Component open and close functions */
+            .mca_open_component = smp_open,
+            .mca_close_component = smp_close,
+            .mca_register_component_params = smp_register,
+        },
+        .scoll_data = {
+            /* The component is not checkpoint ready */
+            MCA_BASE_METADATA_PARAM_NONE
+        },
+
+        /* Initialization / querying functions */
+
+        .scoll_init = mca_scoll_smp_init_query,
+        .scoll_query = mca_scoll_smp_query,
+    },
+    85, /* priority */
+    1,  /* smp_enable */
+    NULL,
+    NULL,
+    NULL,
+    0
+};
+
+static int smp_register(void)
+{
+    mca_base_component_t *comp = &mca_scoll_smp_component.super.scoll_version;
+
+    (void) mca_base_component_var_register(comp,
+                                           "priority",
+                                           "Priority of the scoll:smp component",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_scoll_smp_component.smp_priority);
+
+    (void) mca_base_component_var_register(comp,
+                                           "enable",
+                                           "[1|0] Enable/Disable the node aware broadcast and reduction",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_scoll_smp_component.smp_enable);
+
+    return OSHMEM_SUCCESS;
+}
+
+static int smp_open(void)
+{
+    return OSHMEM_SUCCESS;
+}
+
+static int smp_close(void)
+{
+    mca_scoll_smp_component_t *cm = &mca_scoll_smp_component;
+
+    /* scoll is closed before memheap, so the staging area is still valid */
+    if (cm->staging) {
+        MCA_MEMHEAP_CALL(private_free(cm->staging));
+        cm->staging = NULL;
+    }
+    free(cm->node_ids);
+    cm->node_ids = NULL;
+    free(cm->slots);
+    cm->slots = NULL;
+
+    return OSHMEM_SUCCESS;
+}
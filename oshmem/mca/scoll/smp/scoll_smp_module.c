@@ -0,0 +1,293 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "oshmem_config.h"
+
+#include <string.h>
+
+#include "opal/class/opal_hash_table.h"
+#include "opal/mca/pmix/pmix-internal.h"
+#include "ompi/group/group.h"
+#include "oshmem/constants.h"
+#include "oshmem/mca/memheap/memheap.h"
+#include "oshmem/mca/scoll/scoll.h"
+#include "oshmem/mca/scoll/base/base.h"
+#include "oshmem/proc/proc.h"
+#include "oshmem/runtime/runtime.h"
+#include "scoll_smp.h"
+
+int mca_scoll_smp_init_query(bool enable_progress_threads, bool enable_mpi_threads)
+{
+    return OSHMEM_SUCCESS;
+}
+
+static void mca_scoll_smp_module_construct(mca_scoll_smp_module_t *smp_module)
+{
+    smp_module->nlocal = 0;
+    smp_module->my_local = -1;
+    smp_module->local_pes = NULL;
+    smp_module->leader_comm = NULL;
+    smp_module->leader_rank = NULL;
+    smp_module->previous_broadcast = NULL;
+    smp_module->previous_broadcast_module = NULL;
+    smp_module->previous_reduce = NULL;
+    smp_module->previous_reduce_module = NULL;
+}
+
+static void mca_scoll_smp_module_destruct(mca_scoll_smp_module_t *smp_module)
+{
+    if (smp_module->previous_broadcast_module) {
+        OBJ_RELEASE(smp_module->previous_broadcast_module);
+    }
+    if (smp_module->previous_reduce_module) {
+        OBJ_RELEASE(smp_module->previous_reduce_module);
+    }
+    if (NULL != smp_module->leader_comm) {
+        ompi_comm_free(&smp_module->leader_comm);
+    }
+    free(smp_module->local_pes);
+    free(smp_module->leader_rank);
+}
+
+#define SMP_SAVE_PREV_SCOLL_API(__api) do {\
+    smp_module->previous_ ## __api            = group->g_scoll.scoll_ ## __api;\
+    smp_module->previous_ ## __api ## _module = group->g_scoll.scoll_ ## __api ## _module;\
+    if (!group->g_scoll.scoll_ ## __api || !group->g_scoll.scoll_ ## __api ## _module) {\
+        SCOLL_VERBOSE(1, "no underlying " # __api"; disqualifying myself");\
+        return OSHMEM_ERROR;\
+    }\
+    OBJ_RETAIN(smp_module->previous_ ## __api ## _module);\
+} while(0)
+
+/*
+ * The intra-node phase needs a fallback for requests it cannot handle,
+ * so the module sits on top of whatever was selected before it.
+ */
+static int mca_scoll_smp_module_enable(mca_scoll_base_module_t *module,
+                                       oshmem_group_t *group)
+{
+    mca_scoll_smp_module_t *smp_module = (mca_scoll_smp_module_t *) module;
+
+    SMP_SAVE_PREV_SCOLL_API(broadcast);
+    SMP_SAVE_PREV_SCOLL_API(reduce);
+    return OSHMEM_SUCCESS;
+}
+
+/*
+ * Find out the node of every PE and allocate the staging area. It is
+ * done once, for the group of all PEs, which every PE creates in the
+ * same order. Later private heap allocations must stay symmetric, so
+ * every PE allocates the same size, room for the largest node, and the
+ * PEs agree on whether the component is used at all.
+ */
+static int mca_scoll_smp_setup(void)
+{
+    mca_scoll_smp_component_t *cm = &mca_scoll_smp_component;
+    int nprocs = oshmem_num_procs();
+    int my_pe = oshmem_my_proc_id();
+    ompi_proc_t *proc;
+    uint32_t val, *pval, mine[2], *all = NULL;
+    int *counts = NULL;
+    void *ptr = NULL;
+    int i, nslots, max_slots, rc;
+
+    cm->node_ids = (uint32_t *) malloc(nprocs * sizeof(*cm->node_ids));
+    cm->slots = (int *) malloc(nprocs * sizeof(*cm->slots));
+    all = (uint32_t *) malloc(2 * nprocs * sizeof(*all));
+    counts = (int *) calloc(nprocs, sizeof(*counts));
+    if (NULL == cm->node_ids || NULL == cm->slots || NULL == all || NULL == counts) {
+        /* the other PEs are in the exchanges below */
+        SCOLL_ERROR("out of memory");
+        oshmem_shmem_abort(-1);
+    }
+
+    /* node of this PE, marked unknown if the lookup fails */
+    proc = oshmem_proc_group_find(oshmem_group_all, my_pe);
+    pval = &val;
+    OPAL_MODEX_RECV_VALUE(rc, PMIX_NODEID, &(proc->super.proc_name), &pval, PMIX_UINT32);
+    mine[0] = (PMIX_SUCCESS == rc) ? 1 : 0;
+    mine[1] = mine[0] ? val : 0;
+    rc = oshmem_shmem_allgather(mine, all, sizeof(mine));
+    if (OSHMEM_SUCCESS != rc) {
+        goto err;
+    }
+    for (i = 0; i < nprocs; i++) {
+        if (!all[2 * i]) {
+            SCOLL_VERBOSE(10, "node of PE %d is not known, scoll:smp not used", i);
+            goto err;
+        }
+        cm->node_ids[i] = all[2 * i + 1];
+    }
+
+    /* the same node ids everywhere, so the same largest node */
+    for (i = 0, nslots = 0; i < nprocs; i++) {
+        cm->slots[i] = (cm->node_ids[i] == cm->node_ids[my_pe]) ? nslots++ : -1;
+    }
+    for (i = 0, max_slots = 0; i < nprocs; i++) {
+        int j;
+
+        for (j = 0; j < i && cm->node_ids[j] != cm->node_ids[i]; j++);
+        if (++counts[j] > max_slots) {
+            max_slots = counts[j];
+        }
+    }
+
+    rc = MCA_MEMHEAP_CALL(private_alloc(3 * max_slots * sizeof(long), &ptr));
+    mine[0] = (OSHMEM_SUCCESS == rc && NULL != ptr) ? 1 : 0;
+    rc = oshmem_shmem_allgather(mine, all, sizeof(mine));
+    for (i = 0; OSHMEM_SUCCESS == rc && i < nprocs && all[2 * i]; i++);
+    if (OSHMEM_SUCCESS != rc || i < nprocs) {
+        SCOLL_VERBOSE(10, "no room for staging flags of %d PEs on PE %d, scoll:smp not used",
+                      max_slots, i);
+        /* give the space back so that every PE is where it started */
+        if (mine[0]) {
+            MCA_MEMHEAP_CALL(private_free(ptr));
+        }
+        goto err;
+    }
+    memset(ptr, 0, 3 * max_slots * sizeof(long));
+    cm->staging = (long *) ptr;
+    cm->nslots = max_slots;
+
+    free(all);
+    free(counts);
+    return OSHMEM_SUCCESS;
+
+err:
+    free(all);
+    free(counts);
+    free(cm->node_ids);
+    cm->node_ids = NULL;
+    free(cm->slots);
+    cm->slots = NULL;
+    return OSHMEM_ERROR;
+}
+
+/*
+ * Create the communicator of the node leaders of the group. Only the
+ * leaders call it.
+ */
+static int mca_scoll_smp_leader_comm(int *leader_pes, int nleaders,
+                                     ompi_communicator_t **comm)
+{
+    ompi_group_t *world_group, *new_group;
+    int err;
+
+    err = ompi_comm_group(&(ompi_mpi_comm_world.comm), &world_group);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != err)) {
+        return err;
+    }
+
+    err = ompi_group_incl(world_group, nleaders, leader_pes, &new_group);
+    ompi_group_free(&world_group);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != err)) {
+        return err;
+    }
+
+    err = ompi_comm_create_group(&(ompi_mpi_comm_world.comm), new_group, 2, comm);
+    ompi_group_free(&new_group);
+    return err;
+}
+
+/*
+ * Invoked when there's a new group that has been created.
+ * The module is used when at least two members of the group
+ * share a node.
+ */
+mca_scoll_base_module_t *
+mca_scoll_smp_query(oshmem_group_t *group, int *priority)
+{
+    mca_scoll_smp_component_t *cm = &mca_scoll_smp_component;
+    mca_scoll_smp_module_t *smp_module;
+    opal_hash_table_t leaders;
+    int *leader_pes = NULL;
+    int nleaders = 0;
+    uint32_t my_node;
+    void *value;
+    int i, pe;
+
+    *priority = 0;
+    if (!cm->smp_enable || group->proc_count < 2) {
+        return NULL;
+    }
+
+    if (NULL == cm->staging) {
+        if (group != oshmem_group_all || OSHMEM_SUCCESS != mca_scoll_smp_setup()) {
+            return NULL;
+        }
+    }
+
+    smp_module = OBJ_NEW(mca_scoll_smp_module_t);
+    if (NULL == smp_module) {
+        return NULL;
+    }
+    smp_module->local_pes = (int *) malloc(group->proc_count * sizeof(int));
+    smp_module->leader_rank = (int *) malloc(group->proc_count * sizeof(int));
+    leader_pes = (int *) malloc(group->proc_count * sizeof(int));
+    if (NULL == smp_module->local_pes || NULL == smp_module->leader_rank ||
+        NULL == leader_pes) {
+        goto err;
+    }
+
+    /* the first member of the group on a node leads that node */
+    OBJ_CONSTRUCT(&leaders, opal_hash_table_t);
+    opal_hash_table_init(&leaders, group->proc_count);
+    my_node = cm->node_ids[group->my_pe];
+    for (i = 0; i < group->proc_count; i++) {
+        pe = oshmem_proc_pe(group->proc_array[i]);
+        if (OPAL_SUCCESS != opal_hash_table_get_value_uint32(&leaders,
+                                                             cm->node_ids[pe],
+                                                             &value)) {
+            value = (void *) (intptr_t) nleaders;
+            opal_hash_table_set_value_uint32(&leaders, cm->node_ids[pe], value);
+            leader_pes[nleaders++] = pe;
+        }
+        smp_module->leader_rank[i] = (int) (intptr_t) value;
+
+        if (cm->node_ids[pe] == my_node) {
+            if (pe == group->my_pe) {
+                smp_module->my_local = smp_module->nlocal;
+            }
+            smp_module->local_pes[smp_module->nlocal++] = pe;
+        }
+    }
+    OBJ_DESTRUCT(&leaders);
+
+    if (nleaders == group->proc_count) {
+        SCOLL_VERBOSE(10, "no two PEs of the group share a node, scoll:smp not used");
+        goto err;
+    }
+
+    if (nleaders > 1 && group->my_pe == smp_module->local_pes[0]) {
+        if (OMPI_SUCCESS != mca_scoll_smp_leader_comm(leader_pes, nleaders,
+                                                      &smp_module->leader_comm)) {
+            SCOLL_ERROR("failed to create the communicator of %d node leaders",
+                        nleaders);
+            goto err;
+        }
+    }
+    free(leader_pes);
+
+    smp_module->super.scoll_module_enable = mca_scoll_smp_module_enable;
+    smp_module->super.scoll_broadcast = mca_scoll_smp_broadcast;
+    smp_module->super.scoll_reduce = mca_scoll_smp_reduce;
+
+    *priority = cm->smp_priority;
+    return &smp_module->super;
+
+err:
+    free(leader_pes);
+    OBJ_RELEASE(smp_module);
+    return NULL;
+}
+
+OBJ_CLASS_INSTANCE(mca_scoll_smp_module_t,
+                   mca_scoll_base_module_t,
+                   mca_scoll_smp_module_construct,
+                   mca_scoll_smp_module_destruct);
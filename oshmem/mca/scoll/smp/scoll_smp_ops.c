@@ -0,0 +1,359 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "oshmem_config.h"
+
+#include <string.h>
+
+#include "opal/sys/atomic.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/op/op.h"
+#include "oshmem/constants.h"
+#include "oshmem/op/op.h"
+#include "oshmem/mca/memheap/memheap.h"
+#include "oshmem/mca/memheap/base/base.h"
+#include "oshmem/mca/spml/spml.h"
+#include "oshmem/mca/scoll/scoll.h"
+#include "oshmem/mca/scoll/base/base.h"
+#include "oshmem/runtime/runtime.h"
+#include "scoll_smp.h"
+
+/*
+ * Broadcast and reduction in two levels. Within a node the PEs read
+ * each other's buffers directly through the mapped symmetric heap and
+ * synchronize through flags in the staging area; only the node leaders
+ * take part in the MPI collective across nodes.
+ *
+ * Every signal has its own flag per sender, so a PE never consumes a
+ * signal meant for a collective of another active set.
+ */
+
+#define SMP_STAGING(_idx)   (&mca_scoll_smp_component.staging[(_idx)])
+#define SMP_SLOT(_pe)       (mca_scoll_smp_component.slots[(_pe)])
+
+/* Set our flag of the given kind on a node peer */
+static void smp_signal(int kind, int pe)
+{
+    long one = 1;
+
+    MCA_SPML_CALL(put(oshmem_ctx_default,
+                      SMP_STAGING(kind + SMP_SLOT(oshmem_my_proc_id())),
+                      sizeof(one), &one, pe));
+}
+
+/* Wait for the flag of a node peer and consume it */
+static void smp_wait(int kind, int pe)
+{
+    long *flag = SMP_STAGING(kind + SMP_SLOT(pe));
+    long zero = 0;
+
+    MCA_SPML_CALL(wait((void *) flag, SHMEM_CMP_NE, (void *) &zero, SHMEM_LONG));
+    *flag = 0;
+}
+
+/* Let the node peers read our buffer */
+static void smp_release(mca_scoll_smp_module_t *smp_module)
+{
+    int i;
+
+    opal_atomic_wmb();
+    for (i = 0; i < smp_module->nlocal; i++) {
+        if (i != smp_module->my_local) {
+            smp_signal(SCOLL_SMP_FLAG(0), smp_module->local_pes[i]);
+        }
+    }
+    MCA_SPML_CALL(quiet(oshmem_ctx_default));
+}
+
+static void smp_wait_release(int pe)
+{
+    smp_wait(SCOLL_SMP_FLAG(0), pe);
+    opal_atomic_rmb();
+}
+
+/* Tell a node peer that we are ready (or done) with its buffer */
+static void smp_arrive(int kind, int pe)
+{
+    opal_atomic_mb();
+    smp_signal(kind, pe);
+    MCA_SPML_CALL(quiet(oshmem_ctx_default));
+}
+
+static void smp_wait_arrivals(mca_scoll_smp_module_t *smp_module, int kind)
+{
+    int i;
+
+    for (i = 0; i < smp_module->nlocal; i++) {
+        if (i != smp_module->my_local) {
+            smp_wait(kind, smp_module->local_pes[i]);
+        }
+    }
+    opal_atomic_rmb();
+}
+
+/*
+ * Address of a symmetric buffer of a node peer in our address space,
+ * NULL if its heap is not mapped here
+ */
+static void *smp_peer_ptr(const void *addr, int pe)
+{
+    sshmem_mkey_t *mkey;
+    void *rva;
+    int i;
+
+    for (i = 0; i < mca_memheap_base_num_transports(); i++) {
+        mkey = mca_memheap_base_get_cached_mkey(oshmem_ctx_default, pe,
+                                                (void *) addr, i, &rva);
+        if (OPAL_UNLIKELY(NULL == mkey)) {
+            return NULL;
+        }
+        if (mca_memheap_base_mkey_is_shm(mkey)) {
+            return rva;
+        }
+    }
+
+    return NULL;
+}
+
+static int smp_peer_read(void *dst, const void *src, size_t len, int pe)
+{
+    void *ptr = smp_peer_ptr(src, pe);
+
+    if (OPAL_LIKELY(NULL != ptr)) {
+        memcpy(dst, ptr, len);
+        return OSHMEM_SUCCESS;
+    }
+    return MCA_SPML_CALL(get(oshmem_ctx_default, (void *) src, len, dst, pe));
+}
+
+static struct ompi_datatype_t *smp_dtype(oshmem_op_t *op)
+{
+    switch (op->dt) {
+    case OSHMEM_OP_TYPE_FLOAT:
+        return &ompi_mpi_float.dt;
+    case OSHMEM_OP_TYPE_DOUBLE:
+        return &ompi_mpi_double.dt;
+    case OSHMEM_OP_TYPE_LDOUBLE:
+        return &ompi_mpi_long_double.dt;
+    case OSHMEM_OP_TYPE_FCOMPLEX:
+        return &ompi_mpi_c_float_complex.dt;
+    case OSHMEM_OP_TYPE_DCOMPLEX:
+        return &ompi_mpi_c_double_complex.dt;
+    case OSHMEM_OP_TYPE_FINT4:
+        return &ompi_mpi_integer4.dt;
+    case OSHMEM_OP_TYPE_FINT8:
+        return &ompi_mpi_integer8.dt;
+    case OSHMEM_OP_TYPE_FREAL4:
+        return &ompi_mpi_real4.dt;
+    case OSHMEM_OP_TYPE_FREAL8:
+        return &ompi_mpi_real8.dt;
+    case OSHMEM_OP_TYPE_FREAL16:
+        return &ompi_mpi_real16.dt;
+    default:
+        switch (op->dt_size) {
+        case 8:
+            return &ompi_mpi_int64_t.dt;
+        case 4:
+            return &ompi_mpi_int32_t.dt;
+        case 2:
+            return &ompi_mpi_int16_t.dt;
+        case 1:
+            return &ompi_mpi_int8_t.dt;
+        default:
+            return NULL;
+        }
+    }
+}
+
+static struct ompi_op_t *smp_op(oshmem_op_t *op)
+{
+    switch (op->op) {
+    case OSHMEM_OP_AND:
+        return &(ompi_mpi_op_band.op);
+    case OSHMEM_OP_OR:
+        return &(ompi_mpi_op_bor.op);
+    case OSHMEM_OP_XOR:
+        return &(ompi_mpi_op_bxor.op);
+    case OSHMEM_OP_MAX:
+        return &(ompi_mpi_op_max.op);
+    case OSHMEM_OP_MIN:
+        return &(ompi_mpi_op_min.op);
+    case OSHMEM_OP_SUM:
+        return &(ompi_mpi_op_sum.op);
+    case OSHMEM_OP_PROD:
+        return &(ompi_mpi_op_prod.op);
+    default:
+        return NULL;
+    }
+}
+
+int mca_scoll_smp_broadcast(struct oshmem_group_t *group,
+                            int PE_root,
+                            void *target,
+                            const void *source,
+                            size_t nlong,
+                            long *pSync,
+                            bool nlong_type,
+                            int alg)
+{
+    mca_scoll_smp_module_t *smp_module;
+    ompi_communicator_t *comm;
+    int leader, rc;
+    bool root_local;
+    void *buf;
+
+    smp_module = (mca_scoll_smp_module_t *) group->g_scoll.scoll_broadcast_module;
+
+    /* only the root might know the size, and MPI takes an int count */
+    if (OPAL_UNLIKELY(!nlong_type || (INT_MAX < nlong))) {
+        SCOLL_VERBOSE(20, "RUNNING FALLBACK BCAST");
+        PREVIOUS_SCOLL_FN(smp_module, broadcast, group,
+                PE_root,
+                target,
+                source,
+                nlong,
+                pSync,
+                nlong_type,
+                SCOLL_DEFAULT_ALG);
+        return rc;
+    }
+
+    if (OPAL_UNLIKELY(!nlong)) {
+        return OSHMEM_SUCCESS;
+    }
+
+    root_local = (SMP_SLOT(PE_root) >= 0);
+    leader = smp_module->local_pes[0];
+    comm = smp_module->leader_comm;
+    rc = OSHMEM_SUCCESS;
+
+    /* the node of the root: read from the root directly */
+    if (root_local) {
+        if (group->my_pe == PE_root) {
+            smp_release(smp_module);
+            smp_wait_arrivals(smp_module, SCOLL_SMP_DONE(0));
+        } else {
+            smp_wait_release(PE_root);
+            rc = smp_peer_read(target, source, nlong, PE_root);
+            smp_arrive(SCOLL_SMP_DONE(0), PE_root);
+        }
+    }
+
+    /* across the nodes: the leaders */
+    if (NULL != comm) {
+        buf = (group->my_pe == PE_root) ? (void *) source : target;
+        rc = comm->c_coll->coll_bcast(buf, (int) nlong, &ompi_mpi_char.dt,
+                smp_module->leader_rank[oshmem_proc_group_find_id(group, PE_root)],
+                comm, comm->c_coll->coll_bcast_module);
+    }
+
+    /* other nodes: read from the leader */
+    if (!root_local) {
+        if (group->my_pe == leader) {
+            smp_release(smp_module);
+            smp_wait_arrivals(smp_module, SCOLL_SMP_DONE(0));
+        } else {
+            smp_wait_release(leader);
+            rc = smp_peer_read(target, target, nlong, leader);
+            smp_arrive(SCOLL_SMP_DONE(0), leader);
+        }
+    }
+
+    return rc;
+}
+
+int mca_scoll_smp_reduce(struct oshmem_group_t *group,
+                         struct oshmem_op_t *op,
+                         void *target,
+                         const void *source,
+                         size_t nlong,
+                         long *pSync,
+                         void *pWrk,
+                         int alg)
+{
+    mca_scoll_smp_module_t *smp_module;
+    ompi_communicator_t *comm;
+    struct ompi_datatype_t *dtype;
+    struct ompi_op_t *h_op;
+    size_t count;
+    void *tmp = NULL;
+    void *ptr;
+    int leader, i, rc;
+
+    smp_module = (mca_scoll_smp_module_t *) group->g_scoll.scoll_reduce_module;
+    dtype = smp_dtype(op);
+    h_op = smp_op(op);
+    count = nlong / op->dt_size;
+
+    if (OPAL_UNLIKELY(NULL == dtype || NULL == h_op || INT_MAX < count)) {
+        SCOLL_VERBOSE(20, "RUNNING FALLBACK REDUCE");
+        PREVIOUS_SCOLL_FN(smp_module, reduce, group,
+                op,
+                target,
+                source,
+                nlong,
+                pSync,
+                pWrk,
+                SCOLL_DEFAULT_ALG);
+        return rc;
+    }
+
+    if (OPAL_UNLIKELY(!nlong)) {
+        return OSHMEM_SUCCESS;
+    }
+
+    leader = smp_module->local_pes[0];
+    comm = smp_module->leader_comm;
+    rc = OSHMEM_SUCCESS;
+
+    if (group->my_pe != leader) {
+        /* hand the source to the leader and pick up the result */
+        smp_arrive(SCOLL_SMP_READY(0), leader);
+        smp_wait_release(leader);
+        rc = smp_peer_read(target, target, nlong, leader);
+        smp_arrive(SCOLL_SMP_DONE(0), leader);
+        return rc;
+    }
+
+    /* the leader combines the sources of its node in target */
+    if (target != source) {
+        memmove(target, source, nlong);
+    }
+    smp_wait_arrivals(smp_module, SCOLL_SMP_READY(0));
+    for (i = 1; i < smp_module->nlocal && OSHMEM_SUCCESS == rc; i++) {
+        ptr = smp_peer_ptr(source, smp_module->local_pes[i]);
+        if (NULL == ptr) {
+            if (NULL == tmp && NULL == (tmp = malloc(nlong))) {
+                rc = OSHMEM_ERR_OUT_OF_RESOURCE;
+                break;
+            }
+            rc = MCA_SPML_CALL(get(oshmem_ctx_default, (void *) source, nlong,
+                                   tmp, smp_module->local_pes[i]));
+            if (OSHMEM_SUCCESS != rc) {
+                break;
+            }
+            ptr = tmp;
+        }
+        op->o_func.c_fn(ptr, target, (int) count);
+    }
+    free(tmp);
+
+    if (NULL != comm && OSHMEM_SUCCESS == rc) {
+        rc = comm->c_coll->coll_allreduce(MPI_IN_PLACE, target, (int) count,
+                                          dtype, h_op, comm,
+                                          comm->c_coll->coll_allreduce_module);
+    }
+
+    /* peers wait for the release whatever happened */
+    smp_release(smp_module);
+    smp_wait_arrivals(smp_module, SCOLL_SMP_DONE(0));
+
+    return rc;
+}
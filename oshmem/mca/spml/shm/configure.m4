@@ -0,0 +1,26 @@
+# -*- shell-script -*-
+#
+# $COPYRIGHT$
+#
+# Additional copyrights may follow
+#
+# $HEADER$
+#
+
+# MCA_oshmem_spml_shm_CONFIG([action-if-can-compile],
+#                    [action-if-cant-compile])
+# ------------------------------------------------
+AC_DEFUN([MCA_oshmem_spml_shm_CONFIG],[
+    AC_CONFIG_FILES([oshmem/mca/spml/shm/Makefile])
+
+    # Data outside of a shared heap segment is copied with
+    # process_vm_readv/writev
+    OPAL_CHECK_CMA([spml_shm],
+                   [AC_CHECK_HEADERS([sys/prctl.h])
+                    spml_shm_happy="yes"],
+                   [spml_shm_happy="no"])
+
+    AS_IF([test "$spml_shm_happy" = "yes"],
+          [$1],
+          [$2])
+])dnl
@@ -0,0 +1,391 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "oshmem_config.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#ifdef HAVE_SYS_PRCTL_H
+#include <sys/prctl.h>
+#endif
+
+#if OPAL_CMA_NEED_SYSCALL_DEFS
+#include "opal/sys/cma.h"
+#endif
+
+#include "opal/sys/atomic.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/pml/pml.h"
+#include "oshmem/include/shmem.h"
+#include "oshmem/mca/memheap/memheap.h"
+#include "oshmem/mca/memheap/base/base.h"
+#include "oshmem/mca/atomic/atomic.h"
+#include "oshmem/mca/spml/shm/spml_shm.h"
+#include "oshmem/proc/proc.h"
+#include "oshmem/runtime/runtime.h"
+
+/*
+ * SPML for jobs running on a single node.
+ *
+ * If the symmetric heap comes from a shared sshmem segment (sysv, or
+ * mmap with sshmem_mmap_anonymous=0), the heap of every PE is attached
+ * by the others and put/get are plain memcpy() on the mapped address.
+ * Everything else (static data, a private heap) is copied with
+ * process_vm_readv/writev, for which the mkey of such a segment carries
+ * the pid of its owner.
+ *
+ * All transfers are complete when the call returns, so non-blocking
+ * operations never hand out a handle and quiet/fence are only memory
+ * barriers.
+ */
+
+mca_spml_shm_t mca_spml_shm = {
+    .super = {
+        /* Init mca_spml_base_module_t */
+        .spml_add_procs     = mca_spml_shm_add_procs,
+        .spml_del_procs     = mca_spml_shm_del_procs,
+        .spml_enable        = mca_spml_shm_enable,
+        .spml_register      = mca_spml_shm_register,
+        .spml_deregister    = mca_spml_shm_deregister,
+        .spml_oob_get_mkeys = mca_spml_base_oob_get_mkeys,
+        .spml_ctx_create    = mca_spml_shm_ctx_create,
+        .spml_ctx_destroy   = mca_spml_shm_ctx_destroy,
+        .spml_put           = mca_spml_shm_put,
+        .spml_put_nb        = mca_spml_shm_put_nb,
+        .spml_get           = mca_spml_shm_get,
+        .spml_get_nb        = mca_spml_shm_get_nb,
+        .spml_recv          = mca_spml_shm_recv,
+        .spml_send          = mca_spml_shm_send,
+        .spml_wait          = mca_spml_base_wait,
+        .spml_wait_nb       = mca_spml_base_wait_nb,
+        .spml_test          = mca_spml_base_test,
+        .spml_fence         = mca_spml_shm_fence,
+        .spml_quiet         = mca_spml_shm_quiet,
+        .spml_rmkey_unpack  = mca_spml_shm_rmkey_unpack,
+        .spml_rmkey_free    = mca_spml_shm_rmkey_free,
+        .spml_rmkey_ptr     = mca_spml_shm_rmkey_ptr,
+        .spml_memuse_hook   = mca_spml_shm_memuse_hook,
+        .spml_put_all_nb    = mca_spml_shm_put_all_nb,
+        .self               = (void*)&mca_spml_shm
+    },
+
+    .priority               = 0
+};
+
+mca_spml_shm_ctx_t mca_spml_shm_ctx_default = {
+    .options = 0
+};
+
+static char spml_shm_transport_ids[1] = { 0 };
+
+int mca_spml_shm_enable(bool enable)
+{
+    SPML_VERBOSE(50, "*** shm ENABLED ****");
+    if (false == enable) {
+        return OSHMEM_SUCCESS;
+    }
+
+#if defined(PR_SET_PTRACER)
+    /* process_vm_readv/writev need the permission to ptrace the peer.
+     * With Yama ptrace scope 1 only the parent may attach, allow any
+     * process of the same user instead. Failure is not fatal, copies
+     * through shared segments keep working. */
+    (void) prctl(PR_SET_PTRACER, PR_SET_PTRACER_ANY, 0, 0, 0);
+#endif
+
+    oshmem_ctx_default = (shmem_ctx_t) &mca_spml_shm_ctx_default;
+    return OSHMEM_SUCCESS;
+}
+
+int mca_spml_shm_add_procs(ompi_proc_t** procs, size_t nprocs)
+{
+    size_t i;
+
+    for (i = 0; i < nprocs; i++) {
+        OSHMEM_PROC_DATA(procs[i])->num_transports = 1;
+        OSHMEM_PROC_DATA(procs[i])->transport_ids = spml_shm_transport_ids;
+    }
+
+    return OSHMEM_SUCCESS;
+}
+
+int mca_spml_shm_del_procs(ompi_proc_t** procs, size_t nprocs)
+{
+    /* peers may still access our memory until everybody is done */
+    oshmem_shmem_barrier();
+    return OSHMEM_SUCCESS;
+}
+
+sshmem_mkey_t *mca_spml_shm_register(void* addr,
+                                     size_t size,
+                                     uint64_t shmid,
+                                     int *count)
+{
+    sshmem_mkey_t *mkeys;
+    pid_t *pid;
+
+    *count = 0;
+    mkeys = (sshmem_mkey_t *) calloc(1, sizeof(*mkeys));
+    if (!mkeys) {
+        return NULL;
+    }
+
+    if (MAP_SEGMENT_SHM_INVALID != (int) shmid) {
+        /* peers attach the segment, see memheap_attach_segment() */
+        mkeys[0].va_base = 0;
+        mkeys[0].len     = 0;
+        mkeys[0].u.key   = shmid;
+    } else {
+        pid = (pid_t *) malloc(sizeof(*pid));
+        if (!pid) {
+            free(mkeys);
+            return NULL;
+        }
+        *pid = getpid();
+        mkeys[0].va_base = addr;
+        mkeys[0].len     = sizeof(*pid);
+        mkeys[0].u.data  = pid;
+    }
+
+    *count = 1;
+    SPML_VERBOSE(5, "registered %p size %llu: %s",
+                 addr, (unsigned long long) size,
+                 mca_spml_base_mkey2str(&mkeys[0]));
+    return mkeys;
+}
+
+int mca_spml_shm_deregister(sshmem_mkey_t *mkeys)
+{
+    if (!mkeys) {
+        return OSHMEM_ERROR;
+    }
+
+    if (0 < mkeys[0].len) {
+        free(mkeys[0].u.data);
+    }
+    free(mkeys);
+    return OSHMEM_SUCCESS;
+}
+
+void mca_spml_shm_rmkey_unpack(shmem_ctx_t ctx, sshmem_mkey_t *mkey,
+                               uint32_t segno, int pe, int tr_id)
+{
+    /* the pid of the owner stays in mkey->u.data, which memheap frees */
+}
+
+void mca_spml_shm_rmkey_free(sshmem_mkey_t *mkey)
+{
+}
+
+void *mca_spml_shm_rmkey_ptr(const void *dst_addr, sshmem_mkey_t *mkey, int pe)
+{
+    /* segments which are not attached cannot be accessed by load/store */
+    return NULL;
+}
+
+void mca_spml_shm_memuse_hook(void *addr, size_t length)
+{
+}
+
+int mca_spml_shm_ctx_create(long options, shmem_ctx_t *ctx)
+{
+    mca_spml_shm_ctx_t *shm_ctx;
+
+    shm_ctx = (mca_spml_shm_ctx_t *) malloc(sizeof(*shm_ctx));
+    if (NULL == shm_ctx) {
+        return OSHMEM_ERR_OUT_OF_RESOURCE;
+    }
+    shm_ctx->options = options;
+
+    *ctx = (shmem_ctx_t) shm_ctx;
+    return OSHMEM_SUCCESS;
+}
+
+void mca_spml_shm_ctx_destroy(shmem_ctx_t ctx)
+{
+    if ((shmem_ctx_t) &mca_spml_shm_ctx_default != ctx) {
+        free(ctx);
+    }
+}
+
+/* copy between local memory and the symmetric address of another PE */
+static inline int spml_shm_copy(shmem_ctx_t ctx, void *remote_addr,
+                                void *local_addr, size_t size, int pe,
+                                bool put)
+{
+    struct iovec local_iov, remote_iov;
+    sshmem_mkey_t *mkey;
+    void *rva;
+    ssize_t ret;
+    pid_t pid;
+
+    if (OPAL_UNLIKELY(0 == size)) {
+        return OSHMEM_SUCCESS;
+    }
+
+    mkey = mca_memheap_base_get_cached_mkey(ctx, pe, remote_addr, 0, &rva);
+    if (OPAL_UNLIKELY(!mkey)) {
+        SPML_ERROR("pe=%d: %p is not address of shared variable",
+                   pe, remote_addr);
+        oshmem_shmem_abort(-1);
+        return OSHMEM_ERROR;
+    }
+
+    if (pe == oshmem_my_proc_id() || mca_memheap_base_mkey_is_shm(mkey)) {
+        if (put) {
+            memcpy(rva, local_addr, size);
+        } else {
+            memcpy(local_addr, rva, size);
+        }
+        return OSHMEM_SUCCESS;
+    }
+
+    /* a single iovec element is never split, but large transfers
+     * may still come back short (see btl/sm) */
+    pid = *(pid_t *) mkey->u.data;
+    local_iov.iov_base  = local_addr;
+    local_iov.iov_len   = size;
+    remote_iov.iov_base = rva;
+    remote_iov.iov_len  = size;
+    do {
+        if (put) {
+            ret = process_vm_writev(pid, &local_iov, 1, &remote_iov, 1, 0);
+        } else {
+            ret = process_vm_readv(pid, &local_iov, 1, &remote_iov, 1, 0);
+        }
+        if (OPAL_UNLIKELY(0 > ret)) {
+            SPML_ERROR("pe=%d: %s of %llu bytes at %p failed: %s", pe,
+                       put ? "process_vm_writev" : "process_vm_readv",
+                       (unsigned long long) remote_iov.iov_len,
+                       remote_iov.iov_base, strerror(errno));
+            return OSHMEM_ERROR;
+        }
+        local_iov.iov_base  = (char *) local_iov.iov_base + ret;
+        local_iov.iov_len  -= ret;
+        remote_iov.iov_base = (char *) remote_iov.iov_base + ret;
+        remote_iov.iov_len -= ret;
+    } while (0 < remote_iov.iov_len);
+
+    return OSHMEM_SUCCESS;
+}
+
+int mca_spml_shm_put(shmem_ctx_t ctx,
+                     void* dst_addr,
+                     size_t size,
+                     void* src_addr,
+                     int dst)
+{
+    return spml_shm_copy(ctx, dst_addr, src_addr, size, dst, true);
+}
+
+int mca_spml_shm_put_nb(shmem_ctx_t ctx,
+                        void* dst_addr,
+                        size_t size,
+                        void* src_addr,
+                        int dst,
+                        void **handle)
+{
+    return spml_shm_copy(ctx, dst_addr, src_addr, size, dst, true);
+}
+
+int mca_spml_shm_get(shmem_ctx_t ctx,
+                     void* src_addr,
+                     size_t size,
+                     void* dst_addr,
+                     int src)
+{
+    return spml_shm_copy(ctx, src_addr, dst_addr, size, src, false);
+}
+
+int mca_spml_shm_get_nb(shmem_ctx_t ctx,
+                        void* src_addr,
+                        size_t size,
+                        void* dst_addr,
+                        int src,
+                        void **handle)
+{
+    return spml_shm_copy(ctx, src_addr, dst_addr, size, src, false);
+}
+
+int mca_spml_shm_fence(shmem_ctx_t ctx)
+{
+    /* order the stores to mapped segments */
+    opal_atomic_wmb();
+    return OSHMEM_SUCCESS;
+}
+
+int mca_spml_shm_quiet(shmem_ctx_t ctx)
+{
+    opal_atomic_mb();
+    return OSHMEM_SUCCESS;
+}
+
+int mca_spml_shm_put_all_nb(void *dest, const void *source, size_t size, long *counter)
+{
+    int my_pe = oshmem_my_proc_id();
+    long val  = 1;
+    int peer, dst_pe, rc;
+
+    for (peer = 0; peer < oshmem_num_procs(); peer++) {
+        dst_pe = (peer + my_pe) % oshmem_num_procs();
+        rc = mca_spml_shm_put(oshmem_ctx_default,
+                              (void*)((uintptr_t)dest + my_pe * size),
+                              size,
+                              (void*)((uintptr_t)source + dst_pe * size),
+                              dst_pe);
+        RUNTIME_CHECK_RC(rc);
+
+        mca_spml_shm_fence(oshmem_ctx_default);
+
+        rc = MCA_ATOMIC_CALL(add(oshmem_ctx_default, (void*)counter, val,
+                                 sizeof(val), dst_pe));
+        RUNTIME_CHECK_RC(rc);
+    }
+
+    return OSHMEM_SUCCESS;
+}
+
+/* blocking receive */
+int mca_spml_shm_recv(void* buf, size_t size, int src)
+{
+    int rc = OSHMEM_SUCCESS;
+
+    rc = MCA_PML_CALL(recv(buf,
+                size,
+                &(ompi_mpi_unsigned_char.dt),
+                src,
+                0,
+                &(ompi_mpi_comm_world.comm),
+                NULL));
+
+    return rc;
+}
+
+/* for now only do blocking copy send */
+int mca_spml_shm_send(void* buf,
+                      size_t size,
+                      int dst,
+                      mca_spml_base_put_mode_t mode)
+{
+    int rc = OSHMEM_SUCCESS;
+
+    rc = MCA_PML_CALL(send(buf,
+                size,
+                &(ompi_mpi_unsigned_char.dt),
+                dst,
+                0,
+                (mca_pml_base_send_mode_t)mode,
+                &(ompi_mpi_comm_world.comm)));
+
+    return rc;
+}
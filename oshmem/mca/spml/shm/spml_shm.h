@@ -0,0 +1,104 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/**
+ * @file
+ */
+
+#ifndef MCA_SPML_SHM_H
+#define MCA_SPML_SHM_H
+
+#include "oshmem_config.h"
+
+#include "oshmem/request/request.h"
+#include "oshmem/mca/spml/spml.h"
+#include "oshmem/mca/spml/base/base.h"
+
+BEGIN_C_DECLS
+
+/**
+ * Context of the shm SPML. Every operation is complete when it returns,
+ * so a context carries no state besides its options.
+ */
+struct mca_spml_shm_ctx {
+    long options;
+};
+typedef struct mca_spml_shm_ctx mca_spml_shm_ctx_t;
+
+extern mca_spml_shm_ctx_t mca_spml_shm_ctx_default;
+
+/**
+ * SHM SPML module
+ */
+struct mca_spml_shm {
+    mca_spml_base_module_t super;
+    int                    priority; /* component priority */
+};
+typedef struct mca_spml_shm mca_spml_shm_t;
+
+extern mca_spml_shm_t mca_spml_shm;
+
+OSHMEM_MODULE_DECLSPEC extern mca_spml_base_component_2_0_0_t mca_spml_shm_component;
+
+extern int mca_spml_shm_enable(bool enable);
+extern int mca_spml_shm_add_procs(ompi_proc_t** procs, size_t nprocs);
+extern int mca_spml_shm_del_procs(ompi_proc_t** procs, size_t nprocs);
+
+extern sshmem_mkey_t *mca_spml_shm_register(void* addr,
+                                            size_t size,
+                                            uint64_t shmid,
+                                            int *count);
+extern int mca_spml_shm_deregister(sshmem_mkey_t *mkeys);
+extern void mca_spml_shm_rmkey_unpack(shmem_ctx_t ctx, sshmem_mkey_t *mkey,
+                                      uint32_t segno, int pe, int tr_id);
+extern void mca_spml_shm_rmkey_free(sshmem_mkey_t *mkey);
+extern void *mca_spml_shm_rmkey_ptr(const void *dst_addr, sshmem_mkey_t *mkey, int pe);
+
+extern int mca_spml_shm_ctx_create(long options, shmem_ctx_t *ctx);
+extern void mca_spml_shm_ctx_destroy(shmem_ctx_t ctx);
+
+extern int mca_spml_shm_put(shmem_ctx_t ctx,
+                            void* dst_addr,
+                            size_t size,
+                            void* src_addr,
+                            int dst);
+extern int mca_spml_shm_put_nb(shmem_ctx_t ctx,
+                               void* dst_addr,
+                               size_t size,
+                               void* src_addr,
+                               int dst,
+                               void **handle);
+extern int mca_spml_shm_get(shmem_ctx_t ctx,
+                            void* src_addr,
+                            size_t size,
+                            void* dst_addr,
+                            int src);
+extern int mca_spml_shm_get_nb(shmem_ctx_t ctx,
+                               void* src_addr,
+                               size_t size,
+                               void* dst_addr,
+                               int src,
+                               void **handle);
+extern int mca_spml_shm_put_all_nb(void *target,
+                                   const void *source,
+                                   size_t size,
+                                   long *counter);
+
+extern int mca_spml_shm_recv(void* buf, size_t size, int src);
+extern int mca_spml_shm_send(void* buf,
+                             size_t size,
+                             int dst,
+                             mca_spml_base_put_mode_t mode);
+
+extern int mca_spml_shm_fence(shmem_ctx_t ctx);
+extern int mca_spml_shm_quiet(shmem_ctx_t ctx);
+extern void mca_spml_shm_memuse_hook(void *addr, size_t length);
+
+END_C_DECLS
+
+#endif
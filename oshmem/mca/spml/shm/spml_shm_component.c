@@ -0,0 +1,102 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "oshmem_config.h"
+
+#include "ompi/runtime/ompi_rte.h"
+#include "oshmem/mca/spml/spml.h"
+#include "oshmem/mca/spml/base/base.h"
+#include "oshmem/mca/spml/shm/spml_shm.h"
+
+static int mca_spml_shm_component_register(void);
+static int mca_spml_shm_component_open(void);
+static int mca_spml_shm_component_close(void);
+static mca_spml_base_module_t*
+mca_spml_shm_component_init(int* priority,
+                            bool enable_progress_threads,
+                            bool enable_mpi_threads);
+static int mca_spml_shm_component_fini(void);
+mca_spml_base_component_2_0_0_t mca_spml_shm_component = {
+
+    /* First, the mca_base_component_t struct containing meta
+       information about the component itself */
+
+    .spmlm_version = {
+        MCA_SPML_BASE_VERSION_2_0_0,
+
+        .mca_component_name            = "shm",
+        .mca_component_major_version   = OSHMEM_MAJOR_VERSION,
+        .mca_component_minor_version   = OSHMEM_MINOR_VERSION,
+        .mca_component_release_version = OSHMEM_RELEASE_VERSION,
+        .mca_open_component            = mca_spml_shm_component_open,
+        .mca_close_component           = mca_spml_shm_component_close,
+        .mca_query_component           = NULL,
+        .mca_register_component_params = mca_spml_shm_component_register
+    },
+    .spmlm_data = {
+        /* The component is checkpoint ready */
+        .param_field                   = MCA_BASE_METADATA_PARAM_CHECKPOINT
+    },
+
+    .spmlm_init                        = mca_spml_shm_component_init,
+    .spmlm_finalize                    = mca_spml_shm_component_fini
+};
+
+static int mca_spml_shm_component_register(void)
+{
+    /* below ucx, which also uses shared memory on the node if it can */
+    mca_spml_shm.priority = 10;
+    (void) mca_base_component_var_register(&mca_spml_shm_component.spmlm_version,
+                                           "priority",
+                                           "[integer] shm priority",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_spml_shm.priority);
+
+    return OSHMEM_SUCCESS;
+}
+
+static int mca_spml_shm_component_open(void)
+{
+    return OSHMEM_SUCCESS;
+}
+
+static int mca_spml_shm_component_close(void)
+{
+    return OSHMEM_SUCCESS;
+}
+
+static mca_spml_base_module_t*
+mca_spml_shm_component_init(int* priority,
+                            bool enable_progress_threads,
+                            bool enable_mpi_threads)
+{
+    SPML_VERBOSE( 10, "in shm, my priority is %d\n", mca_spml_shm.priority);
+
+    if ((*priority) > mca_spml_shm.priority) {
+        *priority = mca_spml_shm.priority;
+        return NULL ;
+    }
+    *priority = mca_spml_shm.priority;
+
+    /* every PE has to be reachable through memory */
+    if (ompi_process_info.num_local_peers + 1 < ompi_process_info.num_procs) {
+        SPML_VERBOSE(10, "PEs run on more than one node, shm not used");
+        return NULL ;
+    }
+
+    SPML_VERBOSE(50, "*** shm initialized ****");
+    return &mca_spml_shm.super;
+}
+
+static int mca_spml_shm_component_fini(void)
+{
+    return OSHMEM_SUCCESS;
+}
@@ -0,0 +1,168 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include "support.h"
+#include "opal/class/opal_free_list.h"
+#include "opal/runtime/opal.h"
+#include "opal/constants.h"
+#include "opal/mca/threads/threads.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#define OPAL_FREE_LIST_TEST_THREAD_COUNT 8
+#define ITERATIONS 100000
+/* items held at once by each thread */
+#define HELD_COUNT 4
+/* fewer items than the threads may hold together so some of them wait, but
+ * enough that one of them can always get all of its items */
+#define MAX_ITEMS (OPAL_FREE_LIST_TEST_THREAD_COUNT * (HELD_COUNT - 1) + 4)
+
+struct test_item_t {
+    opal_free_list_item_t super;
+    volatile int owner;
+};
+typedef struct test_item_t test_item_t;
+
+static void test_item_construct (test_item_t *item)
+{
+    item->owner = -1;
+}
+
+static OBJ_CLASS_INSTANCE(test_item_t, opal_free_list_item_t, test_item_construct, NULL);
+
+static opal_free_list_t flist;
+static opal_atomic_int32_t errors = 0;
+
+static void *thread_test (opal_object_t *arg) {
+    opal_thread_t *t = (opal_thread_t *) arg;
+    int id = (int) (intptr_t) t->t_arg;
+    test_item_t *items[HELD_COUNT];
+
+    for (int i = 0 ; i < ITERATIONS ; ++i) {
+        for (int j = 0 ; j < HELD_COUNT ; ++j) {
+            /* take some items without waiting, wait for the others */
+            if (j & 1) {
+                items[j] = (test_item_t *) opal_free_list_get (&flist);
+            } else {
+                items[j] = (test_item_t *) opal_free_list_wait (&flist);
+            }
+            if (NULL == items[j]) {
+                continue;
+            }
+            if (-1 != items[j]->owner) {
+                opal_atomic_add_fetch_32 (&errors, 1);
+            }
+            items[j]->owner = id;
+        }
+
+        for (int j = 0 ; j < HELD_COUNT ; ++j) {
+            if (NULL == items[j]) {
+                continue;
+            }
+            if (id != items[j]->owner) {
+                opal_atomic_add_fetch_32 (&errors, 1);
+            }
+            items[j]->owner = -1;
+            opal_free_list_return (&flist, &items[j]->super);
+        }
+    }
+
+    return NULL;
+}
+
+/* get every item of the free list without blocking */
+static int get_all (test_item_t **items)
+{
+    int count = 0;
+
+    while (count <= MAX_ITEMS && NULL != (items[count] = (test_item_t *) opal_free_list_get (&flist))) {
+        ++count;
+    }
+
+    return count;
+}
+
+int main (int argc, char *argv[]) {
+    opal_thread_t threads[OPAL_FREE_LIST_TEST_THREAD_COUNT];
+    test_item_t *items[MAX_ITEMS + 1];
+    int rc, count;
+
+    rc = opal_init_util (&argc, &argv);
+    test_verify_int(OPAL_SUCCESS, rc);
+    if (OPAL_SUCCESS != rc) {
+        test_finalize();
+        exit (1);
+    }
+
+    test_init("opal_free_list_t");
+
+    /* the per-thread magazines are only set up for threaded free lists */
+    opal_set_using_threads (true);
+
+    OBJ_CONSTRUCT(&flist, opal_free_list_t);
+    rc = opal_free_list_init (&flist, sizeof (test_item_t), 8, OBJ_CLASS(test_item_t), 0, 0,
+                              4, MAX_ITEMS, 4, NULL, 0, NULL, NULL, NULL);
+    test_verify_int(OPAL_SUCCESS, rc);
+
+    /* the free list grows up to fl_max_to_alloc */
+    count = get_all (items);
+    if (MAX_ITEMS == count) {
+        test_success ();
+    } else {
+        test_failure (" opal_free_list_get up to fl_max_to_alloc");
+    }
+
+    for (int i = 0 ; i < count ; ++i) {
+        opal_free_list_return (&flist, &items[i]->super);
+    }
+
+    for (int i = 0 ; i < OPAL_FREE_LIST_TEST_THREAD_COUNT ; ++i) {
+        OBJ_CONSTRUCT(&threads[i], opal_thread_t);
+        threads[i].t_run = thread_test;
+        threads[i].t_arg = (void *) (intptr_t) i;
+        opal_thread_start (threads + i);
+    }
+
+    for (int i = 0 ; i < OPAL_FREE_LIST_TEST_THREAD_COUNT ; ++i) {
+        void *ret;
+
+        opal_thread_join (threads + i, &ret);
+    }
+
+    if (0 == errors) {
+        test_success ();
+    } else {
+        test_failure (" item handed out twice with threads");
+    }
+
+    /* none lost in the magazines of the threads */
+    count = get_all (items);
+    if (MAX_ITEMS == count && MAX_ITEMS == (int) flist.fl_num_allocated) {
+        test_success ();
+    } else {
+        test_failure (" opal_free_list_get after get/return/wait with threads");
+    }
+
+    for (int i = 0 ; i < count ; ++i) {
+        opal_free_list_return (&flist, &items[i]->super);
+    }
+
+    for (int i = 0 ; i < OPAL_FREE_LIST_TEST_THREAD_COUNT ; ++i) {
+        OBJ_DESTRUCT(&threads[i]);
+    }
+    OBJ_DESTRUCT(&flist);
+
+    opal_set_using_threads (false);
+    opal_finalize_util ();
+
+    return test_finalize ();
+}
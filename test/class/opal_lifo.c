@@ -26,6 +26,7 @@
 #define OPAL_LIFO_TEST_THREAD_COUNT 8
 #define ITERATIONS 1000000
 #define ITEM_COUNT 100
+#define CHAIN_LENGTH 8
 
 #if !defined(timersub)
 #define timersub(a, b, r) \
@@ -65,6 +66,43 @@ static void *thread_test (opal_object_t *arg) {
     return NULL;
 }
 
+static void *thread_test_chain (opal_object_t *arg) {
+    opal_thread_t *t = (opal_thread_t *) arg;
+    opal_lifo_t *lifo = (opal_lifo_t *) t->t_arg;
+    opal_list_item_t *item, *first, *last;
+    struct timeval start, stop, total;
+    double timing;
+
+    gettimeofday (&start, NULL);
+    for (int i = 0 ; i < ITERATIONS / CHAIN_LENGTH ; ++i) {
+        first = last = NULL;
+        for (int j = 0 ; j < CHAIN_LENGTH ; ++j) {
+            item = opal_lifo_pop_atomic (lifo);
+            if (NULL == item) {
+                break;
+            }
+            item->opal_list_next = first;
+            first = item;
+            if (NULL == last) {
+                last = item;
+            }
+        }
+        if (NULL != first) {
+            (void) opal_lifo_push_chain_atomic (lifo, first, last);
+        }
+    }
+    gettimeofday (&stop, NULL);
+
+    timersub(&stop, &start, &total);
+
+    timing = ((double) total.tv_sec + (double) total.tv_usec * 1e-6) / (double) ITERATIONS;
+
+    printf ("Atomics chain thread finished. Time: %d s %d us %d nsec/poppush\n", (int) total.tv_sec,
+            (int)total.tv_usec, (int)(timing / 1e-9));
+
+    return NULL;
+}
+
 static bool check_lifo_consistency (opal_lifo_t *lifo, int expected_count)
 {
     opal_list_item_t *item;
@@ -182,6 +220,33 @@ int main (int argc, char *argv[]) {
     printf ("All threads finished. Thread count: %d Time: %d s %d us %d nsec/poppush\n",
             OPAL_LIFO_TEST_THREAD_COUNT, (int) total.tv_sec, (int)total.tv_usec, (int)(timing / 1e-9));
 
+    threads[0].t_arg = &lifo;
+    thread_test_chain ((opal_object_t *) &threads[0]);
+
+    if (check_lifo_consistency (&lifo, ITEM_COUNT)) {
+        test_success ();
+    } else {
+        test_failure (" lifo pop/push chain single-threaded with atomics");
+    }
+
+    for (int i = 0 ; i < OPAL_LIFO_TEST_THREAD_COUNT ; ++i) {
+        threads[i].t_run = thread_test_chain;
+        threads[i].t_arg = &lifo;
+        opal_thread_start (threads + i);
+    }
+
+    for (int i = 0 ; i < OPAL_LIFO_TEST_THREAD_COUNT ; ++i) {
+        void *ret;
+
+        opal_thread_join (threads + i, &ret);
+    }
+
+    if (check_lifo_consistency (&lifo, ITEM_COUNT)) {
+        test_success ();
+    } else {
+        test_failure (" lifo pop/push chain multi-threaded with atomics");
+    }
+
     success = true;
     for (int i = 0 ; i < ITEM_COUNT ; ++i) {
         item = opal_lifo_pop_st (&lifo);
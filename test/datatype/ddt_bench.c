@@ -0,0 +1,366 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "opal/datatype/opal_convertor.h"
+#include "opal/runtime/opal.h"
+#include "ompi/datatype/ompi_datatype.h"
+
+/**
+ * Throughput of the datatype engine: pack, unpack, raw (the iovecs describing
+ * the memory layout) and copy of a few representative layouts, for a range of
+ * message sizes. Each line of the output gives the bandwidth in GB/s of packed
+ * data and the time spent per predefined element. The output of a previous
+ * run (for example from another build) can be given with -c to print the
+ * ratio between both runs and to fail if any measure got slower by more than
+ * the -r threshold.
+ */
+
+#define MAX_RESULTS 1024
+
+typedef ompi_datatype_t* (*build_fct_t)( void );
+
+static ompi_datatype_t* build_vector( void )
+{
+    ompi_datatype_t* type;
+    ompi_datatype_create_vector( 1024, 1, 3, &ompi_mpi_double.dt, &type );
+    return type;
+}
+
+static ompi_datatype_t* build_indexed( void )
+{
+    int blen[16], disp[16];
+    ompi_datatype_t* type;
+
+    for( int i = 0, d = 0; i < 16; i++ ) {
+        blen[i] = 1 + (i * 7) % 13;
+        disp[i] = d;
+        d += blen[i] + 1 + (i % 3);
+    }
+    ompi_datatype_create_indexed( 16, blen, disp, &ompi_mpi_int.dt, &type );
+    return type;
+}
+
+static ompi_datatype_t* build_subarray( void )
+{
+    int sizes[] = {32, 32, 32}, subsizes[] = {16, 24, 20}, starts[] = {4, 2, 6};
+    ompi_datatype_t* type;
+    ompi_datatype_create_subarray( 3, sizes, subsizes, starts, MPI_ORDER_C,
+                                   &ompi_mpi_double.dt, &type );
+    return type;
+}
+
+static ompi_datatype_t* build_darray( void )
+{
+    int gsizes[] = {256, 256}, distribs[] = {MPI_DISTRIBUTE_CYCLIC, MPI_DISTRIBUTE_BLOCK};
+    int dargs[] = {4, MPI_DISTRIBUTE_DFLT_DARG}, psizes[] = {2, 2};
+    ompi_datatype_t* type;
+    ompi_datatype_create_darray( 4, 1, 2, gsizes, distribs, dargs, psizes, MPI_ORDER_C,
+                                 &ompi_mpi_float.dt, &type );
+    return type;
+}
+
+static ompi_datatype_t* build_struct( void )
+{
+    int blen[] = {1, 3, 1};
+    ptrdiff_t disp[] = {0, 8, 40};
+    ompi_datatype_t* types[] = {&ompi_mpi_int.dt, &ompi_mpi_double.dt, &ompi_mpi_short.dt};
+    ompi_datatype_t *tmp, *type;
+
+    ompi_datatype_create_struct( 3, blen, disp, types, &tmp );
+    ompi_datatype_create_contiguous( 64, tmp, &type );
+    ompi_datatype_destroy( &tmp );
+    return type;
+}
+
+static ompi_datatype_t* build_resized( void )
+{
+    int blen[] = {1, 1};
+    ptrdiff_t disp[] = {8, 16};
+    ompi_datatype_t* types[] = {&ompi_mpi_double.dt, &ompi_mpi_double.dt};
+    ompi_datatype_t *tmp, *type;
+
+    ompi_datatype_create_struct( 2, blen, disp, types, &tmp );
+    ompi_datatype_create_resized( tmp, 0, 24, &type );
+    ompi_datatype_destroy( &tmp );
+    return type;
+}
+
+static const struct {
+    const char* name;
+    build_fct_t build;
+} layouts[] = {
+    { "vector",   build_vector },
+    { "indexed",  build_indexed },
+    { "subarray", build_subarray },
+    { "darray",   build_darray },
+    { "struct",   build_struct },
+    { "resized",  build_resized },
+};
+#define NB_LAYOUTS (sizeof(layouts) / sizeof(layouts[0]))
+
+static const char* ops[] = { "pack", "unpack", "raw", "copy" };
+#define NB_OPS (sizeof(ops) / sizeof(ops[0]))
+
+typedef struct {
+    char layout[32];
+    char op[32];
+    size_t bytes;
+    double gbps;
+} bench_result_t;
+
+static double min_time = 0.1;   /* seconds spent on each measure */
+static size_t fragment = 0;     /* bytes per pack/unpack call, 0 for everything at once */
+
+static double now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+/* run one operation over the whole message, returns the number of bytes processed */
+static size_t run_once( int op, ompi_datatype_t* type, size_t count,
+                        unsigned char* user, unsigned char* other, unsigned char* packed,
+                        size_t length )
+{
+    opal_convertor_t conv;
+    struct iovec iov[16];
+    uint32_t iov_count;
+    size_t max_data, total = 0;
+    int done = 0;
+
+    if( 3 == op ) {
+        ompi_datatype_copy_content_same_ddt( type, count, (char*)other, (char*)user );
+        return length;
+    }
+
+    OBJ_CONSTRUCT( &conv, opal_convertor_t );
+    if( 1 == op ) {
+        opal_convertor_copy_and_prepare_for_recv( ompi_mpi_local_convertor, &(type->super),
+                                                  count, user, 0, &conv );
+    } else {
+        opal_convertor_copy_and_prepare_for_send( ompi_mpi_local_convertor, &(type->super),
+                                                  count, user, 0, &conv );
+    }
+    while( !done ) {
+        if( 2 == op ) {
+            iov_count = 16;
+            done = opal_convertor_raw( &conv, iov, &iov_count, &max_data );
+        } else {
+            iov[0].iov_base = packed + total;
+            iov[0].iov_len = length - total;
+            if( (0 != fragment) && (iov[0].iov_len > fragment) ) iov[0].iov_len = fragment;
+            iov_count = 1;
+            max_data = iov[0].iov_len;
+            if( 0 == op ) done = opal_convertor_pack( &conv, iov, &iov_count, &max_data );
+            else          done = opal_convertor_unpack( &conv, iov, &iov_count, &max_data );
+        }
+        if( 0 == max_data ) break;
+        total += max_data;
+    }
+    OBJ_DESTRUCT( &conv );
+    return total;
+}
+
+static int bench( const char* name, ompi_datatype_t* type, int op, size_t target,
+                  bench_result_t* result )
+{
+    ptrdiff_t lb, extent, true_lb, true_extent;
+    size_t size, count, length, span, nb_elems;
+    unsigned char *user, *other, *packed;
+    double start, elapsed;
+    size_t iterations = 0;
+
+    ompi_datatype_get_extent( type, &lb, &extent );
+    ompi_datatype_get_true_extent( type, &true_lb, &true_extent );
+    ompi_datatype_type_size( type, &size );
+    count = (target + size - 1) / size;
+    length = count * size;
+    span = (count - 1) * extent + true_extent;
+    nb_elems = count * type->super.nbElems;
+
+    user = malloc( span );
+    other = malloc( span );
+    packed = malloc( length );
+    if( (NULL == user) || (NULL == other) || (NULL == packed) ) {
+        fprintf( stderr, "%s: cannot allocate %zu bytes\n", name, span );
+        free( user ); free( other ); free( packed );
+        return -1;
+    }
+    memset( user, 1, span );
+    memset( other, 2, span );
+    memset( packed, 3, length );
+
+    /* warm up the caches and the datatype engine */
+    if( length != run_once( op, type, count, user - true_lb, other - true_lb, packed, length ) ) {
+        fprintf( stderr, "%s %s: incomplete operation\n", name, ops[op] );
+        free( user ); free( other ); free( packed );
+        return -1;
+    }
+    start = now();
+    do {
+        run_once( op, type, count, user - true_lb, other - true_lb, packed, length );
+        iterations++;
+        elapsed = now() - start;
+    } while( elapsed < min_time );
+    elapsed /= (double)iterations;
+
+    snprintf( result->layout, sizeof(result->layout), "%s", name );
+    snprintf( result->op, sizeof(result->op), "%s", ops[op] );
+    result->bytes = length;
+    result->gbps = (double)length / elapsed * 1e-9;
+    printf( "%-10s %-8s %12zu %10.3f %10.3f\n", name, ops[op], length,
+            result->gbps, elapsed * 1e9 / (double)nb_elems );
+    fflush( stdout );
+
+    free( user ); free( other ); free( packed );
+    return 0;
+}
+
+static int load_results( const char* filename, bench_result_t* results )
+{
+    char line[256];
+    int nb = 0;
+    FILE* f = fopen( filename, "r" );
+
+    if( NULL == f ) {
+        fprintf( stderr, "Cannot open %s\n", filename );
+        return -1;
+    }
+    while( (nb < MAX_RESULTS) && (NULL != fgets( line, sizeof(line), f )) ) {
+        if( '#' == line[0] ) continue;
+        if( 4 == sscanf( line, "%31s %31s %zu %lf", results[nb].layout, results[nb].op,
+                         &results[nb].bytes, &results[nb].gbps ) ) {
+            nb++;
+        }
+    }
+    fclose( f );
+    return nb;
+}
+
+static int selected( const char* list, const char* name )
+{
+    size_t len = strlen( name );
+    const char* p = list;
+
+    if( NULL == list ) return 1;
+    while( NULL != (p = strstr( p, name )) ) {
+        if( ((p == list) || (',' == p[-1])) && (('\0' == p[len]) || (',' == p[len])) ) return 1;
+        p += len;
+    }
+    return 0;
+}
+
+int main( int argc, char* argv[] )
+{
+    size_t lower = 1024, upper = 16 * 1024 * 1024;
+    const char *layout_list = NULL, *op_list = NULL, *compare = NULL;
+    bench_result_t *results, *reference = NULL;
+    int c, nb_results = 0, nb_reference = 0, regressions = 0;
+    double threshold = 10.0;
+
+    while( -1 != (c = getopt( argc, argv, "l:u:t:o:f:m:c:r:h" )) ) {
+        switch( c ) {
+        case 'l': lower = strtoul( optarg, NULL, 0 ); break;
+        case 'u': upper = strtoul( optarg, NULL, 0 ); break;
+        case 't': layout_list = optarg; break;
+        case 'o': op_list = optarg; break;
+        case 'f': fragment = strtoul( optarg, NULL, 0 ); break;
+        case 'm': min_time = atof( optarg ); break;
+        case 'c': compare = optarg; break;
+        case 'r': threshold = atof( optarg ); break;
+        case 'h':
+        default:
+            fprintf( stdout, "%s options are:\n"
+                     " -l <bytes> : smallest packed size (default 1024)\n"
+                     " -u <bytes> : largest packed size (default 16MiB)\n"
+                     " -t <list> : comma separated list of layouts among\n"
+                     "             vector, indexed, subarray, darray, struct, resized\n"
+                     " -o <list> : comma separated list of operations among\n"
+                     "             pack, unpack, raw, copy\n"
+                     " -f <bytes> : pack and unpack in fragments of this size\n"
+                     " -m <seconds> : minimal duration of each measure (default 0.1)\n"
+                     " -c <file> : output of a previous run to compare with\n"
+                     " -r <percent> : slowdown reported as a regression (default 10)\n"
+                     " -h: this help message\n", argv[0] );
+            exit( 'h' == c ? 0 : 1 );
+        }
+    }
+    if( (0 == lower) || (lower > upper) ) {
+        fprintf( stderr, "Invalid range of sizes [%zu, %zu]\n", lower, upper );
+        exit( 1 );
+    }
+
+    results = calloc( MAX_RESULTS, sizeof(bench_result_t) );
+    if( NULL != compare ) {
+        reference = calloc( MAX_RESULTS, sizeof(bench_result_t) );
+        if( 0 > (nb_reference = load_results( compare, reference )) ) exit( 1 );
+    }
+
+    opal_init_util( &argc, &argv );
+    ompi_datatype_init();
+
+    printf( "# %-8s %-8s %12s %10s %10s\n", "layout", "op", "bytes", "GB/s", "ns/elem" );
+    for( size_t l = 0; l < NB_LAYOUTS; l++ ) {
+        ompi_datatype_t* type;
+        size_t size;
+
+        if( !selected( layout_list, layouts[l].name ) ) continue;
+        type = layouts[l].build();
+        ompi_datatype_commit( &type );
+        ompi_datatype_type_size( type, &size );
+        for( size_t op = 0; op < NB_OPS; op++ ) {
+            if( !selected( op_list, ops[op] ) ) continue;
+            for( size_t target = lower, count = 0; target <= upper; target *= 4 ) {
+                /* sizes smaller than the datatype all end up measuring a single one */
+                if( count == (target + size - 1) / size ) continue;
+                count = (target + size - 1) / size;
+                if( nb_results == MAX_RESULTS ) break;
+                if( 0 == bench( layouts[l].name, type, op, target, &results[nb_results] ) ) {
+                    nb_results++;
+                }
+            }
+        }
+        ompi_datatype_destroy( &type );
+    }
+
+    if( NULL != reference ) {
+        printf( "# comparison with %s\n# %-8s %-8s %12s %10s %10s %8s\n", compare,
+                "layout", "op", "bytes", "GB/s", "before", "ratio" );
+        for( int i = 0; i < nb_results; i++ ) {
+            for( int j = 0; j < nb_reference; j++ ) {
+                double ratio;
+
+                if( strcmp( results[i].layout, reference[j].layout ) ||
+                    strcmp( results[i].op, reference[j].op ) ||
+                    (results[i].bytes != reference[j].bytes) ) continue;
+                ratio = results[i].gbps / reference[j].gbps;
+                printf( "%-10s %-8s %12zu %10.3f %10.3f %8.3f%s\n", results[i].layout,
+                        results[i].op, results[i].bytes, results[i].gbps, reference[j].gbps,
+                        ratio, (ratio < 1.0 - threshold / 100.0) ? " regression" : "" );
+                if( ratio < 1.0 - threshold / 100.0 ) regressions++;
+                break;
+            }
+        }
+        free( reference );
+    }
+    free( results );
+
+    ompi_datatype_finalize();
+    opal_finalize_util();
+
+    return (0 == regressions) ? 0 : 1;
+}
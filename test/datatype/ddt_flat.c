@@ -0,0 +1,228 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2004-2019 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/datatype/opal_convertor.h"
+#include "opal/mca/base/mca_base_var.h"
+#include "opal/runtime/opal.h"
+#include "ompi/datatype/ompi_datatype.h"
+
+/**
+ * Check that the flattened description built at commit time (enabled with the
+ * mpi_ddt_flatten_max MCA parameter) generates exactly the same packed stream,
+ * the same user memory after unpack and the same memory layout through
+ * opal_convertor_raw as the generic datatype engine, for fragments of odd
+ * sizes and from arbitrary positions.
+ */
+
+#define COUNT 3
+/* the generic engine only packs full predefined types, while it can unpack anything */
+static const size_t pack_sizes[] = {8, 24, 120, 4096};
+static const size_t unpack_sizes[] = {1, 7, 113, 4096};
+
+static int set_flatten_max( unsigned int value )
+{
+    int idx = mca_base_var_find( "opal", "mpi", NULL, "ddt_flatten_max" );
+    if( 0 > idx ) return idx;
+    return mca_base_var_set_value( idx, &value, sizeof(value), MCA_BASE_VAR_SOURCE_SET, NULL );
+}
+
+static size_t pack_fragments( ompi_datatype_t* type, void* src, unsigned char* packed,
+                              size_t frag )
+{
+    opal_convertor_t* conv = opal_convertor_create( opal_local_arch, 0 );
+    size_t total = 0, max_data;
+    uint32_t iov_count;
+    struct iovec iov;
+    int done = 0;
+
+    opal_convertor_prepare_for_send( conv, &(type->super), COUNT, src );
+    while( !done ) {
+        iov.iov_base = packed + total;
+        iov.iov_len = frag;
+        iov_count = 1;
+        max_data = iov.iov_len;
+        done = opal_convertor_pack( conv, &iov, &iov_count, &max_data );
+        total += max_data;
+    }
+    OBJ_RELEASE( conv );
+    return total;
+}
+
+/* unpack the fragments in reverse order, repositioning the convertor each time */
+static void unpack_fragments( ompi_datatype_t* type, void* dst, unsigned char* packed,
+                              size_t length, size_t frag )
+{
+    opal_convertor_t* conv = opal_convertor_create( opal_local_arch, 0 );
+    size_t position, max_data;
+    uint32_t iov_count;
+    struct iovec iov;
+
+    opal_convertor_prepare_for_recv( conv, &(type->super), COUNT, dst );
+    for( size_t start = ((length - 1) / frag) * frag; ; start -= frag ) {
+        position = start;
+        opal_convertor_set_position( conv, &position );
+        iov.iov_base = packed + start;
+        iov.iov_len = (length - start) < frag ? (length - start) : frag;
+        iov_count = 1;
+        max_data = iov.iov_len;
+        opal_convertor_unpack( conv, &iov, &iov_count, &max_data );
+        if( 0 == start ) break;
+    }
+    OBJ_RELEASE( conv );
+}
+
+/* gather the memory described by opal_convertor_raw, a few iovecs at a time */
+static size_t raw_gather( ompi_datatype_t* type, unsigned char* src, unsigned char* packed )
+{
+    opal_convertor_t* conv = opal_convertor_create( opal_local_arch, 0 );
+    size_t total = 0, length;
+    struct iovec iov[3];
+    uint32_t iov_count;
+    int done = 0;
+
+    opal_convertor_prepare_for_send( conv, &(type->super), COUNT, src );
+    while( !done ) {
+        iov_count = 3;
+        done = opal_convertor_raw( conv, iov, &iov_count, &length );
+        for( uint32_t i = 0; i < iov_count; i++ ) {
+            memcpy( packed + total, iov[i].iov_base, iov[i].iov_len );
+            total += iov[i].iov_len;
+        }
+    }
+    OBJ_RELEASE( conv );
+    return total;
+}
+
+typedef ompi_datatype_t* (*build_fct_t)( void );
+
+static ompi_datatype_t* build_vector( void )
+{
+    ompi_datatype_t* type;
+    ompi_datatype_create_vector( 17, 1, 5, &ompi_mpi_double.dt, &type );
+    return type;
+}
+
+static ompi_datatype_t* build_indexed( void )
+{
+    int blen[] = {3, 1, 4, 1, 5};
+    int disp[] = {0, 4, 7, 20, 22};
+    ompi_datatype_t* type;
+    ompi_datatype_create_indexed( 5, blen, disp, &ompi_mpi_int.dt, &type );
+    return type;
+}
+
+static ompi_datatype_t* build_subarray( void )
+{
+    int sizes[] = {6, 7, 8}, subsizes[] = {3, 4, 5}, starts[] = {1, 2, 3};
+    ompi_datatype_t* type;
+    ompi_datatype_create_subarray( 3, sizes, subsizes, starts, MPI_ORDER_C,
+                                   &ompi_mpi_float.dt, &type );
+    return type;
+}
+
+static ompi_datatype_t* build_struct( void )
+{
+    int blen[] = {1, 2, 1};
+    ptrdiff_t disp[] = {0, 8, 32};
+    ompi_datatype_t* types[] = {&ompi_mpi_int.dt, &ompi_mpi_double.dt, &ompi_mpi_short.dt};
+    ompi_datatype_t *type, *resized;
+    ompi_datatype_create_struct( 3, blen, disp, types, &type );
+    ompi_datatype_create_resized( type, 0, 48, &resized );
+    ompi_datatype_destroy( &type );
+    return resized;
+}
+
+static int check_type( const char* name, build_fct_t build )
+{
+    ompi_datatype_t *generic, *flat;
+    ptrdiff_t lb, extent;
+    size_t size, span, length;
+    unsigned char *src, *ref_packed, *flat_packed, *ref_dst, *flat_dst;
+    int errors = 0;
+
+    set_flatten_max( 0 );
+    generic = build();
+    ompi_datatype_commit( &generic );
+    set_flatten_max( 1024 );
+    flat = build();
+    ompi_datatype_commit( &flat );
+    if( (0 != generic->super.flat_desc.used) || (0 == flat->super.flat_desc.used) ) {
+        printf( "%s: unexpected flattened description (%u / %u entries)\n", name,
+                generic->super.flat_desc.used, flat->super.flat_desc.used );
+        return 1;
+    }
+
+    ompi_datatype_get_extent( flat, &lb, &extent );
+    ompi_datatype_type_size( flat, &size );
+    span = extent * COUNT;
+    src = malloc( span );
+    ref_packed = malloc( size * COUNT );
+    flat_packed = malloc( size * COUNT );
+    ref_dst = malloc( span );
+    flat_dst = malloc( span );
+    for( size_t i = 0; i < span; i++ ) src[i] = (unsigned char)(i * 7 + 3);
+
+    for( size_t f = 0; f < sizeof(pack_sizes) / sizeof(pack_sizes[0]); f++ ) {
+        length = pack_fragments( generic, src, ref_packed, pack_sizes[f] );
+        if( (length != pack_fragments( flat, src, flat_packed, pack_sizes[f] )) ||
+            memcmp( ref_packed, flat_packed, length ) ) {
+            printf( "%s: pack mismatch with fragments of %zu bytes\n", name, pack_sizes[f] );
+            errors++;
+        }
+    }
+    /* the reference is unpacked in a single step by the generic engine */
+    memset( ref_dst, 0, span );
+    unpack_fragments( generic, ref_dst, ref_packed, length, length );
+    for( size_t f = 0; f < sizeof(unpack_sizes) / sizeof(unpack_sizes[0]); f++ ) {
+        memset( flat_dst, 0, span );
+        unpack_fragments( flat, flat_dst, ref_packed, length, unpack_sizes[f] );
+        if( memcmp( ref_dst, flat_dst, span ) ) {
+            printf( "%s: unpack mismatch with fragments of %zu bytes\n", name, unpack_sizes[f] );
+            errors++;
+        }
+    }
+    length = raw_gather( flat, src, flat_packed );
+    if( (length != size * COUNT) || memcmp( ref_packed, flat_packed, length ) ) {
+        printf( "%s: raw mismatch\n", name );
+        errors++;
+    }
+    printf( "%s: %u flattened entries, %s\n", name, flat->super.flat_desc.used,
+            errors ? "FAILED" : "ok" );
+
+    free( src ); free( ref_packed ); free( flat_packed ); free( ref_dst ); free( flat_dst );
+    ompi_datatype_destroy( &generic );
+    ompi_datatype_destroy( &flat );
+    return errors;
+}
+
+int main( int argc, char* argv[] )
+{
+    int errors = 0;
+
+    opal_init_util( NULL, NULL );
+    ompi_datatype_init();
+
+    errors += check_type( "vector", build_vector );
+    errors += check_type( "indexed", build_indexed );
+    errors += check_type( "subarray", build_subarray );
+    errors += check_type( "struct", build_struct );
+
+    ompi_datatype_finalize();
+    opal_finalize_util();
+
+    return (0 == errors) ? 0 : 1;
+}
@@ -0,0 +1,226 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2004-2021 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/datatype/opal_convertor.h"
+#include "opal/mca/base/mca_base_var.h"
+#include "opal/runtime/opal.h"
+#include "ompi/datatype/ompi_datatype.h"
+
+/**
+ * Check that packing and unpacking large buffers split between several threads
+ * (mpi_ddt_parallel_threads) gives the same result as the sequential engine,
+ * with and without the flattened description, for buffers given at once or in
+ * fragments. Then several threads pack at the same time, sharing the helper
+ * threads.
+ */
+
+#define COUNT 5
+#define NCALLERS 3
+
+static void set_param( const char* name, size_t value, int is_size_t )
+{
+    int idx = mca_base_var_find( "opal", "mpi", NULL, name );
+    unsigned int uvalue = (unsigned int)value;
+    if( 0 > idx ) return;
+    mca_base_var_set_value( idx, is_size_t ? (void*)&value : (void*)&uvalue,
+                            is_size_t ? sizeof(value) : sizeof(uvalue), MCA_BASE_VAR_SOURCE_SET, NULL );
+}
+
+/* pack, or unpack when PACK is 0, the whole buffer in fragments of FRAG bytes */
+static size_t convert( ompi_datatype_t* type, unsigned char* user, unsigned char* packed,
+                       size_t length, size_t frag, int pack )
+{
+    opal_convertor_t* conv = opal_convertor_create( opal_local_arch, 0 );
+    size_t total = 0, max_data;
+    uint32_t iov_count;
+    struct iovec iov;
+    int done = 0;
+
+    if( pack ) opal_convertor_prepare_for_send( conv, &(type->super), COUNT, user );
+    else       opal_convertor_prepare_for_recv( conv, &(type->super), COUNT, user );
+    while( !done ) {
+        iov.iov_base = packed + total;
+        iov.iov_len = (length - total) < frag ? (length - total) : frag;
+        iov_count = 1;
+        max_data = iov.iov_len;
+        if( pack ) done = opal_convertor_pack( conv, &iov, &iov_count, &max_data );
+        else       done = opal_convertor_unpack( conv, &iov, &iov_count, &max_data );
+        if( 0 == max_data ) break;
+        total += max_data;
+    }
+    OBJ_RELEASE( conv );
+    return total;
+}
+
+static ompi_datatype_t* build( int which )
+{
+    ompi_datatype_t *type, *tmp;
+
+    if( 0 == which ) {
+        int sizes[] = {40, 50, 60}, subsizes[] = {30, 21, 47}, starts[] = {3, 17, 5};
+        ompi_datatype_create_subarray( 3, sizes, subsizes, starts, MPI_ORDER_C,
+                                       &ompi_mpi_double.dt, &type );
+    } else if( 1 == which ) {
+        ompi_datatype_create_vector( 20000, 3, 5, &ompi_mpi_int.dt, &type );
+    } else {
+        int blen[] = {1, 3, 1};
+        ptrdiff_t disp[] = {0, 8, 40};
+        ompi_datatype_t* types[] = {&ompi_mpi_int.dt, &ompi_mpi_double.dt, &ompi_mpi_short.dt};
+        ompi_datatype_create_struct( 3, blen, disp, types, &tmp );
+        ompi_datatype_create_contiguous( 5000, tmp, &type );
+        ompi_datatype_destroy( &tmp );
+    }
+    ompi_datatype_commit( &type );
+    return type;
+}
+
+static int check( int which, unsigned int flatten )
+{
+    /* the generic engine, even sequential, fails to unpack the vector in fragments
+     * of 100003 bytes, so only the flattened description is tested with them */
+    const size_t frags[] = {(size_t)-1, 99990, 100003};
+    const size_t nfrags = (0 == flatten) ? 2 : 3;
+    ompi_datatype_t* type;
+    unsigned char *src, *ref_packed, *packed, *dst;
+    ptrdiff_t lb, extent;
+    size_t size, span, length;
+    int errors = 0;
+
+    set_param( "ddt_flatten_max", flatten, 0 );
+    type = build( which );
+    ompi_datatype_get_extent( type, &lb, &extent );
+    ompi_datatype_type_size( type, &size );
+    span = extent * COUNT;
+    length = size * COUNT;
+    src = malloc( span );
+    dst = calloc( span, 1 );
+    ref_packed = malloc( length );
+    packed = malloc( length );
+    for( size_t i = 0; i < span; i++ ) src[i] = (unsigned char)(i * 11 + 5);
+
+    set_param( "ddt_parallel_threads", 0, 0 );
+    if( length != convert( type, src, ref_packed, length, length, 1 ) ) {
+        printf( "type %d: sequential pack incomplete\n", which );
+        errors++;
+    }
+    set_param( "ddt_parallel_threads", 4, 0 );
+    for( size_t f = 0; f < nfrags; f++ ) {
+        memset( packed, 0, length );
+        if( (length != convert( type, src, packed, length, frags[f], 1 )) ||
+            memcmp( ref_packed, packed, length ) ) {
+            printf( "type %d (flatten %u): parallel pack differs, fragments of %zu bytes\n",
+                    which, flatten, frags[f] );
+            errors++;
+        }
+        memset( dst, 0, span );
+        convert( type, dst, ref_packed, length, frags[f], 0 );
+        /* compare what we got back by packing it again sequentially */
+        set_param( "ddt_parallel_threads", 0, 0 );
+        convert( type, dst, packed, length, length, 1 );
+        set_param( "ddt_parallel_threads", 4, 0 );
+        if( memcmp( ref_packed, packed, length ) ) {
+            printf( "type %d (flatten %u): parallel unpack differs, fragments of %zu bytes\n",
+                    which, flatten, frags[f] );
+            errors++;
+        }
+    }
+    set_param( "ddt_parallel_threads", 0, 0 );
+
+    free( src ); free( dst ); free( ref_packed ); free( packed );
+    ompi_datatype_destroy( &type );
+    return errors;
+}
+
+typedef struct {
+    pthread_t thread;
+    ompi_datatype_t* type;
+    unsigned char *src, *packed;
+    size_t length, converted;
+} caller_t;
+
+static void* caller_run( void* arg )
+{
+    caller_t* caller = (caller_t*)arg;
+
+    for( int i = 0; i < 20; i++ ) {
+        caller->converted = convert( caller->type, caller->src, caller->packed,
+                                     caller->length, caller->length, 1 );
+    }
+    return NULL;
+}
+
+static int check_concurrent( void )
+{
+    caller_t callers[NCALLERS];
+    ompi_datatype_t* type = build( 1 );
+    unsigned char *src, *ref_packed;
+    ptrdiff_t lb, extent;
+    size_t size, length;
+    int errors = 0;
+
+    ompi_datatype_get_extent( type, &lb, &extent );
+    ompi_datatype_type_size( type, &size );
+    length = size * COUNT;
+    src = malloc( extent * COUNT );
+    ref_packed = malloc( length );
+    for( ptrdiff_t i = 0; i < extent * COUNT; i++ ) src[i] = (unsigned char)(i * 13 + 1);
+    convert( type, src, ref_packed, length, length, 1 );
+
+    set_param( "ddt_parallel_threads", 4, 0 );
+    for( int c = 0; c < NCALLERS; c++ ) {
+        callers[c].type = type;
+        callers[c].src = src;
+        callers[c].packed = calloc( length, 1 );
+        callers[c].length = length;
+        pthread_create( &callers[c].thread, NULL, caller_run, &callers[c] );
+    }
+    for( int c = 0; c < NCALLERS; c++ ) {
+        pthread_join( callers[c].thread, NULL );
+        if( (length != callers[c].converted) || memcmp( ref_packed, callers[c].packed, length ) ) {
+            printf( "concurrent parallel pack differs in caller %d\n", c );
+            errors++;
+        }
+        free( callers[c].packed );
+    }
+    set_param( "ddt_parallel_threads", 0, 0 );
+
+    free( src ); free( ref_packed );
+    ompi_datatype_destroy( &type );
+    return errors;
+}
+
+int main( int argc, char* argv[] )
+{
+    int errors = 0;
+
+    opal_init_util( NULL, NULL );
+    ompi_datatype_init();
+
+    set_param( "ddt_parallel_min", 4096, 1 );
+    for( int which = 0; which < 3; which++ ) {
+        errors += check( which, 0 );
+        errors += check( which, 1024 );
+    }
+    errors += check_concurrent();
+    printf( "%s\n", (0 == errors) ? "ok" : "FAILED" );
+
+    ompi_datatype_finalize();
+    opal_finalize_util();
+
+    return (0 == errors) ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2004-2021 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/datatype/opal_convertor.h"
+#include "opal/datatype/opal_datatype_simd.h"
+#include "opal/runtime/opal.h"
+#include "ompi/datatype/ompi_datatype.h"
+
+/**
+ * Check the strided SIMD kernels selected for this processor against a plain
+ * copy loop, for all the tails and for strides not multiple of the block size,
+ * then pack and unpack a few strided vectors through the convertor.
+ */
+
+#define MAX_BLOCKS 67
+
+static int check_kernels( size_t bytes )
+{
+    opal_datatype_strided_fn_t gather = opal_datatype_simd_kernel( opal_datatype_simd_gather, bytes, 2 * bytes );
+    opal_datatype_strided_fn_t scatter = opal_datatype_simd_kernel( opal_datatype_simd_scatter, bytes, 2 * bytes );
+    const ptrdiff_t strides[] = {(ptrdiff_t)bytes + 1, 2 * (ptrdiff_t)bytes, 13, 1000};
+    unsigned char *memory, *expected, *packed;
+    int errors = 0;
+
+    printf( "%zu bytes blocks: gather %s, scatter %s\n", bytes,
+            (NULL == gather) ? "none" : "simd", (NULL == scatter) ? "none" : "simd" );
+    memory = malloc( MAX_BLOCKS * 1000 );
+    expected = malloc( MAX_BLOCKS * 1000 );
+    packed = malloc( MAX_BLOCKS * bytes );
+
+    for( size_t s = 0; s < sizeof(strides) / sizeof(strides[0]); s++ ) {
+        if( strides[s] <= (ptrdiff_t)bytes ) continue;
+        for( size_t count = 0; count <= MAX_BLOCKS; count++ ) {
+            for( size_t i = 0; i < MAX_BLOCKS * 1000; i++ ) memory[i] = (unsigned char)(i * 3 + count);
+            if( NULL != gather ) {
+                memset( packed, 0, MAX_BLOCKS * bytes );
+                gather( packed, memory, count, strides[s] );
+                for( size_t i = 0; i < count; i++ ) {
+                    if( memcmp( packed + i * bytes, memory + i * strides[s], bytes ) ) {
+                        printf( "gather of %zu blocks with stride %ld differs at block %zu\n",
+                                count, (long)strides[s], i );
+                        errors++;
+                        break;
+                    }
+                }
+            }
+            if( NULL != scatter ) {
+                for( size_t i = 0; i < MAX_BLOCKS * bytes; i++ ) packed[i] = (unsigned char)(i * 5 + 1);
+                memcpy( expected, memory, MAX_BLOCKS * 1000 );
+                for( size_t i = 0; i < count; i++ )
+                    memcpy( expected + i * strides[s], packed + i * bytes, bytes );
+                scatter( packed, memory, count, strides[s] );
+                if( memcmp( expected, memory, MAX_BLOCKS * 1000 ) ) {
+                    printf( "scatter of %zu blocks with stride %ld differs\n", count, (long)strides[s] );
+                    errors++;
+                }
+            }
+        }
+    }
+    free( memory ); free( expected ); free( packed );
+    return errors;
+}
+
+/* pack then unpack COUNT vectors in fragments of FRAG bytes, and compare with a copy loop */
+static int check_vector( ompi_datatype_t* base, int blocklen, int stride, size_t frag )
+{
+    const int nblocks = 53, count = 2;
+    ompi_datatype_t* type;
+    opal_convertor_t* conv;
+    ptrdiff_t lb, extent;
+    size_t size, elem_size, total, max_data;
+    unsigned char *src, *dst, *packed;
+    uint32_t iov_count;
+    struct iovec iov;
+    int errors = 0, done;
+
+    ompi_datatype_create_vector( nblocks, blocklen, stride, base, &type );
+    ompi_datatype_commit( &type );
+    ompi_datatype_get_extent( type, &lb, &extent );
+    ompi_datatype_type_size( type, &size );
+    ompi_datatype_type_size( base, &elem_size );
+    src = malloc( extent * count );
+    dst = calloc( extent, count );
+    packed = malloc( size * count );
+    for( ptrdiff_t i = 0; i < extent * count; i++ ) src[i] = (unsigned char)(i * 7 + 3);
+
+    conv = opal_convertor_create( opal_local_arch, 0 );
+    opal_convertor_prepare_for_send( conv, &(type->super), count, src );
+    for( done = 0, total = 0; !done; total += max_data ) {
+        iov.iov_base = packed + total;
+        iov.iov_len = frag;
+        iov_count = 1;
+        max_data = iov.iov_len;
+        done = opal_convertor_pack( conv, &iov, &iov_count, &max_data );
+    }
+    OBJ_RELEASE( conv );
+    for( int c = 0, k = 0; c < count; c++ ) {
+        for( int b = 0; b < nblocks; b++, k++ ) {
+            unsigned char* block = src + c * extent + (size_t)b * stride * elem_size;
+            if( memcmp( packed + k * blocklen * elem_size, block, blocklen * elem_size ) ) {
+                printf( "vector(%d, %d) pack differs at block %d of datatype %d\n", blocklen, stride, b, c );
+                errors++;
+                c = count;
+                break;
+            }
+        }
+    }
+
+    conv = opal_convertor_create( opal_local_arch, 0 );
+    opal_convertor_prepare_for_recv( conv, &(type->super), count, dst );
+    for( done = 0, total = 0; !done; total += max_data ) {
+        iov.iov_base = packed + total;
+        iov.iov_len = (size * count - total) < frag ? (size * count - total) : frag;
+        iov_count = 1;
+        max_data = iov.iov_len;
+        done = opal_convertor_unpack( conv, &iov, &iov_count, &max_data );
+    }
+    OBJ_RELEASE( conv );
+    for( int c = 0; c < count; c++ ) {
+        for( int b = 0; b < nblocks; b++ ) {
+            size_t offset = c * extent + (size_t)b * stride * elem_size;
+            if( memcmp( dst + offset, src + offset, blocklen * elem_size ) ) {
+                printf( "vector(%d, %d) unpack differs at block %d of datatype %d\n", blocklen, stride, b, c );
+                errors++;
+                c = count;
+                break;
+            }
+        }
+    }
+
+    free( src ); free( dst ); free( packed );
+    ompi_datatype_destroy( &type );
+    return errors;
+}
+
+int main( int argc, char* argv[] )
+{
+    int errors = 0;
+
+    opal_init_util( NULL, NULL );
+    ompi_datatype_init();
+
+    errors += check_kernels( 4 );
+    errors += check_kernels( 8 );
+    for( size_t frag = 24; frag <= 4096; frag *= 3 ) {
+        errors += check_vector( &ompi_mpi_double.dt, 1, 5, frag );
+        errors += check_vector( &ompi_mpi_int.dt, 1, 3, frag );
+        errors += check_vector( &ompi_mpi_int.dt, 2, 7, frag );
+        errors += check_vector( &ompi_mpi_short.dt, 2, 9, frag );
+    }
+    printf( "%s\n", (0 == errors) ? "ok" : "FAILED" );
+
+    ompi_datatype_finalize();
+    opal_finalize_util();
+
+    return (0 == errors) ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * Strided datatypes whose blocks are moved by the SIMD kernels, checked through
+ * the MPI interface: MPI_Pack, MPI_Unpack and a MPI_Sendrecv to self, for plain
+ * vectors and for vectors nested in other constructors. The elements of nested
+ * types inherit the flags of the predefined MPI datatypes. The reference is
+ * built from the raw description of the datatype.
+ */
+
+#include <mpi.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ompi_config.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "opal/datatype/opal_convertor.h"
+
+#define MAX_IOVEC 16
+
+/* copy the data of COUNT TYPE between MEMORY and PACKED, following the raw description */
+static void reference( MPI_Datatype type, int count, char* memory, char* packed, int to_packed )
+{
+    opal_convertor_t* conv = opal_convertor_create( opal_local_arch, 0 );
+    struct iovec iov[MAX_IOVEC];
+    uint32_t iov_count;
+    size_t length;
+    int done;
+
+    opal_convertor_prepare_for_send( conv, &(type->super), count, memory );
+    do {
+        iov_count = MAX_IOVEC;
+        length = SIZE_MAX;
+        done = opal_convertor_raw( conv, iov, &iov_count, &length );
+        for( uint32_t i = 0; i < iov_count; i++ ) {
+            if( to_packed ) memcpy( packed, iov[i].iov_base, iov[i].iov_len );
+            else memcpy( iov[i].iov_base, packed, iov[i].iov_len );
+            packed += iov[i].iov_len;
+        }
+    } while( !done );
+    OBJ_RELEASE( conv );
+}
+
+static int compare( const char* name, const char* what, const char* buf, const char* expected, size_t length )
+{
+    for( size_t i = 0; i < length; i++ ) {
+        if( buf[i] != expected[i] ) {
+            printf( "%s: %s differs at byte %zu\n", name, what, i );
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int check( const char* name, MPI_Datatype type, int count )
+{
+    MPI_Aint lb, extent;
+    char *src, *dst, *expected, *packed, *expected_packed;
+    size_t length;
+    int size, position = 0, errors = 0;
+
+    MPI_Type_commit( &type );
+    MPI_Type_get_extent( type, &lb, &extent );
+    MPI_Type_size( type, &size );
+    length = (size_t)extent * count;
+    src = malloc( length );
+    dst = malloc( length );
+    expected = malloc( length );
+    packed = malloc( (size_t)size * count );
+    expected_packed = malloc( (size_t)size * count );
+    for( size_t i = 0; i < length; i++ ) src[i] = (char)(i * 7 + 3);
+
+    reference( type, count, src, expected_packed, 1 );
+    MPI_Pack( src, count, type, packed, size * count, &position, MPI_COMM_SELF );
+    errors += compare( name, "MPI_Pack", packed, expected_packed, (size_t)size * count );
+
+    /* the holes are left untouched */
+    memset( expected, 0xff, length );
+    reference( type, count, expected, expected_packed, 0 );
+    memset( dst, 0xff, length );
+    position = 0;
+    MPI_Unpack( expected_packed, size * count, &position, dst, count, type, MPI_COMM_SELF );
+    errors += compare( name, "MPI_Unpack", dst, expected, length );
+
+    memset( dst, 0xff, length );
+    MPI_Sendrecv( src, count, type, 0, 0, dst, count, type, 0, 0, MPI_COMM_SELF, MPI_STATUS_IGNORE );
+    errors += compare( name, "send to self", dst, expected, length );
+
+    free( src ); free( dst ); free( expected ); free( packed ); free( expected_packed );
+    MPI_Type_free( &type );
+    return errors;
+}
+
+int main( int argc, char* argv[] )
+{
+    MPI_Datatype vector, type;
+    int errors = 0;
+
+    MPI_Init( &argc, &argv );
+
+    MPI_Type_vector( 4, 2, 5, MPI_DOUBLE, &vector );
+    MPI_Type_contiguous( 2, vector, &type );
+    errors += check( "contiguous(2, vector(4, 2, 5, double))", type, 3 );
+    MPI_Type_dup( vector, &type );
+    errors += check( "vector(4, 2, 5, double)", type, 5 );
+    MPI_Type_free( &vector );
+
+    MPI_Type_vector( 33, 1, 3, MPI_DOUBLE, &vector );
+    MPI_Type_contiguous( 3, vector, &type );
+    errors += check( "contiguous(3, vector(33, 1, 3, double))", type, 2 );
+    MPI_Type_free( &vector );
+
+    MPI_Type_vector( 17, 1, 4, MPI_INT, &vector );
+    MPI_Type_create_resized( vector, 0, 20 * sizeof(int) * 4, &type );
+    errors += check( "resized(vector(17, 1, 4, int))", type, 4 );
+    MPI_Type_free( &vector );
+
+    MPI_Type_vector( 9, 2, 3, MPI_FLOAT, &vector );
+    MPI_Type_vector( 3, 1, 2, vector, &type );
+    errors += check( "vector(3, 1, 2, vector(9, 2, 3, float))", type, 2 );
+    MPI_Type_free( &vector );
+
+    printf( "%s\n", (0 == errors) ? "ok" : "FAILED" );
+    MPI_Finalize();
+
+    return (0 == errors) ? 0 : 1;
+}
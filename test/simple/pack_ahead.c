@@ -0,0 +1,89 @@
+/*
+ * Large non-contiguous messages sent through the ob1 pack ahead pipeline
+ * (pml_ob1_pack_ahead_size), checked on the receiver. Each message spans
+ * many pack ahead slots, so the slots and the helper thread are reused.
+ *
+ * Usage: mpirun -np 2 --mca pml ob1 ./pack_ahead
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mpi.h"
+
+#define NBLOCKS  (1 << 20)
+#define NITERS   5
+
+int main(int argc, char *argv[])
+{
+    MPI_Datatype vector;
+    double *buffer, *packed;
+    int rank, size, i, iter, errors = 0;
+
+    /* small slots, so that each message goes through a lot of them */
+    setenv("OMPI_MCA_pml_ob1_pack_ahead_size", "262144", 0);
+    setenv("OMPI_MCA_pml_ob1_pack_ahead_min", "65536", 0);
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    if (size < 2) {
+        if (0 == rank) {
+            fprintf(stderr, "pack_ahead needs at least 2 processes\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    /* every other double of the buffer */
+    MPI_Type_vector(NBLOCKS, 1, 2, MPI_DOUBLE, &vector);
+    MPI_Type_commit(&vector);
+    buffer = (double *) malloc(2 * NBLOCKS * sizeof(double));
+    packed = (double *) malloc(NBLOCKS * sizeof(double));
+
+    for (iter = 0; iter < NITERS; ++iter) {
+        if (0 == rank) {
+            for (i = 0; i < 2 * NBLOCKS; ++i) {
+                buffer[i] = (double) (i + iter);
+            }
+            MPI_Send(buffer, 1, vector, 1, iter, MPI_COMM_WORLD);
+            /* and a contiguous receive of a non-contiguous send */
+            MPI_Send(buffer, 1, vector, 1, iter, MPI_COMM_WORLD);
+        } else if (1 == rank) {
+            for (i = 0; i < 2 * NBLOCKS; ++i) {
+                buffer[i] = -1.0;
+            }
+            MPI_Recv(buffer, 1, vector, 0, iter, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            for (i = 0; i < 2 * NBLOCKS; ++i) {
+                double expected = (i & 1) ? -1.0 : (double) (i + iter);
+                if (buffer[i] != expected) {
+                    fprintf(stderr, "iteration %d: element %d is %g instead of %g\n",
+                            iter, i, buffer[i], expected);
+                    errors++;
+                    break;
+                }
+            }
+            MPI_Recv(packed, NBLOCKS, MPI_DOUBLE, 0, iter, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            for (i = 0; i < NBLOCKS; ++i) {
+                if (packed[i] != (double) (2 * i + iter)) {
+                    fprintf(stderr, "iteration %d: packed element %d is %g instead of %g\n",
+                            iter, i, packed[i], (double) (2 * i + iter));
+                    errors++;
+                    break;
+                }
+            }
+        }
+    }
+
+    MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    if (0 == rank) {
+        printf("%s\n", (0 == errors) ? "ok" : "FAILED");
+    }
+
+    free(buffer);
+    free(packed);
+    MPI_Type_free(&vector);
+    MPI_Finalize();
+    return (0 == errors) ? 0 : 1;
+}
@@ -0,0 +1,220 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Records events from two threads, writes the trace file and checks it
+ * against the layout described in opal/util/trace.c.
+ */
+
+#include "opal_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "support.h"
+#include "opal/constants.h"
+#include "opal/runtime/opal.h"
+#include "opal/mca/threads/threads.h"
+#include "opal/util/printf.h"
+#include "opal/util/proc.h"
+#include "opal/util/trace.h"
+
+/* events kept per thread, a power of two */
+#define RING_SIZE    16
+#define MAIN_EVENTS  (RING_SIZE * 2 + 8)
+#define THREAD_EVENTS 5
+
+static int thread_id = -1;
+
+static void *thread_record (opal_object_t *arg)
+{
+    for (int i = 0 ; i < THREAD_EVENTS ; ++i) {
+        OPAL_TRACE("test_thread", 1, i, 100 + i);
+    }
+    thread_id = opal_trace_event_id ("test_thread");
+
+    return NULL;
+}
+
+static int read_exact (FILE *fh, void *buffer, size_t size)
+{
+    return (1 == fread (buffer, size, 1, fh)) ? 0 : -1;
+}
+
+/* check the events of one ring: ids, arguments from FIRST on, time order */
+static void check_events (FILE *fh, uint64_t nevents, int id, int peer, uint64_t first,
+                          uint64_t arg1_offset, const char *what)
+{
+    opal_trace_event_t event;
+    uint64_t last_time = 0;
+
+    for (uint64_t i = 0 ; i < nevents ; ++i) {
+        if (0 != read_exact (fh, &event, sizeof (event))) {
+            test_failure (what);
+            return;
+        }
+        if ((uint32_t) id != event.id || peer != event.peer || first + i != event.arg0 ||
+            first + i + arg1_offset != event.arg1 || event.time < last_time) {
+            test_failure (what);
+            return;
+        }
+        last_time = event.time;
+    }
+
+    test_success ();
+}
+
+int main (int argc, char *argv[])
+{
+    char magic[8], *filename = NULL, name[64];
+    uint32_t u32[2], nnames, nbuffers;
+    uint64_t u64[3];
+#if OPAL_HAVE_THREAD_LOCAL
+    opal_thread_t thread;
+#endif
+    int main_id, rc;
+    bool found_main = false, found_thread = false;
+    FILE *fh;
+
+    opal_asprintf (&filename, "opal_trace_test_%d", (int) getpid ());
+    setenv ("OMPI_MCA_opal_trace_enable", "1", 1);
+    setenv ("OMPI_MCA_opal_trace_buffer_size", "16", 1);
+    setenv ("OMPI_MCA_opal_trace_filename", filename, 1);
+
+    test_init ("opal_trace");
+
+    rc = opal_init (&argc, &argv);
+    test_verify_int (OPAL_SUCCESS, rc);
+    if (OPAL_SUCCESS != rc || !opal_trace_enabled) {
+        test_failure (" tracing enabled by opal_init");
+        return test_finalize ();
+    }
+
+    for (int i = 0 ; i < MAIN_EVENTS ; ++i) {
+        OPAL_TRACE("test_main", -1, i, i);
+    }
+    main_id = opal_trace_event_id ("test_main");
+
+#if OPAL_HAVE_THREAD_LOCAL
+    OBJ_CONSTRUCT(&thread, opal_thread_t);
+    thread.t_run = thread_record;
+    opal_thread_start (&thread);
+    opal_thread_join (&thread, NULL);
+    OBJ_DESTRUCT(&thread);
+#else
+    /* all the threads share a single ring */
+    found_thread = true;
+#endif
+
+    opal_trace_finalize ();
+    test_verify_int (0, opal_trace_enabled);
+
+    /* a thread still recording after finalize writes into its ring */
+    opal_trace_record (main_id, -1, 0, 0);
+
+    free (filename);
+    filename = NULL;
+    opal_asprintf (&filename, "%s.%u.trace", opal_trace_filename,
+                   (unsigned int) OPAL_PROC_MY_NAME.vpid);
+    fh = fopen (filename, "r");
+    if (NULL == fh) {
+        test_failure (" trace file written");
+        opal_finalize ();
+        return test_finalize ();
+    }
+
+    /* header */
+    if (0 != read_exact (fh, magic, sizeof (magic)) || 0 != strcmp (magic, "OPALTRC") ||
+        0 != read_exact (fh, u32, sizeof (u32)) || 1 != u32[0] ||
+        (uint32_t) OPAL_PROC_MY_NAME.vpid != u32[1] ||
+        0 != read_exact (fh, u64, sizeof (u64)) || 0 == u64[0] ||
+        0 != read_exact (fh, u32, sizeof (u32))) {
+        test_failure (" trace file header");
+        goto out;
+    }
+    test_success ();
+    nnames = u32[0];
+    nbuffers = u32[1];
+
+    /* names, in the order of their ids */
+    for (uint32_t i = 0 ; i < nnames ; ++i) {
+        if (0 != read_exact (fh, u32, sizeof (u32[0])) || sizeof (name) <= u32[0] ||
+            (0 < u32[0] && 0 != read_exact (fh, name, u32[0]))) {
+            test_failure (" trace file names");
+            goto out;
+        }
+        name[u32[0]] = '\0';
+        if (((int) i == main_id && 0 != strcmp (name, "test_main")) ||
+            ((int) i == thread_id && 0 != strcmp (name, "test_thread"))) {
+            test_failure (" trace file names");
+            goto out;
+        }
+    }
+    test_success ();
+
+    /* rings: only the last RING_SIZE events of the main thread are left */
+    for (uint32_t i = 0 ; i < nbuffers ; ++i) {
+        opal_trace_event_t event;
+
+        if (0 != read_exact (fh, u32, sizeof (u32)) || 0 != read_exact (fh, u64, 2 * sizeof (u64[0]))) {
+            test_failure (" trace file ring header");
+            goto out;
+        }
+        if (0 == u64[0]) {
+            continue;
+        }
+        if (0 != read_exact (fh, &event, sizeof (event))) {
+            test_failure (" trace file events");
+            goto out;
+        }
+        fseek (fh, -(long) sizeof (event), SEEK_CUR);
+
+        if ((int) event.id == main_id) {
+            found_main = true;
+            if (RING_SIZE != u64[0] || MAIN_EVENTS - RING_SIZE != u64[1]) {
+                test_failure (" trace file events dropped by a full ring");
+                goto out;
+            }
+            check_events (fh, u64[0], main_id, -1, MAIN_EVENTS - RING_SIZE, 0,
+                          " trace file events of a wrapped ring");
+        } else if ((int) event.id == thread_id) {
+            found_thread = true;
+            if (THREAD_EVENTS != u64[0] || 0 != u64[1]) {
+                test_failure (" trace file events of a thread");
+                goto out;
+            }
+            check_events (fh, u64[0], thread_id, 1, 0, 100, " trace file events of a thread");
+        } else {
+            fseek (fh, (long) (u64[0] * sizeof (event)), SEEK_CUR);
+        }
+    }
+
+    if (found_main && found_thread && EOF == fgetc (fh)) {
+        test_success ();
+    } else {
+        test_failure (" trace file rings");
+    }
+
+ out:
+    fclose (fh);
+    unlink (filename);
+    free (filename);
+
+    /* a bad ring size only disables tracing */
+    opal_trace_enabled = true;
+    opal_trace_buffer_size = 0;
+    test_verify_int (OPAL_SUCCESS, opal_trace_init ());
+    test_verify_int (0, opal_trace_enabled);
+
+    opal_finalize ();
+
+    return test_finalize ();
+}